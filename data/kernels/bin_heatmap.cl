@@ -0,0 +1,44 @@
+
+#include "oclr_global.h"
+
+#define OCLRASTER_IMAGE_UCHAR4
+#include "oclr_image.h"
+
+// same color ramp as bin_heatmap::heat_color
+float3 heat_color(const float value) {
+	const float t = clamp(value, 0.0f, 1.0f) * 4.0f;
+	return clamp((float3)(1.5f) - fabs((float3)(t) - (float3)(3.0f, 2.0f, 1.0f)), 0.0f, 1.0f);
+}
+
+//
+kernel void bin_heatmap_overlay(//###OCLRASTER_FRAMEBUFFER_IMAGES###
+								global uchar4* framebuffer,
+								const uint2 framebuffer_size,
+								global const unsigned int* bin_heatmap,
+								const uint2 heatmap_bin_count,
+								const unsigned int metric,
+								const float inv_max_value) {
+	const unsigned int x = get_global_id(0);
+	const unsigned int y = get_global_id(1);
+	if(x >= framebuffer_size.x || y >= framebuffer_size.y) {
+		return;
+	}
+	
+	const uint2 bin_location = (uint2)(x, y) / BIN_SIZE;
+	if(bin_location.x >= heatmap_bin_count.x || bin_location.y >= heatmap_bin_count.y) {
+		return;
+	}
+	const unsigned int value = bin_heatmap[(bin_location.y * heatmap_bin_count.x + bin_location.x) * BH_METRIC_COUNT + metric];
+	
+	// empty bins are left untouched, bin borders are darkened
+	const uint2 coord = (uint2)(x, y);
+	const oclr_sampler_t point_sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_NONE | CLK_FILTER_NEAREST;
+	float3 color = image_read(framebuffer, point_sampler, coord).xyz;
+	if(value > 0u) {
+		color = mix(color, heat_color(convert_float(value) * inv_max_value), 0.6f);
+	}
+	if(x % BIN_SIZE == 0u || y % BIN_SIZE == 0u) {
+		color *= 0.5f;
+	}
+	image_write(framebuffer, coord, (float4)(color, 1.0f));
+}
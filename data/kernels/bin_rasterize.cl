@@ -19,6 +19,13 @@ kernel void oclraster_bin(global unsigned int* bin_distribution_counter,
 						  const uint2 framebuffer_size
 #if !defined(CPU)
 						  , const unsigned int intra_bin_groups
+#endif
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+						  , global unsigned int* pipeline_stats
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+						  , global unsigned int* bin_heatmap
+						  , const uint2 heatmap_bin_count
 #endif
 						  ) {
 	const unsigned int local_id = get_local_id(0);
@@ -140,6 +147,12 @@ kernel void oclraster_bin(global unsigned int* bin_distribution_counter,
 			
 			// store the "any primitives visible at all" flag in the first bit of the first byte
 			primitive_queue[0] |= (primitives_in_queue > 0u ? 1u : 0u);
+			
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+			if(primitives_in_queue > 0u) pipeline_stat_add(PS_BIN_PRIMITIVE_PAIRS, primitives_in_queue);
+			else pipeline_stat_inc(PS_EMPTY_BATCHES);
+#endif
+			bin_heatmap_add(bin_location, BH_PRIMITIVES, primitives_in_queue);
 	
 			// copy queue to global memory (note that some/all implementations have 64-bit loads/stores -> use an ulong4)
 #if (BATCH_SIZE == 256u)
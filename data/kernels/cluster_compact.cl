@@ -0,0 +1,25 @@
+
+#include "oclr_global.h"
+
+// gathers the indices of all visible clusters (see cluster_culling_stage) into a compact index buffer
+// -> 1D kernel, with one work-item per triangle of the largest cluster and visible cluster
+kernel void oclraster_cluster_compact(global const unsigned int* index_buffer,
+									  global const uint4* visible_clusters,
+									  global unsigned int* culled_index_buffer,
+									  const unsigned int visible_cluster_count,
+									  const unsigned int max_cluster_triangle_count) {
+	const unsigned int global_id = get_global_id(0);
+	const unsigned int cluster_idx = global_id / max_cluster_triangle_count;
+	if(cluster_idx >= visible_cluster_count) return;
+	
+	// .x = source triangle offset, .y = triangle count, .z = destination triangle offset
+	const uint4 cluster = visible_clusters[cluster_idx];
+	const unsigned int triangle_idx = global_id - cluster_idx * max_cluster_triangle_count;
+	if(triangle_idx >= cluster.y) return;
+	
+	const unsigned int src_offset = (cluster.x + triangle_idx) * 3u;
+	const unsigned int dst_offset = (cluster.z + triangle_idx) * 3u;
+	culled_index_buffer[dst_offset] = index_buffer[src_offset];
+	culled_index_buffer[dst_offset + 1u] = index_buffer[src_offset + 1u];
+	culled_index_buffer[dst_offset + 2u] = index_buffer[src_offset + 2u];
+}
@@ -85,6 +85,12 @@ typedef half3 oclr_half3;
 typedef half4 oclr_half4;
 #endif
 
+// block compressed image types (one 4x4 texel block each, decoded by the software image functions)
+typedef struct __attribute__((aligned(8))) { uint2 data; } oclr_bc1;
+typedef struct __attribute__((aligned(16))) { uint4 data; } oclr_bc3;
+typedef struct __attribute__((aligned(8))) { uint2 data; } oclr_bc4;
+typedef struct __attribute__((aligned(16))) { uint4 data; } oclr_bc5;
+
 //
 #define print_float3(vec) { \
 	printf(#vec": (%.10f %.10f %.10f)\n", vec.x, vec.y, vec.z); \
@@ -121,6 +127,55 @@ enum PRIMITIVE_TYPE {
 	PT_TRIANGLE_FAN
 };
 
+// pipeline statistics counter indices (PIPELINE_STATISTIC on host side, order must match)
+enum PIPELINE_STATISTIC {
+	PS_PRIMITIVES_IN,
+	PS_CULLED_VERTEX_DISCARD,
+	PS_CULLED_NEAR_PLANE,
+	PS_CULLED_FRUSTUM,
+	PS_CULLED_BACKFACE,
+	PS_CULLED_DEGENERATE,
+	PS_CULLED_SCISSOR,
+	PS_BIN_PRIMITIVE_PAIRS,
+	PS_BATCHES,
+	PS_EMPTY_BATCHES,
+	PS_FRAGMENTS_TESTED,
+	PS_FRAGMENTS_EARLY_DEPTH_REJECTED,
+	PS_FRAGMENTS_DISCARDED,
+	PS_FRAGMENTS_LATE_DEPTH_REJECTED,
+	PS_FRAGMENTS_WRITTEN,
+	PS_FRAGMENT_STATISTIC_COUNT = (PS_FRAGMENTS_WRITTEN - PS_FRAGMENTS_TESTED + 1)
+};
+
+// statistics are counted in the "pipeline_stats" kernel parameter (only present if statistics are enabled)
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+#define pipeline_stat_inc(stat) atomic_inc(&pipeline_stats[stat])
+#define pipeline_stat_add(stat, value) atomic_add(&pipeline_stats[stat], value)
+#else
+#define pipeline_stat_inc(stat)
+#define pipeline_stat_add(stat, value)
+#endif
+
+// per-bin load metrics of the bin heatmap (BIN_HEATMAP_METRIC on host side, order must match)
+enum BIN_HEATMAP_METRIC {
+	BH_PRIMITIVES,
+	BH_FRAGMENTS_TESTED,
+	BH_FRAGMENTS_SHADED,
+	BH_METRIC_COUNT
+};
+
+// metrics are accumulated in the "bin_heatmap" kernel parameter (only present if the bin heatmap is enabled),
+// "heatmap_bin_count" is (0, 0) if the current draw call is not recorded
+#if defined(OCLRASTER_BIN_HEATMAP)
+#define bin_heatmap_add(location, metric, value) { \
+	if(heatmap_bin_count.x != 0u && (value) > 0u) { \
+		atomic_add(&bin_heatmap[((location).y * heatmap_bin_count.x + (location).x) * BH_METRIC_COUNT + (metric)], (value)); \
+	} \
+}
+#else
+#define bin_heatmap_add(location, metric, value)
+#endif
+
 // batch: 2 header bytes (#passing triangles), n bytes passing primitive mask (8 primitives per byte)
 #define BATCH_HEADER_SIZE (1u)
 #define BATCH_BYTE_COUNT (BATCH_SIZE / 8u)
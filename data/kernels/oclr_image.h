@@ -24,6 +24,9 @@ typedef struct __attribute__((packed,
 	const ushort channel_order;
 	const ushort width;
 	const ushort height;
+	const ushort mip_level_count;
+	const ushort layout; // 0: linear (row-major), otherwise: log2 of the tile size (tiles are row-major, texels inside a tile too)
+	const uint mip_level_offsets[OCLRASTER_IMAGE_MAX_MIP_LEVELS]; // byte offsets relative to the first header
 } image_header;
 typedef global const image_header* image_header_ptr;
 
@@ -37,6 +40,33 @@ OCLRASTER_FUNC unsigned int oclr_get_image_type(global const image_header* img)
 OCLRASTER_FUNC unsigned int oclr_get_image_channel_order(global const image_header* img) {
 	return img->channel_order;
 }
+// offset of the texel at coord inside the image data (in texels)
+OCLRASTER_FUNC unsigned int oclr_get_image_texel_offset(global const image_header* img, const uint2 coord) {
+	const uint tile_shift = img->layout;
+	if(tile_shift == 0u) return coord.y * img->width + coord.x;
+	const uint tile_mask = (1u << tile_shift) - 1u;
+	const uint tile_count_x = (img->width + tile_mask) >> tile_shift;
+	const uint2 tile = coord >> tile_shift;
+	const uint2 tile_coord = coord & tile_mask;
+	return (((((tile.y * tile_count_x + tile.x) << tile_shift) + tile_coord.y) << tile_shift) + tile_coord.x);
+}
+OCLRASTER_FUNC unsigned int oclr_get_image_mip_level_count(global const image_header* img) {
+	return img->mip_level_count;
+}
+// every mip-map level has its own header -> the returned pointer can be used like any other buffer-based image
+OCLRASTER_FUNC global const uchar* oclr_get_image_mip_level(global const image_header* img, const uint level) {
+	return (global const uchar*)img + img->mip_level_offsets[level];
+}
+
+// computes the level of detail from the screen-space derivatives of a (normalized) texture coordinate
+OCLRASTER_FUNC float oclr_compute_lod(const float2 img_size, const float2 dx, const float2 dy) {
+	const float2 texel_dx = dx * img_size;
+	const float2 texel_dy = dy * img_size;
+	return 0.5f * log2(fmax(dot(texel_dx, texel_dx), dot(texel_dy, texel_dy)));
+}
+OCLRASTER_FUNC float FUNC_OVERLOAD oclr_compute_image_lod(global const void* img, const float2 dx, const float2 dy) {
+	return oclr_compute_lod(convert_float2(oclr_get_image_size((image_header_ptr)img)), dx, dy);
+}
 
 //
 OCLRASTER_FUNC float FUNC_OVERLOAD texel_mix(float x, float y, float a) { return linear_blend(x, y, a); }
@@ -105,6 +135,20 @@ OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_uint_hw(read_only image2d_t img, c
 	return read_imageui(img, sampler, convert_int2(coord));
 }
 
+// native images have no mip-map levels (opencl 1.x) -> lod is ignored
+OCLRASTER_FUNC float4 FUNC_OVERLOAD image_read_lod_hw(read_only image2d_t img, const sampler_t sampler, const float2 coord, const float lod) {
+	return read_imagef(img, sampler, coord);
+}
+OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_lod_int_hw(read_only image2d_t img, const sampler_t sampler, const float2 coord, const float lod) {
+	return read_imagei(img, sampler, coord);
+}
+OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_lod_uint_hw(read_only image2d_t img, const sampler_t sampler, const float2 coord, const float lod) {
+	return read_imageui(img, sampler, coord);
+}
+OCLRASTER_FUNC float FUNC_OVERLOAD oclr_compute_image_lod(read_only image2d_t img, const float2 dx, const float2 dy) {
+	return oclr_compute_lod(convert_float2(get_image_dim(img)), dx, dy);
+}
+
 OCLRASTER_FUNC float4 FUNC_OVERLOAD image_read_float_nearest_hw(read_only image2d_t img, const float2 coord) {
 	const sampler_t sampler = CLK_NORMALIZED_COORDS_TRUE | CLK_ADDRESS_REPEAT | CLK_FILTER_NEAREST;
 	return read_imagef(img, sampler, coord);
@@ -123,6 +167,56 @@ OCLRASTER_FUNC void FUNC_OVERLOAD image_write_hw(write_only image2d_t img, const
 
 #endif
 
+// block compressed texel decoding (texel: position inside the 4x4 block)
+OCLRASTER_FUNC float3 oclr_bc_decode_565(const uint color) {
+	return convert_float3((uint3)((color >> 11u) & 0x1Fu, (color >> 5u) & 0x3Fu, color & 0x1Fu)) / (float3)(31.0f, 63.0f, 31.0f);
+}
+// bc1 color block: 2 rgb565 endpoints + 2-bit indices
+OCLRASTER_FUNC float4 oclr_bc_decode_color(const uint2 block, const uint2 texel, const bool allow_alpha) {
+	const uint color0 = block.x & 0xFFFFu;
+	const uint color1 = block.x >> 16u;
+	const uint index = (block.y >> (2u * (texel.y * 4u + texel.x))) & 3u;
+	const float3 rgb0 = oclr_bc_decode_565(color0);
+	const float3 rgb1 = oclr_bc_decode_565(color1);
+	if(index == 0u) return (float4)(rgb0, 1.0f);
+	if(index == 1u) return (float4)(rgb1, 1.0f);
+	if(color0 > color1 || !allow_alpha) {
+		// 4 color mode (always used by bc3)
+		return (float4)(index == 2u ? (2.0f * rgb0 + rgb1) / 3.0f : (rgb0 + 2.0f * rgb1) / 3.0f, 1.0f);
+	}
+	// 3 color mode + transparent black
+	return (index == 2u ? (float4)((rgb0 + rgb1) * 0.5f, 1.0f) : (float4)(0.0f));
+}
+// bc4 block: 2 8-bit endpoints + 3-bit indices
+OCLRASTER_FUNC float oclr_bc_decode_alpha(const uint2 block, const uint2 texel) {
+	const float value0 = (float)(block.x & 0xFFu) / 255.0f;
+	const float value1 = (float)((block.x >> 8u) & 0xFFu) / 255.0f;
+	const ulong bits = ((ulong)block.y << 32ul) | (ulong)block.x;
+	const uint index = (uint)(bits >> (16ul + 3ul * (ulong)(texel.y * 4u + texel.x))) & 7u;
+	if(index == 0u) return value0;
+	if(index == 1u) return value1;
+	if(value0 > value1) {
+		// 6 interpolated values
+		return ((float)(8u - index) * value0 + (float)(index - 1u) * value1) / 7.0f;
+	}
+	// 4 interpolated values + 0 and 1
+	if(index == 6u) return 0.0f;
+	if(index == 7u) return 1.0f;
+	return ((float)(6u - index) * value0 + (float)(index - 1u) * value1) / 5.0f;
+}
+OCLRASTER_FUNC float4 FUNC_OVERLOAD oclr_bc_decode(const oclr_bc1 block, const uint2 texel) {
+	return oclr_bc_decode_color(block.data, texel, true);
+}
+OCLRASTER_FUNC float4 FUNC_OVERLOAD oclr_bc_decode(const oclr_bc3 block, const uint2 texel) {
+	return (float4)(oclr_bc_decode_color(block.data.zw, texel, false).xyz, oclr_bc_decode_alpha(block.data.xy, texel));
+}
+OCLRASTER_FUNC float4 FUNC_OVERLOAD oclr_bc_decode(const oclr_bc4 block, const uint2 texel) {
+	return (float4)(oclr_bc_decode_alpha(block.data, texel), 0.0f, 0.0f, 1.0f);
+}
+OCLRASTER_FUNC float4 FUNC_OVERLOAD oclr_bc_decode(const oclr_bc5 block, const uint2 texel) {
+	return (float4)(oclr_bc_decode_alpha(block.data.xy, texel), oclr_bc_decode_alpha(block.data.zw, texel), 0.0f, 1.0f);
+}
+
 // image_read* and image_write* functions for buffer-based/software images
 #include "oclr_image_support.h"
 
@@ -137,6 +231,9 @@ OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_int_sw(read_only image2d_t img, con
 OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_int_sw(read_only image2d_t img, const oclr_sampler_t sampler, const uint2 coord) { return (int4)(0); }
 OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_uint_sw(read_only image2d_t img, const oclr_sampler_t sampler, const float2 coord) { return (uint4)(0u); }
 OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_uint_sw(read_only image2d_t img, const oclr_sampler_t sampler, const uint2 coord) { return (uint4)(0u); }
+OCLRASTER_FUNC float4 FUNC_OVERLOAD image_read_lod_sw(read_only image2d_t img, const oclr_sampler_t sampler, const float2 coord, const float lod) { return (float4)(0.0f); }
+OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_lod_int_sw(read_only image2d_t img, const oclr_sampler_t sampler, const float2 coord, const float lod) { return (int4)(0); }
+OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_lod_uint_sw(read_only image2d_t img, const oclr_sampler_t sampler, const float2 coord, const float lod) { return (uint4)(0u); }
 OCLRASTER_FUNC void FUNC_OVERLOAD image_write_sw(write_only image2d_t img, const uint2 coord, const float4 color) {}
 OCLRASTER_FUNC void FUNC_OVERLOAD image_write_sw(write_only image2d_t img, const uint2 coord, const int4 color) {}
 OCLRASTER_FUNC void FUNC_OVERLOAD image_write_sw(write_only image2d_t img, const uint2 coord, const uint4 color) {}
@@ -147,6 +244,9 @@ OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_int_hw(global const void* img, cons
 OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_int_hw(global const void* img, const sampler_t sampler, const uint2 coord) { return (int4)(0); }
 OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_uint_hw(global const void* img, const sampler_t sampler, const float2 coord) { return (uint4)(0u); }
 OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_uint_hw(global const void* img, const sampler_t sampler, const uint2 coord) { return (uint4)(0u); }
+OCLRASTER_FUNC float4 FUNC_OVERLOAD image_read_lod_hw(global const void* img, const sampler_t sampler, const float2 coord, const float lod) { return (float4)(0.0f); }
+OCLRASTER_FUNC int4 FUNC_OVERLOAD image_read_lod_int_hw(global const void* img, const sampler_t sampler, const float2 coord, const float lod) { return (int4)(0); }
+OCLRASTER_FUNC uint4 FUNC_OVERLOAD image_read_lod_uint_hw(global const void* img, const sampler_t sampler, const float2 coord, const float lod) { return (uint4)(0u); }
 OCLRASTER_FUNC void FUNC_OVERLOAD image_write_hw(global void* img, const uint2 coord, const float4 color) {}
 OCLRASTER_FUNC void FUNC_OVERLOAD image_write_hw(global void* img, const uint2 coord, const int4 color) {}
 OCLRASTER_FUNC void FUNC_OVERLOAD image_write_hw(global void* img, const uint2 coord, const uint4 color) {}
@@ -168,6 +268,21 @@ __builtin_choose_expr(__alignof__(img) != 16, \
 __builtin_choose_expr(__alignof__(img) != 16, \
 					  image_read_uint_hw(img, sampler, coord), \
 					  image_read_uint_sw(img, sampler, coord))
+
+#define image_read_lod(img, sampler, coord, lod) \
+__builtin_choose_expr(__alignof__(img) != 16, \
+					  image_read_lod_hw(img, sampler, coord, lod), \
+					  image_read_lod_sw(img, sampler, coord, lod))
+
+#define image_read_lod_int(img, sampler, coord, lod) \
+__builtin_choose_expr(__alignof__(img) != 16, \
+					  image_read_lod_int_hw(img, sampler, coord, lod), \
+					  image_read_lod_int_sw(img, sampler, coord, lod))
+
+#define image_read_lod_uint(img, sampler, coord, lod) \
+__builtin_choose_expr(__alignof__(img) != 16, \
+					  image_read_lod_uint_hw(img, sampler, coord, lod), \
+					  image_read_lod_uint_sw(img, sampler, coord, lod))
 #else
 // the intel opencl compiler explicitly needs a sampler_t variable
 #define image_read(img, sampler, coord) \
@@ -193,6 +308,30 @@ __builtin_choose_expr(__alignof__(img) != 16, \
 						  image_read_uint_hw(img, hw_sampler, coord), \
 						  image_read_uint_sw(img, sampler, coord)); \
 })
+
+#define image_read_lod(img, sampler, coord, lod) \
+({ \
+	const sampler_t hw_sampler = sampler; \
+	__builtin_choose_expr(__alignof__(img) != 16, \
+						  image_read_lod_hw(img, hw_sampler, coord, lod), \
+						  image_read_lod_sw(img, sampler, coord, lod)); \
+})
+
+#define image_read_lod_int(img, sampler, coord, lod) \
+({ \
+	const sampler_t hw_sampler = sampler; \
+	__builtin_choose_expr(__alignof__(img) != 16, \
+						  image_read_lod_int_hw(img, hw_sampler, coord, lod), \
+						  image_read_lod_int_sw(img, sampler, coord, lod)); \
+})
+
+#define image_read_lod_uint(img, sampler, coord, lod) \
+({ \
+	const sampler_t hw_sampler = sampler; \
+	__builtin_choose_expr(__alignof__(img) != 16, \
+						  image_read_lod_uint_hw(img, hw_sampler, coord, lod), \
+						  image_read_lod_uint_sw(img, sampler, coord, lod)); \
+})
 #endif
 
 #define image_write(img, coord, color) \
@@ -206,6 +345,9 @@ __builtin_choose_expr(__alignof__(img) != 16, \
 #define image_read(img, sampler, coord) image_read_sw(img, sampler, coord)
 #define image_read_int(img, sampler, coord) image_read_int_sw(img, sampler, coord)
 #define image_read_uint(img, sampler, coord) image_read_uint_sw(img, sampler, coord)
+#define image_read_lod(img, sampler, coord, lod) image_read_lod_sw(img, sampler, coord, lod)
+#define image_read_lod_int(img, sampler, coord, lod) image_read_lod_int_sw(img, sampler, coord, lod)
+#define image_read_lod_uint(img, sampler, coord, lod) image_read_lod_uint_sw(img, sampler, coord, lod)
 #define image_write(img, coord, color) image_write_sw(img, coord, color)
 
 #else // amd opencl c++ and cuda c++
@@ -254,6 +396,39 @@ OCLRASTER_FUNC uint4 image_read_uint(image_type img, const oclr_sampler_t sample
 	return image_read_uint_hw(img, sampler, coord);
 }
 
+template <typename image_type,
+		  typename enable_if<!is_native_image<image_type>::value, int>::type = 0>
+OCLRASTER_FUNC float4 image_read_lod(image_type img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_lod_sw(img, sampler, coord, lod);
+}
+template <typename image_type,
+		  typename enable_if<is_native_image<image_type>::value, int>::type = 0>
+OCLRASTER_FUNC float4 image_read_lod(image_type img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_lod_hw(img, sampler, coord, lod);
+}
+
+template <typename image_type,
+		  typename enable_if<!is_native_image<image_type>::value, int>::type = 0>
+OCLRASTER_FUNC int4 image_read_lod_int(image_type img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_lod_int_sw(img, sampler, coord, lod);
+}
+template <typename image_type,
+		  typename enable_if<is_native_image<image_type>::value, int>::type = 0>
+OCLRASTER_FUNC int4 image_read_lod_int(image_type img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_lod_int_hw(img, sampler, coord, lod);
+}
+
+template <typename image_type,
+		  typename enable_if<!is_native_image<image_type>::value, int>::type = 0>
+OCLRASTER_FUNC uint4 image_read_lod_uint(image_type img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_lod_uint_sw(img, sampler, coord, lod);
+}
+template <typename image_type,
+		  typename enable_if<is_native_image<image_type>::value, int>::type = 0>
+OCLRASTER_FUNC uint4 image_read_lod_uint(image_type img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_lod_uint_hw(img, sampler, coord, lod);
+}
+
 template <typename image_type, typename color_type,
 		  typename enable_if<!is_native_image<image_type>::value, int>::type = 0>
 OCLRASTER_FUNC void image_read(image_type img, const uint2 coord, const color_type color) {
@@ -267,6 +442,12 @@ OCLRASTER_FUNC void image_read(image_type img, const uint2 coord, const color_ty
 
 #endif
 
+// mip-mapped reads with the level of detail computed from the screen-space derivatives of the texture coordinate
+// (e.g. dfdx(...) and dfdy(...) in rasterization programs)
+#define image_read_grad(img, sampler, coord, dx, dy) image_read_lod(img, sampler, coord, oclr_compute_image_lod(img, dx, dy))
+#define image_read_grad_int(img, sampler, coord, dx, dy) image_read_lod_int(img, sampler, coord, oclr_compute_image_lod(img, dx, dy))
+#define image_read_grad_uint(img, sampler, coord, dx, dy) image_read_lod_uint(img, sampler, coord, oclr_compute_image_lod(img, dx, dy))
+
 //
 #if defined(__clang__)
 #pragma clang diagnostic pop
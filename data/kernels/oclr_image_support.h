@@ -15,11 +15,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uch
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uchar* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const uchar* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -31,15 +30,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ucha
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float texels[4] = {
  convert_float(native_texels[0]),
@@ -61,9 +61,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const uchar* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const uchar* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const uchar*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const uchar*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const uchar*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar* img_data_ptr = (global uchar*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar_sat( (((color.x * 255.0f))) );
 }
@@ -80,11 +95,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uch
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uchar2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const uchar2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -96,15 +110,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ucha
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float2 texels[4] = {
  convert_float2(native_texels[0]),
@@ -126,9 +141,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const uchar2* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const uchar2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const uchar2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const uchar2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const uchar2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar2* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar2* img_data_ptr = (global uchar2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar2_sat( (((color.xy * 255.0f))) );
 }
@@ -145,11 +175,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uch
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uchar3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const uchar3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -161,15 +190,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ucha
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float3 texels[4] = {
  convert_float3(native_texels[0]),
@@ -191,9 +221,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const uchar3* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const uchar3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const uchar3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const uchar3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const uchar3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar3* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar3* img_data_ptr = (global uchar3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar3_sat( (((color.xyz * 255.0f))) );
 }
@@ -210,11 +255,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uch
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const uchar4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const uchar4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -226,15 +270,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ucha
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float4 texels[4] = {
  convert_float4(native_texels[0]),
@@ -256,9 +301,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const uchar4* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const uchar4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const uchar4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const uchar4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const uchar4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar4* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar4* img_data_ptr = (global uchar4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar4_sat( (((color.xyzw * 255.0f))) );
 }
@@ -275,11 +335,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -291,15 +350,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint texels[4] = {
  convert_uint(native_texels[0]),
@@ -321,9 +381,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uchar* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uchar* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uchar*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uchar*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uchar*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar* img_data_ptr = (global uchar*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar_sat( (((color.x ))) );
 }
@@ -340,11 +415,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -356,15 +430,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar2
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint2 texels[4] = {
  convert_uint2(native_texels[0]),
@@ -386,9 +461,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uchar2* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uchar2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uchar2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uchar2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uchar2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar2* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar2* img_data_ptr = (global uchar2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar2_sat( (((color.xy ))) );
 }
@@ -405,11 +495,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -421,15 +510,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar3
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint3 texels[4] = {
  convert_uint3(native_texels[0]),
@@ -451,9 +541,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uchar3* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uchar3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uchar3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uchar3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uchar3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar3* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar3* img_data_ptr = (global uchar3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar3_sat( (((color.xyz ))) );
 }
@@ -470,11 +575,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uchar4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -486,15 +590,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uchar4
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uchar4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint4 texels[4] = {
  convert_uint4(native_texels[0]),
@@ -516,9 +621,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uchar4* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uchar4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uchar4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uchar4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uchar4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uchar4* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uchar4* img_data_ptr = (global uchar4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_uchar4_sat( (((color.xyzw ))) );
 }
@@ -535,11 +655,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ush
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ushort* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ushort* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -551,15 +670,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const usho
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float texels[4] = {
  convert_float(native_texels[0]),
@@ -581,9 +701,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const ushort* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const ushort* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const ushort*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const ushort*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const ushort*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort* img_data_ptr = (global ushort*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort_sat( (((color.x * 65535.0f))) );
 }
@@ -600,11 +735,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ush
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ushort2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ushort2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -616,15 +750,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const usho
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float2 texels[4] = {
  convert_float2(native_texels[0]),
@@ -646,9 +781,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const ushort2* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const ushort2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const ushort2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const ushort2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const ushort2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort2* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort2* img_data_ptr = (global ushort2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort2_sat( (((color.xy * 65535.0f))) );
 }
@@ -665,11 +815,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ush
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ushort3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ushort3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -681,15 +830,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const usho
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float3 texels[4] = {
  convert_float3(native_texels[0]),
@@ -711,9 +861,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const ushort3* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const ushort3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const ushort3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const ushort3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const ushort3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort3* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort3* img_data_ptr = (global ushort3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort3_sat( (((color.xyz * 65535.0f))) );
 }
@@ -730,11 +895,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ush
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ushort4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const ushort4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -746,15 +910,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const usho
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float4 texels[4] = {
  convert_float4(native_texels[0]),
@@ -776,9 +941,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const ushort4* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const ushort4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const ushort4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const ushort4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const ushort4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort4* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort4* img_data_ptr = (global ushort4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort4_sat( (((color.xyzw * 65535.0f))) );
 }
@@ -795,11 +975,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushor
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushort* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -811,15 +990,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint texels[4] = {
  convert_uint(native_texels[0]),
@@ -841,9 +1021,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const ushort* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const ushort* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const ushort*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const ushort*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const ushort*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort* img_data_ptr = (global ushort*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort_sat( (((color.x ))) );
 }
@@ -860,11 +1055,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushor
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushort2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -876,15 +1070,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint2 texels[4] = {
  convert_uint2(native_texels[0]),
@@ -906,9 +1101,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const ushort2* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const ushort2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const ushort2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const ushort2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const ushort2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort2* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort2* img_data_ptr = (global ushort2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort2_sat( (((color.xy ))) );
 }
@@ -925,11 +1135,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushor
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushort3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -941,15 +1150,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint3 texels[4] = {
  convert_uint3(native_texels[0]),
@@ -971,9 +1181,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const ushort3* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const ushort3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const ushort3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const ushort3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const ushort3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort3* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort3* img_data_ptr = (global ushort3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort3_sat( (((color.xyz ))) );
 }
@@ -990,11 +1215,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushor
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const ushort4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1006,15 +1230,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const ushort
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ushort4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint4 texels[4] = {
  convert_uint4(native_texels[0]),
@@ -1036,9 +1261,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const ushort4* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const ushort4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const ushort4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const ushort4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const ushort4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ushort4* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ushort4* img_data_ptr = (global ushort4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_ushort4_sat( (((color.xyzw ))) );
 }
@@ -1055,11 +1295,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1071,15 +1310,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uint native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint texels[4] = {
  convert_uint(native_texels[0]),
@@ -1101,9 +1341,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uint* img, co
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uint* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uint*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uint*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uint*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uint* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uint* img_data_ptr = (global uint*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.x ))) );
 }
@@ -1120,11 +1375,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint2
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1136,15 +1390,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint2*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uint2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint2 texels[4] = {
  convert_uint2(native_texels[0]),
@@ -1166,9 +1421,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uint2* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uint2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uint2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uint2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uint2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uint2* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uint2* img_data_ptr = (global uint2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xy ))) );
 }
@@ -1185,11 +1455,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint3
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1201,15 +1470,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint3*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uint3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint3 texels[4] = {
  convert_uint3(native_texels[0]),
@@ -1231,9 +1501,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uint3* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uint3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uint3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uint3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uint3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uint3* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uint3* img_data_ptr = (global uint3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyz ))) );
 }
@@ -1250,11 +1535,10 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint4
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_uint_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_nearest_sw(global const uint4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_uint_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_uint_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1266,15 +1550,16 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_linear_sw(global const uint4*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const uint4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const uint4 texels[4] = {
  convert_uint4(native_texels[0]),
@@ -1296,9 +1581,24 @@ uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_uint_sw(global const uint4* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_uint_nearest_sw(img, coord);
  return (uint4)(0, 0, 0, 1);
 }
+uint4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_uint_sw(global const uint4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const uint4 texel = image_read_uint_linear_sw((global const uint4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_uint_linear_sw((global const uint4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_uint_nearest_sw((global const uint4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (uint4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global uint4* img, const uint2 coord, const uint4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global uint4* img_data_ptr = (global uint4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyzw ))) );
 }
@@ -1315,11 +1615,10 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_ulong_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulong* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_ulong_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulong* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1331,15 +1630,16 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulon
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ulong native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const ulong texels[4] = {
  convert_ulong(native_texels[0]),
@@ -1361,9 +1661,24 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_sw(global const ulong* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_ulong_nearest_sw(img, coord);
  return (ulong4)(0, 0, 0, 1);
 }
+ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_ulong_sw(global const ulong* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const ulong4 texel = image_read_ulong_linear_sw((global const ulong*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_ulong_linear_sw((global const ulong*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_ulong_nearest_sw((global const ulong*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (ulong4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ulong* img, const uint2 coord, const ulong4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ulong* img_data_ptr = (global ulong*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.x ))) );
 }
@@ -1380,11 +1695,10 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_ulong_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulong2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_ulong_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulong2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1396,15 +1710,16 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulon
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ulong2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const ulong2 texels[4] = {
  convert_ulong2(native_texels[0]),
@@ -1426,9 +1741,24 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_sw(global const ulong2* img
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_ulong_nearest_sw(img, coord);
  return (ulong4)(0, 0, 0, 1);
 }
+ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_ulong_sw(global const ulong2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const ulong4 texel = image_read_ulong_linear_sw((global const ulong2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_ulong_linear_sw((global const ulong2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_ulong_nearest_sw((global const ulong2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (ulong4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ulong2* img, const uint2 coord, const ulong4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ulong2* img_data_ptr = (global ulong2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xy ))) );
 }
@@ -1445,11 +1775,10 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_ulong_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulong3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_ulong_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulong3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1461,15 +1790,16 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulon
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ulong3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const ulong3 texels[4] = {
  convert_ulong3(native_texels[0]),
@@ -1491,9 +1821,24 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_sw(global const ulong3* img
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_ulong_nearest_sw(img, coord);
  return (ulong4)(0, 0, 0, 1);
 }
+ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_ulong_sw(global const ulong3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const ulong4 texel = image_read_ulong_linear_sw((global const ulong3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_ulong_linear_sw((global const ulong3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_ulong_nearest_sw((global const ulong3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (ulong4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ulong3* img, const uint2 coord, const ulong4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ulong3* img_data_ptr = (global ulong3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyz ))) );
 }
@@ -1510,11 +1855,10 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_ulong_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_nearest_sw(global const ulong4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_ulong_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_ulong_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulong4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1526,15 +1870,16 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_linear_sw(global const ulon
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const ulong4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const ulong4 texels[4] = {
  convert_ulong4(native_texels[0]),
@@ -1556,9 +1901,24 @@ ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_ulong_sw(global const ulong4* img
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_ulong_nearest_sw(img, coord);
  return (ulong4)(0, 0, 0, 1);
 }
+ulong4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_ulong_sw(global const ulong4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const ulong4 texel = image_read_ulong_linear_sw((global const ulong4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_ulong_linear_sw((global const ulong4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_ulong_nearest_sw((global const ulong4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (ulong4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global ulong4* img, const uint2 coord, const ulong4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global ulong4* img_data_ptr = (global ulong4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyzw ))) );
 }
@@ -1575,11 +1935,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const cha
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const char* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1591,15 +1950,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float texels[4] = {
  convert_float(native_texels[0]),
@@ -1621,9 +1981,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const char* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const char* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const char*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const char*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const char*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char* img_data_ptr = (global char*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char_sat( (((color.x + 1.0f) * 0.5f) * 255.0f) - 128.0f );
 }
@@ -1640,11 +2015,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const cha
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const char2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1656,15 +2030,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float2 texels[4] = {
  convert_float2(native_texels[0]),
@@ -1686,9 +2061,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const char2* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const char2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const char2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const char2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const char2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char2* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char2* img_data_ptr = (global char2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char2_sat( (((color.xy + 1.0f) * 0.5f) * 255.0f) - 128.0f );
 }
@@ -1705,11 +2095,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const cha
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const char3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1721,15 +2110,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float3 texels[4] = {
  convert_float3(native_texels[0]),
@@ -1751,9 +2141,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const char3* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const char3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const char3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const char3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const char3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char3* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char3* img_data_ptr = (global char3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char3_sat( (((color.xyz + 1.0f) * 0.5f) * 255.0f) - 128.0f );
 }
@@ -1770,11 +2175,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const cha
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const char4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1786,15 +2190,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const char
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float4 texels[4] = {
  convert_float4(native_texels[0]),
@@ -1816,9 +2221,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const char4* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const char4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const char4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const char4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const char4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char4* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char4* img_data_ptr = (global char4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char4_sat( (((color.xyzw + 1.0f) * 0.5f) * 255.0f) - 128.0f );
 }
@@ -1835,11 +2255,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char* i
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1851,15 +2270,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char* im
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int texels[4] = {
  convert_int(native_texels[0]),
@@ -1881,9 +2301,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const char* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const char* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const char*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const char*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const char*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char* img_data_ptr = (global char*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char_sat( (((color.x ))) );
 }
@@ -1900,11 +2335,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char2*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1916,15 +2350,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char2* i
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int2 texels[4] = {
  convert_int2(native_texels[0]),
@@ -1946,9 +2381,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const char2* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const char2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const char2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const char2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const char2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char2* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char2* img_data_ptr = (global char2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char2_sat( (((color.xy ))) );
 }
@@ -1965,11 +2415,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char3*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -1981,15 +2430,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char3* i
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int3 texels[4] = {
  convert_int3(native_texels[0]),
@@ -2011,9 +2461,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const char3* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const char3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const char3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const char3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const char3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char3* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char3* img_data_ptr = (global char3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char3_sat( (((color.xyz ))) );
 }
@@ -2030,11 +2495,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char4*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const char4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2046,15 +2510,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const char4* i
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const char4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int4 texels[4] = {
  convert_int4(native_texels[0]),
@@ -2076,9 +2541,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const char4* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const char4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const char4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const char4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const char4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global char4* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global char4* img_data_ptr = (global char4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_char4_sat( (((color.xyzw ))) );
 }
@@ -2095,11 +2575,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const sho
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const short* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const short* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2111,15 +2590,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const shor
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float texels[4] = {
  convert_float(native_texels[0]),
@@ -2141,9 +2621,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const short* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const short* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const short*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const short*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const short*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short* img_data_ptr = (global short*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short_sat( (((color.x + 1.0f) * 0.5f) * 65535.0f) - 32768.0f );
 }
@@ -2160,11 +2655,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const sho
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const short2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const short2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2176,15 +2670,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const shor
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float2 texels[4] = {
  convert_float2(native_texels[0]),
@@ -2206,9 +2701,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const short2* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const short2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const short2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const short2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const short2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short2* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short2* img_data_ptr = (global short2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short2_sat( (((color.xy + 1.0f) * 0.5f) * 65535.0f) - 32768.0f );
 }
@@ -2225,11 +2735,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const sho
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const short3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const short3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2241,15 +2750,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const shor
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float3 texels[4] = {
  convert_float3(native_texels[0]),
@@ -2271,9 +2781,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const short3* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const short3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const short3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const short3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const short3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short3* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short3* img_data_ptr = (global short3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short3_sat( (((color.xyz + 1.0f) * 0.5f) * 65535.0f) - 32768.0f );
 }
@@ -2290,11 +2815,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const sho
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const short4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const short4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2306,15 +2830,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const shor
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float4 texels[4] = {
  convert_float4(native_texels[0]),
@@ -2336,9 +2861,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const short4* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const short4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const short4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const short4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const short4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short4* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short4* img_data_ptr = (global short4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short4_sat( (((color.xyzw + 1.0f) * 0.5f) * 65535.0f) - 32768.0f );
 }
@@ -2355,11 +2895,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2371,15 +2910,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short* i
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int texels[4] = {
  convert_int(native_texels[0]),
@@ -2401,9 +2941,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const short* img, con
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const short* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const short*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const short*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const short*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short* img_data_ptr = (global short*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short_sat( (((color.x ))) );
 }
@@ -2420,11 +2975,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short2*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2436,15 +2990,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short2*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int2 texels[4] = {
  convert_int2(native_texels[0]),
@@ -2466,9 +3021,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const short2* img, co
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const short2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const short2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const short2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const short2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short2* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short2* img_data_ptr = (global short2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short2_sat( (((color.xy ))) );
 }
@@ -2485,11 +3055,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short3*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2501,15 +3070,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short3*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int3 texels[4] = {
  convert_int3(native_texels[0]),
@@ -2531,9 +3101,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const short3* img, co
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const short3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const short3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const short3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const short3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short3* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short3* img_data_ptr = (global short3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short3_sat( (((color.xyz ))) );
 }
@@ -2550,11 +3135,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short4*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const short4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2566,15 +3150,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const short4*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const short4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int4 texels[4] = {
  convert_int4(native_texels[0]),
@@ -2596,9 +3181,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const short4* img, co
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const short4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const short4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const short4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const short4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global short4* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global short4* img_data_ptr = (global short4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = convert_short4_sat( (((color.xyzw ))) );
 }
@@ -2615,11 +3215,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int* im
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2631,15 +3230,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int* img
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const int native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int texels[4] = {
  convert_int(native_texels[0]),
@@ -2661,9 +3261,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const int* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const int* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const int*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const int*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const int*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global int* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global int* img_data_ptr = (global int*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.x ))) );
 }
@@ -2680,11 +3295,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int2* i
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2696,15 +3310,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int2* im
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const int2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int2 texels[4] = {
  convert_int2(native_texels[0]),
@@ -2726,9 +3341,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const int2* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const int2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const int2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const int2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const int2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global int2* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global int2* img_data_ptr = (global int2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xy ))) );
 }
@@ -2745,11 +3375,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int3* i
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2761,15 +3390,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int3* im
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const int3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int3 texels[4] = {
  convert_int3(native_texels[0]),
@@ -2791,9 +3421,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const int3* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const int3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const int3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const int3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const int3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global int3* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global int3* img_data_ptr = (global int3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyz ))) );
 }
@@ -2810,11 +3455,10 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int4* i
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_int_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_nearest_sw(global const int4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_int_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_int_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2826,15 +3470,16 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_linear_sw(global const int4* im
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const int4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const int4 texels[4] = {
  convert_int4(native_texels[0]),
@@ -2856,9 +3501,24 @@ int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_int_sw(global const int4* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_int_nearest_sw(img, coord);
  return (int4)(0, 0, 0, 1);
 }
+int4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_int_sw(global const int4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const int4 texel = image_read_int_linear_sw((global const int4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_int_linear_sw((global const int4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_int_nearest_sw((global const int4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (int4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global int4* img, const uint2 coord, const int4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global int4* img_data_ptr = (global int4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyzw ))) );
 }
@@ -2875,11 +3535,10 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long*
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_long_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_long_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2891,15 +3550,16 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const long native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const long texels[4] = {
  convert_long(native_texels[0]),
@@ -2921,9 +3581,24 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_sw(global const long* img, co
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_long_nearest_sw(img, coord);
  return (long4)(0, 0, 0, 1);
 }
+long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_long_sw(global const long* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const long4 texel = image_read_long_linear_sw((global const long*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_long_linear_sw((global const long*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_long_nearest_sw((global const long*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (long4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global long* img, const uint2 coord, const long4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global long* img_data_ptr = (global long*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.x ))) );
 }
@@ -2940,11 +3615,10 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long2
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_long_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_long_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -2956,15 +3630,16 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long2*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const long2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const long2 texels[4] = {
  convert_long2(native_texels[0]),
@@ -2986,9 +3661,24 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_sw(global const long2* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_long_nearest_sw(img, coord);
  return (long4)(0, 0, 0, 1);
 }
+long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_long_sw(global const long2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const long4 texel = image_read_long_linear_sw((global const long2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_long_linear_sw((global const long2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_long_nearest_sw((global const long2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (long4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global long2* img, const uint2 coord, const long4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global long2* img_data_ptr = (global long2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xy ))) );
 }
@@ -3005,11 +3695,10 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long3
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_long_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_long_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3021,15 +3710,16 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long3*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const long3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const long3 texels[4] = {
  convert_long3(native_texels[0]),
@@ -3051,9 +3741,24 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_sw(global const long3* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_long_nearest_sw(img, coord);
  return (long4)(0, 0, 0, 1);
 }
+long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_long_sw(global const long3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const long4 texel = image_read_long_linear_sw((global const long3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_long_linear_sw((global const long3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_long_nearest_sw((global const long3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (long4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global long3* img, const uint2 coord, const long4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global long3* img_data_ptr = (global long3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyz ))) );
 }
@@ -3070,11 +3775,10 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long4
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_long_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_nearest_sw(global const long4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_long_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_long_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3086,15 +3790,16 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_linear_sw(global const long4*
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const long4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const long4 texels[4] = {
  convert_long4(native_texels[0]),
@@ -3116,9 +3821,24 @@ long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_long_sw(global const long4* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_long_nearest_sw(img, coord);
  return (long4)(0, 0, 0, 1);
 }
+long4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_long_sw(global const long4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const long4 texel = image_read_long_linear_sw((global const long4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_long_linear_sw((global const long4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_long_nearest_sw((global const long4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (long4)(0, 0, 0, 1);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global long4* img, const uint2 coord, const long4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global long4* img_data_ptr = (global long4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyzw ))) );
 }
@@ -3135,11 +3855,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ocl
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_half* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_half* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3151,15 +3870,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float texels[4] = {
- vload_half(coords.y + coords.x, img_data_ptr),
- vload_half(coords.y + coords.z, img_data_ptr),
- vload_half(coords.w + coords.x, img_data_ptr),
- vload_half(coords.w + coords.z, img_data_ptr),
+ vload_half(offsets.x, img_data_ptr),
+ vload_half(offsets.y, img_data_ptr),
+ vload_half(offsets.z, img_data_ptr),
+ vload_half(offsets.w, img_data_ptr),
  };
  return (float4)(
  texel_mix(texel_mix(texels[0], texels[1], weights.x),
@@ -3175,9 +3895,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_half* img, c
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_half* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const oclr_half*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const oclr_half*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const oclr_half*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global oclr_half* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global oclr_half* img_data_ptr = (global oclr_half*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  vstore_half(color.x, offset, img_data_ptr);
 }
@@ -3194,11 +3929,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ocl
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_half2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_half2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3210,15 +3944,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float2 texels[4] = {
- vload_half2(coords.y + coords.x, img_data_ptr),
- vload_half2(coords.y + coords.z, img_data_ptr),
- vload_half2(coords.w + coords.x, img_data_ptr),
- vload_half2(coords.w + coords.z, img_data_ptr),
+ vload_half2(offsets.x, img_data_ptr),
+ vload_half2(offsets.y, img_data_ptr),
+ vload_half2(offsets.z, img_data_ptr),
+ vload_half2(offsets.w, img_data_ptr),
  };
  return (float4)(
  texel_mix(texel_mix(texels[0], texels[1], weights.x),
@@ -3234,9 +3969,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_half2* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_half2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const oclr_half2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const oclr_half2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const oclr_half2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global oclr_half2* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global oclr_half2* img_data_ptr = (global oclr_half2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  vstore_half2(color.xy, offset, img_data_ptr);
 }
@@ -3253,11 +4003,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ocl
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_half3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_half3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3269,15 +4018,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float3 texels[4] = {
- vload_half3(coords.y + coords.x, img_data_ptr),
- vload_half3(coords.y + coords.z, img_data_ptr),
- vload_half3(coords.w + coords.x, img_data_ptr),
- vload_half3(coords.w + coords.z, img_data_ptr),
+ vload_half3(offsets.x, img_data_ptr),
+ vload_half3(offsets.y, img_data_ptr),
+ vload_half3(offsets.z, img_data_ptr),
+ vload_half3(offsets.w, img_data_ptr),
  };
  return (float4)(
  texel_mix(texel_mix(texels[0], texels[1], weights.x),
@@ -3293,9 +4043,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_half3* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_half3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const oclr_half3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const oclr_half3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const oclr_half3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global oclr_half3* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global oclr_half3* img_data_ptr = (global oclr_half3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  vstore_half3(color.xyz, offset, img_data_ptr);
 }
@@ -3312,11 +4077,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const ocl
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_half4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_half4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3328,15 +4092,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float4 texels[4] = {
- vload_half4(coords.y + coords.x, img_data_ptr),
- vload_half4(coords.y + coords.z, img_data_ptr),
- vload_half4(coords.w + coords.x, img_data_ptr),
- vload_half4(coords.w + coords.z, img_data_ptr),
+ vload_half4(offsets.x, img_data_ptr),
+ vload_half4(offsets.y, img_data_ptr),
+ vload_half4(offsets.z, img_data_ptr),
+ vload_half4(offsets.w, img_data_ptr),
  };
  return (float4)(
  texel_mix(texel_mix(texels[0], texels[1], weights.x),
@@ -3352,9 +4117,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_half4* img,
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_half4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const oclr_half4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const oclr_half4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const oclr_half4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global oclr_half4* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global oclr_half4* img_data_ptr = (global oclr_half4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  vstore_half4(color.xyzw, offset, img_data_ptr);
 }
@@ -3371,11 +4151,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const flo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const float* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const float* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3387,15 +4166,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const floa
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float texels[4] = {
  convert_float(native_texels[0]),
@@ -3417,9 +4197,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const float* img, const
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const float* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const float*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const float*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const float*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global float* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global float* img_data_ptr = (global float*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.x ))) );
 }
@@ -3436,11 +4231,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const flo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const float2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const float2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3452,15 +4246,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const floa
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float2 texels[4] = {
  convert_float2(native_texels[0]),
@@ -3482,9 +4277,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const float2* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const float2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const float2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const float2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const float2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global float2* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global float2* img_data_ptr = (global float2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xy ))) );
 }
@@ -3501,11 +4311,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const flo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const float3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const float3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3517,15 +4326,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const floa
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float3 texels[4] = {
  convert_float3(native_texels[0]),
@@ -3547,9 +4357,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const float3* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const float3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const float3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const float3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const float3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global float3* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global float3* img_data_ptr = (global float3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyz ))) );
 }
@@ -3566,11 +4391,10 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const flo
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_float_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const float4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_float_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_float_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const float4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3582,15 +4406,16 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const floa
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const float4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const float4 texels[4] = {
  convert_float4(native_texels[0]),
@@ -3612,9 +4437,24 @@ float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const float4* img, cons
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
  return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
 }
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const float4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const float4 texel = image_read_float_linear_sw((global const float4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_float_linear_sw((global const float4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_float_nearest_sw((global const float4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global float4* img, const uint2 coord, const float4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global float4* img_data_ptr = (global float4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyzw ))) );
 }
@@ -3631,11 +4471,10 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const d
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_double_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const double* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_double_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const double* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3647,15 +4486,16 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const do
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const double native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const double texels[4] = {
  convert_double(native_texels[0]),
@@ -3677,9 +4517,24 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_sw(global const double* i
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_double_nearest_sw(img, coord);
  return (double4)(0.0, 0.0, 0.0, 1.0);
 }
+double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_double_sw(global const double* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const double4 texel = image_read_double_linear_sw((global const double*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_double_linear_sw((global const double*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_double_nearest_sw((global const double*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (double4)(0.0, 0.0, 0.0, 1.0);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global double* img, const uint2 coord, const double4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global double* img_data_ptr = (global double*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.x ))) );
 }
@@ -3696,11 +4551,10 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const d
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_double_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const double2* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_double_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const double2* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3712,15 +4566,16 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const do
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const double2 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const double2 texels[4] = {
  convert_double2(native_texels[0]),
@@ -3742,9 +4597,24 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_sw(global const double2*
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_double_nearest_sw(img, coord);
  return (double4)(0.0, 0.0, 0.0, 1.0);
 }
+double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_double_sw(global const double2* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const double4 texel = image_read_double_linear_sw((global const double2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_double_linear_sw((global const double2*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_double_nearest_sw((global const double2*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (double4)(0.0, 0.0, 0.0, 1.0);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global double2* img, const uint2 coord, const double4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global double2* img_data_ptr = (global double2*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xy ))) );
 }
@@ -3761,11 +4631,10 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const d
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_double_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const double3* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_double_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const double3* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3777,15 +4646,16 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const do
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const double3 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const double3 texels[4] = {
  convert_double3(native_texels[0]),
@@ -3807,9 +4677,24 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_sw(global const double3*
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_double_nearest_sw(img, coord);
  return (double4)(0.0, 0.0, 0.0, 1.0);
 }
+double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_double_sw(global const double3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const double4 texel = image_read_double_linear_sw((global const double3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_double_linear_sw((global const double3*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_double_nearest_sw((global const double3*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (double4)(0.0, 0.0, 0.0, 1.0);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global double3* img, const uint2 coord, const double4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global double3* img_data_ptr = (global double3*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyz ))) );
 }
@@ -3826,11 +4711,10 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const d
  const float2 fimg_size = convert_float2(img_size) - 1.0f;
  const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
  const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
- return image_read_double_nearest_sw(img, ui_tc.y * img_size.x + ui_tc.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_nearest_sw(global const double4* img, const uint2 coord) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- return image_read_double_nearest_sw(img, coord.y * img_size.x + coord.x);
+ return image_read_double_nearest_sw(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const double4* img, const float2 coord) {
  const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
@@ -3842,15 +4726,16 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_linear_sw(global const do
  const float2 weights = scaled_coord - fcoords.xy;
  fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
  fimg_size.x, fimg_size.y));
- const uint4 coords = (uint4)((uint)fcoords.x,
- img_size.x * (uint)fcoords.y,
- (uint)fcoords.z,
- img_size.x * (uint)fcoords.w);
+ const uint4 coords = convert_uint4(fcoords);
+ const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+ oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
  const double4 native_texels[4] = {
- img_data_ptr[coords.y + coords.x],
- img_data_ptr[coords.y + coords.z],
- img_data_ptr[coords.w + coords.x],
- img_data_ptr[coords.w + coords.z]
+ img_data_ptr[offsets.x],
+ img_data_ptr[offsets.y],
+ img_data_ptr[offsets.z],
+ img_data_ptr[offsets.w]
  };
  const double4 texels[4] = {
  convert_double4(native_texels[0]),
@@ -3872,13 +4757,220 @@ double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_double_sw(global const double4*
  if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_double_nearest_sw(img, coord);
  return (double4)(0.0, 0.0, 0.0, 1.0);
 }
+double4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_double_sw(global const double4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+ const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+ const uint level = min((uint)clamped_lod, max_level);
+ const float weight = clamped_lod - (float)level;
+ const double4 texel = image_read_double_linear_sw((global const double4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ if(weight == 0.0f || level == max_level) return texel;
+ return texel_mix(texel, image_read_double_linear_sw((global const double4*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+ }
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+ const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+ return image_read_double_nearest_sw((global const double4*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+ }
+ return (double4)(0.0, 0.0, 0.0, 1.0);
+}
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global double4* img, const uint2 coord, const double4 color) {
- const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
- const uint offset = coord.y * img_size.x + coord.x;
+ const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
  global double4* img_data_ptr = (global double4*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
  img_data_ptr[offset] = ( (((color.xyzw ))) );
 }
 #endif
 
+#if defined(OCLRASTER_IMAGE_OCLR_BC1)
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc1* img, const uint2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ global const oclr_bc1* img_data_ptr = (global const oclr_bc1*)((global const uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
+ const uint block_offset = (coord.y >> 2u) * ((img_size.x + 3u) >> 2u) + (coord.x >> 2u);
+ return oclr_bc_decode(img_data_ptr[block_offset], coord & 3u);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc1* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
+ return image_read_float_nearest_sw(img, ui_tc);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_bc1* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const float2 scaled_coord = norm_coord * fimg_size + 0.5f;
+ float4 fcoords = (float4)(trunc(scaled_coord), ceil(scaled_coord));
+ const float2 weights = scaled_coord - fcoords.xy;
+ fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
+ fimg_size.x, fimg_size.y));
+ const uint4 coords = convert_uint4(fcoords);
+ const float4 texels[4] = {
+ image_read_float_nearest_sw(img, coords.xy),
+ image_read_float_nearest_sw(img, coords.zy),
+ image_read_float_nearest_sw(img, coords.xw),
+ image_read_float_nearest_sw(img, coords.zw)
+ };
+ return texel_mix(texel_mix(texels[0], texels[1], weights.x),
+ texel_mix(texels[2], texels[3], weights.x),
+ weights.y);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc1* img, const oclr_sampler_t sampler, const float2 coord) {
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) return image_read_float_linear_sw(img, coord);
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc1* img, const oclr_sampler_t sampler, const uint2 coord) {
+ if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_bc1* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ return image_read_sw(img, sampler, coord);
+}
+#endif
+
+#if defined(OCLRASTER_IMAGE_OCLR_BC3)
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc3* img, const uint2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ global const oclr_bc3* img_data_ptr = (global const oclr_bc3*)((global const uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
+ const uint block_offset = (coord.y >> 2u) * ((img_size.x + 3u) >> 2u) + (coord.x >> 2u);
+ return oclr_bc_decode(img_data_ptr[block_offset], coord & 3u);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc3* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
+ return image_read_float_nearest_sw(img, ui_tc);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_bc3* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const float2 scaled_coord = norm_coord * fimg_size + 0.5f;
+ float4 fcoords = (float4)(trunc(scaled_coord), ceil(scaled_coord));
+ const float2 weights = scaled_coord - fcoords.xy;
+ fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
+ fimg_size.x, fimg_size.y));
+ const uint4 coords = convert_uint4(fcoords);
+ const float4 texels[4] = {
+ image_read_float_nearest_sw(img, coords.xy),
+ image_read_float_nearest_sw(img, coords.zy),
+ image_read_float_nearest_sw(img, coords.xw),
+ image_read_float_nearest_sw(img, coords.zw)
+ };
+ return texel_mix(texel_mix(texels[0], texels[1], weights.x),
+ texel_mix(texels[2], texels[3], weights.x),
+ weights.y);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc3* img, const oclr_sampler_t sampler, const float2 coord) {
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) return image_read_float_linear_sw(img, coord);
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc3* img, const oclr_sampler_t sampler, const uint2 coord) {
+ if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_bc3* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ return image_read_sw(img, sampler, coord);
+}
+#endif
+
+#if defined(OCLRASTER_IMAGE_OCLR_BC4)
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc4* img, const uint2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ global const oclr_bc4* img_data_ptr = (global const oclr_bc4*)((global const uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
+ const uint block_offset = (coord.y >> 2u) * ((img_size.x + 3u) >> 2u) + (coord.x >> 2u);
+ return oclr_bc_decode(img_data_ptr[block_offset], coord & 3u);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc4* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
+ return image_read_float_nearest_sw(img, ui_tc);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_bc4* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const float2 scaled_coord = norm_coord * fimg_size + 0.5f;
+ float4 fcoords = (float4)(trunc(scaled_coord), ceil(scaled_coord));
+ const float2 weights = scaled_coord - fcoords.xy;
+ fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
+ fimg_size.x, fimg_size.y));
+ const uint4 coords = convert_uint4(fcoords);
+ const float4 texels[4] = {
+ image_read_float_nearest_sw(img, coords.xy),
+ image_read_float_nearest_sw(img, coords.zy),
+ image_read_float_nearest_sw(img, coords.xw),
+ image_read_float_nearest_sw(img, coords.zw)
+ };
+ return texel_mix(texel_mix(texels[0], texels[1], weights.x),
+ texel_mix(texels[2], texels[3], weights.x),
+ weights.y);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc4* img, const oclr_sampler_t sampler, const float2 coord) {
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) return image_read_float_linear_sw(img, coord);
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc4* img, const oclr_sampler_t sampler, const uint2 coord) {
+ if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_bc4* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ return image_read_sw(img, sampler, coord);
+}
+#endif
+
+#if defined(OCLRASTER_IMAGE_OCLR_BC5)
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc5* img, const uint2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ global const oclr_bc5* img_data_ptr = (global const oclr_bc5*)((global const uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
+ const uint block_offset = (coord.y >> 2u) * ((img_size.x + 3u) >> 2u) + (coord.x >> 2u);
+ return oclr_bc_decode(img_data_ptr[block_offset], coord & 3u);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const oclr_bc5* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
+ return image_read_float_nearest_sw(img, ui_tc);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const oclr_bc5* img, const float2 coord) {
+ const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+ const float2 fimg_size = convert_float2(img_size) - 1.0f;
+ const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+ const float2 scaled_coord = norm_coord * fimg_size + 0.5f;
+ float4 fcoords = (float4)(trunc(scaled_coord), ceil(scaled_coord));
+ const float2 weights = scaled_coord - fcoords.xy;
+ fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
+ fimg_size.x, fimg_size.y));
+ const uint4 coords = convert_uint4(fcoords);
+ const float4 texels[4] = {
+ image_read_float_nearest_sw(img, coords.xy),
+ image_read_float_nearest_sw(img, coords.zy),
+ image_read_float_nearest_sw(img, coords.xw),
+ image_read_float_nearest_sw(img, coords.zw)
+ };
+ return texel_mix(texel_mix(texels[0], texels[1], weights.x),
+ texel_mix(texels[2], texels[3], weights.x),
+ weights.y);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc5* img, const oclr_sampler_t sampler, const float2 coord) {
+ if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) return image_read_float_linear_sw(img, coord);
+ else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const oclr_bc5* img, const oclr_sampler_t sampler, const uint2 coord) {
+ if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+ return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const oclr_bc5* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+ return image_read_sw(img, sampler, coord);
+}
+#endif
+
 
 #endif
@@ -28,4 +28,38 @@ const unsigned int indices_var_name[3] = {											\
 	index_buffer[index_ids[2]] + instance_index_offset								\
 };
 
+
+// internal primitive setup data (written once per primitive by the processing stage, read by the rasterizer for each fragment)
+#if defined(OCLRASTER_PROJECTION_ORTHOGRAPHIC) && defined(OCLRASTER_HALF_PRIMITIVE_SETUP)
+// half-precision variant for orthographic/2D draws (40 instead of 48 bytes):
+// the edge functions are relative to the primitive origin (floored bounds minimum) and normalized, so that they stay
+// in half range, the depth is kept at full precision
+// NOTE: half precision is only sufficient for small primitives (sprites, text, ui, ...)
+typedef struct __attribute__((aligned(8))) {
+	float2 origin;
+	float2 depth; // .y is unused
+	ushort VV[12]; // VV0, VV1, VV2 as half4 (.w is unused) -> use vload_half4/vstore_half4
+} transformed_data;
+
+#define LOAD_TRANSFORMED_DATA(tf_ptr)													\
+const float3 VV0 = vload_half4(0, (global const half*)(tf_ptr)->VV).xyz;				\
+const float3 VV1 = vload_half4(1, (global const half*)(tf_ptr)->VV).xyz;				\
+const float3 VV2 = vload_half4(2, (global const half*)(tf_ptr)->VV).xyz;				\
+const float primitive_depth = (tf_ptr)->depth.x;										\
+const float2 setup_coord = fragment_coord - (tf_ptr)->origin;
+#else
+// VV0 - VV2 (edge functions) in .xyz, the depth is folded into VV[0].w (-> 3 aligned vector loads)
+typedef struct __attribute__((aligned(16))) {
+	float4 VV[3];
+} transformed_data;
+
+#define LOAD_TRANSFORMED_DATA(tf_ptr)													\
+const float4 VV0_depth = (tf_ptr)->VV[0];												\
+const float3 VV0 = VV0_depth.xyz;														\
+const float3 VV1 = (tf_ptr)->VV[1].xyz;													\
+const float3 VV2 = (tf_ptr)->VV[2].xyz;													\
+const float primitive_depth = VV0_depth.w;												\
+const float2 setup_coord = fragment_coord;
+#endif
+
 #endif
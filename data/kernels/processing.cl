@@ -12,14 +12,6 @@ typedef struct __attribute__((packed, aligned(16))) {
 	uint2 viewport;
 } constant_data;
 
-typedef struct __attribute__((packed, aligned(4))) {
-	// VV0: 0 - 2
-	// VV1: 3 - 5
-	// VV2: 6 - 8
-	// depth: 9
-	float data[10];
-} transformed_data;
-
 typedef struct __attribute__((packed, aligned(16))) {
 	float4 bounds; // (.x = INFINITY if culled)
 } primitive_bounds;
@@ -27,6 +19,7 @@ typedef struct __attribute__((packed, aligned(16))) {
 //
 #define MIN_FRAGMENT_SIZE (1.0f / 256.0f)
 #define discard() { tb_ptr->bounds.x = INFINITY; return; }
+#define cull(stat) { pipeline_stat_inc(stat); discard(); }
 kernel void oclraster_processing(global const unsigned int* index_buffer,
 								 global const float4* transformed_vertex_buffer,
 								 global transformed_data* transformed_buffer,
@@ -36,7 +29,11 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 								 const unsigned int primitive_count,
 								 const unsigned int instance_primitive_count,
 								 const unsigned int instance_index_count,
-								 const uint4 scissor_rectangle) {
+								 const uint4 scissor_rectangle
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+								 , global unsigned int* pipeline_stats
+#endif
+								 ) {
 	const unsigned int primitive_id = get_global_id(0);
 	// global work size is greater than the actual primitive count
 	// -> check for primitive_count instead of get_global_size(0)
@@ -44,7 +41,6 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 	
 	global transformed_data* tf_ptr = &transformed_buffer[primitive_id];
 	global primitive_bounds* tb_ptr = &primitive_bounds_buffer[primitive_id];
-	global float* tf_data_ptr = tf_ptr->data;
 	const unsigned int instance_id = primitive_id / instance_primitive_count;
 	const unsigned int instance_index_offset = instance_id * instance_index_count;
 	
@@ -60,7 +56,7 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 	
 	// check if any vertex has been discarded (-> discard the primitive)
 	for(unsigned int i = 0; i < 3; i++) {
-		if(vertices[i].x == INFINITY) discard();
+		if(vertices[i].x == INFINITY) cull(PS_CULLED_VERTEX_DISCARD);
 	}
 	
 	//
@@ -87,7 +83,7 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 	   primitive_near_clipping[1] < 0.0f &&
 	   primitive_near_clipping[2] < 0.0f) {
 		// all vertices are behind the camera
-		discard();
+		cull(PS_CULLED_NEAR_PLANE);
 	}
 	
 	// frustum culling using the "p/n-test"
@@ -107,7 +103,7 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 	}
 	// if any dot product is less than 0 (aabb is completely outside any plane) -> cull
 	if(any(signbit(fc_dot))) {
-		discard();
+		cull(PS_CULLED_FRUSTUM);
 	}
 #endif
 	
@@ -245,7 +241,8 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 			// half sample size (TODO: -> check if between sample points; <=1/2^8 sample size seems to be a good threshold?)
 			if(area < MIN_FRAGMENT_SIZE) {
 				//printf("primitive area culled: %d (%f)\n", primitive_id, area);
-				discard(); // cull
+				// negative area -> back-facing, otherwise too small
+				cull(area < 0.0f ? PS_CULLED_BACKFACE : PS_CULLED_DEGENERATE);
 			}
 		}
 		
@@ -258,7 +255,7 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 		   (coord_ys[1] == 0.0f || coord_ys[1] == -1.0f) &&
 		   (coord_ys[2] == 0.0f || coord_ys[2] == -1.0f)) {
 			//printf("imprecision culled (tp2): %d\n", primitive_id);
-			discard();
+			cull(PS_CULLED_DEGENERATE);
 		}
 		
 		// ---bin---
@@ -329,7 +326,7 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 	float2 y_bounds = (float2)(aabb_min.y, aabb_max.y);
 	if(fabs(aabb_min.x - aabb_max.x) < MIN_FRAGMENT_SIZE ||
 	   fabs(aabb_min.y - aabb_max.y) < MIN_FRAGMENT_SIZE) {
-		discard();
+		cull(PS_CULLED_DEGENERATE);
 	}
 #endif
 	const float4 bounds = (float4)(floor(x_bounds.x), ceil(x_bounds.y),
@@ -340,18 +337,33 @@ kernel void oclraster_processing(global const unsigned int* index_buffer,
 	const uint4 ubounds = convert_uint4(bounds);
 	if(scissor_rectangle.x > ubounds.y || ubounds.x > scissor_rectangle.z ||
 	   scissor_rectangle.y > ubounds.w || ubounds.z > scissor_rectangle.w) {
-		discard();
+		cull(PS_CULLED_SCISSOR);
 	}
 #endif
 	
 	// output:
+#if defined(OCLRASTER_PROJECTION_ORTHOGRAPHIC) && defined(OCLRASTER_HALF_PRIMITIVE_SETUP)
+	// move the edge functions to the primitive origin and normalize them (scaling all edge functions and the depth
+	// by the same factor doesn't change the normalized barycentric coordinates or the depth)
+	const float2 origin = (float2)(bounds.x, bounds.z);
+	float max_gradient = 0.0f;
 	for(unsigned int i = 0u; i < 3u; i++) {
-		*tf_data_ptr++ = VV[i][0];
-		*tf_data_ptr++ = VV[i][1];
-		*tf_data_ptr++ = VV[i][2];
+		max_gradient = fmax(max_gradient, fmax(fabs(VV[i][0]), fabs(VV[i][1])));
 	}
+	const float scale = (max_gradient > 0.0f ? 1.0f / max_gradient : 1.0f);
+	global half* tf_half_ptr = (global half*)tf_ptr->VV;
+	for(unsigned int i = 0u; i < 3u; i++) {
+		vstore_half4((float4)(VV[i][0], VV[i][1], mad(origin.x, VV[i][0], mad(origin.y, VV[i][1], VV[i][2])), 0.0f) * scale,
+					 i, tf_half_ptr);
+	}
+	tf_ptr->origin = origin;
+	tf_ptr->depth = (float2)(VV_depth * scale, 0.0f);
+#else
+	tf_ptr->VV[0] = (float4)(VV[0][0], VV[0][1], VV[0][2], VV_depth);
+	tf_ptr->VV[1] = (float4)(VV[1][0], VV[1][1], VV[1][2], 0.0f);
+	tf_ptr->VV[2] = (float4)(VV[2][0], VV[2][1], VV[2][2], 0.0f);
+#endif
 	//printf("[%d] bounds: %f %f -> %f %f\n", primitive_id, x_bounds.x, y_bounds.x, x_bounds.y, y_bounds.y);
-	*tf_data_ptr++ = VV_depth;
 	
 	// TODO: rounding should depend on sampling mode
 	tb_ptr->bounds = bounds;
@@ -4,16 +4,23 @@
 	#include "oclr_image.h"
 	#include "oclr_primitive_assembly.h"
 
-	typedef struct __attribute__((packed, aligned(4))) {
-		// VV0: 0 - 2
-		// VV1: 3 - 5
-		// VV2: 6 - 8
-		// depth: 9
-		float data[10];
-	} transformed_data;
-
 	// shortcut for the opengl folks
 	#define discard() { return false; }
+	
+	// screen-space derivatives of interpolated output variables, e.g. dfdx(output_attributes, tex_coord)
+	#define dfdx(object, member) (object##_ddx->member)
+	#define dfdy(object, member) (object##_ddy->member)
+	
+	// difference between the (normalized) barycentric coordinates at a neighboring fragment and the current fragment
+	// -> since interpolation is linear, interpolating with this results in the derivative of an interpolated value
+	OCLRASTER_FUNC float4 compute_barycentric_derivative(const float3 VV0, const float3 VV1, const float3 VV2,
+														 const float2 coord, const float4 barycentric) {
+		float3 neighbor = (float3)(mad(coord.x, VV0.x, mad(coord.y, VV0.y, VV0.z)),
+								   mad(coord.x, VV1.x, mad(coord.y, VV1.y, VV1.z)),
+								   mad(coord.x, VV2.x, mad(coord.y, VV2.y, VV2.z)));
+		neighbor /= neighbor.x + neighbor.y + neighbor.z;
+		return (float4)(neighbor - barycentric.xyz, 0.0f);
+	}
 	//###OCLRASTER_DEPTH_TEST_FUNCTION###
 	//###OCLRASTER_USER_CODE###
 	
@@ -24,6 +31,9 @@
 										
 										global unsigned int* bin_distribution_counter,
 										global const transformed_data* transformed_buffer,
+#if defined(OCLRASTER_ATTRIBUTE_SETUP)
+										global const float* attribute_planes,
+#endif
 										global const uchar* bin_queues,
 										
 										const uint2 bin_count,
@@ -37,7 +47,15 @@
 										const unsigned int instance_index_count,
 										
 										const uint2 framebuffer_size,
-										const uint4 scissor_rectangle) {
+										const uint4 scissor_rectangle
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+										, global unsigned int* pipeline_stats
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+										, global unsigned int* bin_heatmap
+										, const uint2 heatmap_bin_count
+#endif
+										) {
 		const unsigned int local_id = get_local_id(0);
 		const unsigned int local_size = get_local_size(0);
 				
@@ -110,6 +128,21 @@
 			const size_t global_queue_offset = (bin_idx * batch_count) * BATCH_BYTE_COUNT;
 #endif
 			
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+			// per work-item fragment statistics of this bin (-> only one atomic add per counter and bin)
+			unsigned int fragment_stats[PS_FRAGMENT_STATISTIC_COUNT] = { 0u, 0u, 0u, 0u, 0u };
+#define fragment_stat_inc(stat) fragment_stats[stat - PS_FRAGMENTS_TESTED]++
+#else
+#define fragment_stat_inc(stat)
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+			// per work-item fragment metrics of this bin (flushed once per bin, like the statistics)
+			unsigned int heatmap_fragments[2] = { 0u, 0u };
+#define heatmap_fragment_inc(metric) heatmap_fragments[metric - BH_FRAGMENTS_TESTED]++
+#else
+#define heatmap_fragment_inc(metric)
+#endif
+			
 			//
 			const uint2 bin_location = (uint2)(bin_idx % bin_count.x, bin_idx / bin_count.x) + bin_offset;
 			for(unsigned int i = 0; i < intra_bin_groups; i++) {
@@ -163,21 +196,14 @@
 						
 						//
 						{
-							const float3 VV0 = (float3)(transformed_buffer[primitive_id].data[0],
-														transformed_buffer[primitive_id].data[1],
-														transformed_buffer[primitive_id].data[2]);
-							const float3 VV1 = (float3)(transformed_buffer[primitive_id].data[3],
-														transformed_buffer[primitive_id].data[4],
-														transformed_buffer[primitive_id].data[5]);
-							const float3 VV2 = (float3)(transformed_buffer[primitive_id].data[6],
-														transformed_buffer[primitive_id].data[7],
-														transformed_buffer[primitive_id].data[8]);
+							// -> VV0, VV1, VV2, primitive_depth and setup_coord (edge function coordinate of this fragment)
+							LOAD_TRANSFORMED_DATA(&transformed_buffer[primitive_id]);
 							
 							//
-							float4 barycentric = (float4)(mad(fragment_coord.x, VV0.x, mad(fragment_coord.y, VV0.y, VV0.z)),
-														  mad(fragment_coord.x, VV1.x, mad(fragment_coord.y, VV1.y, VV1.z)),
-														  mad(fragment_coord.x, VV2.x, mad(fragment_coord.y, VV2.y, VV2.z)),
-														  transformed_buffer[primitive_id].data[9]); // .w = computed depth
+							float4 barycentric = (float4)(mad(setup_coord.x, VV0.x, mad(setup_coord.y, VV0.y, VV0.z)),
+														  mad(setup_coord.x, VV1.x, mad(setup_coord.y, VV1.y, VV1.z)),
+														  mad(setup_coord.x, VV2.x, mad(setup_coord.y, VV2.y, VV2.z)),
+														  primitive_depth); // .w = computed depth
 							
 #if defined(OCLRASTER_PROJECTION_PERSPECTIVE)
 							if(barycentric.x >= 0.0f || barycentric.y >= 0.0f || barycentric.z >= 0.0f) continue;
@@ -208,15 +234,21 @@
 #endif
 							
 							// simplified:
-							barycentric /= barycentric.x + barycentric.y + barycentric.z;
+							const float barycentric_sum = barycentric.x + barycentric.y + barycentric.z;
+							barycentric /= barycentric_sum;
 							
 							// ignore fragments with negative depth
 							if(barycentric.w < 0.0f) continue;
+							fragment_stat_inc(PS_FRAGMENTS_TESTED);
+							heatmap_fragment_inc(BH_FRAGMENTS_TESTED);
 							
 #if !defined(OCLRASTER_NO_DEPTH) && !defined(OCLRASTER_NO_DEPTH_TEST)
 #if !defined(OCLRASTER_DEPTH_OVERRIDE)
 							// early depth test
-							if(!depth_test(barycentric.w, *fragment_depth)) continue;
+							if(!depth_test(barycentric.w, *fragment_depth)) {
+								fragment_stat_inc(PS_FRAGMENTS_EARLY_DEPTH_REJECTED);
+								continue;
+							}
 #else
 							// need to save the old depth value if the user overwrites the framebuffer depth
 							const float prev_depth = *fragment_depth;
@@ -225,6 +257,7 @@
 							
 							// note: if a fragment is discarded, this will "continue"
 							// -> depth is not updated and fragment counter is not increased
+							heatmap_fragment_inc(BH_FRAGMENTS_SHADED);
 							//###OCLRASTER_USER_MAIN_CALL###
 							
 #if !defined(OCLRASTER_NO_DEPTH) && !defined(OCLRASTER_NO_DEPTH_TEST)
@@ -235,22 +268,63 @@
 							// depth test when "depth-override" is active, i.e. the depth is written by the user program
 							if(!depth_test(*fragment_depth, prev_depth)) {
 								*fragment_depth = prev_depth; // restore previous depth value
+								fragment_stat_inc(PS_FRAGMENTS_LATE_DEPTH_REJECTED);
 								continue;
 							}
 #endif
 #endif
 							
+							fragment_stat_inc(PS_FRAGMENTS_WRITTEN);
 							fragments_passed += 1.0f;
 						}
 					}
 				}
-				//fragments_passed = 1.0f;
-				//framebuffer.color = (float4)((float3)(fragments_passed / 32.0f), 1.0f);
-				
 				// write framebuffer output (if any fragment has passed)
 				if(fragments_passed != 0.0f) {
 					//###OCLRASTER_FRAMEBUFFER_WRITE###
 				}
 			}
+			
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+			for(unsigned int stat_idx = 0; stat_idx < PS_FRAGMENT_STATISTIC_COUNT; stat_idx++) {
+				if(fragment_stats[stat_idx] > 0u) {
+					pipeline_stat_add(PS_FRAGMENTS_TESTED + stat_idx, fragment_stats[stat_idx]);
+				}
+			}
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+			bin_heatmap_add(bin_location, BH_FRAGMENTS_TESTED, heatmap_fragments[0]);
+			bin_heatmap_add(bin_location, BH_FRAGMENTS_SHADED, heatmap_fragments[1]);
+#endif
 		}
 	}
+	
+	// attribute plane equations (only used with "attribute setup", see pipeline::set_attribute_setup):
+	// computes the screen-space plane equation (dx, dy, offset) of each output variable once per visible primitive,
+	// the rasterizer then evaluates these per fragment instead of fetching the indices and vertex outputs
+	// -> value = (setup_coord.x * dx + setup_coord.y * dy + offset) / (barycentric.x + barycentric.y + barycentric.z)
+#if defined(OCLRASTER_ATTRIBUTE_SETUP)
+	kernel void oclraster_attribute_setup(//###OCLRASTER_SETUP_USER_STRUCTS###
+										  global const unsigned int* index_buffer,
+										  global const transformed_data* transformed_buffer,
+										  global const float4* primitive_bounds_buffer,
+										  global float* attribute_planes,
+										  const unsigned int primitive_type,
+										  const unsigned int primitive_count,
+										  const unsigned int instance_primitive_count,
+										  const unsigned int instance_index_count) {
+		const unsigned int primitive_id = get_global_id(0);
+		if(primitive_id >= primitive_count) return;
+		
+		// culled primitive (-> will never be rasterized)
+		if(primitive_bounds_buffer[primitive_id].x == INFINITY) return;
+		
+		const unsigned int instance_id = primitive_id / instance_primitive_count;
+		const unsigned int instance_index_offset = instance_id * instance_index_count;
+		MAKE_PRIMITIVE_INDICES(indices);
+		
+		const float2 fragment_coord = (float2)(0.0f, 0.0f); // not needed here
+		LOAD_TRANSFORMED_DATA(&transformed_buffer[primitive_id]);
+		//###OCLRASTER_ATTRIBUTE_SETUP###
+	}
+#endif
@@ -0,0 +1,59 @@
+
+// this is the same for both programs
+oclraster_out bench_output {
+	float4 vertex;
+	float4 normal;
+} output_attributes;
+
+#if defined(OCLRASTER_TRANSFORM_PROGRAM)
+//////////////////////////////////////////////////////////////////
+// transform program (used by oclr_bench)
+
+oclraster_in bench_input {
+	float4 vertex;
+	float4 normal;
+	float4 binormal; // unused
+	float4 tangent; // unused
+	float2 tex_coord; // unused
+} input_attributes;
+
+oclraster_uniforms transform_uniforms {
+	mat4 modelview_matrix;
+	float4 grid; // .x = instances per row, .y = instance spacing
+} tp_uniforms;
+
+float4 transform_main() {
+	// each instance is placed on a grid in the xz plane, centered around the origin
+	const float per_row = tp_uniforms->grid.x;
+	const float spacing = tp_uniforms->grid.y;
+	const float3 offset = (float3)((fmod((float)instance_index, per_row) - (per_row - 1.0f) * 0.5f) * spacing,
+								   0.0f,
+								   (floor((float)instance_index / per_row) - (per_row - 1.0f) * 0.5f) * spacing);
+	
+	float4 mv_vertex = mat4_mul_vec4(tp_uniforms->modelview_matrix,
+									 input_attributes->vertex);
+	mv_vertex.xyz += offset;
+	output_attributes->vertex = mv_vertex;
+	output_attributes->normal = input_attributes->normal;
+	return mv_vertex;
+}
+
+#elif defined(OCLRASTER_RASTERIZATION_PROGRAM)
+//////////////////////////////////////////////////////////////////
+// rasterization program (used by oclr_bench)
+
+oclraster_framebuffer {
+	image2d color;
+	depth_image depth;
+};
+
+bool rasterize_main() {
+	// fixed directional light + ambient term
+	const float3 light_dir = normalize((float3)(0.5f, 1.0f, 0.25f));
+	const float lambert_term = max(dot(normalize(output_attributes->normal.xyz), light_dir), 0.0f);
+	framebuffer->color.xyz = (float3)(0.1f, 0.1f, 0.1f) + (float3)(0.8f, 0.6f, 0.3f) * lambert_term;
+	framebuffer->color.w = 1.0f;
+	return true;
+}
+
+#endif
@@ -0,0 +1,45 @@
+
+// this is the same for both programs
+oclraster_out fill_output {
+	float4 color;
+} output_attributes;
+
+#if defined(OCLRASTER_TRANSFORM_PROGRAM)
+//////////////////////////////////////////////////////////////////
+// transform program (used by oclr_bench, vertices are in orthographic screen space)
+
+// note: this must match the screen_quad vertex layout of oclr_bench (the tex_coord is unused)
+oclraster_in fill_input {
+	float4 vertex;
+	float2 tex_coord;
+} input_attributes;
+
+float4 transform_main() {
+	// every instance is one full-screen layer with a different color
+	const float layer = (float)instance_index;
+	output_attributes->color = (float4)(fmod(layer * 0.37f, 1.0f),
+										fmod(layer * 0.61f, 1.0f),
+										fmod(layer * 0.83f, 1.0f),
+										0.25f);
+	return input_attributes->vertex;
+}
+
+#elif defined(OCLRASTER_RASTERIZATION_PROGRAM)
+//////////////////////////////////////////////////////////////////
+// rasterization program (used by oclr_bench)
+
+oclraster_framebuffer {
+	image2d color;
+	depth_image depth;
+};
+
+bool rasterize_main() {
+	// read-modify-write blending, so every layer has to touch every pixel
+	framebuffer->color.xyz = mix(framebuffer->color.xyz,
+								 output_attributes->color.xyz,
+								 output_attributes->color.w);
+	framebuffer->color.w = 1.0f;
+	return true;
+}
+
+#endif
@@ -16,7 +16,9 @@ oclraster_framebuffer {
 
 bool rasterize_main() {
 	const oclr_sampler_t sampler = CLK_NORMALIZED_COORDS_TRUE | CLK_ADDRESS_REPEAT | CLK_FILTER_LINEAR;
-	const float4 color = image_read(diffuse_texture, sampler, output_attributes->tex_coord);
+	// trilinear filtering if the texture has mip-maps (otherwise the same as image_read)
+	const float4 color = image_read_grad(diffuse_texture, sampler, output_attributes->tex_coord,
+										 dfdx(output_attributes, tex_coord), dfdy(output_attributes, tex_coord));
 	framebuffer->color = color;
 	return true;
 }
@@ -0,0 +1,14 @@
+
+//////////////////////////////////////////////////////////////////
+// rasterization program (used by oclr_stage_bench)
+// minimal program without any inputs, so that the measured time is dominated by the rasterizer itself
+
+oclraster_framebuffer {
+	image2d color;
+	depth_image depth;
+};
+
+bool rasterize_main() {
+	framebuffer->color = (float4)(1.0f, 0.5f, 0.0f, 1.0f);
+	return true;
+}
@@ -135,6 +135,16 @@ for type in "${defs[@]}"; do
 	done
 done
 
+# block compressed types (read-only, always decoded to float4 -> no return type or channel variants)
+declare -a bc_types=("oclr_bc1" "oclr_bc3" "oclr_bc4" "oclr_bc5")
+for img_type in "${bc_types[@]}"; do
+	echo "type:$img_type"
+	img_type_upper=$(echo "${img_type}" | tr "[:lower:]" "[:upper:]")
+	CODE+="#if defined(OCLRASTER_IMAGE_${img_type_upper})\n"
+	CODE+=$(clang -E -DIMG_TYPE=${img_type} image_support_template_bc.h | grep -v "#")
+	CODE+="\n#endif\n\n"
+done
+
 # remove empty lines
 CODE=$(sed "/^$/d" <<< ${CODE})
 CLEAR_CODE=$(sed "/^$/d" <<< ${CLEAR_CODE})
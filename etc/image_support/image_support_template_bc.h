@@ -0,0 +1,70 @@
+
+// block compressed images: always decoded to normalized float4 (there are no integer or write functions)
+// NOTE: the texel data consists of 4x4 texel blocks in row-major order (oclr_bc_decode is defined in oclr_image.h)
+
+/////////////////
+// read functions
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const IMG_TYPE* img, const uint2 coord) {
+	const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+	global const IMG_TYPE* img_data_ptr = (global const IMG_TYPE*)((global const uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
+	const uint block_offset = (coord.y >> 2u) * ((img_size.x + 3u) >> 2u) + (coord.x >> 2u);
+	return oclr_bc_decode(img_data_ptr[block_offset], coord & 3u);
+}
+
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_nearest_sw(global const IMG_TYPE* img, const float2 coord) {
+	const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+	const float2 fimg_size = convert_float2(img_size) - 1.0f;
+	
+	// normalize input texture coordinate to [0, 1]
+	const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+	const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
+	return image_read_float_nearest_sw(img, ui_tc);
+}
+
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_float_linear_sw(global const IMG_TYPE* img, const float2 coord) {
+	const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
+	const float2 fimg_size = convert_float2(img_size) - 1.0f;
+	
+	// normalize input texture coordinate to [0, 1]
+	const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
+	
+	// compute texel coordinates for the 4 samples
+	const float2 scaled_coord = norm_coord * fimg_size + 0.5f;
+	float4 fcoords = (float4)(trunc(scaled_coord), ceil(scaled_coord));
+	const float2 weights = scaled_coord - fcoords.xy;
+	fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
+									 fimg_size.x, fimg_size.y));
+	const uint4 coords = convert_uint4(fcoords);
+	
+	// decode the 4 texels (most of the time, these are inside the same block) and interpolate according to weights
+	const float4 texels[4] = {
+		image_read_float_nearest_sw(img, coords.xy),
+		image_read_float_nearest_sw(img, coords.zy),
+		image_read_float_nearest_sw(img, coords.xw),
+		image_read_float_nearest_sw(img, coords.zw)
+	};
+	return texel_mix(texel_mix(texels[0], texels[1], weights.x),
+					 texel_mix(texels[2], texels[3], weights.x),
+					 weights.y);
+}
+
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const IMG_TYPE* img, const oclr_sampler_t sampler, const float2 coord) {
+	// need to check linear first (CLK_FILTER_NEAREST might be 0)
+	if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) return image_read_float_linear_sw(img, coord);
+	else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+	return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_sw(global const IMG_TYPE* img, const oclr_sampler_t sampler, const uint2 coord) {
+	// filter must be set to CLK_FILTER_NEAREST
+	if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) return image_read_float_nearest_sw(img, coord);
+	return (float4)(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+///////////////////////////////
+// mip-mapped read functions
+// NOTE: mip-maps can't be generated for block compressed images -> this only samples level 0,
+// but is provided so that image_read_lod/image_read_grad can be used with any image type
+float4 FUNC_OVERLOAD OCLRASTER_FUNC image_read_lod_sw(global const IMG_TYPE* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	return image_read_sw(img, sampler, coord);
+}
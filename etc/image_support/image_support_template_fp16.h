@@ -5,6 +5,9 @@
 #define IMG_READ_FUNC_CONCAT(return_name) image_read##return_name##_sw
 #define IMG_READ_FUNC_EVAL(return_name) IMG_READ_FUNC_CONCAT(return_name)
 #define IMG_READ_FUNC_NAME() IMG_READ_FUNC_EVAL(FUNC_RETURN_NAME)
+#define IMG_READ_LOD_FUNC_CONCAT(return_name) image_read_lod##return_name##_sw
+#define IMG_READ_LOD_FUNC_EVAL(return_name) IMG_READ_LOD_FUNC_CONCAT(return_name)
+#define IMG_READ_LOD_FUNC_NAME() IMG_READ_LOD_FUNC_EVAL(FUNC_RETURN_NAME)
 #define HALF_VEC_LOAD_CONCAT(vecn) vload_half##vecn
 #define HALF_VEC_LOAD_EVAL(vecn) HALF_VEC_LOAD_CONCAT(vecn)
 #define HALF_VEC_LOAD HALF_VEC_LOAD_EVAL(VECN)
@@ -27,12 +30,11 @@ RETURN_TYPE_VEC4 FUNC_OVERLOAD OCLRASTER_FUNC IMG_READ_FUNC_FILTER_NAME(nearest)
 	// normalize input texture coordinate to [0, 1]
 	const float2 norm_coord = fmod(coord + fabs(floor(coord)), (float2)(1.0f, 1.0f));
 	const uint2 ui_tc = clamp(convert_uint2(norm_coord * fimg_size), (uint2)(0u, 0u), img_size - 1u);
-	return IMG_READ_FUNC_FILTER_NAME(nearest)(img, ui_tc.y * img_size.x + ui_tc.x);
+	return IMG_READ_FUNC_FILTER_NAME(nearest)(img, oclr_get_image_texel_offset((image_header_ptr)img, ui_tc));
 }
 
 RETURN_TYPE_VEC4 FUNC_OVERLOAD OCLRASTER_FUNC IMG_READ_FUNC_FILTER_NAME(nearest)(global const IMG_TYPE* img, const uint2 coord) {
-	const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
-	return IMG_READ_FUNC_FILTER_NAME(nearest)(img, coord.y * img_size.x + coord.x);
+	return IMG_READ_FUNC_FILTER_NAME(nearest)(img, oclr_get_image_texel_offset((image_header_ptr)img, coord));
 }
 
 RETURN_TYPE_VEC4 FUNC_OVERLOAD OCLRASTER_FUNC IMG_READ_FUNC_FILTER_NAME(linear)(global const IMG_TYPE* img, const float2 coord) {
@@ -50,18 +52,19 @@ RETURN_TYPE_VEC4 FUNC_OVERLOAD OCLRASTER_FUNC IMG_READ_FUNC_FILTER_NAME(linear)(
 	fcoords = fmod(fcoords, (float4)(fimg_size.x, fimg_size.y,
 									 fimg_size.x, fimg_size.y));
 	
-	const uint4 coords = (uint4)((uint)fcoords.x,
-								 img_size.x * (uint)fcoords.y,
-								 (uint)fcoords.z,
-								 img_size.x * (uint)fcoords.w);
+	const uint4 coords = convert_uint4(fcoords);
+	const uint4 offsets = (uint4)(oclr_get_image_texel_offset((image_header_ptr)img, coords.xy),
+								  oclr_get_image_texel_offset((image_header_ptr)img, coords.zy),
+								  oclr_get_image_texel_offset((image_header_ptr)img, coords.xw),
+								  oclr_get_image_texel_offset((image_header_ptr)img, coords.zw));
 	
 	// finally: read texels and interpolate according to weights
 	const RETURN_TYPE_VEC texels[4] = {
 		// bilinear coords
-		HALF_VEC_LOAD(coords.y + coords.x, img_data_ptr),
-		HALF_VEC_LOAD(coords.y + coords.z, img_data_ptr),
-		HALF_VEC_LOAD(coords.w + coords.x, img_data_ptr),
-		HALF_VEC_LOAD(coords.w + coords.z, img_data_ptr),
+		HALF_VEC_LOAD(offsets.x, img_data_ptr),
+		HALF_VEC_LOAD(offsets.y, img_data_ptr),
+		HALF_VEC_LOAD(offsets.z, img_data_ptr),
+		HALF_VEC_LOAD(offsets.w, img_data_ptr),
 	};
 	return (RETURN_TYPE_VEC4)(
 		texel_mix(texel_mix(texels[0], texels[1], weights.x),
@@ -82,11 +85,32 @@ RETURN_TYPE_VEC4 FUNC_OVERLOAD OCLRASTER_FUNC IMG_READ_FUNC_NAME()(global const
 	return (RETURN_TYPE_VEC4)(IMG_ZERO, IMG_ZERO, IMG_ZERO, IMG_ONE);
 }
 
+///////////////////////////////
+// mip-mapped read functions
+// NOTE: lod is the (unclamped) level of detail, linear filtering blends between the two nearest levels (trilinear),
+// nearest filtering uses the nearest level
+RETURN_TYPE_VEC4 FUNC_OVERLOAD OCLRASTER_FUNC IMG_READ_LOD_FUNC_NAME()(global const IMG_TYPE* img, const oclr_sampler_t sampler, const float2 coord, const float lod) {
+	const uint max_level = oclr_get_image_mip_level_count((image_header_ptr)img) - 1u;
+	const float clamped_lod = clamp(lod, 0.0f, (float)max_level);
+	if((sampler & CLK_FILTER_LINEAR) == CLK_FILTER_LINEAR) {
+		const uint level = min((uint)clamped_lod, max_level);
+		const float weight = clamped_lod - (float)level;
+		const RETURN_TYPE_VEC4 texel = IMG_READ_FUNC_FILTER_NAME(linear)((global const IMG_TYPE*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+		// skip the second level if it doesn't contribute anything
+		if(weight == 0.0f || level == max_level) return texel;
+		return texel_mix(texel, IMG_READ_FUNC_FILTER_NAME(linear)((global const IMG_TYPE*)oclr_get_image_mip_level((image_header_ptr)img, level + 1u), coord), weight);
+	}
+	else if((sampler & CLK_FILTER_NEAREST) == CLK_FILTER_NEAREST) {
+		const uint level = min((uint)(clamped_lod + 0.5f), max_level);
+		return IMG_READ_FUNC_FILTER_NAME(nearest)((global const IMG_TYPE*)oclr_get_image_mip_level((image_header_ptr)img, level), coord);
+	}
+	return (RETURN_TYPE_VEC4)(IMG_ZERO, IMG_ZERO, IMG_ZERO, IMG_ONE);
+}
+
 //////////////////
 // write functions
 void FUNC_OVERLOAD OCLRASTER_FUNC image_write_sw(global IMG_TYPE* img, const uint2 coord, const RETURN_TYPE_VEC4 color) {
-	const uint2 img_size = oclr_get_image_size((image_header_ptr)img);
-	const uint offset = coord.y * img_size.x + coord.x;
+	const uint offset = oclr_get_image_texel_offset((image_header_ptr)img, coord);
 	global IMG_TYPE* img_data_ptr = (global IMG_TYPE*)((global uchar*)img + OCLRASTER_IMAGE_HEADER_SIZE);
 #if (CHANNEL_COUNT == 1)
 #define IMG_COLOR color.x
@@ -20,38 +20,201 @@
 #include "core/file_io.hpp"
 #include "core/core.hpp"
 #include "oclraster.hpp"
+#include "memory_tracker.hpp"
+#include "mesh_optimizer.hpp"
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
+#if !defined(__WINDOWS__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
 
 static constexpr unsigned int A2M_VERSION = 2u;
 
-a2m::a2m(const string& filename) {
-	load(filename);
+// binary mesh cache (<model>.a2m.oclrmesh), which stores the final device data of a model:
+// header | per-object index counts | per-object cluster counts | interleaved vertex_data | per-object indices |
+// per-object clusters | lods | object names
+// lods: per object: lod count, then (triangle count, error) per lod | indices of all lods (in object and lod order)
+// NOTE: this is a local cache in native byte order and struct layout -> it is regenerated whenever
+// the version, the vertex_data/cluster size, the flags or the size/modification time of the source model change
+// (optimized and unoptimized models are cached in separate files)
+static constexpr unsigned int A2M_CACHE_VERSION = 5u;
+static constexpr char a2m_cache_magic[8] { 'O', 'C', 'L', 'R', 'M', 'E', 'S', 'H' };
+static constexpr char a2m_cache_extension[] { ".oclrmesh" };
+static constexpr char a2m_optimized_cache_extension[] { ".optimized.oclrmesh" };
+enum class A2M_CACHE_FLAG : unsigned int {
+	NONE		= 0u,
+	OPTIMIZED	= (1u << 0u),
+};
+struct a2m_cache_header {
+	char magic[8];
+	unsigned int version;
+	unsigned int vertex_data_size;
+	unsigned long long int source_size;
+	long long int source_mtime; // in nanoseconds (if supported by the file system and os)
+	unsigned int vertex_count;
+	unsigned int object_count;
+	unsigned int flags;
+	unsigned int cluster_size;
+	unsigned long long int vertex_offset;
+	unsigned long long int index_offset;
+	unsigned long long int cluster_offset;
+	unsigned long long int lod_offset;
+	unsigned long long int names_offset;
+};
+static_assert(sizeof(a2m_cache_header) == 88, "invalid a2m cache header size");
+
+static bool get_source_info(const string& filename, unsigned long long int& size, long long int& mtime) {
+	struct stat file_stat;
+	if(stat(filename.c_str(), &file_stat) != 0) return false;
+	size = (unsigned long long int)file_stat.st_size;
+	// use the nanosecond modification time where available, so that a same-size edit within
+	// the same second still invalidates the cache
+#if defined(__APPLE__)
+	mtime = (long long int)file_stat.st_mtimespec.tv_sec * 1000000000ll + (long long int)file_stat.st_mtimespec.tv_nsec;
+#elif !defined(__WINDOWS__)
+	mtime = (long long int)file_stat.st_mtim.tv_sec * 1000000000ll + (long long int)file_stat.st_mtim.tv_nsec;
+#else
+	mtime = (long long int)file_stat.st_mtime * 1000000000ll;
+#endif
+	return true;
+}
+
+// read-only memory mapping of a complete file (the file contents are read into memory on windows)
+class a2m_mapped_file {
+public:
+	a2m_mapped_file(const string& filename) {
+#if !defined(__WINDOWS__)
+		const int fd = open(filename.c_str(), O_RDONLY);
+		if(fd == -1) return;
+		struct stat file_stat;
+		if(fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+			void* ptr = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(ptr != MAP_FAILED) {
+				data = (const unsigned char*)ptr;
+				size = (size_t)file_stat.st_size;
+			}
+		}
+		close(fd);
+#else
+		ifstream file(filename, ios::in | ios::binary | ios::ate);
+		if(!file.is_open()) return;
+		const streamoff file_size = file.tellg();
+		if(file_size <= 0) return;
+		file_data.resize((size_t)file_size);
+		file.seekg(0, ios::beg);
+		if(!file.read((char*)&file_data[0], file_size)) return;
+		data = &file_data[0];
+		size = file_data.size();
+#endif
+	}
+	~a2m_mapped_file() {
+#if !defined(__WINDOWS__)
+		if(data != nullptr) munmap((void*)data, size);
+#endif
+	}
+	a2m_mapped_file(const a2m_mapped_file&) = delete;
+	a2m_mapped_file& operator=(const a2m_mapped_file&) = delete;
+	
+	const unsigned char* data { nullptr };
+	size_t size { 0 };
+	
+protected:
+#if defined(__WINDOWS__)
+	vector<unsigned char> file_data;
+#endif
+};
+
+// runs func(begin, end) on contiguous chunks of [0, count) on all cpu cores (small ranges are processed on
+// the calling thread). func must only write the outputs of its own range, so that the results never depend
+// on the thread count.
+template <typename F> static void parallel_for(const size_t count, F&& func) {
+	static constexpr size_t min_chunk_size { 4096 };
+	const size_t thread_count = std::min(size_t(std::max(thread::hardware_concurrency(), 1u)),
+										 (count + min_chunk_size - 1) / min_chunk_size);
+	if(thread_count <= 1) {
+		func(size_t(0), count);
+		return;
+	}
+	
+	const size_t chunk_size = (count + thread_count - 1) / thread_count;
+	vector<thread> threads;
+	for(size_t i = 1; i < thread_count; i++) {
+		const size_t begin = i * chunk_size;
+		const size_t end = std::min(begin + chunk_size, count);
+		if(begin >= end) break;
+		threads.emplace_back([&func, begin, end] { func(begin, end); });
+	}
+	func(size_t(0), chunk_size);
+	for(auto& th : threads) {
+		th.join();
+	}
+}
+
+a2m::a2m(const string& filename, const bool optimize) {
+	load(filename, optimize);
 }
 
 a2m::~a2m() {
 	if(cl_vertex_buffer != nullptr) {
-		ocl->delete_buffer(cl_vertex_buffer);
+		memory_tracker::delete_buffer(cl_vertex_buffer);
 	}
 	for(const auto& ib : cl_index_buffers) {
 		if(ib != nullptr) {
-			ocl->delete_buffer(ib);
+			memory_tracker::delete_buffer(ib);
+		}
+	}
+	for(const auto& obj_lods : lods) {
+		for(const auto& lod : obj_lods) {
+			if(lod.index_buffer != nullptr) {
+				memory_tracker::delete_buffer(lod.index_buffer);
+			}
 		}
 	}
+	memory_tracker::remove_host(MEMORY_TAG::MESH, host_data_size);
+	if(index_count != nullptr) delete [] index_count;
+	delete_model_data();
+}
+
+void a2m::delete_model_data() {
 	if(vertices != nullptr) delete [] vertices;
 	if(normals != nullptr) delete [] normals;
 	if(binormals != nullptr) delete [] binormals;
 	if(tangents != nullptr) delete [] tangents;
 	if(tex_coords != nullptr) delete [] tex_coords;
-	if(index_count != nullptr) delete [] index_count;
+	vertices = nullptr;
+	normals = nullptr;
+	binormals = nullptr;
+	tangents = nullptr;
+	tex_coords = nullptr;
+	
+	// note: indices and tex_indices point to the same location after reorganize_model_data
+	if(tex_indices != nullptr && tex_indices != indices) {
+		for(unsigned int i = 0; i < object_count; i++) {
+			delete [] tex_indices[i];
+		}
+		delete [] tex_indices;
+	}
 	if(indices != nullptr) {
 		for(unsigned int i = 0; i < object_count; i++) {
-			// note: indices and tex_indices point to the same location now
 			delete [] indices[i];
 		}
 		delete [] indices;
 	}
+	indices = nullptr;
+	tex_indices = nullptr;
 }
 
-void a2m::load(const string& filename) {
+void a2m::load(const string& filename, const bool optimize) {
+	const string cache_filename = filename + (optimize ? a2m_optimized_cache_extension : a2m_cache_extension);
+	if(load_cache(filename, cache_filename, optimize)) {
+		return;
+	}
+	
 	file_io file(filename, file_io::OPEN_TYPE::READ_BINARY);
 	if(!file.is_open()) {
 		return;
@@ -135,64 +298,508 @@ void a2m::load(const string& filename) {
 	generate_normals();
 	reorganize_model_data();
 	
-	// create opencl buffers
+	// create the interleaved vertex data
 	vertex_data* vdata = new vertex_data[vertex_count];
+	parallel_for(vertex_count, [&](const size_t begin, const size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			vdata[i].vertex = vertices[i];
+			vdata[i].normal = normals[i];
+			vdata[i].binormal = binormals[i];
+			vdata[i].tangent = tangents[i];
+			vdata[i].vertex.w = 1.0f;
+			vdata[i].normal.w = 1.0f;
+			vdata[i].binormal.w = 1.0f;
+			vdata[i].tangent.w = 1.0f;
+			vdata[i].tex_coord = tex_coords[i];
+		}
+	});
+	
+	if(optimize) {
+		optimize_model_data(vdata);
+	}
+	
+	// clusters (must be built from the final triangle order)
+	for(unsigned int i = 0; i < object_count; i++) {
+		clusters.emplace_back(mesh_optimizer::build_clusters((const unsigned int*)indices[i], index_count[i],
+															 &vdata[0].vertex.x, sizeof(vertex_data)));
+	}
+	
+	compute_bounds();
+	
+	// simplified lods (built from the final triangle and vertex order as well)
+	vector<vector<vector<unsigned int>>> lod_data;
+	build_lods(vdata, optimize, lod_data);
+	vector<vector<const unsigned int*>> lod_indices(object_count);
+	for(unsigned int i = 0; i < object_count; i++) {
+		for(const auto& lod : lod_data[i]) {
+			lod_indices[i].emplace_back(&lod[0]);
+		}
+	}
+	
+	// write the binary cache, so that the next load can skip all of the above
+	write_cache(filename, cache_filename, vdata, lod_indices, optimize);
+	
+	vector<const unsigned int*> object_indices;
+	for(unsigned int i = 0; i < object_count; i++) {
+		object_indices.emplace_back((const unsigned int*)indices[i]);
+	}
+	create_buffers(vdata, object_indices, lod_indices);
+	delete [] vdata;
+	
+	// the host-side model data is not needed any more (everything lives in the opencl buffers now)
+	delete_model_data();
+}
+
+void a2m::optimize_model_data(vertex_data*& vdata) {
+	const float acmr_before = compute_acmr();
+	
+	// triangle order: spatially sorted binning batches, each optimized for vertex cache efficiency
+	for(unsigned int i = 0; i < object_count; i++) {
+		mesh_optimizer::optimize_locality((unsigned int*)indices[i], index_count[i],
+										  &vdata[0].vertex.x, sizeof(vertex_data));
+	}
+	
+	// vertex order: order of first use over all objects
+	vector<pair<unsigned int*, size_t>> index_buffers;
+	for(unsigned int i = 0; i < object_count; i++) {
+		index_buffers.emplace_back((unsigned int*)indices[i], index_count[i]);
+	}
+	const vector<unsigned int> remap = mesh_optimizer::optimize_vertex_fetch(index_buffers, vertex_count);
+	vertex_data* remapped_vdata = new vertex_data[vertex_count];
 	for(unsigned int i = 0; i < vertex_count; i++) {
-		vdata[i].vertex = vertices[i];
-		vdata[i].normal = normals[i];
-		vdata[i].binormal = binormals[i];
-		vdata[i].tangent = tangents[i];
-		vdata[i].vertex.w = 1.0f;
-		vdata[i].normal.w = 1.0f;
-		vdata[i].binormal.w = 1.0f;
-		vdata[i].tangent.w = 1.0f;
-		vdata[i].tex_coord = tex_coords[i];
-	}
-	cl_vertex_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-										  opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-										  opencl::BUFFER_FLAG::INITIAL_COPY,
-										  sizeof(vertex_data) * vertex_count,
-										  vdata);
+		remapped_vdata[remap[i]] = vdata[i];
+	}
 	delete [] vdata;
+	vdata = remapped_vdata;
+	
+	log_debug("optimized model: acmr %f -> %f", acmr_before, compute_acmr());
+}
+
+void a2m::build_lods(const vertex_data* vdata, const bool optimize, vector<vector<vector<unsigned int>>>& lod_indices) {
+	static constexpr unsigned int max_lod_count { 3 };
+	static constexpr unsigned int min_lod_triangle_count { 64 };
 	
+	// each lod is simplified from the previous one -> the errors of all previous simplifications are summed up,
+	// so that the error is a conservative bound relative to lod 0 and increases monotonically
+	lods.resize(object_count);
+	lod_indices.resize(object_count);
+	for(unsigned int i = 0; i < object_count; i++) {
+		vector<unsigned int> lod_idx((const unsigned int*)indices[i], (const unsigned int*)indices[i] + index_count[i] * 3);
+		unsigned int triangle_count = index_count[i];
+		float error = 0.0f;
+		for(unsigned int lod = 0; lod < max_lod_count; lod++) {
+			const unsigned int target_triangle_count = triangle_count / 2;
+			if(target_triangle_count < min_lod_triangle_count) break;
+			error += mesh_optimizer::simplify(lod_idx, &vdata[0].vertex.x, sizeof(vertex_data),
+											  vertex_count, target_triangle_count);
+			
+			// stop once the simplification doesn't make enough progress any more (locked borders and seams)
+			const unsigned int lod_triangle_count = (unsigned int)(lod_idx.size() / 3);
+			if(lod_triangle_count == 0 || lod_triangle_count > triangle_count - triangle_count / 10) break;
+			if(optimize) {
+				mesh_optimizer::optimize_locality(&lod_idx[0], lod_triangle_count, &vdata[0].vertex.x, sizeof(vertex_data));
+			}
+			lods[i].emplace_back(lod_level { lod_triangle_count, error, nullptr });
+			lod_indices[i].emplace_back(lod_idx);
+			triangle_count = lod_triangle_count;
+		}
+		log_debug("object \"%s\": %u lods (%u triangles -> %u triangles, max error %f)",
+				  object_names[i], lods[i].size() + 1, index_count[i], triangle_count, error);
+	}
+}
+
+void a2m::compute_bounds() {
+	// merge the cluster spheres: bounding box of all spheres -> center, farthest sphere -> radius
+	bounds.clear();
+	for(const auto& obj_clusters : clusters) {
+		if(obj_clusters.empty()) {
+			bounds.emplace_back(float4 { 0.0f, 0.0f, 0.0f, 0.0f });
+			continue;
+		}
+		float3 bmin { numeric_limits<float>::max(), numeric_limits<float>::max(), numeric_limits<float>::max() };
+		float3 bmax { -numeric_limits<float>::max(), -numeric_limits<float>::max(), -numeric_limits<float>::max() };
+		for(const auto& cluster : obj_clusters) {
+			const float4& sphere = cluster.sphere;
+			bmin.x = std::min(bmin.x, sphere.x - sphere.w);
+			bmin.y = std::min(bmin.y, sphere.y - sphere.w);
+			bmin.z = std::min(bmin.z, sphere.z - sphere.w);
+			bmax.x = std::max(bmax.x, sphere.x + sphere.w);
+			bmax.y = std::max(bmax.y, sphere.y + sphere.w);
+			bmax.z = std::max(bmax.z, sphere.z + sphere.w);
+		}
+		const float3 center { (bmin.x + bmax.x) * 0.5f, (bmin.y + bmax.y) * 0.5f, (bmin.z + bmax.z) * 0.5f };
+		float radius = 0.0f;
+		for(const auto& cluster : obj_clusters) {
+			const float4& sphere = cluster.sphere;
+			const float3 diff { sphere.x - center.x, sphere.y - center.y, sphere.z - center.z };
+			radius = std::max(radius, sqrtf(diff.x * diff.x + diff.y * diff.y + diff.z * diff.z) + sphere.w);
+		}
+		bounds.emplace_back(float4 { center.x, center.y, center.z, radius });
+	}
+}
+
+float a2m::compute_acmr() const {
+	size_t triangle_count = 0;
+	float miss_count = 0.0f;
 	for(unsigned int i = 0; i < object_count; i++) {
-		opencl::buffer_object* index_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-																 opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-																 opencl::BUFFER_FLAG::INITIAL_COPY,
-																 // 3 vertices/indices per triangle
-																 sizeof(unsigned int) * index_count[i] * 3,
-																 indices[i]);
+		miss_count += mesh_optimizer::compute_acmr((const unsigned int*)indices[i], index_count[i], vertex_count) * float(index_count[i]);
+		triangle_count += index_count[i];
+	}
+	return (triangle_count > 0 ? miss_count / float(triangle_count) : 0.0f);
+}
+
+bool a2m::load_cache(const string& filename, const string& cache_filename, const bool optimized) {
+	unsigned long long int source_size = 0;
+	long long int source_mtime = 0;
+	if(!get_source_info(filename, source_size, source_mtime)) {
+		return false;
+	}
+	
+	const a2m_mapped_file cache(cache_filename);
+	if(cache.data == nullptr || cache.size < sizeof(a2m_cache_header)) {
+		return false;
+	}
+	
+	// validate the header and the data layout against the file size
+	const a2m_cache_header* header = (const a2m_cache_header*)cache.data;
+	if(memcmp(header->magic, a2m_cache_magic, sizeof(a2m_cache_magic)) != 0 ||
+	   header->version != A2M_CACHE_VERSION ||
+	   header->vertex_data_size != sizeof(vertex_data) ||
+	   header->cluster_size != sizeof(mesh_cluster) ||
+	   header->source_size != source_size ||
+	   header->source_mtime != source_mtime ||
+	   header->flags != (unsigned int)(optimized ? A2M_CACHE_FLAG::OPTIMIZED : A2M_CACHE_FLAG::NONE) ||
+	   header->object_count == 0) {
+		log_debug("a2m cache \"%s\" is out of date", cache_filename);
+		return false;
+	}
+	const unsigned long long int counts_end = sizeof(a2m_cache_header) + header->object_count * 2ull * sizeof(unsigned int);
+	const unsigned long long int vertex_end = header->vertex_offset + header->vertex_count * sizeof(vertex_data);
+	if(counts_end > cache.size ||
+	   header->vertex_offset < counts_end || vertex_end > cache.size ||
+	   header->index_offset < vertex_end || header->index_offset > cache.size ||
+	   header->cluster_offset > cache.size || header->lod_offset > cache.size || header->names_offset > cache.size) {
+		log_error("invalid a2m cache \"%s\"!", cache_filename);
+		return false;
+	}
+	const unsigned int* counts = (const unsigned int*)(cache.data + sizeof(a2m_cache_header));
+	const unsigned int* cluster_counts = counts + header->object_count;
+	unsigned long long int index_end = header->index_offset;
+	unsigned long long int cluster_end = header->cluster_offset;
+	for(unsigned int i = 0; i < header->object_count; i++) {
+		index_end += counts[i] * 3ull * sizeof(unsigned int);
+		cluster_end += cluster_counts[i] * sizeof(mesh_cluster);
+	}
+	if(index_end > header->cluster_offset || cluster_end > header->lod_offset) {
+		log_error("invalid a2m cache \"%s\"!", cache_filename);
+		return false;
+	}
+	
+	// all cluster ranges must lie within the triangles of their object (-> no out of bounds access when compacting)
+	const mesh_cluster* cache_clusters = (const mesh_cluster*)(cache.data + header->cluster_offset);
+	for(unsigned int i = 0; i < header->object_count; i++) {
+		for(unsigned int j = 0; j < cluster_counts[i]; j++, cache_clusters++) {
+			if((unsigned long long int)cache_clusters->triangle_offset + cache_clusters->triangle_count > counts[i]) {
+				log_error("invalid a2m cache \"%s\"!", cache_filename);
+				return false;
+			}
+		}
+	}
+	
+	// lod table, followed by the lod indices
+	vector<vector<lod_level>> cache_lods(header->object_count);
+	const unsigned char* lod_ptr = cache.data + header->lod_offset;
+	const unsigned char* lod_end = cache.data + header->names_offset;
+	unsigned long long int lod_index_size = 0;
+	for(unsigned int i = 0; i < header->object_count; i++) {
+		unsigned int lod_count = 0;
+		if(lod_ptr + sizeof(unsigned int) > lod_end) {
+			log_error("invalid a2m cache \"%s\"!", cache_filename);
+			return false;
+		}
+		memcpy(&lod_count, lod_ptr, sizeof(unsigned int));
+		lod_ptr += sizeof(unsigned int);
+		if((unsigned long long int)(lod_end - lod_ptr) < lod_count * 2ull * sizeof(unsigned int)) {
+			log_error("invalid a2m cache \"%s\"!", cache_filename);
+			return false;
+		}
+		for(unsigned int j = 0; j < lod_count; j++) {
+			lod_level lod { 0, 0.0f, nullptr };
+			memcpy(&lod.index_count, lod_ptr, sizeof(unsigned int));
+			memcpy(&lod.error, lod_ptr + sizeof(unsigned int), sizeof(float));
+			lod_ptr += 2 * sizeof(unsigned int);
+			lod_index_size += lod.index_count * 3ull * sizeof(unsigned int);
+			cache_lods[i].emplace_back(lod);
+		}
+	}
+	if(lod_index_size > (unsigned long long int)(lod_end - lod_ptr)) {
+		log_error("invalid a2m cache \"%s\"!", cache_filename);
+		return false;
+	}
+	
+	// object names (null-terminated, in object order)
+	vector<string> names;
+	const char* names_ptr = (const char*)(cache.data + header->names_offset);
+	const char* names_end = (const char*)(cache.data + cache.size);
+	for(unsigned int i = 0; i < header->object_count; i++) {
+		const char* name_end = (const char*)memchr(names_ptr, 0, size_t(names_end - names_ptr));
+		if(name_end == nullptr) {
+			log_error("invalid a2m cache \"%s\"!", cache_filename);
+			return false;
+		}
+		names.emplace_back(names_ptr, size_t(name_end - names_ptr));
+		names_ptr = name_end + 1;
+	}
+	
+	vertex_count = header->vertex_count;
+	tex_coord_count = header->vertex_count;
+	object_count = header->object_count;
+	object_names.swap(names);
+	index_count = new unsigned int[object_count];
+	memcpy(index_count, counts, object_count * sizeof(unsigned int));
+	const mesh_cluster* cluster_ptr = (const mesh_cluster*)(cache.data + header->cluster_offset);
+	for(unsigned int i = 0; i < object_count; i++) {
+		clusters.emplace_back(cluster_ptr, cluster_ptr + cluster_counts[i]);
+		cluster_ptr += cluster_counts[i];
+	}
+	compute_bounds();
+	lods.swap(cache_lods);
+	
+	// upload straight from the mapped file
+	vector<const unsigned int*> object_indices;
+	const unsigned char* index_ptr = cache.data + header->index_offset;
+	for(unsigned int i = 0; i < object_count; i++) {
+		object_indices.emplace_back((const unsigned int*)index_ptr);
+		index_ptr += index_count[i] * 3ull * sizeof(unsigned int);
+	}
+	vector<vector<const unsigned int*>> lod_indices(object_count);
+	for(unsigned int i = 0; i < object_count; i++) {
+		for(const auto& lod : lods[i]) {
+			lod_indices[i].emplace_back((const unsigned int*)lod_ptr);
+			lod_ptr += lod.index_count * 3ull * sizeof(unsigned int);
+		}
+	}
+	create_buffers((const vertex_data*)(cache.data + header->vertex_offset), object_indices, lod_indices);
+	return true;
+}
+
+void a2m::write_cache(const string& filename, const string& cache_filename, const vertex_data* vdata,
+					  const vector<vector<const unsigned int*>>& lod_indices, const bool optimized) const {
+	a2m_cache_header header;
+	memcpy(header.magic, a2m_cache_magic, sizeof(a2m_cache_magic));
+	header.version = A2M_CACHE_VERSION;
+	header.vertex_data_size = sizeof(vertex_data);
+	if(!get_source_info(filename, header.source_size, header.source_mtime)) {
+		return;
+	}
+	header.vertex_count = vertex_count;
+	header.object_count = object_count;
+	header.flags = (unsigned int)(optimized ? A2M_CACHE_FLAG::OPTIMIZED : A2M_CACHE_FLAG::NONE);
+	header.cluster_size = sizeof(mesh_cluster);
+	
+	// vertex data is 16-byte aligned within the file
+	const unsigned long long int counts_end = sizeof(a2m_cache_header) + object_count * 2ull * sizeof(unsigned int);
+	header.vertex_offset = (counts_end + 15ull) & ~15ull;
+	header.index_offset = header.vertex_offset + vertex_count * sizeof(vertex_data);
+	unsigned long long int index_end = header.index_offset;
+	for(unsigned int i = 0; i < object_count; i++) {
+		index_end += index_count[i] * 3ull * sizeof(unsigned int);
+	}
+	// clusters are 16-byte aligned as well
+	header.cluster_offset = (index_end + 15ull) & ~15ull;
+	header.lod_offset = header.cluster_offset;
+	for(const auto& obj_clusters : clusters) {
+		header.lod_offset += obj_clusters.size() * sizeof(mesh_cluster);
+	}
+	header.names_offset = header.lod_offset;
+	for(const auto& obj_lods : lods) {
+		header.names_offset += sizeof(unsigned int);
+		for(const auto& lod : obj_lods) {
+			header.names_offset += 2ull * sizeof(unsigned int) + lod.index_count * 3ull * sizeof(unsigned int);
+		}
+	}
+	
+	// write to a temporary file first, so that a failed or concurrent write never leaves a broken cache behind
+	// (the temporary file is unique per process and thread -> concurrent writers never write into the same file)
+#if !defined(__WINDOWS__)
+	const unsigned int pid = (unsigned int)getpid();
+#else
+	const unsigned int pid = (unsigned int)_getpid();
+#endif
+	const string tmp_filename = (cache_filename + "." + uint2string(pid) + "." +
+								 size_t2string(std::hash<thread::id>()(this_thread::get_id())) + ".tmp");
+	{
+		ofstream file(tmp_filename, ios::out | ios::binary | ios::trunc);
+		if(!file.is_open()) {
+			// not fatal (e.g. read-only data directory), the model will simply be parsed again next time
+			log_debug("failed to create a2m cache \"%s\"", cache_filename);
+			return;
+		}
+		
+		static const char padding[16] {};
+		file.write((const char*)&header, sizeof(a2m_cache_header));
+		file.write((const char*)index_count, object_count * sizeof(unsigned int));
+		for(const auto& obj_clusters : clusters) {
+			const unsigned int cluster_count = (unsigned int)obj_clusters.size();
+			file.write((const char*)&cluster_count, sizeof(unsigned int));
+		}
+		file.write(padding, std::streamsize(header.vertex_offset - counts_end));
+		file.write((const char*)vdata, std::streamsize(vertex_count * sizeof(vertex_data)));
+		for(unsigned int i = 0; i < object_count; i++) {
+			file.write((const char*)indices[i], std::streamsize(index_count[i] * 3ull * sizeof(unsigned int)));
+		}
+		file.write(padding, std::streamsize(header.cluster_offset - index_end));
+		for(const auto& obj_clusters : clusters) {
+			if(obj_clusters.empty()) continue;
+			file.write((const char*)&obj_clusters[0], std::streamsize(obj_clusters.size() * sizeof(mesh_cluster)));
+		}
+		for(const auto& obj_lods : lods) {
+			const unsigned int lod_count = (unsigned int)obj_lods.size();
+			file.write((const char*)&lod_count, sizeof(unsigned int));
+			for(const auto& lod : obj_lods) {
+				file.write((const char*)&lod.index_count, sizeof(unsigned int));
+				file.write((const char*)&lod.error, sizeof(float));
+			}
+		}
+		for(unsigned int i = 0; i < object_count; i++) {
+			for(size_t j = 0; j < lods[i].size(); j++) {
+				file.write((const char*)lod_indices[i][j], std::streamsize(lods[i][j].index_count * 3ull * sizeof(unsigned int)));
+			}
+		}
+		for(const auto& name : object_names) {
+			file.write(name.c_str(), std::streamsize(name.size() + 1));
+		}
+		
+		if(!file.good()) {
+			log_error("failed to write a2m cache \"%s\"!", cache_filename);
+			file.close();
+			remove(tmp_filename.c_str());
+			return;
+		}
+	}
+	
+	remove(cache_filename.c_str());
+	if(rename(tmp_filename.c_str(), cache_filename.c_str()) != 0) {
+		log_error("failed to write a2m cache \"%s\"!", cache_filename);
+		remove(tmp_filename.c_str());
+	}
+}
+
+void a2m::create_buffers(const vertex_data* vdata,
+						 const vector<const unsigned int*>& object_indices,
+						 const vector<vector<const unsigned int*>>& lod_indices) {
+	// only the index counts, clusters, bounds and lod infos are kept on the host side
+	host_data_size = object_count * (sizeof(unsigned int) + sizeof(float4));
+	for(const auto& obj_clusters : clusters) {
+		host_data_size += obj_clusters.size() * sizeof(mesh_cluster);
+	}
+	for(const auto& obj_lods : lods) {
+		host_data_size += obj_lods.size() * sizeof(lod_level);
+	}
+	memory_tracker::add_host(MEMORY_TAG::MESH, host_data_size);
+	
+	cl_vertex_buffer = memory_tracker::create_buffer(MEMORY_TAG::MESH,
+													 opencl::BUFFER_FLAG::READ |
+													 opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+													 opencl::BUFFER_FLAG::INITIAL_COPY,
+													 sizeof(vertex_data) * vertex_count,
+													 (void*)vdata);
+	
+	for(unsigned int i = 0; i < object_count; i++) {
+		opencl::buffer_object* index_buffer = memory_tracker::create_buffer(MEMORY_TAG::MESH,
+																			opencl::BUFFER_FLAG::READ |
+																			opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+																			opencl::BUFFER_FLAG::INITIAL_COPY,
+																			// 3 vertices/indices per triangle
+																			sizeof(unsigned int) * index_count[i] * 3,
+																			(void*)object_indices[i]);
 		cl_index_buffers.emplace_back(index_buffer);
+		
+		for(size_t j = 0; j < lods[i].size(); j++) {
+			lods[i][j].index_buffer = memory_tracker::create_buffer(MEMORY_TAG::MESH,
+																	opencl::BUFFER_FLAG::READ |
+																	opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+																	opencl::BUFFER_FLAG::INITIAL_COPY,
+																	sizeof(unsigned int) * lods[i][j].index_count * 3,
+																	(void*)lod_indices[i][j]);
+		}
 	}
 }
 
 void a2m::generate_normals() {
-	float3 normal, binormal, tangent;
+	// global face numbering over all objects
+	vector<size_t> face_offset(object_count + 1, 0);
+	for(unsigned int i = 0; i < object_count; i++) {
+		face_offset[i + 1] = face_offset[i] + index_count[i];
+	}
+	const size_t face_count = face_offset[object_count];
+	
+	// per-face normal, binormal and tangent
+	vector<float3> face_normals(face_count), face_binormals(face_count), face_tangents(face_count);
+	for(unsigned int i = 0; i < object_count; i++) {
+		const index3* obj_indices = indices[i];
+		const index3* obj_tex_indices = tex_indices[i];
+		const size_t offset = face_offset[i];
+		parallel_for(index_count[i], [&](const size_t begin, const size_t end) {
+			for(size_t j = begin; j < end; j++) {
+				core::compute_normal_tangent_binormal(vertices[obj_indices[j].x],
+													  vertices[obj_indices[j].y],
+													  vertices[obj_indices[j].z],
+													  face_normals[offset + j],
+													  face_binormals[offset + j],
+													  face_tangents[offset + j],
+													  tex_coords[obj_tex_indices[j].x],
+													  tex_coords[obj_tex_indices[j].y],
+													  tex_coords[obj_tex_indices[j].z]);
+			}
+		});
+	}
+	
+	// vertex -> face adjacency, in face order
+	vector<unsigned int> adjacency_offset(vertex_count + 1, 0);
 	for(unsigned int i = 0; i < object_count; i++) {
 		for(unsigned int j = 0; j < index_count[i]; j++) {
-			core::compute_normal_tangent_binormal(vertices[indices[i][j].x],
-												  vertices[indices[i][j].y],
-												  vertices[indices[i][j].z],
-												  normal, binormal, tangent,
-												  tex_coords[tex_indices[i][j].x],
-												  tex_coords[tex_indices[i][j].y],
-												  tex_coords[tex_indices[i][j].z]);
-			normals[indices[i][j].x] += normal;
-			normals[indices[i][j].y] += normal;
-			normals[indices[i][j].z] += normal;
-			binormals[indices[i][j].x] += binormal;
-			binormals[indices[i][j].y] += binormal;
-			binormals[indices[i][j].z] += binormal;
-			tangents[indices[i][j].x] += tangent;
-			tangents[indices[i][j].y] += tangent;
-			tangents[indices[i][j].z] += tangent;
+			adjacency_offset[indices[i][j].x + 1]++;
+			adjacency_offset[indices[i][j].y + 1]++;
+			adjacency_offset[indices[i][j].z + 1]++;
 		}
 	}
 	for(unsigned int i = 0; i < vertex_count; i++) {
-		normals[i].normalize();
-		binormals[i].normalize();
-		tangents[i].normalize();
+		adjacency_offset[i + 1] += adjacency_offset[i];
+	}
+	vector<unsigned int> adjacency(adjacency_offset[vertex_count]);
+	{
+		vector<unsigned int> fill_offset(adjacency_offset.cbegin(), adjacency_offset.cend() - 1);
+		for(unsigned int i = 0; i < object_count; i++) {
+			for(unsigned int j = 0; j < index_count[i]; j++) {
+				const unsigned int face = (unsigned int)(face_offset[i] + j);
+				adjacency[fill_offset[indices[i][j].x]++] = face;
+				adjacency[fill_offset[indices[i][j].y]++] = face;
+				adjacency[fill_offset[indices[i][j].z]++] = face;
+			}
+		}
 	}
+	
+	// gather: each vertex sums up its adjacent faces in face order (no atomics, and the summation order is
+	// the same as with a serial scatter over all faces -> deterministic, independent of the thread count)
+	parallel_for(vertex_count, [&](const size_t begin, const size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			float3 normal { 0.0f, 0.0f, 0.0f };
+			float3 binormal { 0.0f, 0.0f, 0.0f };
+			float3 tangent { 0.0f, 0.0f, 0.0f };
+			for(unsigned int j = adjacency_offset[i]; j < adjacency_offset[i + 1]; j++) {
+				normal += face_normals[adjacency[j]];
+				binormal += face_binormals[adjacency[j]];
+				tangent += face_tangents[adjacency[j]];
+			}
+			normal.normalize();
+			binormal.normalize();
+			tangent.normalize();
+			normals[i] = normal;
+			binormals[i] = binormal;
+			tangents[i] = tangent;
+		}
+	});
 }
 
 /*! reorganizes the model data, so that each texture coordinate has it's own vertex
@@ -211,25 +818,26 @@ void a2m::reorganize_model_data() {
 	binormals = new float3[vertex_count];
 	tangents = new float3[vertex_count];
 	
+	// the last face (in face order) that references a texture coordinate determines its source vertex
+	// -> resolve the sources serially (cheap), then gather the vertex data in parallel
+	vector<unsigned int> source_vertex(vertex_count, ~0u);
 	for(unsigned int i = 0; i < object_count; i++) {
 		for(unsigned int j = 0; j < index_count[i]; j++) {
-			vertices[tex_indices[i][j].x] = old_vertices[indices[i][j].x];
-			vertices[tex_indices[i][j].y] = old_vertices[indices[i][j].y];
-			vertices[tex_indices[i][j].z] = old_vertices[indices[i][j].z];
-			
-			normals[tex_indices[i][j].x] = old_normals[indices[i][j].x];
-			normals[tex_indices[i][j].y] = old_normals[indices[i][j].y];
-			normals[tex_indices[i][j].z] = old_normals[indices[i][j].z];
-			
-			binormals[tex_indices[i][j].x] = old_binormals[indices[i][j].x];
-			binormals[tex_indices[i][j].y] = old_binormals[indices[i][j].y];
-			binormals[tex_indices[i][j].z] = old_binormals[indices[i][j].z];
-			
-			tangents[tex_indices[i][j].x] = old_tangents[indices[i][j].x];
-			tangents[tex_indices[i][j].y] = old_tangents[indices[i][j].y];
-			tangents[tex_indices[i][j].z] = old_tangents[indices[i][j].z];
+			source_vertex[tex_indices[i][j].x] = indices[i][j].x;
+			source_vertex[tex_indices[i][j].y] = indices[i][j].y;
+			source_vertex[tex_indices[i][j].z] = indices[i][j].z;
 		}
 	}
+	parallel_for(vertex_count, [&](const size_t begin, const size_t end) {
+		for(size_t i = begin; i < end; i++) {
+			const unsigned int src = source_vertex[i];
+			if(src == ~0u) continue;
+			vertices[i] = old_vertices[src];
+			normals[i] = old_normals[src];
+			binormals[i] = old_binormals[src];
+			tangents[i] = old_tangents[src];
+		}
+	});
 	
 	delete [] old_vertices;
 	delete [] old_normals;
@@ -250,6 +858,10 @@ const opencl::buffer_object& a2m::get_index_buffer(const size_t& sub_object) con
 	return *cl_index_buffers[sub_object];
 }
 
+unsigned int a2m::get_object_count() const {
+	return object_count;
+}
+
 unsigned int a2m::get_vertex_count() const {
 	return vertex_count;
 }
@@ -258,35 +870,126 @@ unsigned int a2m::get_index_count(const unsigned int& sub_object) const {
 	return index_count[sub_object];
 }
 
-void a2m::flip_faces() {
-	for(unsigned int i = 0; i < object_count; i++) {
-		for(unsigned int j = 0; j < index_count[i]; j++) {
-			indices[i][j].set(indices[i][j].z, indices[i][j].y, indices[i][j].x);
-		}
-	}
-	for(unsigned int i = 0; i < vertex_count; i++) {
-		normals[i] *= -1.0f;
-		binormals[i] *= -1.0f;
-		tangents[i] *= -1.0f;
+const vector<mesh_cluster>& a2m::get_clusters(const size_t& sub_object) const {
+	return clusters[sub_object];
+}
+
+const float4& a2m::get_bounds(const size_t& sub_object) const {
+	return bounds[sub_object];
+}
+
+unsigned int a2m::get_lod_count(const size_t& sub_object) const {
+	return (unsigned int)lods[sub_object].size() + 1;
+}
+
+const opencl::buffer_object& a2m::get_lod_index_buffer(const size_t& sub_object, const unsigned int& lod) const {
+	if(lod == 0) return *cl_index_buffers[sub_object];
+	return *lods[sub_object][lod - 1].index_buffer;
+}
+
+unsigned int a2m::get_lod_index_count(const size_t& sub_object, const unsigned int& lod) const {
+	if(lod == 0) return index_count[sub_object];
+	return lods[sub_object][lod - 1].index_count;
+}
+
+float a2m::get_lod_error(const size_t& sub_object, const unsigned int& lod) const {
+	if(lod == 0) return 0.0f;
+	return lods[sub_object][lod - 1].error;
+}
+
+unsigned int a2m::select_lod(const size_t& sub_object,
+							 const draw_state::camera_setup& cam_setup,
+							 const matrix4f& model_matrix,
+							 const float max_pixel_error,
+							 const PROJECTION projection) const {
+	const auto& obj_lods = lods[sub_object];
+	if(obj_lods.empty() || max_pixel_error <= 0.0f) return 0;
+	
+	// object -> world space (column major): errors and radii scale with the largest axis scale
+	const float* mat = model_matrix.data;
+	const float max_scale = sqrtf(std::max(std::max(mat[0] * mat[0] + mat[1] * mat[1] + mat[2] * mat[2],
+													mat[4] * mat[4] + mat[5] * mat[5] + mat[6] * mat[6]),
+										   mat[8] * mat[8] + mat[9] * mat[9] + mat[10] * mat[10]));
+	if(max_scale <= 0.0f) return (unsigned int)obj_lods.size();
+	
+	// world space size of one pixel: x_vec is the distance between two pixels at distance 1 along the forward
+	// vector -> scale by the distance to the closest point of the bounding sphere for perspective projections
+	const float3& x_vec = cam_setup.x_vec;
+	float pixel_size = sqrtf(x_vec.x * x_vec.x + x_vec.y * x_vec.y + x_vec.z * x_vec.z);
+	if(projection == PROJECTION::PERSPECTIVE) {
+		const float4& sphere = bounds[sub_object];
+		const float3 center {
+			mat[0] * sphere.x + mat[4] * sphere.y + mat[8] * sphere.z + mat[12] - cam_setup.position.x,
+			mat[1] * sphere.x + mat[5] * sphere.y + mat[9] * sphere.z + mat[13] - cam_setup.position.y,
+			mat[2] * sphere.x + mat[6] * sphere.y + mat[10] * sphere.z + mat[14] - cam_setup.position.z
+		};
+		const float distance = sqrtf(center.x * center.x + center.y * center.y + center.z * center.z) - sphere.w * max_scale;
+		// camera inside the bounding sphere -> full detail
+		if(distance <= 0.0f) return 0;
+		pixel_size *= distance;
 	}
 	
-	// update opencl buffers
-	vertex_data* vdata = new vertex_data[vertex_count];
+	// the lod errors increase monotonically -> use the last lod within the (object space) error bound
+	const float max_error = (max_pixel_error * pixel_size) / max_scale;
+	unsigned int lod = 0;
+	while(lod < obj_lods.size() && obj_lods[lod].error <= max_error) {
+		lod++;
+	}
+	return lod;
+}
+
+vector<vector<unsigned int>> a2m::select_instance_lods(const size_t& sub_object,
+														const draw_state::camera_setup& cam_setup,
+														const vector<matrix4f>& instance_matrices,
+														const float max_pixel_error,
+														const PROJECTION projection) const {
+	vector<vector<unsigned int>> instance_lods(get_lod_count(sub_object));
+	for(size_t i = 0; i < instance_matrices.size(); i++) {
+		const unsigned int lod = select_lod(sub_object, cam_setup, instance_matrices[i], max_pixel_error, projection);
+		instance_lods[lod].emplace_back((unsigned int)i);
+	}
+	return instance_lods;
+}
+
+void a2m::flip_faces() {
+	// the host-side model data is freed after the upload -> flip the opencl buffer data in place
+	vertex_data* vdata = (vertex_data*)ocl->map_buffer(cl_vertex_buffer,
+													   opencl::MAP_BUFFER_FLAG::READ |
+													   opencl::MAP_BUFFER_FLAG::WRITE |
+													   opencl::MAP_BUFFER_FLAG::BLOCK);
+	const auto flip = [](float4& vec) {
+		vec.x = -vec.x;
+		vec.y = -vec.y;
+		vec.z = -vec.z;
+	};
 	for(unsigned int i = 0; i < vertex_count; i++) {
-		vdata[i].vertex = vertices[i];
-		vdata[i].normal = normals[i];
-		vdata[i].binormal = binormals[i];
-		vdata[i].tangent = tangents[i];
-		vdata[i].vertex.w = 1.0f;
-		vdata[i].normal.w = 1.0f;
-		vdata[i].binormal.w = 1.0f;
-		vdata[i].tangent.w = 1.0f;
-		vdata[i].tex_coord = tex_coords[i];
-	}
-	ocl->write_buffer(cl_vertex_buffer, vdata);
-	delete [] vdata;
+		flip(vdata[i].normal);
+		flip(vdata[i].binormal);
+		flip(vdata[i].tangent);
+	}
+	ocl->unmap_buffer(cl_vertex_buffer, vdata);
 	
+	const auto flip_indices = [](opencl::buffer_object* index_buffer, const unsigned int triangle_count) {
+		index3* obj_indices = (index3*)ocl->map_buffer(index_buffer,
+													   opencl::MAP_BUFFER_FLAG::READ |
+													   opencl::MAP_BUFFER_FLAG::WRITE |
+													   opencl::MAP_BUFFER_FLAG::BLOCK);
+		for(unsigned int j = 0; j < triangle_count; j++) {
+			std::swap(obj_indices[j].x, obj_indices[j].z);
+		}
+		ocl->unmap_buffer(index_buffer, obj_indices);
+	};
 	for(unsigned int i = 0; i < object_count; i++) {
-		ocl->write_buffer(cl_index_buffers[i], indices[i]);
+		flip_indices(cl_index_buffers[i], index_count[i]);
+		for(const auto& lod : lods[i]) {
+			flip_indices(lod.index_buffer, lod.index_count);
+		}
+		
+		// the normal cones flip as well
+		for(auto& cluster : clusters[i]) {
+			cluster.cone.x = -cluster.cone.x;
+			cluster.cone.y = -cluster.cone.y;
+			cluster.cone.z = -cluster.cone.z;
+		}
 	}
 }
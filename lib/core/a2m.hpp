@@ -24,10 +24,14 @@
 #include "core/vector3.hpp"
 #include "cl/opencl.hpp"
 #include "pipeline/transform_stage.hpp"
+#include "pipeline/pipeline.hpp"
+#include "core/mesh_optimizer.hpp"
 
 class a2m {
 public:
-	a2m(const string& filename);
+	// optimize: reorders the triangles and vertices of the model for index locality (see mesh_optimizer)
+	// NOTE: this changes the triangle draw order, which affects blending and coplanar geometry -> opt-in only
+	a2m(const string& filename, const bool optimize = false);
 	~a2m();
 	
 	oclraster_struct vertex_data {
@@ -41,8 +45,38 @@ public:
 	const opencl::buffer_object& get_vertex_buffer() const;
 	const opencl::buffer_object& get_index_buffer(const size_t& sub_object) const;
 	
+	unsigned int get_object_count() const;
 	unsigned int get_vertex_count() const;
 	unsigned int get_index_count(const unsigned int& sub_object) const;
+	// clusters of 128 triangles of each sub-object (for pipeline::draw_clusters)
+	const vector<mesh_cluster>& get_clusters(const size_t& sub_object) const;
+	// object space bounding sphere of each sub-object (.xyz = center, .w = radius)
+	const float4& get_bounds(const size_t& sub_object) const;
+	
+	// level of detail: each sub-object has up to 3 simplified index buffers (lod 1+, each with about half the
+	// triangles of the previous level) that use the same vertex buffer. lod 0 is the original index buffer
+	// (-> get_index_buffer/get_index_count), clusters are only available for lod 0.
+	unsigned int get_lod_count(const size_t& sub_object) const;
+	const opencl::buffer_object& get_lod_index_buffer(const size_t& sub_object, const unsigned int& lod) const;
+	unsigned int get_lod_index_count(const size_t& sub_object, const unsigned int& lod) const;
+	// geometric error of a lod in object space (0 for lod 0)
+	float get_lod_error(const size_t& sub_object, const unsigned int& lod) const;
+	
+	// selects the coarsest lod of a sub-object whose geometric error projects to at most max_pixel_error
+	// pixels on screen, when drawn with the specified model matrix and camera setup
+	unsigned int select_lod(const size_t& sub_object,
+							const draw_state::camera_setup& cam_setup,
+							const matrix4f& model_matrix = matrix4f(),
+							const float max_pixel_error = 1.0f,
+							const PROJECTION projection = PROJECTION::PERSPECTIVE) const;
+	// per-instance lod selection: returns the instance ids that use each lod (get_lod_count entries)
+	// NOTE: draw each non-empty lod with its own draw_instanced call (instance count = number of ids) and bind
+	// the ids as a buffer, so that the transform program can map its instance index to the actual instance
+	vector<vector<unsigned int>> select_instance_lods(const size_t& sub_object,
+													  const draw_state::camera_setup& cam_setup,
+													  const vector<matrix4f>& instance_matrices,
+													  const float max_pixel_error = 1.0f,
+													  const PROJECTION projection = PROJECTION::PERSPECTIVE) const;
 	
 	void flip_faces();
 	
@@ -61,15 +95,39 @@ protected:
 	vector<string> object_names;
 	index3** indices = nullptr;
 	index3** tex_indices = nullptr;
+	vector<vector<mesh_cluster>> clusters;
+	vector<float4> bounds;
+	
+	struct lod_level {
+		unsigned int index_count; // triangle count
+		float error; // object space
+		opencl::buffer_object* index_buffer;
+	};
+	vector<vector<lod_level>> lods; // lod 1+ of each sub-object
 	
 	//
-	opencl::buffer_object* cl_vertex_buffer;
+	opencl::buffer_object* cl_vertex_buffer = nullptr;
 	vector<opencl::buffer_object*> cl_index_buffers;
+	size_t host_data_size = 0;
 	
 	//
-	void load(const string& filename);
+	void load(const string& filename, const bool optimize);
 	void reorganize_model_data();
 	void generate_normals();
+	void delete_model_data();
+	void optimize_model_data(vertex_data*& vdata);
+	float compute_acmr() const;
+	void build_lods(const vertex_data* vdata, const bool optimize, vector<vector<vector<unsigned int>>>& lod_indices);
+	void compute_bounds();
+	
+	// binary mesh cache: the final vertex and index data is stored next to the model on the first load
+	// and memory-mapped and uploaded directly on subsequent loads
+	bool load_cache(const string& filename, const string& cache_filename, const bool optimized);
+	void write_cache(const string& filename, const string& cache_filename, const vertex_data* vdata,
+					 const vector<vector<const unsigned int*>>& lod_indices, const bool optimized) const;
+	void create_buffers(const vertex_data* vdata,
+						const vector<const unsigned int*>& object_indices,
+						const vector<vector<const unsigned int*>>& lod_indices);
 
 };
 
@@ -0,0 +1,301 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "memory_tracker.hpp"
+#include "oclraster.hpp"
+#include "pipeline/trace_recorder.hpp"
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+mutex memory_tracker::tracker_lock;
+array<memory_tracker::usage, memory_tag_count> memory_tracker::device_usage {};
+array<memory_tracker::usage, memory_tag_count> memory_tracker::host_usage {};
+unordered_map<const opencl::buffer_object*, pair<MEMORY_TAG, size_t>> memory_tracker::allocations;
+atomic<bool> memory_tracker::zero_copy { true };
+unordered_map<const opencl::buffer_object*, pair<void*, size_t>> memory_tracker::zero_copy_memory;
+vector<void*> memory_tracker::deferred_memory;
+size_t memory_tracker::deferred_bytes { 0 };
+
+void memory_tracker::add(usage& tag_usage, const size_t size) {
+	tag_usage.current_bytes += size;
+	tag_usage.peak_bytes = std::max(tag_usage.peak_bytes, tag_usage.current_bytes);
+	tag_usage.allocation_count++;
+	tag_usage.total_allocation_count++;
+}
+
+void memory_tracker::remove(usage& tag_usage, const size_t size) {
+	tag_usage.current_bytes -= std::min(size, tag_usage.current_bytes);
+	if(tag_usage.allocation_count > 0) tag_usage.allocation_count--;
+}
+
+opencl::buffer_object* memory_tracker::create_buffer(const MEMORY_TAG tag,
+													 const opencl::BUFFER_FLAG type,
+													 const size_t size,
+													 const void* data) {
+	typedef underlying_type<opencl::BUFFER_FLAG>::type flag_type;
+	const bool is_cpu = (ocl->get_active_device()->type >= opencl::DEVICE_TYPE::CPU0 &&
+						 ocl->get_active_device()->type <= opencl::DEVICE_TYPE::CPU255);
+	const bool has_initial_copy = ((type & opencl::BUFFER_FLAG::INITIAL_COPY) == opencl::BUFFER_FLAG::INITIAL_COPY);
+	
+	// zero-copy: the buffer uses our own (aligned) host memory, initial data is copied into it directly
+	// note: buffers that already use host memory or don't copy their initial data are left alone
+	void* host_memory = nullptr;
+	if(zero_copy && is_cpu && size > 0 &&
+	   (type & opencl::BUFFER_FLAG::USE_HOST_MEMORY) != opencl::BUFFER_FLAG::USE_HOST_MEMORY &&
+	   (data == nullptr || has_initial_copy)) {
+		host_memory = alloc_zero_copy_memory(size);
+	}
+	
+	opencl::buffer_object* buffer = nullptr;
+	if(host_memory != nullptr) {
+		if(data != nullptr) {
+			memcpy(host_memory, data, size);
+		}
+		const auto host_type = (opencl::BUFFER_FLAG)(((flag_type)type & ~(flag_type)opencl::BUFFER_FLAG::INITIAL_COPY) |
+													 (flag_type)opencl::BUFFER_FLAG::USE_HOST_MEMORY);
+		buffer = ocl->create_buffer(host_type, size, host_memory);
+		if(buffer == nullptr) {
+			free_zero_copy_memory(host_memory);
+		}
+		else {
+			lock_guard<mutex> lock(tracker_lock);
+			zero_copy_memory.emplace(buffer, make_pair(host_memory, size));
+		}
+	}
+	else {
+		buffer = ocl->create_buffer(type, size, data);
+	}
+	
+	if(buffer != nullptr) {
+		track(tag, buffer, size);
+		OCLRASTER_TRACE_INSTANT("create_buffer", "buffer", string(tag_name(tag)) + ": " + size_t2string(size) + " bytes");
+	}
+	return buffer;
+}
+
+void memory_tracker::delete_buffer(opencl::buffer_object* buffer) {
+	if(buffer == nullptr) return;
+	OCLRASTER_TRACE_INSTANT("delete_buffer", "buffer");
+	untrack(buffer);
+	
+	pair<void*, size_t> host_memory { nullptr, 0 };
+	{
+		lock_guard<mutex> lock(tracker_lock);
+		const auto iter = zero_copy_memory.find(buffer);
+		if(iter != zero_copy_memory.end()) {
+			host_memory = iter->second;
+			zero_copy_memory.erase(iter);
+		}
+	}
+	
+	ocl->delete_buffer(buffer);
+	if(host_memory.first != nullptr) {
+		// queued commands might still use this memory -> free it later (see release_deferred)
+		bool force_release = false;
+		{
+			lock_guard<mutex> lock(tracker_lock);
+			deferred_memory.emplace_back(host_memory.first);
+			deferred_bytes += host_memory.second;
+			force_release = (deferred_bytes >= max_deferred_bytes);
+		}
+		// without a swap (e.g. offscreen rendering only), this would grow indefinitely -> wait and free now
+		if(force_release) {
+			ocl->finish();
+			release_deferred();
+		}
+	}
+}
+
+void memory_tracker::release_deferred() {
+	vector<void*> release_memory;
+	{
+		lock_guard<mutex> lock(tracker_lock);
+		release_memory.swap(deferred_memory);
+		deferred_bytes = 0;
+	}
+	for(auto& host_memory : release_memory) {
+		free_zero_copy_memory(host_memory);
+	}
+}
+
+void* memory_tracker::alloc_zero_copy_memory(const size_t size) {
+	// page aligned (most cpu implementations require this for zero-copy), large buffers are aligned to 2 MiB
+	// so that they can be backed by huge pages
+	static constexpr size_t page_size { 4096 };
+	static constexpr size_t huge_page_size { 2u * 1024u * 1024u };
+	const size_t alignment = (size >= huge_page_size ? huge_page_size : page_size);
+	const size_t alloc_size = ((size + alignment - 1) / alignment) * alignment;
+	
+	void* ptr = nullptr;
+#if defined(__WINDOWS__)
+	ptr = _aligned_malloc(alloc_size, alignment);
+#else
+	if(posix_memalign(&ptr, alignment, alloc_size) != 0) ptr = nullptr;
+#endif
+	if(ptr == nullptr) {
+		log_error("failed to allocate %u bytes of zero-copy memory!", alloc_size);
+		return nullptr;
+	}
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	if(alignment == huge_page_size) {
+		// only a hint, failure is not an error (-> normal pages)
+		madvise(ptr, alloc_size, MADV_HUGEPAGE);
+	}
+#endif
+	return ptr;
+}
+
+void memory_tracker::free_zero_copy_memory(void* ptr) {
+#if defined(__WINDOWS__)
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+void memory_tracker::set_zero_copy(const bool state) {
+	zero_copy = state;
+}
+
+bool memory_tracker::get_zero_copy() {
+	return zero_copy;
+}
+
+void memory_tracker::track(const MEMORY_TAG tag, const opencl::buffer_object* buffer, const size_t size) {
+	if(buffer == nullptr) return;
+	lock_guard<mutex> lock(tracker_lock);
+	const auto iter = allocations.find(buffer);
+	if(iter != allocations.end()) {
+		// already tracked -> replace the old allocation
+		remove(device_usage[(size_t)iter->second.first], iter->second.second);
+	}
+	allocations[buffer] = { tag, size };
+	add(device_usage[(size_t)tag], size);
+}
+
+void memory_tracker::untrack(const opencl::buffer_object* buffer) {
+	lock_guard<mutex> lock(tracker_lock);
+	const auto iter = allocations.find(buffer);
+	if(iter == allocations.end()) return;
+	remove(device_usage[(size_t)iter->second.first], iter->second.second);
+	allocations.erase(iter);
+}
+
+void memory_tracker::retag(const opencl::buffer_object* buffer, const MEMORY_TAG tag) {
+	lock_guard<mutex> lock(tracker_lock);
+	const auto iter = allocations.find(buffer);
+	if(iter == allocations.end() || iter->second.first == tag) return;
+	remove(device_usage[(size_t)iter->second.first], iter->second.second);
+	add(device_usage[(size_t)tag], iter->second.second);
+	iter->second.first = tag;
+}
+
+void memory_tracker::add_host(const MEMORY_TAG tag, const size_t size) {
+	lock_guard<mutex> lock(tracker_lock);
+	add(host_usage[(size_t)tag], size);
+}
+
+void memory_tracker::remove_host(const MEMORY_TAG tag, const size_t size) {
+	lock_guard<mutex> lock(tracker_lock);
+	remove(host_usage[(size_t)tag], size);
+}
+
+memory_tracker::usage memory_tracker::get_device_usage(const MEMORY_TAG tag) {
+	lock_guard<mutex> lock(tracker_lock);
+	return device_usage[(size_t)tag];
+}
+
+memory_tracker::usage memory_tracker::get_host_usage(const MEMORY_TAG tag) {
+	lock_guard<mutex> lock(tracker_lock);
+	return host_usage[(size_t)tag];
+}
+
+size_t memory_tracker::get_total_device_bytes() {
+	lock_guard<mutex> lock(tracker_lock);
+	size_t ret = 0;
+	for(const auto& tag_usage : device_usage) {
+		ret += tag_usage.current_bytes;
+	}
+	return ret;
+}
+
+size_t memory_tracker::get_total_host_bytes() {
+	lock_guard<mutex> lock(tracker_lock);
+	size_t ret = 0;
+	for(const auto& tag_usage : host_usage) {
+		ret += tag_usage.current_bytes;
+	}
+	return ret;
+}
+
+void memory_tracker::reset_peaks() {
+	lock_guard<mutex> lock(tracker_lock);
+	for(auto& tag_usage : device_usage) {
+		tag_usage.peak_bytes = tag_usage.current_bytes;
+	}
+	for(auto& tag_usage : host_usage) {
+		tag_usage.peak_bytes = tag_usage.current_bytes;
+	}
+}
+
+void memory_tracker::log_usage() {
+	lock_guard<mutex> lock(tracker_lock);
+	static constexpr double mib { 1.0 / (1024.0 * 1024.0) };
+	log_debug("memory usage (device current/peak, host current/peak):");
+	for(size_t i = 0; i < memory_tag_count; i++) {
+		const usage& dev = device_usage[i];
+		const usage& host = host_usage[i];
+		if(dev.total_allocation_count == 0 && host.total_allocation_count == 0) continue;
+		log_debug("\t%s: %fMiB / %fMiB (%u buffers), %fMiB / %fMiB",
+				  tag_name((MEMORY_TAG)i),
+				  double(dev.current_bytes) * mib, double(dev.peak_bytes) * mib, dev.allocation_count,
+				  double(host.current_bytes) * mib, double(host.peak_bytes) * mib);
+	}
+}
+
+void memory_tracker::log_leaks() {
+	lock_guard<mutex> lock(tracker_lock);
+	if(allocations.empty()) return;
+	array<pair<size_t, size_t>, memory_tag_count> leaks {};
+	for(const auto& alloc : allocations) {
+		leaks[(size_t)alloc.second.first].first++;
+		leaks[(size_t)alloc.second.first].second += alloc.second.second;
+	}
+	for(size_t i = 0; i < memory_tag_count; i++) {
+		if(leaks[i].first == 0) continue;
+		log_error("%u buffers (%u bytes) tagged \"%s\" were not deleted!",
+				  leaks[i].first, leaks[i].second, tag_name((MEMORY_TAG)i));
+	}
+}
+
+const char* memory_tracker::tag_name(const MEMORY_TAG tag) {
+	switch(tag) {
+		case MEMORY_TAG::PIPELINE: return "pipeline";
+		case MEMORY_TAG::PIPELINE_TRANSIENT: return "pipeline-transient";
+		case MEMORY_TAG::BINNING: return "binning";
+		case MEMORY_TAG::FRAMEBUFFER: return "framebuffer";
+		case MEMORY_TAG::IMAGE: return "image";
+		case MEMORY_TAG::PROGRAM: return "program";
+		case MEMORY_TAG::MESH: return "mesh";
+		case MEMORY_TAG::GUI: return "gui";
+		case MEMORY_TAG::OTHER: return "other";
+		case MEMORY_TAG::__MAX_MEMORY_TAG: floor_unreachable();
+	}
+	floor_unreachable();
+}
@@ -0,0 +1,120 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_MEMORY_TRACKER_HPP__
+#define __OCLRASTER_MEMORY_TRACKER_HPP__
+
+#include "oclraster/global.hpp"
+#include "cl/opencl.hpp"
+
+// subsystem an allocation belongs to
+enum class MEMORY_TAG : unsigned int {
+	PIPELINE,			//!< persistent pipeline buffers (camera, counters, statistics, ...)
+	PIPELINE_TRANSIENT,	//!< per draw call buffers (transformed vertices/primitives, bounds, user outputs)
+	BINNING,			//!< bin queues
+	FRAMEBUFFER,		//!< framebuffer images
+	IMAGE,				//!< all other images
+	PROGRAM,			//!< program/struct layout probe buffers
+	MESH,				//!< model data (device buffers and host-side copies)
+	GUI,				//!< oclraster_support gui and 2d rendering buffers
+	OTHER,				//!< anything that isn't explicitly tagged
+	__MAX_MEMORY_TAG
+};
+static constexpr size_t memory_tag_count { (size_t)MEMORY_TAG::__MAX_MEMORY_TAG };
+
+// keeps track of the current and peak device and host memory usage of each subsystem.
+// device buffers must be created and deleted through this class to be accounted for (buffers
+// that are created otherwise, e.g. mapped or image buffers, can be added via track()).
+// host memory is only accounted for where it is explicitly reported via add_host/remove_host.
+// NOTE: sub-buffers don't allocate any memory and must not be tracked.
+class memory_tracker {
+public:
+	struct usage {
+		size_t current_bytes;
+		size_t peak_bytes;
+		size_t allocation_count; //!< currently live allocations
+		size_t total_allocation_count; //!< all allocations so far
+	};
+	
+	// device memory
+	static opencl::buffer_object* create_buffer(const MEMORY_TAG tag,
+												const opencl::BUFFER_FLAG type,
+												const size_t size,
+												const void* data = nullptr);
+	// deletes the buffer (also works for untracked buffers)
+	static void delete_buffer(opencl::buffer_object* buffer);
+	static void track(const MEMORY_TAG tag, const opencl::buffer_object* buffer, const size_t size);
+	static void untrack(const opencl::buffer_object* buffer);
+	// moves a tracked buffer to a different tag (peak of the new tag is updated accordingly)
+	static void retag(const opencl::buffer_object* buffer, const MEMORY_TAG tag);
+	
+	// zero-copy allocation policy for cpu devices: buffers created through create_buffer use host memory
+	// directly (USE_HOST_MEMORY) that is page aligned (2 MiB aligned and backed by transparent huge pages
+	// for buffers >= 2 MiB on linux). mapping such a buffer doesn't copy anything, and kernels work directly
+	// on that memory (-> no map/read/write copies for images, framebuffers and the swap blit, fewer tlb misses).
+	// enabled by default, only has an effect when the active device is a cpu (at buffer creation time).
+	static void set_zero_copy(const bool state);
+	static bool get_zero_copy();
+	// the host memory of deleted zero-copy buffers is only freed by this (must only be called when all commands
+	// that were enqueued before the deletion have completed, this is done on each pipeline swap)
+	static void release_deferred();
+	
+	// host memory
+	static void add_host(const MEMORY_TAG tag, const size_t size);
+	static void remove_host(const MEMORY_TAG tag, const size_t size);
+	
+	//
+	static usage get_device_usage(const MEMORY_TAG tag);
+	static usage get_host_usage(const MEMORY_TAG tag);
+	static size_t get_total_device_bytes();
+	static size_t get_total_host_bytes();
+	// resets the peak usage of all tags to their current usage
+	static void reset_peaks();
+	
+	// writes the usage of all tags to the debug log
+	static void log_usage();
+	// logs all allocations that are still alive (called on oclraster::destroy)
+	static void log_leaks();
+	
+	static const char* tag_name(const MEMORY_TAG tag);
+
+protected:
+	memory_tracker() = delete;
+	~memory_tracker() = delete;
+	memory_tracker& operator=(const memory_tracker&) = delete;
+	
+	static mutex tracker_lock;
+	static array<usage, memory_tag_count> device_usage;
+	static array<usage, memory_tag_count> host_usage;
+	static unordered_map<const opencl::buffer_object*, pair<MEMORY_TAG, size_t>> allocations;
+	
+	static atomic<bool> zero_copy;
+	// host memory of zero-copy buffers (freed when the buffer is deleted)
+	static unordered_map<const opencl::buffer_object*, pair<void*, size_t>> zero_copy_memory;
+	static vector<void*> deferred_memory;
+	static size_t deferred_bytes;
+	static constexpr size_t max_deferred_bytes { 256u * 1024u * 1024u };
+	static void* alloc_zero_copy_memory(const size_t size);
+	static void free_zero_copy_memory(void* ptr);
+	
+	static void add(usage& tag_usage, const size_t size);
+	static void remove(usage& tag_usage, const size_t size);
+	
+};
+
+#endif
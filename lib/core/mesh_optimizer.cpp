@@ -0,0 +1,576 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "mesh_optimizer.hpp"
+
+// forsyth vertex cache optimization parameters
+static constexpr size_t forsyth_cache_size { 32 };
+static constexpr float forsyth_cache_decay_power { 1.5f };
+static constexpr float forsyth_last_triangle_score { 0.75f };
+static constexpr float forsyth_valence_boost_scale { 2.0f };
+static constexpr float forsyth_valence_boost_power { 0.5f };
+
+static float forsyth_vertex_score(const int cache_position, const unsigned int remaining_valence) {
+	// vertices without any remaining triangles are never used again
+	if(remaining_valence == 0) return -1.0f;
+	
+	float score = 0.0f;
+	if(cache_position >= 0) {
+		if(cache_position < 3) {
+			// used by the last triangle: fixed score, so that the vertices of a strip-like triangle order
+			// are not preferred too much
+			score = forsyth_last_triangle_score;
+		}
+		else {
+			const float scale = 1.0f / float(forsyth_cache_size - 3);
+			score = powf(1.0f - float(cache_position - 3) * scale, forsyth_cache_decay_power);
+		}
+	}
+	
+	// boost vertices with only a few remaining triangles, so that they are finished off first
+	score += forsyth_valence_boost_scale * powf(float(remaining_valence), -forsyth_valence_boost_power);
+	return score;
+}
+
+void mesh_optimizer::optimize_vertex_cache(unsigned int* indices, const size_t triangle_count, const size_t vertex_count) {
+	if(triangle_count == 0 || vertex_count == 0) return;
+	const size_t index_count = triangle_count * 3;
+	
+	// vertex -> triangle adjacency (only the first "valence" entries of each vertex are still live)
+	vector<unsigned int> valence(vertex_count, 0);
+	for(size_t i = 0; i < index_count; i++) {
+		valence[indices[i]]++;
+	}
+	vector<unsigned int> adjacency_offset(vertex_count + 1, 0);
+	for(size_t i = 0; i < vertex_count; i++) {
+		adjacency_offset[i + 1] = adjacency_offset[i] + valence[i];
+	}
+	vector<unsigned int> adjacency(index_count);
+	{
+		vector<unsigned int> fill_offset(adjacency_offset.cbegin(), adjacency_offset.cend() - 1);
+		for(size_t i = 0; i < index_count; i++) {
+			adjacency[fill_offset[indices[i]]++] = (unsigned int)(i / 3);
+		}
+	}
+	
+	vector<int> cache_position(vertex_count, -1);
+	vector<float> vertex_score(vertex_count);
+	for(size_t i = 0; i < vertex_count; i++) {
+		vertex_score[i] = forsyth_vertex_score(-1, valence[i]);
+	}
+	vector<bool> emitted(triangle_count, false);
+	
+	vector<unsigned int> output;
+	output.reserve(index_count);
+	array<unsigned int, forsyth_cache_size + 3> cache, new_cache;
+	size_t cache_count = 0;
+	size_t scan_offset = 0;
+	unsigned int best_triangle = ~0u;
+	while(output.size() < index_count) {
+		if(best_triangle == ~0u) {
+			// no candidate in the cache (start or a new mesh island) -> continue with the next triangle
+			// in input order (deterministic and O(n) in total, unlike a search for the best triangle)
+			while(emitted[scan_offset]) scan_offset++;
+			best_triangle = (unsigned int)scan_offset;
+		}
+		
+		emitted[best_triangle] = true;
+		const unsigned int* triangle = &indices[best_triangle * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+		
+		// new cache order: the vertices of the emitted triangle, then the previous cache contents
+		size_t new_cache_count = 0;
+		for(size_t i = 0; i < 3; i++) {
+			if(find(new_cache.begin(), new_cache.begin() + (ptrdiff_t)new_cache_count, triangle[i]) ==
+			   new_cache.begin() + (ptrdiff_t)new_cache_count) {
+				new_cache[new_cache_count++] = triangle[i];
+			}
+		}
+		for(size_t i = 0; i < cache_count; i++) {
+			if(cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2]) {
+				new_cache[new_cache_count++] = cache[i];
+			}
+		}
+		
+		// remove the emitted triangle from the adjacency of its vertices
+		for(size_t i = 0; i < 3; i++) {
+			unsigned int* vertex_adjacency = &adjacency[adjacency_offset[triangle[i]]];
+			const unsigned int live_count = valence[triangle[i]];
+			for(unsigned int j = 0; j < live_count; j++) {
+				if(vertex_adjacency[j] == best_triangle) {
+					vertex_adjacency[j] = vertex_adjacency[live_count - 1];
+					valence[triangle[i]]--;
+					break;
+				}
+			}
+		}
+		
+		// update the scores of all vertices that are or were in the cache (vertices beyond the cache size drop out)
+		for(size_t i = 0; i < new_cache_count; i++) {
+			const unsigned int vertex = new_cache[i];
+			cache_position[vertex] = (i < forsyth_cache_size ? (int)i : -1);
+			vertex_score[vertex] = forsyth_vertex_score(cache_position[vertex], valence[vertex]);
+		}
+		
+		// update the scores of all affected triangles and pick the best one as the next triangle
+		best_triangle = ~0u;
+		float best_score = -1.0f;
+		for(size_t i = 0; i < new_cache_count; i++) {
+			const unsigned int vertex = new_cache[i];
+			const unsigned int* vertex_adjacency = &adjacency[adjacency_offset[vertex]];
+			for(unsigned int j = 0; j < valence[vertex]; j++) {
+				const unsigned int tri = vertex_adjacency[j];
+				const float score = (vertex_score[indices[tri * 3]] +
+									 vertex_score[indices[tri * 3 + 1]] +
+									 vertex_score[indices[tri * 3 + 2]]);
+				if(score > best_score) {
+					best_score = score;
+					best_triangle = tri;
+				}
+			}
+		}
+		
+		cache_count = std::min(new_cache_count, forsyth_cache_size);
+		copy(new_cache.cbegin(), new_cache.cbegin() + (ptrdiff_t)cache_count, cache.begin());
+	}
+	
+	copy(output.cbegin(), output.cend(), indices);
+}
+
+// interleaves the lower 10 bits of v with two zero bits each
+static unsigned int morton_spread(unsigned int v) {
+	v &= 0x3FFu;
+	v = (v | (v << 16u)) & 0x030000FFu;
+	v = (v | (v << 8u)) & 0x0300F00Fu;
+	v = (v | (v << 4u)) & 0x030C30C3u;
+	v = (v | (v << 2u)) & 0x09249249u;
+	return v;
+}
+
+void mesh_optimizer::optimize_locality(unsigned int* indices, const size_t triangle_count,
+									   const float* positions, const size_t position_stride,
+									   const size_t batch_size) {
+	if(triangle_count == 0 || batch_size == 0) return;
+	const auto get_position = [&positions, &position_stride](const unsigned int index) {
+		return (const float*)((const unsigned char*)positions + size_t(index) * position_stride);
+	};
+	
+	// triangle centroids and their bounding box
+	vector<float3> centroids(triangle_count);
+	float3 bbox_min { numeric_limits<float>::max(), numeric_limits<float>::max(), numeric_limits<float>::max() };
+	float3 bbox_max { -numeric_limits<float>::max(), -numeric_limits<float>::max(), -numeric_limits<float>::max() };
+	for(size_t i = 0; i < triangle_count; i++) {
+		const float* v0 = get_position(indices[i * 3]);
+		const float* v1 = get_position(indices[i * 3 + 1]);
+		const float* v2 = get_position(indices[i * 3 + 2]);
+		float3& centroid = centroids[i];
+		centroid.x = (v0[0] + v1[0] + v2[0]) * (1.0f / 3.0f);
+		centroid.y = (v0[1] + v1[1] + v2[1]) * (1.0f / 3.0f);
+		centroid.z = (v0[2] + v1[2] + v2[2]) * (1.0f / 3.0f);
+		bbox_min.x = std::min(bbox_min.x, centroid.x);
+		bbox_min.y = std::min(bbox_min.y, centroid.y);
+		bbox_min.z = std::min(bbox_min.z, centroid.z);
+		bbox_max.x = std::max(bbox_max.x, centroid.x);
+		bbox_max.y = std::max(bbox_max.y, centroid.y);
+		bbox_max.z = std::max(bbox_max.z, centroid.z);
+	}
+	
+	// sort along a 30-bit morton curve (ties are resolved by the triangle index -> deterministic)
+	const float extent = std::max(std::max(bbox_max.x - bbox_min.x, bbox_max.y - bbox_min.y),
+								  std::max(bbox_max.z - bbox_min.z, numeric_limits<float>::min()));
+	const float scale = 1023.0f / extent;
+	vector<pair<unsigned int, unsigned int>> keys(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		const unsigned int x = (unsigned int)((centroids[i].x - bbox_min.x) * scale);
+		const unsigned int y = (unsigned int)((centroids[i].y - bbox_min.y) * scale);
+		const unsigned int z = (unsigned int)((centroids[i].z - bbox_min.z) * scale);
+		keys[i] = { morton_spread(x) | (morton_spread(y) << 1u) | (morton_spread(z) << 2u), (unsigned int)i };
+	}
+	sort(keys.begin(), keys.end());
+	
+	vector<unsigned int> sorted_indices(triangle_count * 3);
+	for(size_t i = 0; i < triangle_count; i++) {
+		const unsigned int tri = keys[i].second;
+		sorted_indices[i * 3] = indices[tri * 3];
+		sorted_indices[i * 3 + 1] = indices[tri * 3 + 1];
+		sorted_indices[i * 3 + 2] = indices[tri * 3 + 2];
+	}
+	copy(sorted_indices.cbegin(), sorted_indices.cend(), indices);
+	
+	// vertex cache optimization within each batch (on batch local vertex indices)
+	vector<unsigned int> batch_vertices, batch_indices;
+	for(size_t batch_start = 0; batch_start < triangle_count; batch_start += batch_size) {
+		const size_t batch_triangle_count = std::min(batch_size, triangle_count - batch_start);
+		unsigned int* batch = indices + batch_start * 3;
+		
+		batch_vertices.assign(batch, batch + batch_triangle_count * 3);
+		sort(batch_vertices.begin(), batch_vertices.end());
+		batch_vertices.erase(unique(batch_vertices.begin(), batch_vertices.end()), batch_vertices.end());
+		
+		batch_indices.resize(batch_triangle_count * 3);
+		for(size_t i = 0; i < batch_triangle_count * 3; i++) {
+			batch_indices[i] = (unsigned int)(lower_bound(batch_vertices.cbegin(), batch_vertices.cend(), batch[i]) -
+											  batch_vertices.cbegin());
+		}
+		optimize_vertex_cache(&batch_indices[0], batch_triangle_count, batch_vertices.size());
+		for(size_t i = 0; i < batch_triangle_count * 3; i++) {
+			batch[i] = batch_vertices[batch_indices[i]];
+		}
+	}
+}
+
+vector<unsigned int> mesh_optimizer::optimize_vertex_fetch(const vector<pair<unsigned int*, size_t>>& index_buffers,
+														   const size_t vertex_count) {
+	vector<unsigned int> remap(vertex_count, ~0u);
+	unsigned int next_vertex = 0;
+	for(const auto& index_buffer : index_buffers) {
+		for(size_t i = 0, count = index_buffer.second * 3; i < count; i++) {
+			unsigned int& index = index_buffer.first[i];
+			if(remap[index] == ~0u) {
+				remap[index] = next_vertex++;
+			}
+			index = remap[index];
+		}
+	}
+	for(auto& vertex : remap) {
+		if(vertex == ~0u) vertex = next_vertex++;
+	}
+	return remap;
+}
+
+vector<mesh_cluster> mesh_optimizer::build_clusters(const unsigned int* indices, const size_t triangle_count,
+													const float* positions, const size_t position_stride,
+													const size_t cluster_size) {
+	vector<mesh_cluster> clusters;
+	if(triangle_count == 0 || cluster_size == 0) return clusters;
+	const auto get_position = [&positions, &position_stride](const unsigned int index) {
+		const float* pos = (const float*)((const unsigned char*)positions + size_t(index) * position_stride);
+		return float3 { pos[0], pos[1], pos[2] };
+	};
+	
+	vector<float3> normals;
+	for(size_t offset = 0; offset < triangle_count; offset += cluster_size) {
+		mesh_cluster cluster;
+		cluster.triangle_offset = (unsigned int)offset;
+		cluster.triangle_count = (unsigned int)std::min(cluster_size, triangle_count - offset);
+		cluster._unused[0] = 0;
+		cluster._unused[1] = 0;
+		const unsigned int* cluster_indices = indices + offset * 3;
+		const size_t index_count = size_t(cluster.triangle_count) * 3;
+		
+		// bounding sphere: center of the bounding box + max vertex distance
+		float3 bbox_min = get_position(cluster_indices[0]);
+		float3 bbox_max = bbox_min;
+		for(size_t i = 1; i < index_count; i++) {
+			const float3 pos = get_position(cluster_indices[i]);
+			bbox_min.x = std::min(bbox_min.x, pos.x);
+			bbox_min.y = std::min(bbox_min.y, pos.y);
+			bbox_min.z = std::min(bbox_min.z, pos.z);
+			bbox_max.x = std::max(bbox_max.x, pos.x);
+			bbox_max.y = std::max(bbox_max.y, pos.y);
+			bbox_max.z = std::max(bbox_max.z, pos.z);
+		}
+		const float3 center { (bbox_min.x + bbox_max.x) * 0.5f, (bbox_min.y + bbox_max.y) * 0.5f, (bbox_min.z + bbox_max.z) * 0.5f };
+		float radius_sq = 0.0f;
+		for(size_t i = 0; i < index_count; i++) {
+			const float3 pos = get_position(cluster_indices[i]);
+			const float3 diff { pos.x - center.x, pos.y - center.y, pos.z - center.z };
+			radius_sq = std::max(radius_sq, diff.x * diff.x + diff.y * diff.y + diff.z * diff.z);
+		}
+		cluster.sphere = float4 { center.x, center.y, center.z, sqrtf(radius_sq) };
+		
+		// normal cone (front faces are wound counter-clockwise -> normals point towards the camera)
+		normals.clear();
+		float3 axis { 0.0f, 0.0f, 0.0f };
+		for(size_t i = 0; i < index_count; i += 3) {
+			const float3 v0 = get_position(cluster_indices[i]);
+			const float3 v1 = get_position(cluster_indices[i + 1]);
+			const float3 v2 = get_position(cluster_indices[i + 2]);
+			const float3 e0 { v1.x - v0.x, v1.y - v0.y, v1.z - v0.z };
+			const float3 e1 { v2.x - v0.x, v2.y - v0.y, v2.z - v0.z };
+			float3 normal { e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+			const float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			if(length <= 0.0f) continue; // degenerate triangles are never visible
+			normal.x /= length;
+			normal.y /= length;
+			normal.z /= length;
+			normals.emplace_back(normal);
+			axis.x += normal.x;
+			axis.y += normal.y;
+			axis.z += normal.z;
+		}
+		cluster.cone = float4 { 0.0f, 0.0f, 0.0f, 1.0f };
+		const float axis_length = sqrtf(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+		if(!normals.empty() && axis_length > 0.0f) {
+			axis.x /= axis_length;
+			axis.y /= axis_length;
+			axis.z /= axis_length;
+			float min_dot = 1.0f;
+			for(const auto& normal : normals) {
+				min_dot = std::min(min_dot, normal.x * axis.x + normal.y * axis.y + normal.z * axis.z);
+			}
+			// cones wider than ~84 degrees would hardly ever be culled
+			if(min_dot > 0.1f) {
+				cluster.cone = float4 { axis.x, axis.y, axis.z, sqrtf(1.0f - min_dot * min_dot) };
+			}
+		}
+		clusters.emplace_back(cluster);
+	}
+	return clusters;
+}
+
+// symmetric 4x4 quadric: a², ab, ac, ad, b², bc, bd, c², cd, d²
+struct quadric {
+	array<double, 10> q {};
+	
+	static quadric from_plane(const double a, const double b, const double c, const double d) {
+		quadric ret;
+		ret.q = {{ a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d }};
+		return ret;
+	}
+	quadric& operator+=(const quadric& other) {
+		for(size_t i = 0; i < q.size(); i++) q[i] += other.q[i];
+		return *this;
+	}
+	// squared distance sum of the point to all accumulated planes
+	double evaluate(const double x, const double y, const double z) const {
+		const double err = (q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x +
+							q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y +
+							q[7] * z * z + 2.0 * q[8] * z +
+							q[9]);
+		return std::max(err, 0.0);
+	}
+};
+
+float mesh_optimizer::simplify(vector<unsigned int>& indices,
+							   const float* positions, const size_t position_stride, const size_t vertex_count,
+							   const size_t target_triangle_count) {
+	if(indices.size() / 3 <= target_triangle_count || vertex_count == 0) return 0.0f;
+	const auto get_position = [&positions, &position_stride](const unsigned int index) {
+		const float* pos = (const float*)((const unsigned char*)positions + size_t(index) * position_stride);
+		return float3 { pos[0], pos[1], pos[2] };
+	};
+	const auto triangle_normal = [](const float3& v0, const float3& v1, const float3& v2) {
+		const float3 e0 { v1.x - v0.x, v1.y - v0.y, v1.z - v0.z };
+		const float3 e1 { v2.x - v0.x, v2.y - v0.y, v2.z - v0.z };
+		return float3 { e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+	};
+	
+	// lock vertices that share their position with other vertices (texture coordinate seams): moving them would
+	// tear the mesh apart, since their copies would be collapsed differently
+	vector<bool> locked(vertex_count, false);
+	{
+		vector<unsigned int> sorted_vertices(indices.cbegin(), indices.cend());
+		sort(sorted_vertices.begin(), sorted_vertices.end());
+		sorted_vertices.erase(unique(sorted_vertices.begin(), sorted_vertices.end()), sorted_vertices.end());
+		const auto position_less = [&get_position](const unsigned int& lhs, const unsigned int& rhs) {
+			const float3 lpos = get_position(lhs), rpos = get_position(rhs);
+			if(lpos.x != rpos.x) return lpos.x < rpos.x;
+			if(lpos.y != rpos.y) return lpos.y < rpos.y;
+			return lpos.z < rpos.z;
+		};
+		stable_sort(sorted_vertices.begin(), sorted_vertices.end(), position_less);
+		for(size_t i = 1; i < sorted_vertices.size(); i++) {
+			if(!position_less(sorted_vertices[i - 1], sorted_vertices[i])) {
+				locked[sorted_vertices[i - 1]] = true;
+				locked[sorted_vertices[i]] = true;
+			}
+		}
+	}
+	
+	// lock border vertices (edges that are only used by one triangle), so that the silhouette doesn't shrink
+	{
+		vector<pair<unsigned int, unsigned int>> edges;
+		edges.reserve(indices.size());
+		for(size_t i = 0; i < indices.size(); i += 3) {
+			for(size_t j = 0; j < 3; j++) {
+				const unsigned int v0 = indices[i + j], v1 = indices[i + (j + 1) % 3];
+				edges.emplace_back(std::min(v0, v1), std::max(v0, v1));
+			}
+		}
+		sort(edges.begin(), edges.end());
+		for(size_t i = 0; i < edges.size(); ) {
+			size_t j = i + 1;
+			while(j < edges.size() && edges[j] == edges[i]) j++;
+			if(j - i == 1) {
+				locked[edges[i].first] = true;
+				locked[edges[i].second] = true;
+			}
+			i = j;
+		}
+	}
+	
+	// initial vertex quadrics: sum of the planes of all adjacent triangles
+	vector<quadric> quadrics(vertex_count);
+	for(size_t i = 0; i < indices.size(); i += 3) {
+		const float3 v0 = get_position(indices[i]);
+		const float3 normal = triangle_normal(v0, get_position(indices[i + 1]), get_position(indices[i + 2]));
+		const double length = sqrt(double(normal.x) * double(normal.x) +
+								   double(normal.y) * double(normal.y) +
+								   double(normal.z) * double(normal.z));
+		if(length <= 0.0) continue;
+		const double a = normal.x / length, b = normal.y / length, c = normal.z / length;
+		const quadric plane = quadric::from_plane(a, b, c, -(a * v0.x + b * v0.y + c * v0.z));
+		for(size_t j = 0; j < 3; j++) {
+			quadrics[indices[i + j]] += plane;
+		}
+	}
+	
+	// collapse edges in passes: each pass collapses the cheapest edges whose neighborhoods don't overlap
+	// (-> no priority queue updates necessary), until the target triangle count is reached or nothing can be collapsed
+	struct collapse {
+		double cost;
+		unsigned int from;
+		unsigned int to;
+		bool operator<(const collapse& other) const {
+			if(cost != other.cost) return cost < other.cost;
+			if(from != other.from) return from < other.from;
+			return to < other.to;
+		}
+	};
+	static constexpr float max_normal_rotation_cos_sq { 0.25f }; // 60°
+	vector<unsigned int> remap(vertex_count);
+	vector<bool> touched(vertex_count);
+	vector<unsigned int> adjacency_offset(vertex_count + 1), adjacency;
+	vector<pair<unsigned int, unsigned int>> edges;
+	vector<collapse> collapses;
+	double max_cost = 0.0;
+	for(;;) {
+		const size_t triangle_count = indices.size() / 3;
+		if(triangle_count <= target_triangle_count) break;
+		
+		// vertex -> triangle adjacency
+		fill(adjacency_offset.begin(), adjacency_offset.end(), 0u);
+		for(const auto& index : indices) adjacency_offset[index + 1]++;
+		for(size_t i = 0; i < vertex_count; i++) adjacency_offset[i + 1] += adjacency_offset[i];
+		adjacency.resize(indices.size());
+		{
+			vector<unsigned int> fill_offset(adjacency_offset.cbegin(), adjacency_offset.cend() - 1);
+			for(size_t i = 0; i < indices.size(); i++) {
+				adjacency[fill_offset[indices[i]]++] = (unsigned int)(i / 3);
+			}
+		}
+		
+		// collapse candidates: the cheaper direction of each (unique) edge
+		edges.clear();
+		for(size_t i = 0; i < indices.size(); i += 3) {
+			for(size_t j = 0; j < 3; j++) {
+				const unsigned int v0 = indices[i + j], v1 = indices[i + (j + 1) % 3];
+				edges.emplace_back(std::min(v0, v1), std::max(v0, v1));
+			}
+		}
+		sort(edges.begin(), edges.end());
+		edges.erase(unique(edges.begin(), edges.end()), edges.end());
+		collapses.clear();
+		for(const auto& edge : edges) {
+			if(locked[edge.first] && locked[edge.second]) continue;
+			quadric combined = quadrics[edge.first];
+			combined += quadrics[edge.second];
+			const float3 p0 = get_position(edge.first), p1 = get_position(edge.second);
+			const double cost_to_second = (locked[edge.first] ? numeric_limits<double>::max() : combined.evaluate(p1.x, p1.y, p1.z));
+			const double cost_to_first = (locked[edge.second] ? numeric_limits<double>::max() : combined.evaluate(p0.x, p0.y, p0.z));
+			if(cost_to_second <= cost_to_first) {
+				collapses.emplace_back(collapse { cost_to_second, edge.first, edge.second });
+			}
+			else {
+				collapses.emplace_back(collapse { cost_to_first, edge.second, edge.first });
+			}
+		}
+		sort(collapses.begin(), collapses.end());
+		
+		// collapse
+		for(size_t i = 0; i < vertex_count; i++) remap[i] = (unsigned int)i;
+		fill(touched.begin(), touched.end(), false);
+		const size_t remove_count = triangle_count - target_triangle_count;
+		size_t removed_count = 0;
+		size_t collapse_count = 0;
+		for(const auto& col : collapses) {
+			if(removed_count >= remove_count) break;
+			if(touched[col.from] || touched[col.to]) continue;
+			
+			// triangles around "from" must not flip, rotate too much or become degenerate when "from" is moved to "to"
+			bool valid = true;
+			size_t collapsed_triangles = 0;
+			const float3 to_pos = get_position(col.to);
+			for(unsigned int j = adjacency_offset[col.from]; j < adjacency_offset[col.from + 1]; j++) {
+				const unsigned int* tri = &indices[adjacency[j] * 3];
+				if(tri[0] == col.to || tri[1] == col.to || tri[2] == col.to) {
+					collapsed_triangles++;
+					continue;
+				}
+				array<float3, 3> tri_pos {{ get_position(tri[0]), get_position(tri[1]), get_position(tri[2]) }};
+				const float3 old_normal = triangle_normal(tri_pos[0], tri_pos[1], tri_pos[2]);
+				for(size_t k = 0; k < 3; k++) {
+					if(tri[k] == col.from) tri_pos[k] = to_pos;
+				}
+				const float3 new_normal = triangle_normal(tri_pos[0], tri_pos[1], tri_pos[2]);
+				const float old_length_sq = old_normal.x * old_normal.x + old_normal.y * old_normal.y + old_normal.z * old_normal.z;
+				const float new_length_sq = new_normal.x * new_normal.x + new_normal.y * new_normal.y + new_normal.z * new_normal.z;
+				const float normal_dot = old_normal.x * new_normal.x + old_normal.y * new_normal.y + old_normal.z * new_normal.z;
+				if(normal_dot <= 0.0f || normal_dot * normal_dot < max_normal_rotation_cos_sq * old_length_sq * new_length_sq) {
+					valid = false;
+					break;
+				}
+			}
+			if(!valid) continue;
+			
+			remap[col.from] = col.to;
+			quadrics[col.to] += quadrics[col.from];
+			max_cost = std::max(max_cost, col.cost);
+			removed_count += collapsed_triangles;
+			collapse_count++;
+			for(unsigned int j = adjacency_offset[col.from]; j < adjacency_offset[col.from + 1]; j++) {
+				const unsigned int* tri = &indices[adjacency[j] * 3];
+				touched[tri[0]] = true;
+				touched[tri[1]] = true;
+				touched[tri[2]] = true;
+			}
+		}
+		if(collapse_count == 0) break;
+		
+		// apply the collapses and remove all degenerate triangles (the triangle order is kept)
+		size_t write_offset = 0;
+		for(size_t i = 0; i < indices.size(); i += 3) {
+			const unsigned int v0 = remap[indices[i]], v1 = remap[indices[i + 1]], v2 = remap[indices[i + 2]];
+			if(v0 == v1 || v1 == v2 || v0 == v2) continue;
+			indices[write_offset++] = v0;
+			indices[write_offset++] = v1;
+			indices[write_offset++] = v2;
+		}
+		indices.resize(write_offset);
+	}
+	return (float)sqrt(max_cost);
+}
+
+float mesh_optimizer::compute_acmr(const unsigned int* indices, const size_t triangle_count,
+								   const size_t vertex_count, const size_t cache_size) {
+	if(triangle_count == 0) return 0.0f;
+	
+	// fifo simulation via timestamps: a vertex is in the cache if it was inserted less than cache_size misses ago
+	vector<size_t> cache_timestamp(vertex_count, 0);
+	size_t timestamp = cache_size + 1;
+	size_t miss_count = 0;
+	for(size_t i = 0, index_count = triangle_count * 3; i < index_count; i++) {
+		const unsigned int index = indices[i];
+		if(timestamp - cache_timestamp[index] > cache_size) {
+			cache_timestamp[index] = timestamp++;
+			miss_count++;
+		}
+	}
+	return float(miss_count) / float(triangle_count);
+}
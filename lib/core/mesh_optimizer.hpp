@@ -0,0 +1,90 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_MESH_OPTIMIZER_HPP__
+#define __OCLRASTER_MESH_OPTIMIZER_HPP__
+
+#include "oclraster/global.hpp"
+#include "core/vector3.hpp"
+#include "core/vector4.hpp"
+
+// bounds of a cluster ("meshlet") of consecutive triangles of an index buffer (in object space),
+// used to cull whole clusters before primitive processing (see pipeline::draw_clusters)
+struct mesh_cluster {
+	float4 sphere; // .xyz = center, .w = radius
+	// normal cone: .xyz = normalized axis, .w = cutoff (sine of the cone half-angle)
+	// -> all triangles are back-facing if dot(center - camera, axis) >= cutoff * |center - camera| + radius
+	// (axis = 0 and cutoff = 1 if the triangle normals diverge too much -> never back-face culled)
+	float4 cone;
+	unsigned int triangle_offset;
+	unsigned int triangle_count;
+	unsigned int _unused[2];
+};
+
+// offline mesh optimizations for triangle lists (3 indices per triangle), which are applied when a
+// model is loaded (and then stored in the binary mesh cache)
+// NOTE: the transform stage transforms each vertex exactly once, so there is no post-transform cache
+// to optimize for. however, the processing, binning and rasterization stages fetch the transformed
+// vertices and user outputs by index -> better index locality directly reduces memory bandwidth there.
+class mesh_optimizer {
+public:
+	// reorders the triangles for vertex cache efficiency (tom forsyth's "linear-speed vertex cache optimisation")
+	static void optimize_vertex_cache(unsigned int* indices, const size_t triangle_count, const size_t vertex_count);
+	
+	// sorts the triangles along a morton curve of their centroids, splits them into batches of batch_size
+	// triangles (default: the primitive count of one binning batch) and optimizes each batch for vertex
+	// cache efficiency -> each binning batch covers a compact area of the screen and touches fewer bins.
+	// position_stride is the byte distance between two consecutive positions (3 floats).
+	static void optimize_locality(unsigned int* indices, const size_t triangle_count,
+								  const float* positions, const size_t position_stride,
+								  const size_t batch_size = OCLRASTER_BATCH_PRIMITIVE_COUNT);
+	
+	// renumbers all vertices in the order of their first use (over all specified index buffers, in order)
+	// and rewrites the indices accordingly. returns the old -> new vertex mapping, which must be applied to
+	// the vertex data (unreferenced vertices are moved to the end).
+	static vector<unsigned int> optimize_vertex_fetch(const vector<pair<unsigned int*, size_t>>& index_buffers,
+													  const size_t vertex_count);
+	
+	// splits the triangles into clusters of (at most) cluster_size consecutive triangles and computes their
+	// bounding spheres and normal cones (call this after optimize_locality, so that the clusters are compact)
+	static vector<mesh_cluster> build_clusters(const unsigned int* indices, const size_t triangle_count,
+											   const float* positions, const size_t position_stride,
+											   const size_t cluster_size = 128);
+	
+	// simplifies the triangles to (at most) target_triangle_count triangles with quadric error metric based edge
+	// collapses (garland and heckbert), reusing the existing vertices -> the result is a lod index buffer for the
+	// same vertex data. border vertices and vertices that share their position with another vertex (attribute
+	// seams) are never moved, so the result may contain more triangles than requested.
+	// returns the geometric error of the simplified triangles (object space distance).
+	static float simplify(vector<unsigned int>& indices,
+						  const float* positions, const size_t position_stride, const size_t vertex_count,
+						  const size_t target_triangle_count);
+	
+	// average cache miss ratio (vertices fetched per triangle) of a fifo cache with cache_size entries:
+	// 3.0 is the worst case, ~0.5 is the optimum for large regular meshes
+	static float compute_acmr(const unsigned int* indices, const size_t triangle_count,
+							  const size_t vertex_count, const size_t cache_size = 32);
+
+protected:
+	mesh_optimizer() = delete;
+	~mesh_optimizer() = delete;
+	mesh_optimizer& operator=(const mesh_optimizer&) = delete;
+	
+};
+
+#endif
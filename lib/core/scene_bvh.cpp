@@ -0,0 +1,307 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "scene_bvh.hpp"
+
+static float surface_area(const float3& bmin, const float3& bmax) {
+	const float3 size { bmax.x - bmin.x, bmax.y - bmin.y, bmax.z - bmin.z };
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+scene_bvh::scene_bvh(const float bounds_margin) : margin(bounds_margin) {
+}
+
+scene_bvh::~scene_bvh() {
+}
+
+unsigned int scene_bvh::allocate_node() {
+	if(free_list != null_node) {
+		const unsigned int index = free_list;
+		free_list = nodes[index].parent;
+		return index;
+	}
+	nodes.emplace_back();
+	return (unsigned int)(nodes.size() - 1);
+}
+
+void scene_bvh::free_node(const unsigned int& index) {
+	nodes[index].parent = free_list;
+	nodes[index].height = null_node;
+	free_list = index;
+}
+
+unsigned int scene_bvh::add(const float3& bmin, const float3& bmax, draw_function draw) {
+	unsigned int id;
+	if(!free_draws.empty()) {
+		id = free_draws.back();
+		free_draws.pop_back();
+	}
+	else {
+		id = (unsigned int)draws.size();
+		draws.emplace_back();
+	}
+	
+	const unsigned int leaf = allocate_node();
+	node& leaf_node = nodes[leaf];
+	const float3 fat_margin { (bmax.x - bmin.x) * margin, (bmax.y - bmin.y) * margin, (bmax.z - bmin.z) * margin };
+	leaf_node.bmin = float3 { bmin.x - fat_margin.x, bmin.y - fat_margin.y, bmin.z - fat_margin.z };
+	leaf_node.bmax = float3 { bmax.x + fat_margin.x, bmax.y + fat_margin.y, bmax.z + fat_margin.z };
+	leaf_node.parent = null_node;
+	leaf_node.children[0] = null_node;
+	leaf_node.children[1] = null_node;
+	leaf_node.draw_id = id;
+	leaf_node.height = 0;
+	insert_leaf(leaf);
+	
+	draws[id].leaf = leaf;
+	draws[id].sequence = next_sequence++;
+	draws[id].func = draw;
+	draw_count++;
+	return id;
+}
+
+void scene_bvh::remove(const unsigned int& id) {
+	if(id >= draws.size() || draws[id].leaf == null_node) {
+		log_error("invalid draw id %u!", id);
+		return;
+	}
+	remove_leaf(draws[id].leaf);
+	free_node(draws[id].leaf);
+	draws[id].leaf = null_node;
+	draws[id].func = nullptr;
+	free_draws.emplace_back(id);
+	draw_count--;
+}
+
+void scene_bvh::update(const unsigned int& id, const float3& bmin, const float3& bmax) {
+	if(id >= draws.size() || draws[id].leaf == null_node) {
+		log_error("invalid draw id %u!", id);
+		return;
+	}
+	
+	// still inside the fat bounds -> nothing to do
+	const unsigned int leaf = draws[id].leaf;
+	node& leaf_node = nodes[leaf];
+	if(bmin.x >= leaf_node.bmin.x && bmin.y >= leaf_node.bmin.y && bmin.z >= leaf_node.bmin.z &&
+	   bmax.x <= leaf_node.bmax.x && bmax.y <= leaf_node.bmax.y && bmax.z <= leaf_node.bmax.z) {
+		return;
+	}
+	
+	remove_leaf(leaf);
+	const float3 fat_margin { (bmax.x - bmin.x) * margin, (bmax.y - bmin.y) * margin, (bmax.z - bmin.z) * margin };
+	leaf_node.bmin = float3 { bmin.x - fat_margin.x, bmin.y - fat_margin.y, bmin.z - fat_margin.z };
+	leaf_node.bmax = float3 { bmax.x + fat_margin.x, bmax.y + fat_margin.y, bmax.z + fat_margin.z };
+	insert_leaf(leaf);
+}
+
+void scene_bvh::clear() {
+	nodes.clear();
+	draws.clear();
+	free_draws.clear();
+	root = null_node;
+	free_list = null_node;
+	draw_count = 0;
+}
+
+void scene_bvh::insert_leaf(const unsigned int& leaf) {
+	if(root == null_node) {
+		root = leaf;
+		nodes[root].parent = null_node;
+		return;
+	}
+	
+	// find the best sibling (surface area heuristic): descend into the child with the lowest cost increase,
+	// until creating a new parent for the current node is cheaper than descending any further
+	const float3 leaf_min = nodes[leaf].bmin, leaf_max = nodes[leaf].bmax;
+	const auto merged_area = [this, &leaf_min, &leaf_max](const unsigned int& index) {
+		const node& n = nodes[index];
+		return surface_area(float3 { std::min(n.bmin.x, leaf_min.x), std::min(n.bmin.y, leaf_min.y), std::min(n.bmin.z, leaf_min.z) },
+							float3 { std::max(n.bmax.x, leaf_max.x), std::max(n.bmax.y, leaf_max.y), std::max(n.bmax.z, leaf_max.z) });
+	};
+	unsigned int index = root;
+	while(!nodes[index].is_leaf()) {
+		const node& n = nodes[index];
+		const float area = surface_area(n.bmin, n.bmax);
+		const float combined_area = merged_area(index);
+		const float cost = 2.0f * combined_area;
+		// all ancestors of the new leaf grow by at least this much
+		const float inheritance_cost = 2.0f * (combined_area - area);
+		
+		array<float, 2> child_cost;
+		for(size_t i = 0; i < 2; i++) {
+			const node& child = nodes[n.children[i]];
+			child_cost[i] = merged_area(n.children[i]) + inheritance_cost;
+			if(!child.is_leaf()) child_cost[i] -= surface_area(child.bmin, child.bmax);
+		}
+		if(cost < child_cost[0] && cost < child_cost[1]) break;
+		index = n.children[child_cost[0] < child_cost[1] ? 0 : 1];
+	}
+	
+	// new parent of the sibling and the leaf
+	const unsigned int sibling = index;
+	const unsigned int old_parent = nodes[sibling].parent;
+	const unsigned int new_parent = allocate_node();
+	node& parent_node = nodes[new_parent];
+	parent_node.parent = old_parent;
+	parent_node.children[0] = sibling;
+	parent_node.children[1] = leaf;
+	parent_node.draw_id = null_node;
+	parent_node.height = 0;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+	if(old_parent == null_node) {
+		root = new_parent;
+	}
+	else {
+		node& old_parent_node = nodes[old_parent];
+		old_parent_node.children[old_parent_node.children[0] == sibling ? 0 : 1] = new_parent;
+	}
+	refit(new_parent);
+}
+
+void scene_bvh::remove_leaf(const unsigned int& leaf) {
+	if(leaf == root) {
+		root = null_node;
+		return;
+	}
+	
+	// the sibling replaces the parent
+	const unsigned int parent = nodes[leaf].parent;
+	const unsigned int grand_parent = nodes[parent].parent;
+	const unsigned int sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
+	nodes[sibling].parent = grand_parent;
+	if(grand_parent == null_node) {
+		root = sibling;
+	}
+	else {
+		node& grand_parent_node = nodes[grand_parent];
+		grand_parent_node.children[grand_parent_node.children[0] == parent ? 0 : 1] = sibling;
+		refit(grand_parent);
+	}
+	free_node(parent);
+	nodes[leaf].parent = null_node;
+}
+
+void scene_bvh::refit(unsigned int index) {
+	// only the bounds and heights on the path to the root change
+	while(index != null_node) {
+		node& n = nodes[index];
+		const node& child_0 = nodes[n.children[0]];
+		const node& child_1 = nodes[n.children[1]];
+		n.bmin = float3 { std::min(child_0.bmin.x, child_1.bmin.x), std::min(child_0.bmin.y, child_1.bmin.y), std::min(child_0.bmin.z, child_1.bmin.z) };
+		n.bmax = float3 { std::max(child_0.bmax.x, child_1.bmax.x), std::max(child_0.bmax.y, child_1.bmax.y), std::max(child_0.bmax.z, child_1.bmax.z) };
+		n.height = std::max(child_0.height, child_1.height) + 1;
+		index = n.parent;
+	}
+}
+
+void scene_bvh::cull(const draw_state::camera_setup& cam_setup, vector<unsigned int>& visible_ids,
+					 const PROJECTION projection) const {
+	if(root == null_node) return;
+	if(projection != PROJECTION::PERSPECTIVE) {
+		for(unsigned int i = 0; i < (unsigned int)draws.size(); i++) {
+			if(draws[i].leaf != null_node) visible_ids.emplace_back(i);
+		}
+		return;
+	}
+	
+	// the left/top/right/bottom planes are tested at once: the frustum normals are already stored transposed
+	// (see pipeline::compute_frustum_normals) -> 4 lanes per axis, which are vectorized by the compiler.
+	// all planes go through the camera position, normals point inwards and the near plane normal is forward.
+	typedef array<float, 4> lanes;
+	array<lanes, 3> plane_normals, abs_plane_normals;
+	for(size_t i = 0; i < 3; i++) {
+		const float4& fn = cam_setup.frustum_normals[i];
+		plane_normals[i] = lanes {{ fn.x, fn.y, fn.z, fn.w }};
+		abs_plane_normals[i] = lanes {{ fabsf(fn.x), fabsf(fn.y), fabsf(fn.z), fabsf(fn.w) }};
+	}
+	const float3& forward = cam_setup.forward;
+	const float3 abs_forward { fabsf(forward.x), fabsf(forward.y), fabsf(forward.z) };
+	
+	// traversal stack: node index + "completely inside" flag (-> no more tests for the whole subtree)
+	cull_stack.clear();
+	cull_stack.reserve(nodes[root].height * 2 + 2);
+	cull_stack.emplace_back(root, false);
+	while(!cull_stack.empty()) {
+		const auto entry = cull_stack.back();
+		cull_stack.pop_back();
+		const node& n = nodes[entry.first];
+		
+		bool inside = entry.second;
+		if(!inside) {
+			// camera relative box center and half extent: a box is outside of a plane if its center is farther
+			// behind the plane than its extent projected onto the plane normal
+			const float3 center {
+				(n.bmin.x + n.bmax.x) * 0.5f - cam_setup.position.x,
+				(n.bmin.y + n.bmax.y) * 0.5f - cam_setup.position.y,
+				(n.bmin.z + n.bmax.z) * 0.5f - cam_setup.position.z
+			};
+			const float3 extent { (n.bmax.x - n.bmin.x) * 0.5f, (n.bmax.y - n.bmin.y) * 0.5f, (n.bmax.z - n.bmin.z) * 0.5f };
+			lanes dist, radius;
+			for(size_t i = 0; i < 4; i++) {
+				dist[i] = plane_normals[0][i] * center.x + plane_normals[1][i] * center.y + plane_normals[2][i] * center.z;
+				radius[i] = abs_plane_normals[0][i] * extent.x + abs_plane_normals[1][i] * extent.y + abs_plane_normals[2][i] * extent.z;
+			}
+			const float near_dist = forward.x * center.x + forward.y * center.y + forward.z * center.z;
+			const float near_radius = abs_forward.x * extent.x + abs_forward.y * extent.y + abs_forward.z * extent.z;
+			
+			bool outside = (near_dist + near_radius < 0.0f);
+			inside = (near_dist - near_radius >= 0.0f);
+			for(size_t i = 0; i < 4; i++) {
+				outside |= (dist[i] + radius[i] < 0.0f);
+				inside &= (dist[i] - radius[i] >= 0.0f);
+			}
+			if(outside) continue;
+		}
+		
+		if(n.is_leaf()) {
+			visible_ids.emplace_back(n.draw_id);
+		}
+		else {
+			cull_stack.emplace_back(n.children[0], inside);
+			cull_stack.emplace_back(n.children[1], inside);
+		}
+	}
+}
+
+unsigned int scene_bvh::draw(pipeline& p) const {
+	{
+		OCLRASTER_TRACE_SCOPE("scene_cull", "pipeline");
+		const draw_state& state = p._get_draw_state();
+		visible_draws.clear();
+		cull(state.cam_setup, visible_draws, state.projection);
+		
+		// draw in insertion order, so that the submission order doesn't depend on the tree layout
+		// (ids are reused after remove() -> sort by the per-draw sequence number instead)
+		sort(visible_draws.begin(), visible_draws.end(), [this](const unsigned int& id_0, const unsigned int& id_1) {
+			return (draws[id_0].sequence < draws[id_1].sequence);
+		});
+	}
+	for(const auto& id : visible_draws) {
+		if(draws[id].func) draws[id].func();
+	}
+	return (unsigned int)visible_draws.size();
+}
+
+unsigned int scene_bvh::get_draw_count() const {
+	return draw_count;
+}
+
+unsigned int scene_bvh::get_height() const {
+	return (root != null_node ? nodes[root].height : 0);
+}
@@ -0,0 +1,101 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_SCENE_BVH_HPP__
+#define __OCLRASTER_SCENE_BVH_HPP__
+
+#include "oclraster/global.hpp"
+#include "core/vector3.hpp"
+#include "core/vector4.hpp"
+#include "pipeline/pipeline.hpp"
+
+// dynamic bounding volume hierarchy of the world space bounds (aabbs) of draw calls, which culls complete
+// draw calls against the camera frustum on the host, before any draw state is set up or buffers are allocated.
+// leaves store slightly enlarged ("fat") bounds, so that small movements don't modify the tree at all, otherwise
+// the leaf is reinserted and only the bounds on its path to the root are refit.
+// NOTE: this is optional and independent of the pipeline, draw calls that aren't added are simply not culled.
+class scene_bvh {
+public:
+	// issues the actual draw call(s) (bind buffers/programs, draw)
+	typedef std::function<void()> draw_function;
+	
+	// bounds_margin: leaf bounds are enlarged by this fraction of their size on each side
+	scene_bvh(const float bounds_margin = 0.1f);
+	~scene_bvh();
+	scene_bvh(const scene_bvh&) = delete;
+	scene_bvh& operator=(const scene_bvh&) = delete;
+	
+	// adds a draw with the specified world space bounds and returns its id
+	unsigned int add(const float3& bmin, const float3& bmax, draw_function draw);
+	void remove(const unsigned int& id);
+	// sets new world space bounds (e.g. after the model matrix changed)
+	void update(const unsigned int& id, const float3& bmin, const float3& bmax);
+	void clear();
+	
+	// appends the ids of all draws whose bounds intersect the view frustum of the camera setup
+	// (with orthographic projection, there is no usable frustum -> nothing is culled)
+	void cull(const draw_state::camera_setup& cam_setup, vector<unsigned int>& visible_ids,
+			  const PROJECTION projection = PROJECTION::PERSPECTIVE) const;
+	// culls against the current camera setup of the pipeline and calls the draw functions of all visible
+	// draws (in insertion order). returns the amount of visible draws.
+	unsigned int draw(pipeline& p) const;
+	
+	unsigned int get_draw_count() const;
+	unsigned int get_height() const;
+
+protected:
+	static constexpr unsigned int null_node { ~0u };
+	struct node {
+		float3 bmin;
+		float3 bmax;
+		unsigned int parent;
+		unsigned int children[2];
+		unsigned int draw_id; // only valid for leaves
+		unsigned int height; // 0 for leaves, null_node for unused nodes
+		
+		bool is_leaf() const { return children[0] == null_node; }
+	};
+	vector<node> nodes;
+	unsigned int root { null_node };
+	unsigned int free_list { null_node }; // unused nodes, linked via their parent index
+	
+	struct draw_entry {
+		unsigned int leaf; // null_node for unused entries
+		unsigned long long int sequence; // monotonically increasing insertion number (ids are reused)
+		draw_function func;
+	};
+	vector<draw_entry> draws;
+	vector<unsigned int> free_draws;
+	unsigned int draw_count { 0 };
+	unsigned long long int next_sequence { 0 };
+	const float margin;
+	
+	// holds the visible draws of draw() and the traversal stack of cull(),
+	// so that no allocation is necessary per frame
+	mutable vector<unsigned int> visible_draws;
+	mutable vector<pair<unsigned int, bool>> cull_stack;
+	
+	unsigned int allocate_node();
+	void free_node(const unsigned int& index);
+	void insert_leaf(const unsigned int& leaf);
+	void remove_leaf(const unsigned int& leaf);
+	void refit(unsigned int index);
+	
+};
+
+#endif
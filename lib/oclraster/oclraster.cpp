@@ -145,10 +145,24 @@ void oclraster::init(const char* callpath_, const char* datapath_) {
 	ocl->add_global_kernel_defines(// just define this everywhere to make using image support
 								   // easier without having to specify this every time
 								   " -DOCLRASTER_IMAGE_HEADER_SIZE="+size_t2string(image::header_size())+
+								   " -DOCLRASTER_IMAGE_MAX_MIP_LEVELS="+uint2string(OCLRASTER_IMAGE_MAX_MIP_LEVELS)+
 								   
 								   // the same goes for the general struct alignment
 								   // TODO: FLOOR_STRUCT_ALIGNMENT is already present, use it?
-								   " -DOCLRASTER_STRUCT_ALIGNMENT="+uint2string(OCLRASTER_STRUCT_ALIGNMENT));
+								   " -DOCLRASTER_STRUCT_ALIGNMENT="+uint2string(OCLRASTER_STRUCT_ALIGNMENT)
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+								   // enables the statistics counters in all internal and user kernels
+								   +" -DOCLRASTER_PIPELINE_STATISTICS"
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+								   // enables the per-bin metrics in the binning and rasterization kernels
+								   +" -DOCLRASTER_BIN_HEATMAP"
+#endif
+#if defined(OCLRASTER_HALF_PRIMITIVE_SETUP)
+								   // half-precision primitive setup data for orthographic draws
+								   +" -DOCLRASTER_HALF_PRIMITIVE_SETUP"
+#endif
+								   );
 	
 	// add "kernel reload" event handler (must be done before calling "add_internal_kernels", which will trigger a reload)
 	event_handler_fnctr = new event::handler(&oclraster::event_handler);
@@ -171,23 +185,39 @@ void oclraster::init(const char* callpath_, const char* datapath_) {
 			" -DBIN_SIZE="+uint2string(OCLRASTER_BIN_SIZE)+
 			" -DBATCH_SIZE="+uint2string(OCLRASTER_BATCH_SIZE)+
 			" -DOCLRASTER_PROJECTION_ORTHOGRAPHIC"
-		}
+		},
+		
+		{ "CLUSTER_COMPACT", "cluster_compact.cl", "oclraster_cluster_compact", "" }
 		
 #if defined(OCLRASTER_FXAA)
 		,
 		{ "FXAA.LUMA", "luma_pass.cl", "framebuffer_luma", "" },
 		{ "FXAA", "fxaa_pass.cl", "framebuffer_fxaa", "" }
 #endif
+		
+#if defined(OCLRASTER_BIN_HEATMAP)
+		,
+		{ "BIN_HEATMAP.OVERLAY", "bin_heatmap.cl", "bin_heatmap_overlay",
+			" -DBIN_SIZE="+uint2string(OCLRASTER_BIN_SIZE)
+		}
+#endif
 	});
 }
 
 void oclraster::destroy() {
 	log_debug("destroying oclraster ...");
+	image_loader::destroy();
+	if(ocl != nullptr) ocl->finish();
+	memory_tracker::release_deferred();
+	memory_tracker::log_usage();
+	memory_tracker::log_leaks();
 	
 	floor::acquire_context();
 	floor::get_event()->remove_event_handler(*event_handler_fnctr);
 	delete event_handler_fnctr;
 	delete_clear_kernels();
+	delete_mip_kernels();
+	delete_readback_buffers();
 	floor::release_context();
 	
 	floor::destroy();
@@ -234,8 +264,9 @@ bool oclraster::event_handler(EVENT_TYPE type, shared_ptr<event_object> obj floo
 		}
 #endif
 		
-		// deletes all framebuffer clear kernels
+		// deletes all framebuffer clear and mip-map kernels
 		delete_clear_kernels();
+		delete_mip_kernels();
 		
 		return true;
 	}
@@ -0,0 +1,180 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "bin_heatmap.hpp"
+#include "oclraster.hpp"
+#include "core/memory_tracker.hpp"
+
+bin_heatmap::bin_heatmap() {
+}
+
+bin_heatmap::~bin_heatmap() {
+	if(heatmap_buffer != nullptr) {
+		memory_tracker::delete_buffer(heatmap_buffer);
+	}
+}
+
+void bin_heatmap::resize(const uint2& framebuffer_size) {
+	const uint2 new_bin_count {
+		(framebuffer_size.x / OCLRASTER_BIN_SIZE) + (framebuffer_size.x % OCLRASTER_BIN_SIZE != 0 ? 1u : 0u),
+		(framebuffer_size.y / OCLRASTER_BIN_SIZE) + (framebuffer_size.y % OCLRASTER_BIN_SIZE != 0 ? 1u : 0u)
+	};
+	if(heatmap_buffer != nullptr && new_bin_count.x == bin_count.x && new_bin_count.y == bin_count.y) {
+		return;
+	}
+	if(heatmap_buffer != nullptr) {
+		memory_tracker::delete_buffer(heatmap_buffer);
+	}
+	
+	bin_count = new_bin_count;
+	const size_t bin_count_lin = std::max(size_t(bin_count.x) * size_t(bin_count.y), size_t(1));
+	device_metrics.clear();
+	device_metrics.resize(bin_count_lin * bin_heatmap_metric_count, 0u);
+	heatmap_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE,
+												   opencl::BUFFER_FLAG::READ_WRITE |
+												   opencl::BUFFER_FLAG::INITIAL_COPY |
+												   opencl::BUFFER_FLAG::BLOCK_ON_READ |
+												   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+												   sizeof(unsigned int) * device_metrics.size(),
+												   (void*)&device_metrics[0]);
+	frame_metrics.clear();
+	frame_max.fill(0u);
+}
+
+opencl::buffer_object* bin_heatmap::get_buffer() const {
+	return heatmap_buffer;
+}
+
+const uint2& bin_heatmap::get_bin_count() const {
+	return bin_count;
+}
+
+void bin_heatmap::end_frame(image* overlay_img) {
+	if(heatmap_buffer == nullptr) return;
+	
+	ocl->read_buffer(&device_metrics[0], heatmap_buffer);
+	const size_t bin_count_lin = size_t(bin_count.x) * size_t(bin_count.y);
+	frame_metrics.resize(bin_count_lin);
+	frame_max.fill(0u);
+	for(size_t i = 0; i < bin_count_lin; i++) {
+		for(size_t metric = 0; metric < bin_heatmap_metric_count; metric++) {
+			frame_metrics[i][metric] = device_metrics[i * bin_heatmap_metric_count + metric];
+			frame_max[metric] = std::max(frame_max[metric], frame_metrics[i][metric]);
+		}
+	}
+	
+	// note: the overlay kernel still reads the device metrics of this frame -> reset afterwards
+	if(overlay && overlay_img != nullptr) {
+		const uint2 img_size = overlay_img->get_size();
+		const unsigned int max_value = frame_max[(size_t)overlay_metric];
+		ocl->use_kernel("BIN_HEATMAP.OVERLAY");
+		ocl->set_kernel_argument(0, overlay_img->get_buffer());
+		ocl->set_kernel_argument(1, img_size);
+		ocl->set_kernel_argument(2, heatmap_buffer);
+		ocl->set_kernel_argument(3, bin_count);
+		ocl->set_kernel_argument(4, (unsigned int)overlay_metric);
+		ocl->set_kernel_argument(5, max_value > 0u ? 1.0f / float(max_value) : 0.0f);
+		ocl->set_kernel_range(ocl->compute_kernel_ranges(img_size.x, img_size.y));
+		ocl->run_kernel();
+	}
+	
+	fill(begin(device_metrics), end(device_metrics), 0u);
+	ocl->write_buffer(heatmap_buffer, &device_metrics[0]);
+}
+
+const vector<array<unsigned int, bin_heatmap_metric_count>>& bin_heatmap::get_frame_metrics() const {
+	return frame_metrics;
+}
+
+unsigned int bin_heatmap::get_frame_max(const BIN_HEATMAP_METRIC metric) const {
+	return frame_max[(size_t)metric];
+}
+
+void bin_heatmap::set_overlay(const bool state, const BIN_HEATMAP_METRIC metric) {
+	overlay = state;
+	overlay_metric = metric;
+}
+
+bool bin_heatmap::get_overlay_state() const {
+	return overlay;
+}
+
+BIN_HEATMAP_METRIC bin_heatmap::get_overlay_metric() const {
+	return overlay_metric;
+}
+
+float3 bin_heatmap::heat_color(const float value) {
+	const float t = core::clamp(value, 0.0f, 1.0f) * 4.0f;
+	return float3 {
+		core::clamp(1.5f - fabsf(t - 3.0f), 0.0f, 1.0f),
+		core::clamp(1.5f - fabsf(t - 2.0f), 0.0f, 1.0f),
+		core::clamp(1.5f - fabsf(t - 1.0f), 0.0f, 1.0f)
+	};
+}
+
+bool bin_heatmap::export_image(const string& filename,
+							   const BIN_HEATMAP_METRIC metric,
+							   const unsigned int bin_pixel_size) const {
+	if(frame_metrics.empty()) {
+		log_error("no bin heatmap metrics available (must be built with OCLRASTER_BIN_HEATMAP)!");
+		return false;
+	}
+	
+	const unsigned int scale = std::max(bin_pixel_size, 1u);
+	const uint2 img_size { bin_count.x * scale, bin_count.y * scale };
+	SDL_Surface* surface = SDL_CreateRGBSurface(0, (int)img_size.x, (int)img_size.y, 32,
+												0x000000FFu, 0x0000FF00u, 0x00FF0000u, 0u);
+	if(surface == nullptr) {
+		log_error("failed to create bin heatmap surface: %s", SDL_GetError());
+		return false;
+	}
+	
+	// empty bins are black, bin (0, 0) is at the bottom left (-> flip y)
+	const unsigned int max_value = frame_max[(size_t)metric];
+	SDL_LockSurface(surface);
+	for(unsigned int y = 0; y < img_size.y; y++) {
+		unsigned int* row = (unsigned int*)((unsigned char*)surface->pixels + size_t(surface->pitch) * size_t(img_size.y - y - 1));
+		for(unsigned int x = 0; x < img_size.x; x++) {
+			const unsigned int value = frame_metrics[(y / scale) * bin_count.x + (x / scale)][(size_t)metric];
+			const float3 color = (value == 0u || max_value == 0u ?
+								  float3 { 0.0f, 0.0f, 0.0f } :
+								  heat_color(float(value) / float(max_value)));
+			row[x] = ((unsigned int)(color.x * 255.0f) |
+					  ((unsigned int)(color.y * 255.0f) << 8u) |
+					  ((unsigned int)(color.z * 255.0f) << 16u));
+		}
+	}
+	SDL_UnlockSurface(surface);
+	
+	const bool ret = (SDL_SaveBMP(surface, filename.c_str()) == 0);
+	if(!ret) {
+		log_error("failed to write bin heatmap image \"%s\": %s", filename, SDL_GetError());
+	}
+	SDL_FreeSurface(surface);
+	return ret;
+}
+
+const char* bin_heatmap::metric_name(const BIN_HEATMAP_METRIC metric) {
+	switch(metric) {
+		case BIN_HEATMAP_METRIC::PRIMITIVES: return "primitives";
+		case BIN_HEATMAP_METRIC::FRAGMENTS_TESTED: return "fragments tested";
+		case BIN_HEATMAP_METRIC::FRAGMENTS_SHADED: return "fragments shaded";
+		case BIN_HEATMAP_METRIC::__MAX_BIN_HEATMAP_METRIC: floor_unreachable();
+	}
+	floor_unreachable();
+}
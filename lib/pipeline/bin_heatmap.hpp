@@ -0,0 +1,89 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_BIN_HEATMAP_HPP__
+#define __OCLRASTER_BIN_HEATMAP_HPP__
+
+#include "oclraster/global.hpp"
+#include "cl/opencl.hpp"
+#include "pipeline/image.hpp"
+
+// per-bin load metrics (only gathered when built with "bin-heatmap")
+// NOTE: the order must match the BH_* indices in oclr_global.h
+enum class BIN_HEATMAP_METRIC : unsigned int {
+	PRIMITIVES,			//!< primitives inserted into the bin queues of a bin
+	FRAGMENTS_TESTED,	//!< fragments that are covered by a primitive and reach the depth test
+	FRAGMENTS_SHADED,	//!< fragments that passed the early depth test and ran the rasterization program
+	__MAX_BIN_HEATMAP_METRIC
+};
+static constexpr size_t bin_heatmap_metric_count { (size_t)BIN_HEATMAP_METRIC::__MAX_BIN_HEATMAP_METRIC };
+
+// accumulates the metrics of all bins of the default framebuffer over a complete frame (draw calls into
+// other framebuffers are not recorded), which can be displayed as a heatmap overlay on swap or exported
+// as an image. this shows which bins dominate the rasterization and helps with bin size tuning.
+// NOTE: there is no device clock in opencl, so per-bin times are not available (fragments shaded is
+// the closest approximation). metrics are read back on each swap, which synchronizes the command queue
+// -> only enabled with OCLRASTER_BIN_HEATMAP.
+class bin_heatmap {
+public:
+	bin_heatmap();
+	~bin_heatmap();
+	bin_heatmap(bin_heatmap& heatmap) = delete;
+	bin_heatmap& operator=(bin_heatmap& heatmap) = delete;
+	
+	// (re)creates the metrics buffer for the bins of a framebuffer with the specified size
+	void resize(const uint2& framebuffer_size);
+	// the buffer that must be passed to the binning and rasterization kernels
+	opencl::buffer_object* get_buffer() const;
+	const uint2& get_bin_count() const;
+	
+	// reads back the metrics of the current frame, draws the overlay (if enabled) into the specified
+	// framebuffer image and resets the device metrics for the next frame
+	void end_frame(image* overlay_img);
+	
+	// metrics of the last complete frame (bin_count.x * bin_count.y entries, row-major, starting at the bottom left)
+	const vector<array<unsigned int, bin_heatmap_metric_count>>& get_frame_metrics() const;
+	unsigned int get_frame_max(const BIN_HEATMAP_METRIC metric) const;
+	
+	// overlay display of the specified metric (disabled by default)
+	void set_overlay(const bool state, const BIN_HEATMAP_METRIC metric = BIN_HEATMAP_METRIC::FRAGMENTS_SHADED);
+	bool get_overlay_state() const;
+	BIN_HEATMAP_METRIC get_overlay_metric() const;
+	
+	// writes the specified metric of the last frame as a .bmp file (each bin is scaled to bin_pixel_size² pixels)
+	bool export_image(const string& filename,
+					  const BIN_HEATMAP_METRIC metric = BIN_HEATMAP_METRIC::FRAGMENTS_SHADED,
+					  const unsigned int bin_pixel_size = 8) const;
+	
+	static const char* metric_name(const BIN_HEATMAP_METRIC metric);
+	// maps [0, 1] to a blue -> green -> yellow -> red color ramp (the same ramp is used by the overlay kernel)
+	static float3 heat_color(const float value);
+
+protected:
+	opencl::buffer_object* heatmap_buffer { nullptr };
+	uint2 bin_count { 0u, 0u };
+	vector<unsigned int> device_metrics;
+	vector<array<unsigned int, bin_heatmap_metric_count>> frame_metrics;
+	array<unsigned int, bin_heatmap_metric_count> frame_max {};
+	
+	bool overlay { false };
+	BIN_HEATMAP_METRIC overlay_metric { BIN_HEATMAP_METRIC::FRAGMENTS_SHADED };
+	
+};
+
+#endif
@@ -21,26 +21,29 @@
 #include "oclraster.hpp"
 
 binning_stage::binning_stage() {
-	bin_distribution_counter = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-												  opencl::BUFFER_FLAG::BLOCK_ON_READ |
-												  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-												  sizeof(unsigned int));
-	queue_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-									  opencl::BUFFER_FLAG::BLOCK_ON_READ |
-									  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-									  24 * 1024 * 1024); // TODO: actual size
+	bin_distribution_counter = memory_tracker::create_buffer(MEMORY_TAG::BINNING,
+															 opencl::BUFFER_FLAG::READ_WRITE |
+															 opencl::BUFFER_FLAG::BLOCK_ON_READ |
+															 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+															 sizeof(unsigned int));
+	queue_buffer = memory_tracker::create_buffer(MEMORY_TAG::BINNING,
+												 opencl::BUFFER_FLAG::READ_WRITE |
+												 opencl::BUFFER_FLAG::BLOCK_ON_READ |
+												 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+												 24 * 1024 * 1024); // TODO: actual size
 }
 
 binning_stage::~binning_stage() {
 	if(bin_distribution_counter != nullptr) {
-		ocl->delete_buffer(bin_distribution_counter);
+		memory_tracker::delete_buffer(bin_distribution_counter);
 	}
 	if(queue_buffer != nullptr) {
-		ocl->delete_buffer(queue_buffer);
+		memory_tracker::delete_buffer(queue_buffer);
 	}
 }
 
 const opencl::buffer_object* binning_stage::bin(draw_state& state) {
+	OCLRASTER_TRACE_SCOPE("binning", "stage");
 	////
 	// bin rasterizer
 	unsigned int argc = 0;
@@ -75,6 +78,13 @@ const opencl::buffer_object* binning_stage::bin(draw_state& state) {
 		ocl->set_kernel_argument(argc++, (unsigned int)intra_bin_groups);
 		ocl->set_kernel_range({ unit_count * bin_local_size, bin_local_size });
 	}
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	ocl->set_kernel_argument(argc++, state.pipeline_stats_buffer);
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+	ocl->set_kernel_argument(argc++, state.bin_heatmap_buffer);
+	ocl->set_kernel_argument(argc++, state.bin_heatmap_bin_count);
+#endif
 	ocl->run_kernel();
 	
 	//
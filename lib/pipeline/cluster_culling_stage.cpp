@@ -0,0 +1,153 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "cluster_culling_stage.hpp"
+#include "pipeline.hpp"
+#include "oclraster.hpp"
+
+cluster_culling_stage::cluster_culling_stage() : stage_base() {
+}
+
+cluster_culling_stage::~cluster_culling_stage() {
+}
+
+unsigned int cluster_culling_stage::cull(draw_state& state,
+										 const vector<mesh_cluster>& clusters,
+										 const matrix4f& model_matrix) {
+	OCLRASTER_TRACE_SCOPE("cluster_culling", "stage");
+	const auto index_buffer = state.bindings.get_binding(index_buffer_slot);
+	if(index_buffer == nullptr || index_buffer->buffer == nullptr) {
+		log_error("index buffer not bound!");
+		return 0;
+	}
+	
+	// object -> world space (column major): radii are scaled by the largest axis scale, normal cones are only
+	// usable if the scale is uniform (otherwise the cone angles would change)
+	const float* mat = model_matrix.data;
+	const float3 axis_scale_sq {
+		mat[0] * mat[0] + mat[1] * mat[1] + mat[2] * mat[2],
+		mat[4] * mat[4] + mat[5] * mat[5] + mat[6] * mat[6],
+		mat[8] * mat[8] + mat[9] * mat[9] + mat[10] * mat[10]
+	};
+	const float max_scale_sq = std::max(std::max(axis_scale_sq.x, axis_scale_sq.y), axis_scale_sq.z);
+	const float min_scale_sq = std::min(std::min(axis_scale_sq.x, axis_scale_sq.y), axis_scale_sq.z);
+	const float radius_scale = sqrtf(max_scale_sq);
+	
+	// a mirroring model matrix (negative determinant) flips the triangle winding, so the world space
+	// winding normal is -(M * n) -> the cone axis has to be flipped as well
+	const float det = (mat[0] * (mat[5] * mat[10] - mat[6] * mat[9]) -
+					   mat[4] * (mat[1] * mat[10] - mat[2] * mat[9]) +
+					   mat[8] * (mat[1] * mat[6] - mat[2] * mat[5]));
+	const float axis_scale = (det < 0.0f ? -1.0f : 1.0f) / radius_scale;
+	
+	const bool frustum_culling = (state.projection == PROJECTION::PERSPECTIVE);
+	const bool cone_culling = (frustum_culling && state.backface_culling &&
+							   (max_scale_sq - min_scale_sq) <= max_scale_sq * 0.02f);
+	
+	// all planes go through the camera position and their normals point inwards
+	// (the frustum normals are stored transposed, there is no far plane and the near plane normal is forward)
+	const auto& cam_setup = state.cam_setup;
+	const auto& fn = cam_setup.frustum_normals;
+	const array<float3, 5> planes {{
+		cam_setup.forward,
+		float3 { fn[0].x, fn[1].x, fn[2].x },
+		float3 { fn[0].y, fn[1].y, fn[2].y },
+		float3 { fn[0].z, fn[1].z, fn[2].z },
+		float3 { fn[0].w, fn[1].w, fn[2].w },
+	}};
+	
+	visible_clusters.clear();
+	unsigned int visible_triangle_count = 0;
+	unsigned int max_cluster_triangle_count = 0;
+	for(const auto& cluster : clusters) {
+		if(frustum_culling) {
+			// camera relative cluster center
+			const float4& sphere = cluster.sphere;
+			const float3 center {
+				mat[0] * sphere.x + mat[4] * sphere.y + mat[8] * sphere.z + mat[12] - cam_setup.position.x,
+				mat[1] * sphere.x + mat[5] * sphere.y + mat[9] * sphere.z + mat[13] - cam_setup.position.y,
+				mat[2] * sphere.x + mat[6] * sphere.y + mat[10] * sphere.z + mat[14] - cam_setup.position.z
+			};
+			const float radius = sphere.w * radius_scale;
+			
+			bool outside = false;
+			for(const auto& plane : planes) {
+				if(center.x * plane.x + center.y * plane.y + center.z * plane.z < -radius) {
+					outside = true;
+					break;
+				}
+			}
+			if(outside) continue;
+			
+			if(cone_culling && cluster.cone.w < 1.0f) {
+				const float4& cone = cluster.cone;
+				float3 axis {
+					mat[0] * cone.x + mat[4] * cone.y + mat[8] * cone.z,
+					mat[1] * cone.x + mat[5] * cone.y + mat[9] * cone.z,
+					mat[2] * cone.x + mat[6] * cone.y + mat[10] * cone.z
+				};
+				axis.x *= axis_scale;
+				axis.y *= axis_scale;
+				axis.z *= axis_scale;
+				const float dist = sqrtf(center.x * center.x + center.y * center.y + center.z * center.z);
+				if(center.x * axis.x + center.y * axis.y + center.z * axis.z >= cone.w * dist + radius) {
+					continue; // completely back-facing
+				}
+			}
+		}
+		
+		visible_clusters.emplace_back(uint4 { cluster.triangle_offset, cluster.triangle_count, visible_triangle_count, 0u });
+		visible_triangle_count += cluster.triangle_count;
+		max_cluster_triangle_count = std::max(max_cluster_triangle_count, cluster.triangle_count);
+	}
+	if(visible_triangle_count == 0) return 0;
+	
+	// gather the indices of all visible clusters (one work-item per triangle of the largest cluster and visible cluster)
+	opencl::buffer_object* visible_clusters_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+																				   opencl::BUFFER_FLAG::READ |
+																				   opencl::BUFFER_FLAG::INITIAL_COPY |
+																				   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+																				   sizeof(uint4) * visible_clusters.size(),
+																				   (void*)&visible_clusters[0]);
+	culled_index_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+														opencl::BUFFER_FLAG::READ_WRITE,
+														sizeof(unsigned int) * 3 * visible_triangle_count);
+	
+	ocl->use_kernel("CLUSTER_COMPACT");
+	unsigned int argc = 0;
+	ocl->set_kernel_argument(argc++, index_buffer->buffer);
+	ocl->set_kernel_argument(argc++, visible_clusters_buffer);
+	ocl->set_kernel_argument(argc++, culled_index_buffer);
+	ocl->set_kernel_argument(argc++, (unsigned int)visible_clusters.size());
+	ocl->set_kernel_argument(argc++, max_cluster_triangle_count);
+	ocl->set_kernel_range(ocl->compute_kernel_ranges((unsigned int)visible_clusters.size() * max_cluster_triangle_count));
+	ocl->run_kernel();
+	memory_tracker::delete_buffer(visible_clusters_buffer);
+	
+	source_index_buffer = index_buffer->buffer;
+	state.bindings.bind_buffer(index_buffer_slot, *culled_index_buffer);
+	return visible_triangle_count;
+}
+
+void cluster_culling_stage::end_draw(draw_state& state) {
+	if(culled_index_buffer == nullptr) return;
+	state.bindings.bind_buffer(index_buffer_slot, *source_index_buffer);
+	memory_tracker::delete_buffer(culled_index_buffer);
+	culled_index_buffer = nullptr;
+	source_index_buffer = nullptr;
+}
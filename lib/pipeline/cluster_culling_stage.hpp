@@ -0,0 +1,57 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_CLUSTER_CULLING_STAGE_HPP__
+#define __OCLRASTER_CLUSTER_CULLING_STAGE_HPP__
+
+#include "cl/opencl.hpp"
+#include "pipeline/stage_base.hpp"
+#include "core/mesh_optimizer.hpp"
+#include "core/matrix4.hpp"
+
+// culls whole clusters of triangles (see mesh_optimizer::build_clusters) before primitive processing:
+// the clusters are tested against the view frustum and their normal cones on the host (cheap, since there
+// is only one test per cluster and no readback is necessary), then the indices of all potentially visible
+// clusters are gathered into a compact index buffer on the device, which is used for the actual draw call.
+// NOTE: all vertices are still transformed (the transform stage runs per vertex, not per primitive)
+struct draw_state;
+class cluster_culling_stage : public stage_base {
+public:
+	cluster_culling_stage();
+	virtual ~cluster_culling_stage();
+	
+	// culls the clusters of the bound index buffer (model_matrix: object -> world space) and returns the triangle
+	// count of all visible clusters (0 -> nothing to draw). if this is > 0, the compact index buffer is bound
+	// instead of the original one and end_draw must be called after the draw call.
+	// with orthographic projection, clusters are only compacted, but not culled.
+	unsigned int cull(draw_state& state,
+					  const vector<mesh_cluster>& clusters,
+					  const matrix4f& model_matrix);
+	
+	// restores the original index buffer binding and deletes the compact index buffer
+	void end_draw(draw_state& state);
+
+protected:
+	// .x = source triangle offset, .y = triangle count, .z = destination triangle offset
+	vector<uint4> visible_clusters;
+	const opencl_base::buffer_object* source_index_buffer { nullptr };
+	opencl::buffer_object* culled_index_buffer { nullptr };
+	
+};
+
+#endif
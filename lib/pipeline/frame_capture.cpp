@@ -0,0 +1,578 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "frame_capture.hpp"
+#include "oclraster.hpp"
+#include <fstream>
+
+constexpr unsigned int frame_capture::version;
+constexpr size_t frame_capture::default_framebuffer_id;
+atomic<bool> frame_capture::capturing { false };
+atomic<bool> frame_capture::requested { false };
+mutex frame_capture::request_lock;
+string frame_capture::requested_filename { "" };
+string frame_capture::filename { "" };
+frame_capture::capture frame_capture::cur_capture;
+unordered_map<const oclraster_program*, size_t> frame_capture::program_ids;
+unordered_map<const framebuffer*, size_t> frame_capture::framebuffer_ids;
+unordered_map<const void*, size_t> frame_capture::buffer_snapshots;
+unordered_map<const void*, size_t> frame_capture::image_snapshots;
+
+static constexpr char capture_magic[8] { 'O', 'C', 'L', 'R', 'C', 'A', 'P', '1' };
+
+void frame_capture::request(const string& filename_) {
+	lock_guard<mutex> lock(request_lock);
+	requested_filename = filename_;
+	requested = !filename_.empty();
+}
+
+void frame_capture::reset() {
+	cur_capture = capture {};
+	program_ids.clear();
+	framebuffer_ids.clear();
+	buffer_snapshots.clear();
+	image_snapshots.clear();
+}
+
+void frame_capture::begin_frame(const vector<framebuffer>& default_framebuffers) {
+	if(!requested) return;
+	{
+		lock_guard<mutex> lock(request_lock);
+		filename = requested_filename;
+		requested_filename = "";
+		requested = false;
+	}
+	
+	reset();
+	
+	// all default framebuffers are mapped to the same framebuffer (they have the same size and formats)
+	const framebuffer& fb = default_framebuffers[0];
+	framebuffer_data fb_data;
+	fb_data.size = fb.get_size();
+	for(size_t i = 0, attachment_count = fb.get_attachment_count(); i < attachment_count; i++) {
+		const image* img = fb.get_image(i);
+		fb_data.image_types.emplace_back(img != nullptr ?
+										 make_pair(img->get_data_type(), img->get_channel_order()) :
+										 make_pair(IMAGE_TYPE::NONE, IMAGE_CHANNEL::NONE));
+	}
+	if(fb.get_depth_buffer() != nullptr) {
+		fb_data.depth_type = { fb.get_depth_buffer()->get_data_type(), fb.get_depth_buffer()->get_channel_order() };
+	}
+	if(fb.get_stencil_buffer() != nullptr) {
+		fb_data.stencil_type = { fb.get_stencil_buffer()->get_data_type(), fb.get_stencil_buffer()->get_channel_order() };
+	}
+	cur_capture.framebuffers.emplace_back(fb_data);
+	for(const auto& default_fb : default_framebuffers) {
+		framebuffer_ids.emplace(&default_fb, default_framebuffer_id);
+	}
+	
+	log_debug("capturing frame to \"%s\" ...", filename);
+	capturing = true;
+}
+
+void frame_capture::end_frame() {
+	if(!capturing) return;
+	capturing = false;
+	
+	if(write(filename, cur_capture)) {
+		log_msg("frame capture written to \"%s\" (%u commands, %u buffers, %u images)",
+				filename, cur_capture.commands.size(), cur_capture.buffers.size(), cur_capture.images.size());
+	}
+	reset();
+}
+
+size_t frame_capture::get_program_id(const oclraster_program* program, const bool transform) {
+	const auto iter = program_ids.find(program);
+	if(iter != program_ids.cend()) return iter->second;
+	
+	// strip the program type define that is added by the program constructor
+	string build_options = program->get_build_options();
+	const string type_define = (transform ? "-DOCLRASTER_TRANSFORM_PROGRAM " : "-DOCLRASTER_RASTERIZATION_PROGRAM ");
+	if(build_options.compare(0, type_define.size(), type_define) == 0) {
+		build_options = build_options.substr(type_define.size());
+	}
+	
+	const size_t id = cur_capture.programs.size();
+	cur_capture.programs.emplace_back(program_data {
+		transform, program->get_source_code(), program->get_entry_function(), build_options
+	});
+	program_ids.emplace(program, id);
+	return id;
+}
+
+size_t frame_capture::get_framebuffer_id(const framebuffer* fb) {
+	const auto iter = framebuffer_ids.find(fb);
+	if(iter != framebuffer_ids.cend()) return iter->second;
+	
+	framebuffer_data fb_data;
+	fb_data.size = fb->get_size();
+	for(size_t i = 0, attachment_count = fb->get_attachment_count(); i < attachment_count; i++) {
+		const image* img = fb->get_image(i);
+		fb_data.image_types.emplace_back(img != nullptr ?
+										 make_pair(img->get_data_type(), img->get_channel_order()) :
+										 make_pair(IMAGE_TYPE::NONE, IMAGE_CHANNEL::NONE));
+	}
+	if(fb->get_depth_buffer() != nullptr) {
+		fb_data.depth_type = { fb->get_depth_buffer()->get_data_type(), fb->get_depth_buffer()->get_channel_order() };
+	}
+	if(fb->get_stencil_buffer() != nullptr) {
+		fb_data.stencil_type = { fb->get_stencil_buffer()->get_data_type(), fb->get_stencil_buffer()->get_channel_order() };
+	}
+	
+	const size_t id = cur_capture.framebuffers.size();
+	cur_capture.framebuffers.emplace_back(fb_data);
+	framebuffer_ids.emplace(fb, id);
+	return id;
+}
+
+size_t frame_capture::snapshot_buffer(const opencl_base::buffer_object* buffer) {
+	vector<unsigned char> data(buffer->size);
+	if(!data.empty()) {
+		ocl->read_buffer(&data[0], const_cast<opencl_base::buffer_object*>(buffer));
+	}
+	
+	// reuse the last snapshot of this buffer if its contents haven't changed
+	const auto iter = buffer_snapshots.find(buffer);
+	if(iter != buffer_snapshots.cend() && cur_capture.buffers[iter->second] == data) {
+		return iter->second;
+	}
+	
+	const size_t id = cur_capture.buffers.size();
+	cur_capture.buffers.emplace_back(move(data));
+	buffer_snapshots[buffer] = id;
+	return id;
+}
+
+bool frame_capture::find_framebuffer_image(const image* img, binding_data& binding) {
+	for(const auto& fb : framebuffer_ids) {
+		for(size_t i = 0, attachment_count = fb.first->get_attachment_count(); i < attachment_count; i++) {
+			if(fb.first->get_image(i) == img) {
+				binding.type = RESOURCE_TYPE::FRAMEBUFFER_IMAGE;
+				binding.index = fb.second;
+				binding.fb_image_index = i;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+size_t frame_capture::snapshot_image(const image* img) {
+	image_data data {
+		img->get_size(), img->get_backing(), img->get_data_type(), img->get_channel_order(),
+		(img->get_mip_level_count() > 1), {}
+	};
+	data.pixels.resize(img->get_image_type().data_size(data.size.x, data.size.y));
+	if(!data.pixels.empty()) {
+		const_cast<image*>(img)->read(&data.pixels[0]);
+	}
+	
+	const auto iter = image_snapshots.find(img);
+	if(iter != image_snapshots.cend()) {
+		const image_data& prev_data = cur_capture.images[iter->second];
+		if(prev_data.size == data.size &&
+		   prev_data.backing == data.backing &&
+		   prev_data.data_type == data.data_type &&
+		   prev_data.channel_order == data.channel_order &&
+		   prev_data.mipmapped == data.mipmapped &&
+		   prev_data.pixels == data.pixels) {
+			return iter->second;
+		}
+	}
+	
+	const size_t id = cur_capture.images.size();
+	cur_capture.images.emplace_back(move(data));
+	image_snapshots[img] = id;
+	return id;
+}
+
+void frame_capture::record_clear(const framebuffer& fb,
+								 const vector<size_t>& image_indices,
+								 const bool clear_depth,
+								 const bool clear_stencil) {
+	if(!capturing) return;
+	command cmd;
+	cmd.type = COMMAND_TYPE::CLEAR;
+	cmd.framebuffer_id = get_framebuffer_id(&fb);
+	cmd.clear_indices = image_indices;
+	cmd.clear_depth = clear_depth;
+	cmd.clear_stencil = clear_stencil;
+	cmd.clear_color_int = fb.get_clear_color_int();
+	cmd.clear_color_float = fb.get_clear_color_float();
+	cmd.clear_depth_value = fb.get_clear_depth();
+	cmd.clear_stencil_value = fb.get_clear_stencil();
+	cur_capture.commands.emplace_back(move(cmd));
+}
+
+void frame_capture::record_draw(const draw_state& state,
+								const PRIMITIVE_TYPE type,
+								const unsigned int vertex_count,
+								const pair<unsigned int, unsigned int> element_range,
+								const unsigned int instance_count) {
+	if(!capturing) return;
+	command cmd;
+	cmd.type = COMMAND_TYPE::DRAW;
+	cmd.framebuffer_id = get_framebuffer_id(state.active_framebuffer);
+	cmd.transform_program = get_program_id(state.transform_prog, true);
+	cmd.rasterization_program = get_program_id(state.rasterize_prog, false);
+	cmd.primitive_type = type;
+	cmd.vertex_count = vertex_count;
+	cmd.element_range = element_range;
+	cmd.instance_count = instance_count;
+	cmd.projection = state.projection;
+	cmd.depth = state.depth;
+	cmd.scissor_test = state.scissor_test;
+	cmd.backface_culling = state.backface_culling;
+	cmd.attribute_setup = state.attribute_setup;
+	cmd.scissor_rectangle = state.scissor_rectangle;
+	cmd.cam_setup = state.cam_setup;
+	
+	// all buffer and image bindings that are used by this draw call
+	// (transform program outputs and rasterization program inputs are created by the pipeline)
+	vector<size_t> buffer_slots { binding_table::get_slot("index_buffer") };
+	vector<size_t> image_slots;
+	const auto add_program_slots = [&buffer_slots, &image_slots](const oclraster_program* program,
+																 const bool add_inputs) {
+		const auto& structs = program->get_structs();
+		const auto& layout = program->get_binding_layout();
+		for(size_t i = 0, struct_count = structs.size(); i < struct_count; i++) {
+			if(structs[i]->type == oclraster_program::STRUCT_TYPE::UNIFORMS ||
+			   (add_inputs && structs[i]->type == oclraster_program::STRUCT_TYPE::INPUT)) {
+				buffer_slots.emplace_back(layout.struct_slots[i]);
+			}
+			else if(structs[i]->type == oclraster_program::STRUCT_TYPE::BUFFERS) {
+				for(const auto& var_name : structs[i]->variables) {
+					buffer_slots.emplace_back(binding_table::get_slot(var_name));
+				}
+			}
+		}
+		for(const auto& slot : layout.image_slots) {
+			if(slot != binding_table::invalid_slot) image_slots.emplace_back(slot);
+		}
+	};
+	add_program_slots(state.transform_prog, true);
+	add_program_slots(state.rasterize_prog, false);
+	for(auto slots : { &buffer_slots, &image_slots }) {
+		sort(slots->begin(), slots->end());
+		slots->erase(unique(slots->begin(), slots->end()), slots->end());
+	}
+	
+	for(const auto& slot : buffer_slots) {
+		const auto binding = state.bindings.get_binding(slot);
+		if(binding == nullptr || binding->buffer == nullptr) continue;
+		cmd.bindings.emplace_back(binding_data {
+			binding_table::get_slot_name(slot), RESOURCE_TYPE::BUFFER, snapshot_buffer(binding->buffer), 0
+		});
+	}
+	for(const auto& slot : image_slots) {
+		const auto binding = state.bindings.get_binding(slot);
+		if(binding == nullptr || binding->img == nullptr) continue;
+		binding_data img_binding { binding_table::get_slot_name(slot), RESOURCE_TYPE::IMAGE, 0, 0 };
+		if(!find_framebuffer_image(binding->img, img_binding)) {
+			img_binding.index = snapshot_image(binding->img);
+		}
+		cmd.bindings.emplace_back(img_binding);
+	}
+	cur_capture.commands.emplace_back(move(cmd));
+}
+
+// serialization helpers for plain data (native endianness and layout, captures are not meant to be portable)
+template <typename T> static void write_value(ofstream& file, const T& value) {
+	static_assert(is_standard_layout<T>::value, "invalid type");
+	file.write((const char*)&value, sizeof(T));
+}
+static void write_string(ofstream& file, const string& str) {
+	write_value(file, (unsigned long long int)str.size());
+	file.write(str.data(), (streamsize)str.size());
+}
+static void write_data(ofstream& file, const vector<unsigned char>& data) {
+	write_value(file, (unsigned long long int)data.size());
+	if(!data.empty()) file.write((const char*)&data[0], (streamsize)data.size());
+}
+template <typename T> static bool read_value(ifstream& file, T& value) {
+	static_assert(is_standard_layout<T>::value, "invalid type");
+	file.read((char*)&value, sizeof(T));
+	return file.good();
+}
+static bool read_size(ifstream& file, size_t& size) {
+	unsigned long long int value = 0;
+	if(!read_value(file, value)) return false;
+	size = (size_t)value;
+	return true;
+}
+// reads an element count and checks that count elements of (at least) min_element_size bytes each can still
+// be stored in the rest of the file -> corrupt counts never lead to huge allocations
+static bool read_count(ifstream& file, const size_t file_size, size_t& count, const size_t min_element_size) {
+	if(!read_size(file, count)) return false;
+	const streamoff pos = file.tellg();
+	if(pos < 0 || (size_t)pos > file_size) return false;
+	return (count <= (file_size - (size_t)pos) / std::max(min_element_size, size_t(1)));
+}
+static bool read_string(ifstream& file, const size_t file_size, string& str) {
+	size_t size = 0;
+	if(!read_count(file, file_size, size, 1)) return false;
+	str.resize(size);
+	if(size > 0) file.read(&str[0], (streamsize)size);
+	return file.good();
+}
+static bool read_data(ifstream& file, const size_t file_size, vector<unsigned char>& data) {
+	size_t size = 0;
+	if(!read_count(file, file_size, size, 1)) return false;
+	data.resize(size);
+	if(size > 0) file.read((char*)&data[0], (streamsize)size);
+	return file.good();
+}
+
+bool frame_capture::write(const string& filename_, const capture& cap) {
+	ofstream file(filename_, ios::out | ios::binary | ios::trunc);
+	if(!file.is_open()) {
+		log_error("failed to open frame capture file \"%s\"!", filename_);
+		return false;
+	}
+	
+	file.write(capture_magic, sizeof(capture_magic));
+	write_value(file, version);
+	
+	write_value(file, (unsigned long long int)cap.programs.size());
+	for(const auto& prog : cap.programs) {
+		write_value(file, prog.transform);
+		write_string(file, prog.source);
+		write_string(file, prog.entry_function);
+		write_string(file, prog.build_options);
+	}
+	
+	write_value(file, (unsigned long long int)cap.buffers.size());
+	for(const auto& buffer : cap.buffers) {
+		write_data(file, buffer);
+	}
+	
+	write_value(file, (unsigned long long int)cap.images.size());
+	for(const auto& img : cap.images) {
+		write_value(file, img.size);
+		write_value(file, img.backing);
+		write_value(file, img.data_type);
+		write_value(file, img.channel_order);
+		write_value(file, img.mipmapped);
+		write_data(file, img.pixels);
+	}
+	
+	write_value(file, (unsigned long long int)cap.framebuffers.size());
+	for(const auto& fb : cap.framebuffers) {
+		write_value(file, fb.size);
+		write_value(file, (unsigned long long int)fb.image_types.size());
+		for(const auto& img_type : fb.image_types) {
+			write_value(file, img_type);
+		}
+		write_value(file, fb.depth_type);
+		write_value(file, fb.stencil_type);
+	}
+	
+	write_value(file, (unsigned long long int)cap.commands.size());
+	for(const auto& cmd : cap.commands) {
+		write_value(file, cmd.type);
+		write_value(file, (unsigned long long int)cmd.framebuffer_id);
+		switch(cmd.type) {
+			case COMMAND_TYPE::CLEAR:
+				write_value(file, (unsigned long long int)cmd.clear_indices.size());
+				for(const auto& index : cmd.clear_indices) {
+					write_value(file, (unsigned long long int)index);
+				}
+				write_value(file, cmd.clear_depth);
+				write_value(file, cmd.clear_stencil);
+				write_value(file, cmd.clear_color_int);
+				write_value(file, cmd.clear_color_float);
+				write_value(file, cmd.clear_depth_value);
+				write_value(file, cmd.clear_stencil_value);
+				break;
+			case COMMAND_TYPE::DRAW:
+				write_value(file, (unsigned long long int)cmd.transform_program);
+				write_value(file, (unsigned long long int)cmd.rasterization_program);
+				write_value(file, cmd.primitive_type);
+				write_value(file, cmd.vertex_count);
+				write_value(file, cmd.element_range);
+				write_value(file, cmd.instance_count);
+				write_value(file, cmd.projection);
+				write_value(file, cmd.depth.depth_func);
+				write_string(file, cmd.depth.custom_depth_func);
+				write_value(file, cmd.depth.depth_test);
+				write_value(file, cmd.depth.depth_override);
+				write_value(file, cmd.scissor_test);
+				write_value(file, cmd.backface_culling);
+				write_value(file, cmd.attribute_setup);
+				write_value(file, cmd.scissor_rectangle);
+				write_value(file, cmd.cam_setup);
+				write_value(file, (unsigned long long int)cmd.bindings.size());
+				for(const auto& binding : cmd.bindings) {
+					write_string(file, binding.name);
+					write_value(file, binding.type);
+					write_value(file, (unsigned long long int)binding.index);
+					write_value(file, (unsigned long long int)binding.fb_image_index);
+				}
+				break;
+		}
+	}
+	
+	if(!file.good()) {
+		log_error("failed to write frame capture file \"%s\"!", filename_);
+		return false;
+	}
+	return true;
+}
+
+bool frame_capture::load(const string& filename_, capture& cap) {
+	ifstream file(filename_, ios::in | ios::binary | ios::ate);
+	if(!file.is_open()) {
+		log_error("failed to open frame capture file \"%s\"!", filename_);
+		return false;
+	}
+	const streamoff file_end = file.tellg();
+	const size_t file_size = (file_end > 0 ? (size_t)file_end : 0);
+	file.seekg(0, ios::beg);
+	
+	const auto fail = [&filename_]() {
+		log_error("invalid or truncated frame capture file \"%s\"!", filename_);
+		return false;
+	};
+	
+	char magic[sizeof(capture_magic)];
+	file.read(magic, sizeof(magic));
+	unsigned int file_version = 0;
+	if(!file.good() || memcmp(magic, capture_magic, sizeof(capture_magic)) != 0 ||
+	   !read_value(file, file_version)) {
+		return fail();
+	}
+	if(file_version != version) {
+		log_error("unsupported frame capture version %u (expected %u)!", file_version, version);
+		return false;
+	}
+	
+	cap = capture {};
+	size_t count = 0;
+	if(!read_count(file, file_size, count, sizeof(bool) + 3 * sizeof(unsigned long long int))) return fail();
+	cap.programs.resize(count);
+	for(auto& prog : cap.programs) {
+		if(!read_value(file, prog.transform) ||
+		   !read_string(file, file_size, prog.source) ||
+		   !read_string(file, file_size, prog.entry_function) ||
+		   !read_string(file, file_size, prog.build_options)) {
+			return fail();
+		}
+	}
+	
+	if(!read_count(file, file_size, count, sizeof(unsigned long long int))) return fail();
+	cap.buffers.resize(count);
+	for(auto& buffer : cap.buffers) {
+		if(!read_data(file, file_size, buffer)) return fail();
+	}
+	
+	if(!read_count(file, file_size, count, sizeof(uint2) + sizeof(unsigned long long int))) return fail();
+	cap.images.resize(count);
+	for(auto& img : cap.images) {
+		if(!read_value(file, img.size) ||
+		   !read_value(file, img.backing) ||
+		   !read_value(file, img.data_type) ||
+		   !read_value(file, img.channel_order) ||
+		   !read_value(file, img.mipmapped) ||
+		   !read_data(file, file_size, img.pixels)) {
+			return fail();
+		}
+	}
+	
+	if(!read_count(file, file_size, count, sizeof(uint2) + sizeof(unsigned long long int)) || count == 0) return fail();
+	cap.framebuffers.resize(count);
+	for(auto& fb : cap.framebuffers) {
+		size_t image_count = 0;
+		if(!read_value(file, fb.size) ||
+		   !read_count(file, file_size, image_count, sizeof(pair<IMAGE_TYPE, IMAGE_CHANNEL>))) {
+			return fail();
+		}
+		fb.image_types.resize(image_count);
+		for(auto& img_type : fb.image_types) {
+			if(!read_value(file, img_type)) return fail();
+		}
+		if(!read_value(file, fb.depth_type) || !read_value(file, fb.stencil_type)) return fail();
+	}
+	
+	if(!read_count(file, file_size, count, sizeof(COMMAND_TYPE) + sizeof(unsigned long long int))) return fail();
+	cap.commands.resize(count);
+	for(auto& cmd : cap.commands) {
+		if(!read_value(file, cmd.type) || !read_size(file, cmd.framebuffer_id)) return fail();
+		if(cmd.framebuffer_id >= cap.framebuffers.size()) return fail();
+		switch(cmd.type) {
+			case COMMAND_TYPE::CLEAR: {
+				size_t index_count = 0;
+				if(!read_count(file, file_size, index_count, sizeof(unsigned long long int))) return fail();
+				cmd.clear_indices.resize(index_count);
+				for(auto& index : cmd.clear_indices) {
+					if(!read_size(file, index)) return fail();
+				}
+				if(!read_value(file, cmd.clear_depth) ||
+				   !read_value(file, cmd.clear_stencil) ||
+				   !read_value(file, cmd.clear_color_int) ||
+				   !read_value(file, cmd.clear_color_float) ||
+				   !read_value(file, cmd.clear_depth_value) ||
+				   !read_value(file, cmd.clear_stencil_value)) {
+					return fail();
+				}
+			}
+			break;
+			case COMMAND_TYPE::DRAW: {
+				size_t binding_count = 0;
+				if(!read_size(file, cmd.transform_program) ||
+				   !read_size(file, cmd.rasterization_program) ||
+				   !read_value(file, cmd.primitive_type) ||
+				   !read_value(file, cmd.vertex_count) ||
+				   !read_value(file, cmd.element_range) ||
+				   !read_value(file, cmd.instance_count) ||
+				   !read_value(file, cmd.projection) ||
+				   !read_value(file, cmd.depth.depth_func) ||
+				   !read_string(file, file_size, cmd.depth.custom_depth_func) ||
+				   !read_value(file, cmd.depth.depth_test) ||
+				   !read_value(file, cmd.depth.depth_override) ||
+				   !read_value(file, cmd.scissor_test) ||
+				   !read_value(file, cmd.backface_culling) ||
+				   !read_value(file, cmd.attribute_setup) ||
+				   !read_value(file, cmd.scissor_rectangle) ||
+				   !read_value(file, cmd.cam_setup) ||
+				   !read_count(file, file_size, binding_count, sizeof(unsigned long long int) * 3 + sizeof(RESOURCE_TYPE))) {
+					return fail();
+				}
+				if(cmd.transform_program >= cap.programs.size() ||
+				   cmd.rasterization_program >= cap.programs.size()) {
+					return fail();
+				}
+				cmd.bindings.resize(binding_count);
+				for(auto& binding : cmd.bindings) {
+					if(!read_string(file, file_size, binding.name) ||
+					   !read_value(file, binding.type) ||
+					   !read_size(file, binding.index) ||
+					   !read_size(file, binding.fb_image_index)) {
+						return fail();
+					}
+					const size_t resource_count = (binding.type == RESOURCE_TYPE::BUFFER ? cap.buffers.size() :
+												   (binding.type == RESOURCE_TYPE::IMAGE ? cap.images.size() :
+													cap.framebuffers.size()));
+					if(binding.index >= resource_count) return fail();
+				}
+			}
+			break;
+			default: return fail();
+		}
+	}
+	return true;
+}
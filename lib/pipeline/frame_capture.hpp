@@ -0,0 +1,160 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_FRAME_CAPTURE_HPP__
+#define __OCLRASTER_FRAME_CAPTURE_HPP__
+
+#include "oclraster/global.hpp"
+#include "pipeline/pipeline.hpp"
+
+// serializes everything a single frame needs to be rendered again into a file: all clears and draw calls
+// (with the complete draw state at the time of the call), the contents of all bound buffers and images,
+// the used program sources and the formats of all used framebuffers.
+// a capture is requested at any time and records the next complete frame (from one swap to the next).
+// NOTE: buffer and image contents are snapshotted at draw time (-> this makes a draw call blocking),
+// framebuffer images that are used as program inputs are stored as references to the framebuffer.
+// the fxaa pass and the blit to the window in swap are not recorded.
+class frame_capture {
+public:
+	static constexpr unsigned int version { 3 };
+	static constexpr size_t default_framebuffer_id { 0 };
+	
+	enum class COMMAND_TYPE : unsigned int {
+		CLEAR,
+		DRAW
+	};
+	enum class RESOURCE_TYPE : unsigned int {
+		BUFFER,
+		IMAGE,
+		FRAMEBUFFER_IMAGE
+	};
+	
+	struct program_data {
+		bool transform; // transform_program or rasterization_program
+		string source;
+		string entry_function;
+		string build_options; // user build options (w/o the program type define)
+	};
+	struct image_data {
+		uint2 size;
+		image::BACKING backing;
+		IMAGE_TYPE data_type;
+		IMAGE_CHANNEL channel_order;
+		bool mipmapped; // only the first level is stored, other levels are regenerated on replay
+		vector<unsigned char> pixels;
+	};
+	struct framebuffer_data {
+		uint2 size;
+		vector<pair<IMAGE_TYPE, IMAGE_CHANNEL>> image_types;
+		pair<IMAGE_TYPE, IMAGE_CHANNEL> depth_type { IMAGE_TYPE::NONE, IMAGE_CHANNEL::NONE };
+		pair<IMAGE_TYPE, IMAGE_CHANNEL> stencil_type { IMAGE_TYPE::NONE, IMAGE_CHANNEL::NONE };
+	};
+	struct binding_data {
+		string name;
+		RESOURCE_TYPE type;
+		size_t index; // buffer/image index or framebuffer id
+		size_t fb_image_index; // only used with FRAMEBUFFER_IMAGE
+	};
+	struct command {
+		COMMAND_TYPE type;
+		size_t framebuffer_id;
+		
+		// clear
+		vector<size_t> clear_indices;
+		bool clear_depth;
+		bool clear_stencil;
+		ulong4 clear_color_int;
+		double4 clear_color_float;
+		float clear_depth_value;
+		unsigned long long int clear_stencil_value;
+		
+		// draw
+		size_t transform_program;
+		size_t rasterization_program;
+		PRIMITIVE_TYPE primitive_type;
+		unsigned int vertex_count;
+		pair<unsigned int, unsigned int> element_range;
+		unsigned int instance_count;
+		PROJECTION projection;
+		depth_state depth;
+		bool scissor_test;
+		bool backface_culling;
+		bool attribute_setup;
+		uint4 scissor_rectangle;
+		draw_state::camera_setup cam_setup;
+		vector<binding_data> bindings;
+	};
+	struct capture {
+		vector<program_data> programs;
+		vector<vector<unsigned char>> buffers;
+		vector<image_data> images;
+		vector<framebuffer_data> framebuffers; // [0] is always the default framebuffer
+		vector<command> commands;
+	};
+	
+	// the next complete frame will be written to the specified file
+	static void request(const string& filename);
+	static bool is_capturing() {
+		return capturing;
+	}
+	
+	// loads a capture file, returns false on failure
+	static bool load(const string& filename, capture& cap);
+	
+	// called by the pipeline: begin_frame at the end of a swap (before the next default framebuffer
+	// is cleared), end_frame at the start of a swap (writes the capture file)
+	static void begin_frame(const vector<framebuffer>& default_framebuffers);
+	static void end_frame();
+	
+	// called by the pipeline/framebuffer if capturing
+	static void record_clear(const framebuffer& fb,
+							 const vector<size_t>& image_indices,
+							 const bool clear_depth,
+							 const bool clear_stencil);
+	static void record_draw(const draw_state& state,
+							const PRIMITIVE_TYPE type,
+							const unsigned int vertex_count,
+							const pair<unsigned int, unsigned int> element_range,
+							const unsigned int instance_count);
+
+protected:
+	static atomic<bool> capturing;
+	static atomic<bool> requested;
+	static mutex request_lock;
+	static string requested_filename;
+	static string filename;
+	
+	// state of the current capture
+	static capture cur_capture;
+	static unordered_map<const oclraster_program*, size_t> program_ids;
+	static unordered_map<const framebuffer*, size_t> framebuffer_ids;
+	// last snapshot of each buffer/image (-> unchanged contents are only stored once)
+	static unordered_map<const void*, size_t> buffer_snapshots;
+	static unordered_map<const void*, size_t> image_snapshots;
+	
+	static void reset();
+	static size_t get_program_id(const oclraster_program* program, const bool transform);
+	static size_t get_framebuffer_id(const framebuffer* fb);
+	static size_t snapshot_buffer(const opencl_base::buffer_object* buffer);
+	static bool find_framebuffer_image(const image* img, binding_data& binding);
+	static size_t snapshot_image(const image* img);
+	static bool write(const string& filename, const capture& cap);
+	
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include "oclraster.hpp"
 #include "oclraster_program.hpp"
 #include "pipeline.hpp"
+#include "frame_capture.hpp"
 
 //
 static constexpr char template_framebuffer_program[] { u8R"OCLRASTER_RAWSTR(
@@ -124,6 +125,7 @@ const framebuffer_program::clear_kernel& framebuffer_program::get_clear_kernel(c
 }
 
 const framebuffer_program::clear_kernel& framebuffer_program::build_kernel(const image_spec& spec) {
+	OCLRASTER_TRACE_SCOPE("build_clear_kernel", "program");
 	image_spec* new_spec = new image_spec(spec);
 	compiled_image_kernels.emplace_back(new_spec);
 	
@@ -235,6 +237,9 @@ framebuffer framebuffer::create_with_images(const unsigned int& width, const uns
 		ret_fb.attach_stencil_buffer(*new image(width, height, image::BACKING::BUFFER, stencil_type.first, stencil_type.second));
 	}
 	
+	// account these as framebuffer memory (instead of image memory)
+	ret_fb.set_memory_tag(MEMORY_TAG::FRAMEBUFFER);
+	
 	return ret_fb;
 }
 
@@ -308,6 +313,15 @@ image* framebuffer::get_stencil_buffer() {
 }
 
 void framebuffer::attach(const size_t& index, image& img) {
+	// framebuffer images are directly accessed by the rasterization and clear kernels (-> no tiled layouts)
+	if(img.get_layout() != image::LAYOUT::LINEAR) {
+		log_error("framebuffer images must use the linear image layout!");
+		return;
+	}
+	if(img.get_image_type().is_compressed()) {
+		log_error("block compressed images can't be attached to a framebuffer (they are read-only)!");
+		return;
+	}
 	if(index >= images.size()) {
 		images.resize(index+1, nullptr);
 	}
@@ -341,6 +355,14 @@ size_t framebuffer::get_attachment_count() const {
 	return images.size();
 }
 
+void framebuffer::set_memory_tag(const MEMORY_TAG tag) {
+	for(auto& img : images) {
+		if(img != nullptr) img->set_memory_tag(tag);
+	}
+	if(depth_buffer != nullptr) depth_buffer->set_memory_tag(tag);
+	if(stencil_buffer != nullptr) stencil_buffer->set_memory_tag(tag);
+}
+
 void framebuffer::attach_depth_buffer(image& img) {
 	if(!((img.get_data_type() == IMAGE_TYPE::NONE && img.get_channel_order() == IMAGE_CHANNEL::NONE) ||
 		 (img.get_data_type() == IMAGE_TYPE::FLOAT_32 && img.get_channel_order() == IMAGE_CHANNEL::R))) {
@@ -369,6 +391,10 @@ void framebuffer::detach_stencil_buffer() {
 }
 
 void framebuffer::clear(const vector<size_t> image_indices, const bool depth_clear, const bool stencil_clear) const {
+	OCLRASTER_TRACE_SCOPE("clear", "framebuffer");
+	if(frame_capture::is_capturing()) {
+		frame_capture::record_clear(*this, image_indices, depth_clear, stencil_clear);
+	}
 	const vector<size_t>* indices = &image_indices;
 	vector<size_t> all_indices;
 	if(image_indices.size() == 1 && image_indices[0] == ~0u) {
@@ -454,6 +480,10 @@ void framebuffer::clear(const vector<size_t> image_indices, const bool depth_cle
 			case IMAGE_TYPE::FLOAT_64:
 				ocl->set_kernel_argument(argc++, clear_color_float);
 				break;
+			case IMAGE_TYPE::BC1:
+			case IMAGE_TYPE::BC3:
+			case IMAGE_TYPE::BC4:
+			case IMAGE_TYPE::BC5:
 			case IMAGE_TYPE::NONE:
 			case IMAGE_TYPE::__MAX_TYPE:
 				floor_unreachable();
@@ -485,7 +515,13 @@ void framebuffer::clear(const vector<size_t> image_indices, const bool depth_cle
 		ocl->set_kernel_range(ocl->compute_kernel_ranges(size.x, size.y));
 	}
 	ocl->set_kernel_argument(argc++, scissor_rectangle);
+#if defined(OCLRASTER_PROFILING)
+	if(active_pipeline != nullptr) active_pipeline->get_profiler().begin(PIPELINE_STAGE::CLEAR);
+#endif
 	ocl->run_kernel();
+#if defined(OCLRASTER_PROFILING)
+	if(active_pipeline != nullptr) active_pipeline->get_profiler().end(PIPELINE_STAGE::CLEAR);
+#endif
 }
 
 void framebuffer::set_clear_color(const double4 value) {
@@ -527,3 +563,164 @@ void framebuffer::set_clear_stencil(const unsigned long long int value) {
 const unsigned long long int& framebuffer::get_clear_stencil() const {
 	return clear_stencil;
 }
+
+//// asynchronous readback
+static atomic<unsigned long long int> queue_sync_epoch { 0 };
+static mutex readback_pool_lock;
+static unordered_multimap<size_t, opencl::buffer_object*> readback_pool; // size -> unused staging buffers
+static unordered_map<size_t, unsigned long long int> readback_size_epochs; // size -> sync epoch of the last request/release
+static bool readback_pool_destroyed { false }; // readbacks that outlive oclraster::destroy free their buffers directly
+// pooled buffers of a size that hasn't been requested or released for this many sync points are freed
+// (-> no buffers of old sizes are kept around after a framebuffer resize or a change of attachments)
+static constexpr unsigned long long int readback_pool_max_age { 8 };
+// further released buffers are freed directly
+static constexpr size_t readback_pool_max_size { 32 };
+
+static opencl::buffer_object* acquire_readback_buffer(const size_t& size) {
+	{
+		lock_guard<mutex> lock(readback_pool_lock);
+		readback_size_epochs[size] = queue_sync_epoch;
+		const auto iter = readback_pool.find(size);
+		if(iter != readback_pool.end()) {
+			opencl::buffer_object* buffer = iter->second;
+			readback_pool.erase(iter);
+			return buffer;
+		}
+	}
+	// note: no BLOCK_ON_* flags (-> copies into this buffer are non-blocking)
+	return memory_tracker::create_buffer(MEMORY_TAG::FRAMEBUFFER, opencl::BUFFER_FLAG::READ_WRITE, size);
+}
+
+static void release_readback_buffer(opencl::buffer_object* buffer, const size_t& size) {
+	{
+		lock_guard<mutex> lock(readback_pool_lock);
+		if(!readback_pool_destroyed && readback_pool.size() < readback_pool_max_size) {
+			readback_size_epochs[size] = queue_sync_epoch;
+			readback_pool.emplace(size, buffer);
+			return;
+		}
+	}
+	if(ocl != nullptr) {
+		memory_tracker::delete_buffer(buffer);
+	}
+}
+
+void delete_readback_buffers() {
+	lock_guard<mutex> lock(readback_pool_lock);
+	for(const auto& entry : readback_pool) {
+		memory_tracker::delete_buffer(entry.second);
+	}
+	readback_pool.clear();
+	readback_size_epochs.clear();
+	readback_pool_destroyed = true;
+}
+
+void framebuffer::signal_queue_sync() {
+	const unsigned long long int epoch = ++queue_sync_epoch;
+	
+	// trim the readback pool
+	lock_guard<mutex> lock(readback_pool_lock);
+	for(auto iter = readback_size_epochs.begin(); iter != readback_size_epochs.end();) {
+		if(epoch - std::min(iter->second, epoch) <= readback_pool_max_age) {
+			++iter;
+			continue;
+		}
+		const auto range = readback_pool.equal_range(iter->first);
+		for(auto buffer_iter = range.first; buffer_iter != range.second; ++buffer_iter) {
+			memory_tracker::delete_buffer(buffer_iter->second);
+		}
+		readback_pool.erase(range.first, range.second);
+		iter = readback_size_epochs.erase(iter);
+	}
+}
+
+void framebuffer::sync_readbacks() {
+	ocl->finish();
+	// everything has completed -> zero-copy memory of deleted buffers can be freed as well
+	memory_tracker::release_deferred();
+	signal_queue_sync();
+}
+
+shared_ptr<framebuffer::readback> framebuffer::read_async(const vector<size_t> image_indices, const bool read_depth) const {
+	shared_ptr<readback> ret { new readback() };
+	ret->size = size;
+	ret->sync_epoch = queue_sync_epoch;
+	
+	const auto add_staging = [&ret](const image* img, const size_t& index) {
+		if(img == nullptr) return;
+		const uint2 img_size = img->get_size();
+		const size_t data_size = size_t(img_size.x) * size_t(img_size.y) * img->get_image_type().pixel_size();
+		opencl::buffer_object* buffer = acquire_readback_buffer(data_size);
+		if(buffer == nullptr) return;
+		
+		if(img->get_backing() == image::BACKING::BUFFER) {
+			ocl->copy_buffer(img->get_data_buffer(), buffer, 0, 0, data_size);
+		}
+		else {
+			ocl->copy_image_to_buffer(img->get_buffer(), buffer);
+		}
+		ret->stagings.emplace_back(readback::staging { index, img->get_image_type(), buffer, data_size, nullptr });
+	};
+	for(const auto& index : image_indices) {
+		if(index >= images.size()) {
+			log_error("invalid framebuffer image index %u!", index);
+			continue;
+		}
+		add_staging(images[index], index);
+	}
+	if(read_depth) {
+		add_staging(depth_buffer, ~size_t(0));
+	}
+	return ret;
+}
+
+framebuffer::readback::~readback() {
+	for(auto& stg : stagings) {
+		if(stg.mapped_ptr != nullptr && ocl != nullptr) {
+			ocl->unmap_buffer(stg.buffer, stg.mapped_ptr);
+		}
+		release_readback_buffer(stg.buffer, stg.size);
+	}
+}
+
+bool framebuffer::readback::is_ready() const {
+	return (queue_sync_epoch > sync_epoch);
+}
+
+void framebuffer::readback::wait() {
+	if(is_ready()) return;
+	sync_readbacks();
+}
+
+const void* framebuffer::readback::map_staging(const size_t& index) {
+	for(auto& stg : stagings) {
+		if(stg.index != index) continue;
+		if(stg.mapped_ptr == nullptr) {
+			// blocking map -> waits for the copy (in-order queue)
+			stg.mapped_ptr = ocl->map_buffer(stg.buffer, opencl::MAP_BUFFER_FLAG::READ | opencl::MAP_BUFFER_FLAG::BLOCK);
+			// all commands that were enqueued before the map have completed as well
+			if(stg.mapped_ptr != nullptr) signal_queue_sync();
+		}
+		return stg.mapped_ptr;
+	}
+	return nullptr;
+}
+
+const void* framebuffer::readback::get_image_data(const size_t& index) {
+	return map_staging(index);
+}
+
+const float* framebuffer::readback::get_depth_data() {
+	return (const float*)map_staging(~size_t(0));
+}
+
+const uint2& framebuffer::readback::get_size() const {
+	return size;
+}
+
+image_type framebuffer::readback::get_image_type(const size_t& index) const {
+	for(const auto& stg : stagings) {
+		if(stg.index == index) return stg.type;
+	}
+	return image_type {};
+}
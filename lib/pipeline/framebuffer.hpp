@@ -90,6 +90,62 @@ public:
 	// does not include depth and stencil buffers
 	size_t get_attachment_count() const;
 	
+	// sets the memory tracker tag of all attached images (including depth and stencil buffers)
+	void set_memory_tag(const MEMORY_TAG tag);
+	
+	// result of an asynchronous readback (see read_async), the host data stays valid until this is destroyed
+	class readback {
+	public:
+		~readback();
+		readback(readback& rb) = delete;
+		readback& operator=(readback& rb) = delete;
+		
+		// true if the copies have completed (-> get_*_data won't block), this is the case after the next
+		// queue sync point: pipeline::swap, sync_readbacks, wait or a get_*_data call of any readback
+		bool is_ready() const;
+		// blocks until the copies have completed (-> sync_readbacks, if this isn't ready yet)
+		void wait();
+		
+		// these block until the copies have completed, nullptr if the image has not been read back
+		const void* get_image_data(const size_t& index);
+		const float* get_depth_data();
+		
+		const uint2& get_size() const;
+		// IMAGE_TYPE::NONE if the image has not been read back
+		image_type get_image_type(const size_t& index) const;
+		
+	protected:
+		friend class framebuffer;
+		readback() = default;
+		
+		struct staging {
+			size_t index; // ~0 == depth
+			image_type type;
+			opencl::buffer_object* buffer;
+			size_t size;
+			void* mapped_ptr;
+		};
+		vector<staging> stagings;
+		uint2 size;
+		unsigned long long int sync_epoch { 0 };
+		
+		const void* map_staging(const size_t& index);
+	};
+	
+	// enqueues a non-blocking device side copy of the specified color images (and the depth buffer) into
+	// staging buffers and returns immediately. the staging buffers are pooled and reused once a readback is
+	// destroyed, so that any amount of frames can be in flight without waiting on the readback or allocating.
+	// pooled buffers of a size that hasn't been requested for several sync points are freed again.
+	shared_ptr<readback> read_async(const vector<size_t> image_indices = vector<size_t> { 0 },
+									const bool read_depth = false) const;
+	
+	// blocks until all enqueued device work has completed, which makes all readbacks that have been enqueued
+	// until now ready. use this for offline rendering without swaps (e.g. once per frame after the last draw).
+	static void sync_readbacks();
+	
+	// must be called once all previously enqueued commands have completed (this is done by pipeline::swap)
+	static void signal_queue_sync();
+	
 protected:
 	uint2 size;
 	vector<image*> images;
@@ -106,5 +162,6 @@ protected:
 
 // only used internally!
 extern void delete_clear_kernels();
+extern void delete_readback_buffers();
 
 #endif
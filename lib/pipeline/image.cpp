@@ -17,6 +17,7 @@
  */
 
 #include "image.hpp"
+#include "image_loader.hpp"
 #include "oclraster.hpp"
 
 // 2d array: [IMAGE_TYPE][IMAGE_CHANNEL] -> cl::ImageFormat (-> will be (0, 0) if not supported)
@@ -88,12 +89,36 @@ bool is_correct_format(const SDL_PixelFormat& format, const IMAGE_CHANNEL& chann
 
 image image::from_file(const string& filename, const BACKING& backing,
 					   const IMAGE_TYPE& type, const IMAGE_CHANNEL& channel_order) {
-	const auto fail_return = [&filename, &backing](const string& error_msg) -> image {
-		log_error("%s (\"%s\"): %s!", error_msg, filename, SDL_GetError());
-		const unsigned int fail_pixel = 0xDEADBEEF;
-		auto img = image(1, 1, backing, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA, &fail_pixel);
-		img.invalidate();
-		return img;
+	string error_msg = "";
+	SDL_Surface* surface = load_surface(filename, type, channel_order, error_msg);
+	if(surface == nullptr) {
+		log_error("%s", error_msg);
+		return create_fail_image(backing);
+	}
+	
+	image img(surface->w, surface->h, backing, type, channel_order, surface->pixels);
+	SDL_FreeSurface(surface);
+	return img;
+}
+
+future<image> image::from_file_async(const string& filename, const BACKING& backing,
+									 const IMAGE_TYPE& type, const IMAGE_CHANNEL& channel_order) {
+	return image_loader::load(image_loader::request { filename, backing, type, channel_order });
+}
+
+image image::create_fail_image(const BACKING& backing) {
+	const unsigned int fail_pixel = 0xDEADBEEF;
+	auto img = image(1, 1, backing, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA, &fail_pixel);
+	img.invalidate();
+	return img;
+}
+
+SDL_Surface* image::load_surface(const string& filename, const IMAGE_TYPE& type,
+								 const IMAGE_CHANNEL& channel_order, string& error_msg) {
+	// note: SDL errors are per thread
+	const auto fail_return = [&filename, &error_msg](const string& msg) -> SDL_Surface* {
+		error_msg = msg + " (\"" + filename + "\"): " + SDL_GetError() + "!";
+		return nullptr;
 	};
 	if(type >= IMAGE_TYPE::__MAX_TYPE) return fail_return("invalid image type");
 	if(channel_order >= IMAGE_CHANNEL::__MAX_CHANNEL) return fail_return("invalid channel type");
@@ -216,18 +241,17 @@ image image::from_file(const string& filename, const BACKING& backing,
 		
 		SDL_Surface* converted_surface = SDL_ConvertSurface(surface, &correct_format, 0);
 		if(converted_surface == nullptr) {
+			SDL_FreeSurface(surface);
 			return fail_return("failed to convert image to correct format");
 		}
 		SDL_FreeSurface(surface);
 		surface = converted_surface;
 	}
 	else if(type != IMAGE_TYPE::INT_8 && type != IMAGE_TYPE::UINT_8) {
+		SDL_FreeSurface(surface);
 		return fail_return("automatic conversion to image types != INT_8 or UINT_8 not supported");
 	}
-	
-	image img(surface->w, surface->h, backing, type, channel_order, surface->pixels);
-	SDL_FreeSurface(surface);
-	return img;
+	return surface;
 }
 
 image::image(const unsigned int& width, const unsigned int& height,
@@ -249,6 +273,7 @@ backing(BACKING::IMAGE), img_type(type, channel_order_), data_type(type), channe
 }
 
 void image::create_buffer(const void* pixels) {
+	buffer_generation++;
 #if defined(OCLRASTER_DEBUG)
 	if(data_type >= IMAGE_TYPE::__MAX_TYPE) {
 		log_error("invalid image type: %u!", data_type);
@@ -262,6 +287,20 @@ void image::create_buffer(const void* pixels) {
 	}
 #endif
 	
+	if(img_type.is_compressed()) {
+		// the channel type is implied by the block compressed type
+		static constexpr array<IMAGE_CHANNEL, 4> compressed_channels {
+			{ IMAGE_CHANNEL::RGBA, IMAGE_CHANNEL::RGBA, IMAGE_CHANNEL::R, IMAGE_CHANNEL::RG }
+		};
+		if(channel_order != compressed_channels[(size_t)data_type - (size_t)IMAGE_TYPE::BC1]) {
+			log_error("invalid channel type for block compressed image type \"%s\"!", img_type.to_string());
+			invalidate();
+			return;
+		}
+		// there is no native support for block compressed images (they are decoded on the fly in software)
+		backing = BACKING::BUFFER;
+	}
+	
 	if(backing == BACKING::IMAGE) {
 		// if constructed with a native format, check if the specified format is supported
 		if(native_format.image_channel_data_type != 0 ||
@@ -298,21 +337,26 @@ void image::create_buffer(const void* pixels) {
 	
 	if(backing == BACKING::BUFFER) {
 		img_type.native = false;
-		const size_t pixel_size = img_type.pixel_size();
-		const size_t data_size = size.x * size.y * pixel_size;
-		const size_t buffer_size = header_size() + data_size;
+		const size_t data_size = get_mip_level_data_size(0);
+		const size_t buffer_size = (get_mip_level_offset(mip_level_count - 1) + header_size() +
+									get_mip_level_data_size(mip_level_count - 1));
 		
-		auto buffer_ptrs = ocl->create_and_map_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-													  opencl::BUFFER_FLAG::BLOCK_ON_READ |
-													  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-													  buffer_size,
-													  nullptr,
-													  opencl::MAP_BUFFER_FLAG::WRITE_INVALIDATE |
-													  opencl::MAP_BUFFER_FLAG::BLOCK,
-													  0,
-													  pixels == nullptr ? header_size() : buffer_size);
-		buffer = buffer_ptrs.first;
-		auto mapped_ptr = buffer_ptrs.second;
+		// note: created through the memory tracker, so that the zero-copy policy applies (cpu devices)
+		buffer = memory_tracker::create_buffer(memory_tag,
+											   opencl::BUFFER_FLAG::READ_WRITE |
+											   opencl::BUFFER_FLAG::BLOCK_ON_READ |
+											   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+											   buffer_size);
+		if(buffer == nullptr) {
+			log_error("image buffer creation failed!");
+			invalidate();
+			return;
+		}
+		auto mapped_ptr = ocl->map_buffer(buffer,
+										  opencl::MAP_BUFFER_FLAG::WRITE_INVALIDATE |
+										  opencl::MAP_BUFFER_FLAG::BLOCK,
+										  0,
+										  pixels == nullptr ? header_size() : buffer_size);
 		
 		// init buffer
 		header* header_ptr = (header*)mapped_ptr;
@@ -320,14 +364,37 @@ void image::create_buffer(const void* pixels) {
 		header_ptr->channel_order = channel_order;
 		header_ptr->width = size.x;
 		header_ptr->height = size.y;
+		header_ptr->mip_level_count = mip_level_count;
+		header_ptr->layout = (unsigned short int)layout;
+		for(unsigned int level = 0; level < mip_level_count; level++) {
+			header_ptr->mip_level_offsets[level] = (unsigned int)get_mip_level_offset(level);
+		}
 		
 		// fill buffer with the specified pixels (otherwise, leave it uninitialized)
 		if(pixels != nullptr) {
 			unsigned char* data_ptr = (unsigned char*)mapped_ptr + header_size();
-			copy_n((const unsigned char*)pixels, data_size, data_ptr);
+			if(layout == LAYOUT::LINEAR) {
+				copy_n((const unsigned char*)pixels, data_size, data_ptr);
+			}
+			else {
+				convert_tiled(data_ptr, (unsigned char*)pixels, uint2 { 0u, 0u }, size, true);
+			}
 		}
 		ocl->unmap_buffer(buffer, mapped_ptr);
 		
+		// headers of all other mip-map levels (the level data is written by generate_mipmaps)
+		for(unsigned int level = 1; level < mip_level_count; level++) {
+			const uint2 level_size = get_mip_level_size(level);
+			header level_header {};
+			level_header.type = data_type;
+			level_header.channel_order = channel_order;
+			level_header.width = level_size.x;
+			level_header.height = level_size.y;
+			level_header.mip_level_count = 1;
+			level_header.layout = (unsigned short int)layout;
+			ocl->write_buffer(buffer, &level_header, get_mip_level_offset(level), sizeof(header));
+		}
+		
 		data_buffer = ocl->create_sub_buffer(buffer,
 											 opencl::BUFFER_FLAG::READ_WRITE |
 											 opencl::BUFFER_FLAG::BLOCK_ON_READ |
@@ -347,6 +414,7 @@ void image::create_buffer(const void* pixels) {
 			invalidate();
 			return;
 		}
+		memory_tracker::track(memory_tag, buffer, size.x * size.y * img_type.pixel_size());
 	}
 	
 	// image creation was successful -> set valid state
@@ -358,15 +426,17 @@ image::~image() {
 		if(data_buffer != nullptr) {
 			ocl->delete_buffer(data_buffer);
 		}
-		ocl->delete_buffer(buffer);
+		memory_tracker::delete_buffer(buffer);
 	}
 }
 
 image::image(image&& img) noexcept :
 backing(img.backing), img_type(img.img_type), data_type(img.data_type), channel_order(img.channel_order),
-size(img.size), buffer(img.buffer), native_format(img.native_format) {
+size(img.size), buffer(img.buffer), buffer_generation(img.buffer_generation), valid(img.valid), memory_tag(img.memory_tag), mip_level_count(img.mip_level_count),
+layout(img.layout), native_format(img.native_format), data_buffer(img.data_buffer) {
 	img.invalidate();
 	img.buffer = nullptr;
+	img.data_buffer = nullptr;
 }
 
 image::BACKING image::get_backing() const {
@@ -381,6 +451,10 @@ opencl::buffer_object* image::get_buffer() {
 	return buffer;
 }
 
+unsigned long long int image::get_buffer_generation() const {
+	return buffer_generation;
+}
+
 const opencl::buffer_object* image::get_data_buffer() const {
 	return data_buffer;
 }
@@ -416,7 +490,23 @@ void image::write(const void* src, const uint2 offset, const uint2 size_) {
 		1
 	};
 	if(backing == BACKING::BUFFER) {
-		ocl->write_buffer_rect(data_buffer, src, size3(offset.x, offset.y, 0), size3(0, 0, 0), write_size);
+		if(img_type.is_compressed()) {
+			// blocks can only be written as a whole -> only complete images are supported
+			if(offset.x != 0 || offset.y != 0 || write_size.x != size.x || write_size.y != size.y) {
+				log_error("only complete block compressed images can be written!");
+				return;
+			}
+			ocl->write_buffer(data_buffer, src);
+		}
+		else if(layout != LAYOUT::LINEAR) {
+			unsigned char* data_ptr = (unsigned char*)ocl->map_buffer(data_buffer, (opencl::MAP_BUFFER_FLAG::WRITE |
+																				   opencl::MAP_BUFFER_FLAG::BLOCK));
+			convert_tiled(data_ptr, (unsigned char*)src, offset, uint2 { (unsigned int)write_size.x, (unsigned int)write_size.y }, true);
+			ocl->unmap_buffer(data_buffer, data_ptr);
+		}
+		else {
+			ocl->write_buffer_rect(data_buffer, src, size3(offset.x, offset.y, 0), size3(0, 0, 0), write_size);
+		}
 	}
 	else {
 		ocl->write_image(buffer, src, size3(offset.x, offset.y, 0), write_size);
@@ -430,7 +520,22 @@ void image::read(void* dst, const uint2 offset, const uint2 size_) {
 		1
 	};
 	if(backing == BACKING::BUFFER) {
-		ocl->read_buffer_rect(dst, data_buffer, size3(offset.x, offset.y, 0), size3(0, 0, 0), read_size);
+		if(img_type.is_compressed()) {
+			if(offset.x != 0 || offset.y != 0 || read_size.x != size.x || read_size.y != size.y) {
+				log_error("only complete block compressed images can be read!");
+				return;
+			}
+			ocl->read_buffer(dst, data_buffer);
+		}
+		else if(layout != LAYOUT::LINEAR) {
+			unsigned char* data_ptr = (unsigned char*)ocl->map_buffer(data_buffer, (opencl::MAP_BUFFER_FLAG::READ |
+																				   opencl::MAP_BUFFER_FLAG::BLOCK));
+			convert_tiled(data_ptr, (unsigned char*)dst, offset, uint2 { (unsigned int)read_size.x, (unsigned int)read_size.y }, false);
+			ocl->unmap_buffer(data_buffer, data_ptr);
+		}
+		else {
+			ocl->read_buffer_rect(dst, data_buffer, size3(offset.x, offset.y, 0), size3(0, 0, 0), read_size);
+		}
 	}
 	else {
 		ocl->read_image(dst, buffer, size3(offset.x, offset.y, 0), read_size);
@@ -444,6 +549,29 @@ void image::copy(const image& src_img, const uint2 src_offset, const uint2 dst_o
 							size_.y == ~0u ? size.y : std::min(size.y, size_.y),
 							1);
 	const size_t pixel_size = img_type.pixel_size();
+	if(img_type.is_compressed() || src_img.get_image_type().is_compressed()) {
+		// block compressed images can only be copied as a whole to an image of the same type and size (through the host)
+		if(src_img.get_image_type() != img_type ||
+		   src_img.get_size().x != size.x || src_img.get_size().y != size.y ||
+		   copy_region.x != size.x || copy_region.y != size.y) {
+			log_error("block compressed images can only be copied as a whole to an image of the same type and size!");
+			return;
+		}
+		vector<unsigned char> blocks(img_type.data_size(size.x, size.y));
+		const_cast<image&>(src_img).read(&blocks[0]);
+		write(&blocks[0]);
+		return;
+	}
+	if((backing == BACKING::BUFFER && layout != LAYOUT::LINEAR) ||
+	   (src_img.get_backing() == BACKING::BUFFER && src_img.get_layout() != LAYOUT::LINEAR)) {
+		// rect copies can't be used with tiled layouts -> copy through the host (this also converts between layouts)
+		const uint2 region { (unsigned int)copy_region.x, (unsigned int)copy_region.y };
+		vector<unsigned char> pixels(size_t(region.x) * size_t(region.y) * pixel_size);
+		if(pixels.empty()) return;
+		const_cast<image&>(src_img).read(&pixels[0], src_offset, region);
+		write(&pixels[0], dst_offset, region);
+		return;
+	}
 	if(backing == BACKING::BUFFER) {
 		if(src_img.get_backing() == BACKING::BUFFER) {
 			// buffer -> buffer
@@ -459,13 +587,14 @@ void image::copy(const image& src_img, const uint2 src_offset, const uint2 dst_o
 										  pixel_size * dst_offset.y * size.x);
 			}
 			else {
-				opencl::buffer_object* copy_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-																		opencl::BUFFER_FLAG::BLOCK_ON_READ |
-																		opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-																		pixel_size * copy_region.x * copy_region.y, nullptr);
+				opencl::buffer_object* copy_buffer = memory_tracker::create_buffer(memory_tag,
+																				   opencl::BUFFER_FLAG::READ_WRITE |
+																				   opencl::BUFFER_FLAG::BLOCK_ON_READ |
+																				   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+																				   pixel_size * copy_region.x * copy_region.y, nullptr);
 				ocl->copy_image_to_buffer(src_img.get_buffer(), copy_buffer, copy_src_offset, copy_region, 0);
 				ocl->copy_buffer_rect(copy_buffer, data_buffer, size3(0, 0, 0), copy_dst_offset, copy_region);
-				ocl->delete_buffer(copy_buffer);
+				memory_tracker::delete_buffer(copy_buffer);
 			}
 		}
 	}
@@ -484,13 +613,14 @@ void image::copy(const image& src_img, const uint2 src_offset, const uint2 dst_o
 										  copy_dst_offset, copy_region);
 			}
 			else {
-				opencl::buffer_object* copy_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-																		opencl::BUFFER_FLAG::BLOCK_ON_READ |
-																		opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-																		pixel_size * copy_region.x * copy_region.y, nullptr);
+				opencl::buffer_object* copy_buffer = memory_tracker::create_buffer(memory_tag,
+																				   opencl::BUFFER_FLAG::READ_WRITE |
+																				   opencl::BUFFER_FLAG::BLOCK_ON_READ |
+																				   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+																				   pixel_size * copy_region.x * copy_region.y, nullptr);
 				ocl->copy_buffer_rect(src_img.get_data_buffer(), copy_buffer, copy_src_offset, size3(0, 0, 0), copy_region);
 				ocl->copy_buffer_to_image(copy_buffer, buffer, 0, copy_dst_offset, copy_region);
-				ocl->delete_buffer(copy_buffer);
+				memory_tracker::delete_buffer(copy_buffer);
 			}
 		}
 	}
@@ -498,6 +628,7 @@ void image::copy(const image& src_img, const uint2 src_offset, const uint2 dst_o
 
 void* __attribute__((aligned(128))) image::map(const opencl::MAP_BUFFER_FLAG access_type) {
 	if(backing == BACKING::BUFFER) {
+		if(layout != LAYOUT::LINEAR) return map_tiled(access_type);
 		return ocl->map_buffer(data_buffer, access_type);
 	}
 	else {
@@ -516,6 +647,7 @@ const void* __attribute__((aligned(128))) image::map(const opencl::MAP_BUFFER_FL
 #endif
 	
 	if(backing == BACKING::BUFFER) {
+		if(layout != LAYOUT::LINEAR) return map_tiled(access_type);
 		return ocl->map_buffer(data_buffer, access_type);
 	}
 	else {
@@ -532,6 +664,14 @@ void* __attribute__((aligned(128))) image::map_region(const uint2 offset, const
 	if(backing == BACKING::BUFFER) {
 		// mapping a region with a width other than the images width is not possible when buffer based backing is used,
 		// because there is no way to specify a row offset when mapping a buffer (+then, there wouldn't be a way to offset by the header size)
+		if(layout != LAYOUT::LINEAR) {
+			log_error("map_region is not possible with a tiled image layout!");
+			return nullptr;
+		}
+		if(img_type.is_compressed()) {
+			log_error("map_region is not possible with block compressed images!");
+			return nullptr;
+		}
 		if(offset.x != 0) {
 			log_error("map x-offset must be 0 when BUFFER backing is used!");
 			return nullptr;
@@ -552,6 +692,15 @@ void* __attribute__((aligned(128))) image::map_region(const uint2 offset, const
 
 void image::unmap(const void* mapped_ptr) const {
 	if(backing == BACKING::BUFFER) {
+		if(!map_staging.empty() && mapped_ptr == &map_staging[0]) {
+			// tiled layout: write back the linear copy (if it was mapped for writing)
+			if(map_staging_write_back) {
+				const_cast<image*>(this)->write(&map_staging[0]);
+			}
+			map_staging.clear();
+			map_staging.shrink_to_fit();
+			return;
+		}
 		ocl->unmap_buffer(data_buffer, (void*)mapped_ptr);
 	}
 	else {
@@ -562,11 +711,17 @@ void image::unmap(const void* mapped_ptr) const {
 bool image::modify_backing(const BACKING& new_backing) {
 	if(backing == new_backing) return true;
 	
+	// native images have no layout and the device-side copy below only works with linear data
+	if(layout != LAYOUT::LINEAR && !modify_layout(LAYOUT::LINEAR)) {
+		return false;
+	}
+	
 	const BACKING old_backing = backing;
 	opencl::buffer_object* old_buffer = buffer;
 	opencl::buffer_object* old_data_buffer = data_buffer;
 	
 	backing = new_backing;
+	mip_level_count = 1; // only the first level is copied -> mip-maps must be regenerated
 	create_buffer(nullptr); // init pixel == nullptr, because we'll do a device-side copy later
 	
 	// this can only happen, if IMAGE backing should be used, but it's falling back to BUFFER backing
@@ -588,11 +743,255 @@ bool image::modify_backing(const BACKING& new_backing) {
 		ocl->delete_buffer(old_data_buffer); // no longer needed
 		data_buffer = nullptr;
 	}
-	ocl->delete_buffer(old_buffer);
+	memory_tracker::delete_buffer(old_buffer);
+	
+	return true;
+}
+
+unsigned int image::compute_mip_level_count(const uint2& img_size) {
+	unsigned int level_count = 1;
+	for(unsigned int max_dim = std::max(img_size.x, img_size.y); max_dim > 1; max_dim >>= 1u) {
+		level_count++;
+	}
+	return std::min(level_count, (unsigned int)OCLRASTER_IMAGE_MAX_MIP_LEVELS);
+}
+
+unsigned int image::get_mip_level_count() const {
+	return mip_level_count;
+}
+
+uint2 image::get_mip_level_size(const unsigned int& level) const {
+	return uint2 { std::max(size.x >> level, 1u), std::max(size.y >> level, 1u) };
+}
+
+size_t image::get_mip_level_offset(const unsigned int& level) const {
+	// each level starts with a header -> keep all levels aligned to the header size
+	size_t offset = 0;
+	for(unsigned int i = 0; i < level; i++) {
+		const size_t level_data_size = get_mip_level_data_size(i);
+		offset += header_size() + ((level_data_size + header_size() - 1) / header_size()) * header_size();
+	}
+	return offset;
+}
+
+uint2 image::get_mip_level_storage_size(const unsigned int& level) const {
+	const unsigned int tile_mask = (1u << (unsigned int)layout) - 1u;
+	const uint2 level_size = get_mip_level_size(level);
+	return uint2 { (level_size.x + tile_mask) & ~tile_mask, (level_size.y + tile_mask) & ~tile_mask };
+}
+
+size_t image::get_mip_level_data_size(const unsigned int& level) const {
+	const uint2 storage_size = get_mip_level_storage_size(level);
+	return img_type.data_size(storage_size.x, storage_size.y);
+}
+
+size_t image::get_texel_offset(const uint2& coord) const {
+	const unsigned int tile_shift = (unsigned int)layout;
+	if(tile_shift == 0) return size_t(coord.y) * size_t(size.x) + size_t(coord.x);
+	const unsigned int tile_mask = (1u << tile_shift) - 1u;
+	const size_t tile_count_x = (size.x + tile_mask) >> tile_shift;
+	const size_t tile_idx = size_t(coord.y >> tile_shift) * tile_count_x + size_t(coord.x >> tile_shift);
+	return ((((tile_idx << tile_shift) + (coord.y & tile_mask)) << tile_shift) + (coord.x & tile_mask));
+}
+
+void image::convert_tiled(unsigned char* tiled_data, unsigned char* linear_data,
+						  const uint2& offset, const uint2& region, const bool to_tiled) const {
+	// texels inside a tile row are contiguous -> copy runs of up to tile size texels
+	const size_t pixel_size = img_type.pixel_size();
+	const unsigned int tile_size = 1u << (unsigned int)layout;
+	for(unsigned int y = 0; y < region.y; y++) {
+		for(unsigned int x = 0; x < region.x;) {
+			const uint2 coord { offset.x + x, offset.y + y };
+			const unsigned int run = std::min(tile_size - (coord.x & (tile_size - 1u)), region.x - x);
+			unsigned char* tiled_ptr = tiled_data + get_texel_offset(coord) * pixel_size;
+			unsigned char* linear_ptr = linear_data + (size_t(y) * size_t(region.x) + size_t(x)) * pixel_size;
+			if(to_tiled) copy_n(linear_ptr, run * pixel_size, tiled_ptr);
+			else copy_n(tiled_ptr, run * pixel_size, linear_ptr);
+			x += run;
+		}
+	}
+}
+
+void* image::map_tiled(const opencl::MAP_BUFFER_FLAG access_type) const {
+	// tiled data can't be mapped directly -> map a linear copy, which is written back on unmap
+	map_staging.resize(size_t(size.x) * size_t(size.y) * img_type.pixel_size());
+	if((access_type & opencl::MAP_BUFFER_FLAG::WRITE_INVALIDATE) != opencl::MAP_BUFFER_FLAG::WRITE_INVALIDATE) {
+		const_cast<image*>(this)->read(&map_staging[0]);
+	}
+	map_staging_write_back = ((access_type & opencl::MAP_BUFFER_FLAG::WRITE) == opencl::MAP_BUFFER_FLAG::WRITE ||
+							  (access_type & opencl::MAP_BUFFER_FLAG::WRITE_INVALIDATE) == opencl::MAP_BUFFER_FLAG::WRITE_INVALIDATE);
+	return &map_staging[0];
+}
+
+bool image::modify_layout(const LAYOUT& new_layout) {
+	if(layout == new_layout) return true;
+	if(backing != BACKING::BUFFER) {
+		log_error("image layouts are only supported with buffer based backing!");
+		return false;
+	}
+	if(img_type.is_compressed()) {
+		log_error("block compressed images are always stored in block order (no tiled layouts)!");
+		return false;
+	}
+	
+	// read the first level in the current layout and recreate the buffer with the data in the new layout
+	vector<unsigned char> pixels(size_t(size.x) * size_t(size.y) * img_type.pixel_size());
+	if(!pixels.empty()) read(&pixels[0]);
+	opencl::buffer_object* old_buffer = buffer;
+	opencl::buffer_object* old_data_buffer = data_buffer;
+	layout = new_layout;
+	create_buffer(pixels.empty() ? nullptr : &pixels[0]);
+	ocl->delete_buffer(old_data_buffer);
+	memory_tracker::delete_buffer(old_buffer);
 	
+	// mip-map levels aren't converted -> regenerate them
+	if(mip_level_count > 1) {
+		return generate_mipmaps();
+	}
 	return true;
 }
 
+image::LAYOUT image::get_layout() const {
+	return layout;
+}
+
+//
+static constexpr char template_mip_program[] { u8R"OCLRASTER_RAWSTR(
+	#include "oclr_global.h"
+	#include "oclr_image.h"
+	
+	// 2x2 box filter (integer version avoids overflows)
+#if defined(MIP_INTEGER)
+	#define mip_average(a, b, c, d) ((a) / 4 + (b) / 4 + (c) / 4 + (d) / 4 + ((a) % 4 + (b) % 4 + (c) % 4 + (d) % 4) / 4)
+#else
+	#define mip_average(a, b, c, d) (((a) + (b) + (c) + (d)) * 0.25f + MIP_ROUNDING)
+#endif
+	
+	// generates the specified mip-map level from the previous level (texels outside of odd sized levels are clamped)
+	kernel void generate_mip_level(global uchar* img, const uint level) {
+		global const MIP_IMAGE_TYPE* src_img = (global const MIP_IMAGE_TYPE*)oclr_get_image_mip_level((image_header_ptr)img, level - 1u);
+		global MIP_IMAGE_TYPE* dst_img = (global MIP_IMAGE_TYPE*)oclr_get_image_mip_level((image_header_ptr)img, level);
+		const uint2 dst_size = oclr_get_image_size((image_header_ptr)dst_img);
+		const uint2 coord = (uint2)(get_global_id(0), get_global_id(1));
+		if(coord.x >= dst_size.x || coord.y >= dst_size.y) return;
+		
+		const uint2 src_max = oclr_get_image_size((image_header_ptr)src_img) - 1u;
+		const uint2 src_coord_0 = min(coord * 2u, src_max);
+		const uint2 src_coord_1 = min(coord * 2u + 1u, src_max);
+		image_write_sw(dst_img, coord, mip_average(MIP_READ(src_img, src_coord_0),
+												   MIP_READ(src_img, (uint2)(src_coord_1.x, src_coord_0.y)),
+												   MIP_READ(src_img, (uint2)(src_coord_0.x, src_coord_1.y)),
+												   MIP_READ(src_img, src_coord_1)));
+	}
+)OCLRASTER_RAWSTR"};
+
+static unordered_map<string, weak_ptr<opencl::kernel_object>> mip_kernels;
+static weak_ptr<opencl::kernel_object> get_mip_kernel(const image_type& type) {
+	const string type_str = (type.data_type == IMAGE_TYPE::FLOAT_16 ? "oclr_" : "") + type.to_string(false);
+	const auto iter = mip_kernels.find(type_str);
+	if(iter != mip_kernels.end()) return iter->second;
+	
+	// read/average with the return type of the image type (normalized types are averaged as floats,
+	// with an additional half-step rounding offset to counteract the truncation on write)
+	string build_options = " -DOCLRASTER_IMAGE_" + core::str_to_upper(type_str) + " -DMIP_IMAGE_TYPE=" + type_str;
+	switch(type.data_type) {
+		case IMAGE_TYPE::UINT_8:
+			build_options += " -DMIP_READ=image_read_float_nearest_sw -DMIP_ROUNDING=(0.5f/255.0f)";
+			break;
+		case IMAGE_TYPE::UINT_16:
+			build_options += " -DMIP_READ=image_read_float_nearest_sw -DMIP_ROUNDING=(0.5f/65535.0f)";
+			break;
+		case IMAGE_TYPE::INT_8:
+			build_options += " -DMIP_READ=image_read_float_nearest_sw -DMIP_ROUNDING=(1.0f/255.0f)";
+			break;
+		case IMAGE_TYPE::INT_16:
+			build_options += " -DMIP_READ=image_read_float_nearest_sw -DMIP_ROUNDING=(1.0f/65535.0f)";
+			break;
+		case IMAGE_TYPE::FLOAT_16:
+		case IMAGE_TYPE::FLOAT_32:
+			build_options += " -DMIP_READ=image_read_float_nearest_sw -DMIP_ROUNDING=0.0f";
+			break;
+		case IMAGE_TYPE::FLOAT_64:
+			build_options += " -DMIP_READ=image_read_double_nearest_sw -DMIP_ROUNDING=0.0";
+			break;
+		case IMAGE_TYPE::INT_32:
+		case IMAGE_TYPE::INT_64:
+		case IMAGE_TYPE::UINT_32:
+		case IMAGE_TYPE::UINT_64:
+			build_options += " -DMIP_INTEGER -DMIP_READ=image_read_" + image_data_type_to_string(type.data_type) + "_nearest_sw";
+			break;
+		case IMAGE_TYPE::BC1:
+		case IMAGE_TYPE::BC3:
+		case IMAGE_TYPE::BC4:
+		case IMAGE_TYPE::BC5:
+		case IMAGE_TYPE::NONE:
+		case IMAGE_TYPE::__MAX_TYPE:
+			floor_unreachable();
+	}
+	
+	weak_ptr<opencl::kernel_object> kernel = ocl->add_kernel_src("IMAGE_MIP." + type_str, template_mip_program,
+																 "generate_mip_level", build_options);
+	mip_kernels.emplace(type_str, kernel);
+	return kernel;
+}
+
+void delete_mip_kernels() {
+	mip_kernels.clear();
+}
+
+bool image::generate_mipmaps() {
+	if(backing != BACKING::BUFFER) {
+		log_error("mip-mapping is only supported for images with buffer based backing!");
+		return false;
+	}
+	if(img_type.is_compressed()) {
+		// this would require a block encoder on the device
+		log_error("mip-maps can't be generated for block compressed images!");
+		return false;
+	}
+	
+	const unsigned int level_count = compute_mip_level_count(size);
+	if(level_count != mip_level_count) {
+		// recreate the buffer with storage for all levels and copy over the first level
+		opencl::buffer_object* old_buffer = buffer;
+		opencl::buffer_object* old_data_buffer = data_buffer;
+		mip_level_count = level_count;
+		create_buffer(nullptr);
+		// note: both buffers use the same layout -> copy the complete (padded) level
+		const uint2 storage_size = get_mip_level_storage_size(0);
+		ocl->copy_buffer_rect(old_data_buffer, data_buffer, size3(0, 0, 0), size3(0, 0, 0), size3(storage_size.x, storage_size.y, 1));
+		ocl->delete_buffer(old_data_buffer);
+		memory_tracker::delete_buffer(old_buffer);
+	}
+	if(mip_level_count == 1) return true; // 1x1 image
+	
+	weak_ptr<opencl::kernel_object> kernel = get_mip_kernel(img_type);
+	if(kernel.use_count() == 0) {
+		log_error("failed to create the mip-map kernel for image type \"%s\"!", img_type.to_string());
+		return false;
+	}
+	
+	// each level is generated from the previous one -> one kernel run per level
+	ocl->use_kernel(kernel);
+	ocl->set_kernel_argument(0, buffer);
+	for(unsigned int level = 1; level < mip_level_count; level++) {
+		const uint2 level_size = get_mip_level_size(level);
+		ocl->set_kernel_argument(1, level);
+		ocl->set_kernel_range(ocl->compute_kernel_ranges(level_size.x, level_size.y));
+		ocl->run_kernel();
+	}
+	return true;
+}
+
+void image::set_memory_tag(const MEMORY_TAG tag) {
+	memory_tag = tag;
+	memory_tracker::retag(buffer, tag);
+}
+
+MEMORY_TAG image::get_memory_tag() const {
+	return memory_tag;
+}
+
 void image::invalidate() {
 	valid = false;
 }
@@ -21,6 +21,8 @@
 
 #include "cl/opencl.hpp"
 #include "pipeline/image_types.hpp"
+#include "core/memory_tracker.hpp"
+#include <future>
 
 class image {
 public:
@@ -30,7 +32,17 @@ public:
 		IMAGE	//!< backed by an actual opencl image object
 	};
 	
+	// memory layout of the image data (only used with buffer based backing)
+	// NOTE: the value is the log2 of the tile size, since this is what's stored in the image header
+	enum class LAYOUT : unsigned int {
+		LINEAR		= 0,	//!< row-major (default)
+		TILED_4X4	= 2,	//!< row-major 4x4 texel tiles, row-major texels inside a tile
+		TILED_8X8	= 3,	//!< row-major 8x8 texel tiles, row-major texels inside a tile
+	};
+	
 	// constructor for both buffer backed and image backed images
+	// NOTE: for block compressed types (BC*), pixels must point to the already compressed blocks
+	// (these images always use buffer based backing and can only be written/read/copied as a whole)
 	image(const unsigned int& width, const unsigned int& height,
 		  const BACKING& backing,
 		  const IMAGE_TYPE& type,
@@ -48,6 +60,17 @@ public:
 	// this uses SDL2_image to create an image from a .png file
 	static image from_file(const string& filename, const BACKING& backing,
 						   const IMAGE_TYPE& type, const IMAGE_CHANNEL& channel_order);
+	// same as from_file, but the file is decoded and converted on a worker thread (see image_loader),
+	// the future is ready once the image has been uploaded by image_loader::process_uploads (called on swap)
+	static future<image> from_file_async(const string& filename, const BACKING& backing,
+										 const IMAGE_TYPE& type, const IMAGE_CHANNEL& channel_order);
+	
+	// decodes the .png file and converts it to the specified format (host only, can be called from any thread),
+	// returns nullptr on failure (-> error_msg). the returned surface must be freed with SDL_FreeSurface.
+	static SDL_Surface* load_surface(const string& filename, const IMAGE_TYPE& type,
+									 const IMAGE_CHANNEL& channel_order, string& error_msg);
+	// the invalid 1x1 image that is returned when loading an image file fails
+	static image create_fail_image(const BACKING& backing);
 	
 	//
 	BACKING get_backing() const;
@@ -68,6 +91,7 @@ public:
 			  const uint2 src_offset = { 0u, 0u },
 			  const uint2 dst_offset = { 0u, 0u },
 			  const uint2 size = { ~0u, ~0u });
+	// NOTE: when a tiled layout is used, map/unmap operate on a linear host copy of the image
 	void* __attribute__((aligned(128))) map(const opencl::MAP_BUFFER_FLAG access_type =
 											opencl::MAP_BUFFER_FLAG::READ_WRITE |
 											opencl::MAP_BUFFER_FLAG::BLOCK);
@@ -75,6 +99,7 @@ public:
 												  opencl::MAP_BUFFER_FLAG::READ |
 												  opencl::MAP_BUFFER_FLAG::BLOCK) const; // read-only!
 	// note: if buffer based backing is used, offset.x must be 0 and size.x must match the image width!
+	// also, this is not possible with a tiled layout
 	void* __attribute__((aligned(128))) map_region(const uint2 offset = { 0u, 0u },
 												   const uint2 size = { ~0u, ~0u },
 												   const opencl::MAP_BUFFER_FLAG access_type =
@@ -86,6 +111,28 @@ public:
 	// note that this will of course create a new buffer/image and copy the data
 	bool modify_backing(const BACKING& new_backing);
 	
+	// converts the image data to the specified layout (only possible with buffer based backing)
+	// tiled layouts keep the texels of a 2D neighborhood close in memory (a 4x4 RGBA8 tile is one 64 byte cache line),
+	// which is faster for filtered and rotated/minified access. write/read/copy/map convert from/to linear data.
+	// note: framebuffer images must use the linear layout, and a backing change always results in the linear layout
+	bool modify_layout(const LAYOUT& new_layout);
+	LAYOUT get_layout() const;
+	
+	// creates the storage for the complete mip-map chain (if it doesn't exist yet) and (re)generates all
+	// levels > 0 from the first level on the device (2x2 box filter). this must be called again after the
+	// first level has been modified (write/copy/map or rendered to), since all other functions only access
+	// the first level.
+	// NOTE: only supported with buffer based backing (opencl 1.x has no mip-mapped image objects)
+	bool generate_mipmaps();
+	unsigned int get_mip_level_count() const;
+	uint2 get_mip_level_size(const unsigned int& level) const;
+	// number of levels of a complete mip-map chain (down to 1x1) for the specified size
+	static unsigned int compute_mip_level_count(const uint2& img_size);
+	
+	// the memory tracker tag of this image (IMAGE by default, FRAMEBUFFER for framebuffer images)
+	void set_memory_tag(const MEMORY_TAG tag);
+	MEMORY_TAG get_memory_tag() const;
+	
 	// note: opencl only supports read_only and write_only images
 	// -> if you need read_write access inside your kernel,
 	// buffer based backing must be used
@@ -96,12 +143,18 @@ public:
 	};
 	
 	// image header when a buffer is used
+	// NOTE: every mip-map level starts with its own header (-> a level can be sampled like a normal image),
+	// the header of the first level additionally contains the byte offsets of all levels (relative to itself)
 #define OCLRASTER_IMAGE_HEADER_SIZE 4096
+#define OCLRASTER_IMAGE_MAX_MIP_LEVELS 16
 	struct __attribute__((packed, aligned(OCLRASTER_IMAGE_HEADER_SIZE))) header {
 		IMAGE_TYPE type;
 		IMAGE_CHANNEL channel_order;
 		unsigned short int width;
 		unsigned short int height;
+		unsigned short int mip_level_count;
+		unsigned short int layout;
+		unsigned int mip_level_offsets[OCLRASTER_IMAGE_MAX_MIP_LEVELS];
 		// (unused ...)
 	};
 	static constexpr size_t header_size() {
@@ -118,6 +171,10 @@ public:
 	const opencl::buffer_object* get_data_buffer() const;
 	opencl::buffer_object* get_data_buffer();
 	
+	// incremented whenever the opencl buffer/image of this image is recreated (backing, layout or mip-map
+	// changes), so that cached kernel arguments can be invalidated
+	unsigned long long int get_buffer_generation() const;
+	
 	//
 	void invalidate();
 	bool is_valid() const;
@@ -133,7 +190,15 @@ protected:
 	const IMAGE_CHANNEL channel_order;
 	const uint2 size;
 	opencl::buffer_object* buffer = nullptr;
+	unsigned long long int buffer_generation { 0 };
 	bool valid = false;
+	MEMORY_TAG memory_tag { MEMORY_TAG::IMAGE };
+	unsigned int mip_level_count = 1;
+	LAYOUT layout = LAYOUT::LINEAR;
+	
+	// linear host copy of a tiled image while it's mapped
+	mutable vector<unsigned char> map_staging;
+	mutable bool map_staging_write_back = false;
 	
 	// only used with image based backing
 	cl::ImageFormat native_format;
@@ -144,10 +209,24 @@ protected:
 	
 	//
 	void create_buffer(const void* pixels);
+	// byte offset of the header of the specified mip-map level (buffer based backing)
+	size_t get_mip_level_offset(const unsigned int& level) const;
+	// size of the specified mip-map level in memory (padded to the tile size of tiled layouts)
+	uint2 get_mip_level_storage_size(const unsigned int& level) const;
+	size_t get_mip_level_data_size(const unsigned int& level) const;
+	// texel offset inside the image data (the host version of oclr_get_image_texel_offset)
+	size_t get_texel_offset(const uint2& coord) const;
+	// copies texels from/to the linear host data "linear_data" (with size "region") to/from the tiled image data
+	void convert_tiled(unsigned char* tiled_data, unsigned char* linear_data,
+					   const uint2& offset, const uint2& region, const bool to_tiled) const;
+	void* map_tiled(const opencl::MAP_BUFFER_FLAG access_type) const;
 	
 	//
 	cl::ImageFormat get_image_format(const IMAGE_TYPE& data_type, const IMAGE_CHANNEL channel_type) const;
 	
 };
 
+// only used internally!
+extern void delete_mip_kernels();
+
 #endif
@@ -0,0 +1,186 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "image_loader.hpp"
+#include "oclraster.hpp"
+
+mutex image_loader::loader_lock;
+condition_variable image_loader::request_cv;
+condition_variable image_loader::decoded_cv;
+deque<unique_ptr<image_loader::entry>> image_loader::requests;
+deque<unique_ptr<image_loader::entry>> image_loader::decoded;
+vector<thread> image_loader::workers;
+unsigned int image_loader::thread_count { 0 };
+size_t image_loader::pending_count { 0 };
+atomic<size_t> image_loader::frame_upload_budget { 64u * 1024u * 1024u };
+bool image_loader::running { false };
+
+static size_t surface_data_size(const SDL_Surface* surface) {
+	return (surface != nullptr ? size_t(surface->pitch) * size_t(surface->h) : 0);
+}
+
+void image_loader::set_thread_count(const unsigned int count) {
+	lock_guard<mutex> lock(loader_lock);
+	thread_count = count;
+}
+
+void image_loader::start_workers() {
+	// note: loader_lock must be held
+	if(running) return;
+	running = true;
+	
+	const unsigned int count = (thread_count != 0 ? thread_count : std::max(thread::hardware_concurrency(), 1u));
+	workers.reserve(count);
+	for(unsigned int i = 0; i < count; i++) {
+		workers.emplace_back(&image_loader::worker_run);
+	}
+	log_debug("started %u image loader threads", count);
+}
+
+void image_loader::worker_run() {
+	for(;;) {
+		unique_ptr<entry> cur_entry;
+		{
+			unique_lock<mutex> lock(loader_lock);
+			request_cv.wait(lock, [] { return (!running || !requests.empty()); });
+			if(!running) return;
+			cur_entry = move(requests.front());
+			requests.pop_front();
+		}
+		
+		// decoding and format conversion is host only (-> no opencl calls here)
+		cur_entry->surface = image::load_surface(cur_entry->req.filename, cur_entry->req.type,
+												 cur_entry->req.channel_order, cur_entry->error_msg);
+		// note: failed decodes have no host data (and no matching remove_host)
+		if(cur_entry->surface != nullptr) {
+			memory_tracker::add_host(MEMORY_TAG::IMAGE, surface_data_size(cur_entry->surface));
+		}
+		
+		{
+			lock_guard<mutex> lock(loader_lock);
+			decoded.emplace_back(move(cur_entry));
+		}
+		decoded_cv.notify_all();
+	}
+}
+
+future<image> image_loader::load(const request& req) {
+	unique_ptr<entry> new_entry { new entry() };
+	new_entry->req = req;
+	future<image> ret = new_entry->result.get_future();
+	{
+		lock_guard<mutex> lock(loader_lock);
+		start_workers();
+		requests.emplace_back(move(new_entry));
+		pending_count++;
+	}
+	request_cv.notify_one();
+	return ret;
+}
+
+vector<image> image_loader::load_batch(const vector<request>& batch_requests) {
+	vector<future<image>> futures;
+	futures.reserve(batch_requests.size());
+	for(const auto& req : batch_requests) {
+		futures.emplace_back(load(req));
+	}
+	
+	// upload everything as soon as it has been decoded (this will also upload other pending requests)
+	vector<image> ret;
+	ret.reserve(batch_requests.size());
+	for(auto& img_future : futures) {
+		while(img_future.wait_for(chrono::seconds(0)) != future_status::ready) {
+			if(process_uploads() > 0) continue;
+			unique_lock<mutex> lock(loader_lock);
+			decoded_cv.wait_for(lock, chrono::milliseconds(10), [] { return !decoded.empty(); });
+		}
+		ret.emplace_back(img_future.get());
+	}
+	return ret;
+}
+
+size_t image_loader::process_uploads(const size_t max_bytes) {
+	size_t upload_count = 0, uploaded_bytes = 0;
+	// the budget is checked after each upload -> at least one image is uploaded per call (even with a 0 budget)
+	do {
+		unique_ptr<entry> cur_entry;
+		{
+			lock_guard<mutex> lock(loader_lock);
+			if(decoded.empty()) break;
+			cur_entry = move(decoded.front());
+			decoded.pop_front();
+			pending_count--;
+		}
+		
+		SDL_Surface* surface = cur_entry->surface;
+		if(surface == nullptr) {
+			log_error("%s", cur_entry->error_msg);
+			cur_entry->result.set_value(image::create_fail_image(cur_entry->req.backing));
+		}
+		else {
+			const size_t data_size = surface_data_size(surface);
+			cur_entry->result.set_value(image(surface->w, surface->h, cur_entry->req.backing,
+											  cur_entry->req.type, cur_entry->req.channel_order, surface->pixels));
+			memory_tracker::remove_host(MEMORY_TAG::IMAGE, data_size);
+			SDL_FreeSurface(surface);
+			uploaded_bytes += data_size;
+		}
+		upload_count++;
+	} while(uploaded_bytes < max_bytes);
+	return upload_count;
+}
+
+void image_loader::set_frame_upload_budget(const size_t max_bytes) {
+	frame_upload_budget = max_bytes;
+}
+
+size_t image_loader::get_frame_upload_budget() {
+	return frame_upload_budget;
+}
+
+size_t image_loader::get_pending_count() {
+	lock_guard<mutex> lock(loader_lock);
+	return pending_count;
+}
+
+void image_loader::destroy() {
+	{
+		lock_guard<mutex> lock(loader_lock);
+		if(!running) return;
+		running = false;
+	}
+	request_cv.notify_all();
+	for(auto& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	
+	// drop everything that hasn't been uploaded yet
+	lock_guard<mutex> lock(loader_lock);
+	for(auto& decoded_entry : decoded) {
+		if(decoded_entry->surface == nullptr) continue;
+		memory_tracker::remove_host(MEMORY_TAG::IMAGE, surface_data_size(decoded_entry->surface));
+		SDL_FreeSurface(decoded_entry->surface);
+	}
+	if(!requests.empty() || !decoded.empty()) {
+		log_debug("dropped %u pending image loads", requests.size() + decoded.size());
+	}
+	requests.clear();
+	decoded.clear();
+	pending_count = 0;
+}
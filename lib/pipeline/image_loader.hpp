@@ -0,0 +1,87 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_IMAGE_LOADER_HPP__
+#define __OCLRASTER_IMAGE_LOADER_HPP__
+
+#include "oclraster/global.hpp"
+#include "pipeline/image.hpp"
+#include <future>
+#include <condition_variable>
+#include <deque>
+
+// asynchronous image file loading: files are decoded and converted to the requested format in parallel
+// on a pool of worker threads, while the device upload is done by the thread that owns the opencl context
+// (process_uploads, which is called on each pipeline swap) -> the render thread only pays for the upload.
+// NOTE: don't wait on a future on the render thread before process_uploads has been called (use load_batch
+// if all images are needed immediately).
+class image_loader {
+public:
+	struct request {
+		string filename;
+		image::BACKING backing;
+		IMAGE_TYPE type;
+		IMAGE_CHANNEL channel_order;
+	};
+	
+	// queues the file for decoding (starts the worker threads on first use)
+	static future<image> load(const request& req);
+	// loads a whole set of images (e.g. all textures of a material set): all files are decoded in parallel
+	// and each image is uploaded by the calling thread as soon as it has been decoded (blocks until all are done)
+	static vector<image> load_batch(const vector<request>& requests);
+	
+	// uploads decoded images and makes their futures ready, at most max_bytes of pixel data are uploaded
+	// per call (but always at least one image). returns the amount of uploaded images.
+	static size_t process_uploads(const size_t max_bytes = ~size_t(0));
+	// the max amount of pixel data that is uploaded per pipeline swap (default: 64 MiB)
+	static void set_frame_upload_budget(const size_t max_bytes);
+	static size_t get_frame_upload_budget();
+	
+	// amount of requests that haven't been uploaded yet
+	static size_t get_pending_count();
+	
+	// amount of worker threads (default: hardware concurrency), only has an effect before the first load
+	static void set_thread_count(const unsigned int count);
+	// stops all worker threads and drops all pending requests (-> their futures will throw a broken_promise)
+	static void destroy();
+
+protected:
+	struct entry {
+		request req;
+		promise<image> result;
+		SDL_Surface* surface { nullptr };
+		string error_msg;
+	};
+	
+	static mutex loader_lock;
+	static condition_variable request_cv;
+	static condition_variable decoded_cv;
+	static deque<unique_ptr<entry>> requests;
+	static deque<unique_ptr<entry>> decoded;
+	static vector<thread> workers;
+	static unsigned int thread_count;
+	static size_t pending_count;
+	static atomic<size_t> frame_upload_budget;
+	static bool running;
+	
+	static void start_workers();
+	static void worker_run();
+	
+};
+
+#endif
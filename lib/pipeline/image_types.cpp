@@ -25,7 +25,8 @@ static constexpr array<const char*, (size_t)IMAGE_TYPE::__MAX_TYPE> data_type_st
 		"none",
 		"char", "short", "int", "long",
 		"uchar", "ushort", "uint", "ulong",
-		"half", "float", "double"
+		"half", "float", "double",
+		"oclr_bc1", "oclr_bc3", "oclr_bc4", "oclr_bc5"
 	}
 };
 
@@ -34,9 +35,10 @@ static constexpr array<const char*, (size_t)IMAGE_CHANNEL::__MAX_CHANNEL> channe
 };
 
 string image_type::to_string(const bool print_native) const {
+	// block compressed types have an implicit channel type (-> no channel suffix)
 	return ((native && print_native ? string("native_") : string("")) +
 			data_type_str_table[(size_t)data_type] +
-			channel_type_str_table[(size_t)channel_type]);
+			(is_compressed() ? "" : channel_type_str_table[(size_t)channel_type]));
 }
 
 size_t image_type::pixel_size() const {
@@ -57,6 +59,11 @@ size_t image_type::pixel_size() const {
 		case IMAGE_TYPE::UINT_64:
 		case IMAGE_TYPE::FLOAT_64:
 			return 8 * channel_size;
+		// block compressed: no per-pixel size (-> block_size())
+		case IMAGE_TYPE::BC1:
+		case IMAGE_TYPE::BC3:
+		case IMAGE_TYPE::BC4:
+		case IMAGE_TYPE::BC5:
 		case IMAGE_TYPE::NONE:
 		case IMAGE_TYPE::__MAX_TYPE:
 			return 0;
@@ -64,6 +71,26 @@ size_t image_type::pixel_size() const {
 	floor_unreachable();
 }
 
+size_t image_type::block_size() const {
+	switch(data_type) {
+		case IMAGE_TYPE::BC1:
+		case IMAGE_TYPE::BC4:
+			return 8;
+		case IMAGE_TYPE::BC3:
+		case IMAGE_TYPE::BC5:
+			return 16;
+		default: break;
+	}
+	return 0;
+}
+
+size_t image_type::data_size(const size_t width, const size_t height) const {
+	if(is_compressed()) {
+		return ((width + 3) / 4) * ((height + 3) / 4) * block_size();
+	}
+	return width * height * pixel_size();
+}
+
 // and while we're at it, make sure that cpu/host side vector4 types that are used for images have the correct size
 static_assert(sizeof(uchar4) == 1 * 4, "invalid uchar4 size");
 static_assert(sizeof(ushort4) == 2 * 4, "invalid ushort4 size");
@@ -33,6 +33,13 @@ enum class IMAGE_TYPE : unsigned short int {
 	FLOAT_16,	//!< half
 	FLOAT_32,	//!< float
 	FLOAT_64,	//!< double (note: must be supported by the device)
+	
+	// block compressed types (read-only, buffer based backing only, always normalized float reads)
+	// NOTE: data is a sequence of 4x4 texel blocks (row-major), the channel type must be RGBA (BC1, BC3), R (BC4) or RG (BC5)
+	BC1,		//!< 8 bytes per block: rgb565 endpoints + 2-bit indices (1-bit alpha)
+	BC3,		//!< 16 bytes per block: bc4 alpha block + bc1 color block
+	BC4,		//!< 8 bytes per block: r8 endpoints + 3-bit indices
+	BC5,		//!< 16 bytes per block: two bc4 blocks (r, g)
 	__MAX_TYPE
 };
 enum_class_hash(IMAGE_TYPE)
@@ -74,6 +81,15 @@ struct __attribute__((packed)) image_type {
 	
 	size_t pixel_size() const;
 	
+	// true for BC1 - BC5
+	bool is_compressed() const {
+		return (data_type >= IMAGE_TYPE::BC1 && data_type <= IMAGE_TYPE::BC5);
+	}
+	// size of a 4x4 texel block in bytes (0 for uncompressed types)
+	size_t block_size() const;
+	// size of the (uncompressed or compressed) data of an image with the specified size
+	size_t data_size(const size_t width, const size_t height) const;
+	
 	string to_string(const bool print_native = true) const;
 	friend ostream& operator<<(ostream& output, const image_type& img_type) {
 		output << img_type.to_string();
@@ -17,6 +17,7 @@
  */
 
 #include "pipeline.hpp"
+#include "frame_capture.hpp"
 #include "oclraster.hpp"
 
 #if defined(OCLRASTER_IOS)
@@ -36,12 +37,14 @@ struct __attribute__((packed, aligned(16))) constant_camera_data {
 pipeline::pipeline() :
 event_handler_fnctr(bind(&pipeline::event_handler, this, placeholders::_1, placeholders::_2)) {
 	create_framebuffers(size2(floor::get_width(), floor::get_height()));
-	state.camera_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-											 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-											 sizeof(constant_camera_data));
+	state.camera_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE,
+														opencl::BUFFER_FLAG::READ |
+														opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+														sizeof(constant_camera_data));
 	
 	state.scissor_test = 0;
 	state.backface_culling = 1;
+	state.attribute_setup = 0;
 	
 	floor::get_event()->add_internal_event_handler(event_handler_fnctr, EVENT_TYPE::WINDOW_RESIZE, EVENT_TYPE::KERNEL_RELOAD);
 	
@@ -59,7 +62,7 @@ pipeline::~pipeline() {
 	
 	destroy_framebuffers();
 	
-	ocl->delete_buffer(state.camera_buffer);
+	memory_tracker::delete_buffer(state.camera_buffer);
 	
 #if defined(OCLRASTER_IOS)
 	if(glIsBuffer(vbo_fullscreen_triangle)) glDeleteBuffers(1, &vbo_fullscreen_triangle);
@@ -70,6 +73,7 @@ bool pipeline::event_handler(EVENT_TYPE type, shared_ptr<event_object> obj) {
 	if(type == EVENT_TYPE::WINDOW_RESIZE) {
 		const window_resize_event& evt = (const window_resize_event&)*obj;
 		create_framebuffers(evt.size);
+		memory_tracker::log_usage();
 	}
 	else if(type == EVENT_TYPE::KERNEL_RELOAD) {
 		// unbind user programs, since those are invalid now
@@ -104,6 +108,11 @@ void pipeline::create_framebuffers(const uint2& size) {
 	// reset default fb counter
 	cur_default_fb = 0;
 	
+#if defined(OCLRASTER_BIN_HEATMAP)
+	heatmap.resize(scaled_size);
+	state.bin_heatmap_buffer = heatmap.get_buffer();
+#endif
+	
 #if !defined(OCLRASTER_USE_DRAW_PIXELS)
 	// create a fbo for copying the color framebuffer every frame and displaying it
 	// (there is no other way, unfortunately)
@@ -159,6 +168,12 @@ void pipeline::destroy_framebuffers() {
 }
 
 void pipeline::swap() {
+	OCLRASTER_TRACE_SCOPE("swap", "pipeline");
+	if(frame_capture::is_capturing()) frame_capture::end_frame();
+	
+	// upload asynchronously loaded images (limited per frame, so that loading doesn't stall rendering)
+	image_loader::process_uploads(image_loader::get_frame_upload_budget());
+	
 	// TODO: multi-threaded/-process/-context swap
 	// use the currently active default framebuffer for swapping and continue with the next one (if possible)
 	const size_t swap_fb_num = cur_default_fb;
@@ -170,6 +185,7 @@ void pipeline::swap() {
 #if defined(OCLRASTER_FXAA)
 	if(fxaa_state) {
 		// fxaa
+		OCLRASTER_PROFILE_BEGIN(profiler, FXAA);
 		ocl->use_kernel("FXAA.LUMA");
 		ocl->set_kernel_argument(0, fbo_img->get_buffer());
 		ocl->set_kernel_argument(1, default_fb_size);
@@ -181,17 +197,30 @@ void pipeline::swap() {
 		ocl->set_kernel_argument(1, default_fb_size);
 		ocl->set_kernel_range(ocl->compute_kernel_ranges(default_fb_size.x, default_fb_size.y));
 		ocl->run_kernel();
+		OCLRASTER_PROFILE_END(profiler, FXAA);
 	}
 #endif
 	
+#if defined(OCLRASTER_BIN_HEATMAP)
+	// read back the bin metrics of this frame and draw the overlay (if enabled)
+	heatmap.end_frame(fbo_img);
+#endif
+	
 	// draw/blit to screen
+	OCLRASTER_PROFILE_BEGIN(profiler, SWAP);
 #if defined(OCLRASTER_IOS)
 	glBindFramebuffer(GL_FRAMEBUFFER, FLOOR_DEFAULT_FRAMEBUFFER);
 #endif
 	glViewport(0, 0, floor::get_width(), floor::get_height());
 	
 	// copy opencl framebuffer to blit framebuffer/texture
+	const unsigned long long int map_start = (trace_recorder::is_enabled() ? SDL_GetPerformanceCounter() : 0);
 	auto fbo_data = fbo_img->map(opencl::MAP_BUFFER_FLAG::READ | opencl::MAP_BUFFER_FLAG::BLOCK);
+	if(trace_recorder::is_enabled()) {
+		// blocking map -> waits for all queued work
+		trace_recorder::record("map_framebuffer", "pipeline", trace_recorder::TRACK::HOST,
+							   map_start, SDL_GetPerformanceCounter());
+	}
 #if !defined(OCLRASTER_USE_DRAW_PIXELS)
 #if !defined(OCLRASTER_IOS)
 	glBindFramebuffer(GL_FRAMEBUFFER, copy_fbo_id);
@@ -204,6 +233,11 @@ void pipeline::swap() {
 #endif
 	fbo_img->unmap(fbo_data);
 	
+	// the blocking map above waited for all queued commands -> zero-copy memory of deleted buffers can be freed
+	// and all readbacks that were enqueued until now have completed
+	memory_tracker::release_deferred();
+	framebuffer::signal_queue_sync();
+	
 #if !defined(OCLRASTER_USE_DRAW_PIXELS)
 #if !defined(OCLRASTER_IOS)
 	// blit
@@ -237,14 +271,27 @@ void pipeline::swap() {
 #endif
 #endif
 	
+	OCLRASTER_PROFILE_END(profiler, SWAP);
+	
 	// make next default fb active
 	cur_default_fb = (cur_default_fb + 1) % get_framebuffer_count_from_mode(default_framebuffer_mode);
 	if(state.active_framebuffer == &default_framebuffer[swap_fb_num]) {
 		state.active_framebuffer = &default_framebuffer[cur_default_fb];
 	}
 	
+	// start a requested frame capture (this also records the default framebuffer clear)
+	frame_capture::begin_frame(default_framebuffer);
+	
 	// TODO: clear on next draw?
 	default_framebuffer[cur_default_fb].clear();
+	
+#if defined(OCLRASTER_PROFILING)
+	profiler.end_frame();
+#endif
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	statistics.end_frame();
+#endif
+	trace_recorder::next_frame();
 }
 
 void pipeline::draw(const PRIMITIVE_TYPE type,
@@ -257,17 +304,114 @@ void pipeline::draw_instanced(const PRIMITIVE_TYPE type,
 							  const unsigned int vertex_count,
 							  const pair<unsigned int, unsigned int> element_range,
 							  const unsigned int instance_count) {
-	if(instance_count == 0) return;
+	OCLRASTER_TRACE_SCOPE("draw", "pipeline");
+	if(!_prepare_draw(type, vertex_count, element_range, instance_count)) return;
+	if(frame_capture::is_capturing()) {
+		frame_capture::record_draw(state, type, vertex_count, element_range, instance_count);
+	}
+	
+	// TODO: this should be static!
+	// note: internal transformed buffer size must be a multiple of "batch primitive count" primitives (necessary for the binner)
+	const unsigned int pc_mod_batch_size = (state.primitive_count % OCLRASTER_BATCH_PRIMITIVE_COUNT);
+	const unsigned int primitive_padding = (pc_mod_batch_size == 0 ? 0 : OCLRASTER_BATCH_PRIMITIVE_COUNT - pc_mod_batch_size);
+	state.transformed_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+															 opencl::BUFFER_FLAG::READ_WRITE,
+															 state.transformed_primitive_size() * (state.primitive_count + primitive_padding));
+	state.primitive_bounds_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+																  opencl::BUFFER_FLAG::READ_WRITE,
+																  sizeof(float) * 4 * (state.primitive_count + primitive_padding));
+	state.transformed_vertices_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+																	  opencl::BUFFER_FLAG::READ_WRITE,
+																	  sizeof(float) * 4 * state.vertex_count * state.instance_count);
+	
+	// create user transformed buffers (transform program outputs)
+	const auto active_device = ocl->get_active_device();
+	const auto& tp_structs = state.transform_prog->get_structs();
+	const auto& tp_struct_slots = state.transform_prog->get_binding_layout().struct_slots;
+	for(size_t i = 0, struct_count = tp_structs.size(); i < struct_count; i++) {
+		if(tp_structs[i]->type == oclraster_program::STRUCT_TYPE::OUTPUT) {
+			opencl::buffer_object* buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+																		  opencl::BUFFER_FLAG::READ_WRITE,
+																		  // get device specific size from program
+																		  tp_structs[i]->device_infos.at(active_device).struct_size * vertex_count * state.instance_count);
+			state.user_transformed_buffers.push_back(buffer);
+			bind_buffer(tp_struct_slots[i], *buffer);
+		}
+	}
+	
+	// pipeline
+#if defined(OCLRASTER_PROFILING)
+	profiler.begin_draw();
+#endif
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	state.pipeline_stats_buffer = statistics.begin_draw();
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+	// only draw calls into the default framebuffer are recorded
+	state.bin_heatmap_bin_count = (state.active_framebuffer == &default_framebuffer[cur_default_fb] ?
+								   heatmap.get_bin_count() : uint2 { 0u, 0u });
+#endif
+	OCLRASTER_PROFILE_BEGIN(profiler, TRANSFORM);
+	transform.transform(state);
+	OCLRASTER_PROFILE_END(profiler, TRANSFORM);
+	OCLRASTER_PROFILE_BEGIN(profiler, PROCESSING);
+	processing.process(state, type);
+	OCLRASTER_PROFILE_END(profiler, PROCESSING);
+	OCLRASTER_PROFILE_BEGIN(profiler, BINNING);
+	const auto queue_buffer = binning.bin(state);
+	OCLRASTER_PROFILE_END(profiler, BINNING);
+	
+	// TODO: pipelining/splitting
+	OCLRASTER_PROFILE_BEGIN(profiler, RASTERIZATION);
+	rasterization.rasterize(state, type, queue_buffer);
+	OCLRASTER_PROFILE_END(profiler, RASTERIZATION);
+	
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	statistics.end_draw(state.primitive_count, state.bin_count.x * state.bin_count.y * state.batch_count);
+#endif
+	
+	//
+	memory_tracker::delete_buffer(state.transformed_buffer);
+	memory_tracker::delete_buffer(state.primitive_bounds_buffer);
+	memory_tracker::delete_buffer(state.transformed_vertices_buffer);
+	
+	// delete user transformed buffers
+	for(const auto& ut_buffer : state.user_transformed_buffers) {
+		memory_tracker::delete_buffer(ut_buffer);
+	}
+	state.user_transformed_buffers.clear();
+}
+
+void pipeline::draw_clusters(const unsigned int vertex_count,
+							 const vector<mesh_cluster>& clusters,
+							 const matrix4f& model_matrix) {
+	OCLRASTER_TRACE_SCOPE("draw_clusters", "pipeline");
+	if(clusters.empty()) return;
+	const unsigned int triangle_count = cluster_culling.cull(state, clusters, model_matrix);
+	if(triangle_count == 0) return;
+	draw_instanced(PRIMITIVE_TYPE::TRIANGLE, vertex_count, { 0, triangle_count }, 1);
+	cluster_culling.end_draw(state);
+}
+
+draw_state& pipeline::_get_draw_state() {
+	return state;
+}
+
+bool pipeline::_prepare_draw(const PRIMITIVE_TYPE type,
+							 const unsigned int vertex_count,
+							 const pair<unsigned int, unsigned int> element_range,
+							 const unsigned int instance_count) {
+	if(instance_count == 0) return false;
 	if(element_range.second <= element_range.first) {
 		log_error("invalid element range: %u - %u", element_range.first, element_range.second);
-		return;
+		return false;
 	}
 	
 	if(state.scissor_test &&
 	   (state.scissor_rectangle.z == 0 || state.scissor_rectangle.w == 0 ||
 		state.scissor_rectangle.x >= state.framebuffer_size.x ||
 		state.scissor_rectangle.y >= state.framebuffer_size.y)) {
-		return; // scissor rectangle size is 0 or offset is beyond the framebuffer size
+		return false; // scissor rectangle size is 0 or offset is beyond the framebuffer size
 	}
 	
 	// initialize draw state
@@ -308,67 +452,31 @@ void pipeline::draw_instanced(const PRIMITIVE_TYPE type,
 	}
 	state.batch_count = ((state.primitive_count / OCLRASTER_BATCH_PRIMITIVE_COUNT) +
 						 ((state.primitive_count % OCLRASTER_BATCH_PRIMITIVE_COUNT) != 0 ? 1 : 0));
-	
-	// TODO: this should be static!
-	// note: internal transformed buffer size must be a multiple of "batch primitive count" primitives (necessary for the binner)
-	const unsigned int pc_mod_batch_size = (state.primitive_count % OCLRASTER_BATCH_PRIMITIVE_COUNT);
-	const unsigned int primitive_padding = (pc_mod_batch_size == 0 ? 0 : OCLRASTER_BATCH_PRIMITIVE_COUNT - pc_mod_batch_size);
-	state.transformed_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
-												  state.transformed_primitive_size * (state.primitive_count + primitive_padding));
-	state.primitive_bounds_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
-													   sizeof(float) * 4 * (state.primitive_count + primitive_padding));
-	state.transformed_vertices_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
-														   sizeof(float) * 4 * state.vertex_count * state.instance_count);
-	
-	// create user transformed buffers (transform program outputs)
-	const auto active_device = ocl->get_active_device();
-	for(const auto& tp_struct : state.transform_prog->get_structs()) {
-		if(tp_struct->type == oclraster_program::STRUCT_TYPE::OUTPUT) {
-			opencl::buffer_object* buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
-															   // get device specific size from program
-															   tp_struct->device_infos.at(active_device).struct_size * vertex_count * state.instance_count);
-			state.user_transformed_buffers.push_back(buffer);
-			bind_buffer(tp_struct->object_name, *buffer);
-		}
-	}
-	
-	// pipeline
-	transform.transform(state);
-	processing.process(state, type);
-	const auto queue_buffer = binning.bin(state);
-	
-	// TODO: pipelining/splitting
-	rasterization.rasterize(state, type, queue_buffer);
-	
-	//
-	ocl->delete_buffer(state.transformed_buffer);
-	ocl->delete_buffer(state.primitive_bounds_buffer);
-	ocl->delete_buffer(state.transformed_vertices_buffer);
-	
-	// delete user transformed buffers
-	for(const auto& ut_buffer : state.user_transformed_buffers) {
-		ocl->delete_buffer(ut_buffer);
-	}
-	state.user_transformed_buffers.clear();
+	return true;
 }
 
 void pipeline::bind_buffer(const string& name, const opencl_base::buffer_object& buffer) {
-	const auto existing_buffer = state.user_buffers.find(name);
-	if(existing_buffer != state.user_buffers.cend()) {
-		state.user_buffers.erase(existing_buffer);
-	}
-	state.user_buffers.emplace(name, buffer);
+	OCLRASTER_TRACE_INSTANT("bind_buffer", "pipeline", name);
+	state.bindings.bind_buffer(binding_table::get_slot(name), buffer);
 }
 
 void pipeline::bind_image(const string& name, const image& img) {
-	const auto existing_image = state.user_images.find(name);
-	if(existing_image != state.user_images.cend()) {
-		state.user_images.erase(existing_image);
-	}
-	state.user_images.emplace(name, img);
+	OCLRASTER_TRACE_INSTANT("bind_image", "pipeline", name);
+	state.bindings.bind_image(binding_table::get_slot(name), img);
+}
+
+void pipeline::bind_buffer(const size_t& slot, const opencl_base::buffer_object& buffer) {
+	OCLRASTER_TRACE_INSTANT("bind_buffer", "pipeline", binding_table::get_slot_name(slot));
+	state.bindings.bind_buffer(slot, buffer);
+}
+
+void pipeline::bind_image(const size_t& slot, const image& img) {
+	OCLRASTER_TRACE_INSTANT("bind_image", "pipeline", binding_table::get_slot_name(slot));
+	state.bindings.bind_image(slot, img);
 }
 
 void pipeline::bind_framebuffer(framebuffer* fb) {
+	OCLRASTER_TRACE_INSTANT("bind_framebuffer", "pipeline");
 	if(fb == nullptr) {
 		state.active_framebuffer = &default_framebuffer[cur_default_fb];
 	}
@@ -547,6 +655,14 @@ const uint4& pipeline::get_scissor_rectangle() const {
 	return state.scissor_rectangle;
 }
 
+void pipeline::set_attribute_setup(const bool attribute_setup_state) {
+	state.attribute_setup = attribute_setup_state;
+}
+
+bool pipeline::get_attribute_setup() const {
+	return state.attribute_setup;
+}
+
 void pipeline::set_depth_function(const DEPTH_FUNCTION depth_func,
 								  const string custom_depth_func) {
 	state.depth.depth_func = depth_func;
@@ -585,6 +701,26 @@ const depth_state& pipeline::get_depth_state() const {
 	return state.depth;
 }
 
+frame_stats pipeline::get_frame_stats() const {
+	return profiler.get_frame_stats();
+}
+
+pipeline_profiler& pipeline::get_profiler() {
+	return profiler;
+}
+
+const pipeline_counters& pipeline::get_draw_statistics() const {
+	return statistics.get_draw_statistics();
+}
+
+const pipeline_counters& pipeline::get_frame_statistics() const {
+	return statistics.get_frame_statistics();
+}
+
+bin_heatmap& pipeline::get_bin_heatmap() {
+	return heatmap;
+}
+
 void pipeline::_set_fxaa_state(const bool state_) {
 	fxaa_state = state_;
 }
@@ -20,14 +20,22 @@
 #define __OCLRASTER_PIPELINE_HPP__
 
 #include "cl/opencl.hpp"
+#include "pipeline/cluster_culling_stage.hpp"
 #include "pipeline/transform_stage.hpp"
 #include "pipeline/processing_stage.hpp"
 #include "pipeline/binning_stage.hpp"
 #include "pipeline/rasterization_stage.hpp"
 #include "pipeline/image.hpp"
+#include "pipeline/image_loader.hpp"
 #include "pipeline/framebuffer.hpp"
+#include "pipeline/pipeline_state.hpp"
+#include "pipeline/pipeline_profiler.hpp"
+#include "pipeline/pipeline_statistics.hpp"
+#include "pipeline/bin_heatmap.hpp"
+#include "pipeline/trace_recorder.hpp"
 #include "core/event.hpp"
 #include "core/camera.hpp"
+#include "core/memory_tracker.hpp"
 #include "program/oclraster_program.hpp"
 #include "program/transform_program.hpp"
 #include "program/rasterization_program.hpp"
@@ -38,9 +46,10 @@ struct draw_state {
 		struct {
 			unsigned int scissor_test : 1;
 			unsigned int backface_culling : 1;
+			unsigned int attribute_setup : 1;
 			
 			//
-			unsigned int _unused : 30;
+			unsigned int _unused : 29;
 		};
 		unsigned int flags;
 	};
@@ -51,8 +60,15 @@ struct draw_state {
 	uint4 scissor_rectangle { 0u, 0u, ~0u, ~0u };
 	uint4 scissor_rectangle_abs { 0u, 0u, ~0u, ~0u }; // absolute, inclusive
 	
-	// NOTE: this is just for the internal transformed buffer
-	const unsigned int transformed_primitive_size = 10 * sizeof(float);
+	// NOTE: this is just for the internal transformed buffer (-> transformed_data in oclr_primitive_assembly.h)
+	unsigned int transformed_primitive_size() const {
+#if defined(OCLRASTER_HALF_PRIMITIVE_SETUP)
+		// float2 origin + float2 depth + 3 * half4 edge functions
+		if(projection == PROJECTION::ORTHOGRAPHIC) return sizeof(float) * 4 + sizeof(unsigned short int) * 4 * 3;
+#endif
+		// 3 * float4 (edge functions + depth)
+		return sizeof(float) * 4 * 3;
+	}
 	
 	// framebuffers
 	uint2 framebuffer_size { 1280, 720 };
@@ -62,9 +78,11 @@ struct draw_state {
 	opencl::buffer_object* transformed_vertices_buffer = nullptr;
 	opencl::buffer_object* transformed_buffer = nullptr;
 	opencl::buffer_object* primitive_bounds_buffer = nullptr;
-	unordered_map<string, const opencl_base::buffer_object&> user_buffers;
-	unordered_map<string, const image&> user_images;
+	binding_table bindings; // user buffers and images
 	vector<opencl::buffer_object*> user_transformed_buffers;
+	opencl::buffer_object* pipeline_stats_buffer = nullptr; // only used with OCLRASTER_PIPELINE_STATISTICS
+	opencl::buffer_object* bin_heatmap_buffer = nullptr; // only used with OCLRASTER_BIN_HEATMAP
+	uint2 bin_heatmap_bin_count { 0u, 0u }; // (0, 0) -> draw call is not recorded in the bin heatmap
 	
 	//
 	transform_program* transform_prog = nullptr;
@@ -118,6 +136,10 @@ public:
 	// NOTE: to bind the index buffer, use the name "index_buffer"
 	void bind_buffer(const string& name, const opencl_base::buffer_object& buffer);
 	void bind_image(const string& name, const image& img);
+	// same as above, but with a slot that has been resolved once via binding_table::get_slot(name)
+	// (avoids any string lookups when binding per draw call)
+	void bind_buffer(const size_t& slot, const opencl_base::buffer_object& buffer);
+	void bind_image(const size_t& slot, const image& img);
 	void bind_framebuffer(framebuffer* fb);
 	
 	// any default framebuffer modification happens at your own risk!
@@ -153,6 +175,15 @@ public:
 						const pair<unsigned int, unsigned int> element_range,
 						const unsigned int instance_count);
 	
+	// cluster culling: draws the triangles of all clusters of the bound index buffer (triangle list) that are
+	// potentially visible, i.e. inside the view frustum and (with backface culling) not completely back-facing.
+	// model_matrix must be the object -> world space transformation that is applied by the transform program.
+	// NOTE: this reduces the primitive processing, binning and rasterization work, all vertices are still
+	// transformed. see cluster_culling_stage for details.
+	void draw_clusters(const unsigned int vertex_count,
+					   const vector<mesh_cluster>& clusters,
+					   const matrix4f& model_matrix = matrix4f());
+	
 	// camera
 	// NOTE: the camera class and these functions are only provided to make things easier.
 	// meaning, they don't have to be used if you don't want to use them and roll your own camera code instead.
@@ -207,12 +238,43 @@ public:
 	void set_scissor_rectangle(const uint2& offset, const uint2& size);
 	const uint4& get_scissor_rectangle() const;
 	
+	// attribute setup: computes the plane equations of all output variables once per visible primitive
+	// (in a separate pass after primitive processing), so that the rasterization program doesn't have to
+	// fetch the indices and transform outputs of each primitive for each fragment.
+	// this needs 12 bytes per output variable component and primitive of additional memory, but is usually
+	// faster for primitives that cover more than a few fragments (disabled by default)
+	void set_attribute_setup(const bool attribute_setup_state);
+	bool get_attribute_setup() const;
+	
+	// rolling per-stage timings of the last frames (only available when built with OCLRASTER_PROFILING,
+	// otherwise frame_count will always be 0)
+	frame_stats get_frame_stats() const;
+	pipeline_profiler& get_profiler();
+	
+	// pipeline statistics counters of the last draw call and the last complete frame
+	// (only available when built with OCLRASTER_PIPELINE_STATISTICS, otherwise all counters are 0)
+	const pipeline_counters& get_draw_statistics() const;
+	const pipeline_counters& get_frame_statistics() const;
+	
+	// per-bin load metrics of the default framebuffer (only available when built with OCLRASTER_BIN_HEATMAP)
+	bin_heatmap& get_bin_heatmap();
+	
 	//
 	void _set_fxaa_state(const bool state);
 	bool _get_fxaa_state() const;
 	
+	// internal draw state access, used to drive the pipeline stages directly (e.g. stage benchmarks).
+	// _prepare_draw initializes the draw state counts, bins and batches like a draw call would
+	// (returns false if there is nothing to draw), but doesn't create any buffers or run any stage.
+	draw_state& _get_draw_state();
+	bool _prepare_draw(const PRIMITIVE_TYPE type,
+					   const unsigned int vertex_count,
+					   const pair<unsigned int, unsigned int> element_range,
+					   const unsigned int instance_count);
+	
 protected:
 	draw_state state;
+	cluster_culling_stage cluster_culling;
 	transform_stage transform;
 	processing_stage processing;
 	binning_stage binning;
@@ -238,6 +300,11 @@ protected:
 	// camera
 	camera* cam { nullptr };
 	
+	// profiling
+	pipeline_profiler profiler;
+	pipeline_statistics statistics;
+	bin_heatmap heatmap;
+	
 	// event handler
 	event::handler event_handler_fnctr;
 	bool event_handler(EVENT_TYPE type, shared_ptr<event_object> obj);
@@ -251,6 +318,7 @@ template <class program_type> void pipeline::bind_program(const program_type& pr
 	static_assert(is_base_of<transform_program, program_type>::value ||
 				  is_base_of<rasterization_program, program_type>::value,
 				  "invalid program type (must be a transform_program or rasterization_program or a derived class)!");
+	OCLRASTER_TRACE_INSTANT("bind_program", "pipeline");
 	if(is_base_of<transform_program, program_type>::value) {
 		state.transform_prog = (transform_program*)&program;
 	}
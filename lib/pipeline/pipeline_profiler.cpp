@@ -0,0 +1,113 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pipeline_profiler.hpp"
+#include "trace_recorder.hpp"
+#include "oclraster.hpp"
+
+static double counter_to_ms(const unsigned long long int& counter_diff) {
+	return (double(counter_diff) * 1000.0) / double(SDL_GetPerformanceFrequency());
+}
+
+void pipeline_profiler::begin(const PIPELINE_STAGE stage) {
+	ocl->finish();
+	stage_start[(size_t)stage] = SDL_GetPerformanceCounter();
+}
+
+void pipeline_profiler::end(const PIPELINE_STAGE stage) {
+	ocl->finish();
+	const unsigned long long int stage_end = SDL_GetPerformanceCounter();
+	const double duration = counter_to_ms(stage_end - stage_start[(size_t)stage]);
+	trace_recorder::record(stage_name(stage), "device", trace_recorder::TRACK::DEVICE,
+						   stage_start[(size_t)stage], stage_end);
+	cur_frame[(size_t)stage] += duration;
+	cur_draw[(size_t)stage] += duration;
+	
+	// rasterization is the last stage of a draw call
+	if(stage == PIPELINE_STAGE::RASTERIZATION) {
+		last_draw = cur_draw;
+	}
+}
+
+void pipeline_profiler::begin_draw() {
+	cur_draw.fill(0.0);
+	cur_frame_draw_count++;
+}
+
+void pipeline_profiler::end_frame() {
+	const unsigned long long int frame_end = SDL_GetPerformanceCounter();
+	if(last_frame_end == 0) {
+		// first frame: no frame start -> only start measuring from here on
+		last_frame_end = frame_end;
+		cur_frame_draw_count = 0;
+		cur_frame.fill(0.0);
+		return;
+	}
+	
+	for(size_t i = 0; i < pipeline_stage_count; i++) {
+		history[i][history_pos] = cur_frame[i];
+	}
+	history[pipeline_stage_count][history_pos] = counter_to_ms(frame_end - last_frame_end);
+	history_pos = (history_pos + 1) % window_size;
+	history_count = std::min(history_count + 1, window_size);
+	
+	last_frame_end = frame_end;
+	last_frame_draw_count = cur_frame_draw_count;
+	cur_frame_draw_count = 0;
+	cur_frame.fill(0.0);
+}
+
+frame_stats pipeline_profiler::get_frame_stats() const {
+	frame_stats stats;
+	stats.last_draw = last_draw;
+	stats.last_frame_draw_count = last_frame_draw_count;
+	stats.frame_count = history_count;
+	if(history_count == 0) return stats;
+	
+	const size_t last_pos = (history_pos + window_size - 1) % window_size;
+	vector<double> sorted(history_count);
+	for(size_t i = 0; i <= pipeline_stage_count; i++) {
+		frame_stats::timing& timing = (i < pipeline_stage_count ? stats.stages[i] : stats.frame);
+		
+		// the ring buffer is always filled from the start -> [0, history_count) are the valid entries
+		copy(history[i].cbegin(), history[i].cbegin() + (ptrdiff_t)history_count, sorted.begin());
+		sort(sorted.begin(), sorted.end());
+		
+		double sum = 0.0;
+		for(const auto& val : sorted) sum += val;
+		timing.min = sorted.front();
+		timing.avg = sum / double(history_count);
+		timing.p99 = sorted[std::min((history_count * 99) / 100, history_count - 1)];
+		timing.last = history[i][last_pos];
+	}
+	return stats;
+}
+
+const char* pipeline_profiler::stage_name(const PIPELINE_STAGE stage) {
+	switch(stage) {
+		case PIPELINE_STAGE::TRANSFORM: return "transform";
+		case PIPELINE_STAGE::PROCESSING: return "processing";
+		case PIPELINE_STAGE::BINNING: return "binning";
+		case PIPELINE_STAGE::RASTERIZATION: return "rasterization";
+		case PIPELINE_STAGE::CLEAR: return "clear";
+		case PIPELINE_STAGE::FXAA: return "fxaa";
+		case PIPELINE_STAGE::SWAP: return "swap";
+		case PIPELINE_STAGE::__MAX_PIPELINE_STAGE: floor_unreachable();
+	}
+	floor_unreachable();
+}
@@ -0,0 +1,97 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_PIPELINE_PROFILER_HPP__
+#define __OCLRASTER_PIPELINE_PROFILER_HPP__
+
+#include "oclraster/global.hpp"
+
+// all pipeline stages that are timed when profiling is enabled (build with "cl-profiling")
+enum class PIPELINE_STAGE : unsigned int {
+	TRANSFORM,
+	PROCESSING,
+	BINNING,
+	RASTERIZATION,
+	CLEAR,
+	FXAA,
+	SWAP,
+	__MAX_PIPELINE_STAGE
+};
+static constexpr size_t pipeline_stage_count { (size_t)PIPELINE_STAGE::__MAX_PIPELINE_STAGE };
+
+// rolling pipeline stage timings, all times are in milliseconds
+struct frame_stats {
+	struct timing {
+		double min { 0.0 };
+		double avg { 0.0 };
+		double p99 { 0.0 };
+		double last { 0.0 };
+	};
+	// per-frame duration of each stage (summed over all draw calls of a frame)
+	array<timing, pipeline_stage_count> stages;
+	// host frame time (swap to swap)
+	timing frame;
+	// stage durations of the last draw call (only transform, processing, binning and rasterization)
+	array<double, pipeline_stage_count> last_draw;
+	// number of draw calls in the last frame
+	unsigned int last_frame_draw_count { 0 };
+	// number of frames the rolling stats were computed over (0 if profiling is disabled)
+	size_t frame_count { 0 };
+};
+
+// NOTE: the opencl wrapper doesn't expose the kernel events, so stages are timed on the host by
+// synchronizing the command queue before and after each stage. this obviously serializes host and
+// device work and is only meant for relative timings -> only enabled with OCLRASTER_PROFILING.
+class pipeline_profiler {
+public:
+	// number of frames the rolling stats are computed over
+	static constexpr size_t window_size { 128 };
+	
+	void begin(const PIPELINE_STAGE stage);
+	void end(const PIPELINE_STAGE stage);
+	void begin_draw();
+	void end_frame();
+	
+	frame_stats get_frame_stats() const;
+	static const char* stage_name(const PIPELINE_STAGE stage);
+	
+protected:
+	array<unsigned long long int, pipeline_stage_count> stage_start {};
+	array<double, pipeline_stage_count> cur_frame {};
+	array<double, pipeline_stage_count> cur_draw {};
+	array<double, pipeline_stage_count> last_draw {};
+	unsigned int cur_frame_draw_count { 0 };
+	unsigned int last_frame_draw_count { 0 };
+	unsigned long long int last_frame_end { 0 };
+	
+	// ring buffer of the last window_size frames ([pipeline_stage_count] == frame time)
+	array<array<double, window_size>, pipeline_stage_count + 1> history {};
+	size_t history_pos { 0 };
+	size_t history_count { 0 };
+	
+};
+
+#if defined(OCLRASTER_PROFILING)
+#define OCLRASTER_PROFILE_BEGIN(profiler, stage) (profiler).begin(PIPELINE_STAGE::stage)
+#define OCLRASTER_PROFILE_END(profiler, stage) (profiler).end(PIPELINE_STAGE::stage)
+#else
+#define OCLRASTER_PROFILE_BEGIN(profiler, stage)
+#define OCLRASTER_PROFILE_END(profiler, stage)
+#endif
+
+#endif
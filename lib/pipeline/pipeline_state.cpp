@@ -0,0 +1,219 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pipeline_state.hpp"
+#include "pipeline.hpp"
+#include "oclraster.hpp"
+
+//// binding_table
+atomic<unsigned long long int> binding_table::version_counter { 0 };
+mutex binding_table::slots_lock;
+unordered_map<string, size_t> binding_table::slots;
+vector<string> binding_table::slot_names;
+
+size_t binding_table::get_slot(const string& name) {
+	lock_guard<mutex> lock(slots_lock);
+	const auto iter = slots.find(name);
+	if(iter != slots.cend()) return iter->second;
+	
+	const size_t slot = slot_names.size();
+	slots.emplace(name, slot);
+	slot_names.emplace_back(name);
+	return slot;
+}
+
+string binding_table::get_slot_name(const size_t& slot) {
+	lock_guard<mutex> lock(slots_lock);
+	if(slot >= slot_names.size()) return "<invalid>";
+	return slot_names[slot];
+}
+
+binding_table::binding& binding_table::get_or_create_binding(const size_t& slot) {
+	if(slot >= bindings.size()) {
+		bindings.resize(slot + 1);
+	}
+	return bindings[slot];
+}
+
+void binding_table::bind_buffer(const size_t& slot, const opencl_base::buffer_object& buffer) {
+	// note: every bind gets a new version, even if the same object is bound again
+	// (buffers are frequently deleted and recreated at the same address, e.g. the transformed user buffers)
+	binding& entry = get_or_create_binding(slot);
+	entry.buffer = &buffer;
+	entry.img = nullptr;
+	entry.version = ++version_counter;
+}
+
+void binding_table::bind_image(const size_t& slot, const image& img) {
+	binding& entry = get_or_create_binding(slot);
+	entry.buffer = nullptr;
+	entry.img = &img;
+	entry.version = ++version_counter;
+}
+
+//// pipeline_state
+pipeline_state::pipeline_state(oclraster_program& program_, const oclraster_program::kernel_spec& spec_) :
+program(program_), spec(spec_), kernel(program.get_kernel(spec)),
+attribute_setup_kernel(spec.attribute_setup ? program.get_attribute_setup_kernel(spec) : opencl::null_kernel_object) {
+	const auto& layout = program.get_binding_layout();
+	arg_versions.resize(layout.buffer_slots.size() + layout.image_slots.size(), 0);
+	arg_image_generations.resize(layout.image_slots.size(), 0);
+}
+
+pipeline_state::~pipeline_state() {
+}
+
+const oclraster_program::kernel_spec& pipeline_state::get_spec() const {
+	return spec;
+}
+
+weak_ptr<opencl::kernel_object> pipeline_state::get_kernel() const {
+	return kernel;
+}
+
+weak_ptr<opencl::kernel_object> pipeline_state::get_attribute_setup_kernel() const {
+	return attribute_setup_kernel;
+}
+
+const image* pipeline_state::get_framebuffer_image(const framebuffer* fb,
+												   const oclraster_program::IMAGE_VAR_TYPE& type,
+												   size_t& fb_img_idx) {
+	switch(type) {
+		case oclraster_program::IMAGE_VAR_TYPE::DEPTH_IMAGE:
+			return fb->get_depth_buffer();
+		case oclraster_program::IMAGE_VAR_TYPE::STENCIL_IMAGE:
+			return fb->get_stencil_buffer();
+		default:
+			return fb->get_image(fb_img_idx++);
+	}
+}
+
+bool pipeline_state::matches(const draw_state& state) const {
+	if(spec.projection != state.projection) return false;
+	if(spec.depth != state.depth) return false;
+	if(spec.attribute_setup != (state.attribute_setup && program.has_attribute_setup())) return false;
+	
+	const auto& images = program.get_images();
+	const auto& layout = program.get_binding_layout();
+	const framebuffer* fb = state.active_framebuffer;
+	for(size_t i = 0, fb_img_idx = 0, img_count = layout.image_slots.size(); i < img_count; i++) {
+		const image* img = nullptr;
+		if(images.is_framebuffer[i]) {
+			if(fb == nullptr) return false;
+			img = get_framebuffer_image(fb, images.image_types[i], fb_img_idx);
+		}
+		else {
+			const auto binding = state.bindings.get_binding(layout.image_slots[i]);
+			if(binding != nullptr) img = binding->img;
+		}
+		if(img == nullptr) return false;
+		if(img->get_image_type() != spec.image_spec[i]) return false;
+	}
+	return true;
+}
+
+bool pipeline_state::bind(const draw_state& state, unsigned int& argc) {
+	ocl->use_kernel(kernel);
+	
+	// user buffers: only set the ones that have been rebound since the last bind
+	const auto& layout = program.get_binding_layout();
+	size_t arg_idx = 0;
+	for(const auto& slot : layout.buffer_slots) {
+		const auto binding = state.bindings.get_binding(slot);
+		if(binding == nullptr || binding->buffer == nullptr) {
+			log_error("buffer \"%s\" not bound!", binding_table::get_slot_name(slot));
+			return false;
+		}
+		if(arg_versions[arg_idx] != binding->version) {
+			ocl->set_kernel_argument(argc, binding->buffer);
+			arg_versions[arg_idx] = binding->version;
+		}
+		argc++;
+		arg_idx++;
+	}
+	
+	// images
+	// note: framebuffer images are always set (cheap, and the bound framebuffer may change at any time)
+	const auto& images = program.get_images();
+	const framebuffer* fb = state.active_framebuffer;
+	for(size_t i = 0, fb_img_idx = 0, img_count = layout.image_slots.size(); i < img_count; i++, arg_idx++) {
+		if(images.is_framebuffer[i]) {
+			if(fb == nullptr) {
+				log_error("no framebuffer is currently bound!");
+				return false;
+			}
+			const image* img = get_framebuffer_image(fb, images.image_types[i], fb_img_idx);
+			if(img == nullptr) {
+				log_error("framebuffer image \"%s\" not bound!", images.image_names[i]);
+				return false;
+			}
+			ocl->set_kernel_argument(argc++, img->get_buffer());
+		}
+		else {
+			const auto binding = state.bindings.get_binding(layout.image_slots[i]);
+			if(binding == nullptr || binding->img == nullptr) {
+				log_error("image \"%s\" not bound!", images.image_names[i]);
+				return false;
+			}
+			const unsigned long long int generation = binding->img->get_buffer_generation();
+			if(arg_versions[arg_idx] != binding->version || arg_image_generations[i] != generation) {
+				ocl->set_kernel_argument(argc, binding->img->get_buffer());
+				arg_versions[arg_idx] = binding->version;
+				arg_image_generations[i] = generation;
+			}
+			argc++;
+		}
+	}
+	
+	return true;
+}
+
+bool pipeline_state::create_kernel_spec(const draw_state& state, const oclraster_program& program,
+										oclraster_program::kernel_spec& spec) {
+	const auto& images = program.get_images();
+	const auto& layout = program.get_binding_layout();
+	const framebuffer* fb = state.active_framebuffer;
+	for(size_t i = 0, fb_img_idx = 0, img_count = layout.image_slots.size(); i < img_count; i++) {
+		if(images.is_framebuffer[i]) {
+			// framebuffer
+			if(fb == nullptr) {
+				log_error("no framebuffer is currently bound!");
+				return false;
+			}
+			const image* img = get_framebuffer_image(fb, images.image_types[i], fb_img_idx);
+			if(img == nullptr) {
+				log_error("framebuffer image \"%s\" not bound!", images.image_names[i]);
+				return false;
+			}
+			spec.image_spec.emplace_back(img->get_image_type());
+		}
+		else {
+			// image
+			const auto binding = state.bindings.get_binding(layout.image_slots[i]);
+			if(binding == nullptr || binding->img == nullptr) {
+				log_error("image \"%s\" not bound!", images.image_names[i]);
+				return false;
+			}
+			spec.image_spec.emplace_back(binding->img->get_image_type());
+		}
+	}
+	spec.projection = state.projection;
+	spec.depth = state.depth;
+	spec.attribute_setup = (state.attribute_setup && program.has_attribute_setup());
+	return true;
+}
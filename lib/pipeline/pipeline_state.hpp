@@ -0,0 +1,110 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_PIPELINE_STATE_HPP__
+#define __OCLRASTER_PIPELINE_STATE_HPP__
+
+#include "cl/opencl.hpp"
+#include "program/oclraster_program.hpp"
+
+class image;
+class framebuffer;
+struct draw_state;
+
+// descriptor-set style binding table: every buffer/image name that is used by a program or bound
+// by the user is mapped to a global binding slot once, draw calls then only deal with slot indices.
+// each bind is tagged with a globally unique version, so pipeline states can tell which kernel
+// arguments actually changed since they were last set.
+class binding_table {
+public:
+	struct binding {
+		const opencl_base::buffer_object* buffer { nullptr };
+		const image* img { nullptr };
+		unsigned long long int version { 0 }; // 0 == unbound
+	};
+	
+	// returns the global binding slot for the given name (creates a new one if necessary)
+	static size_t get_slot(const string& name);
+	static string get_slot_name(const size_t& slot);
+	static constexpr size_t invalid_slot { ~size_t(0) };
+	
+	void bind_buffer(const size_t& slot, const opencl_base::buffer_object& buffer);
+	void bind_image(const size_t& slot, const image& img);
+	
+	// returns nullptr if nothing is bound to this slot
+	const binding* get_binding(const size_t& slot) const {
+		if(slot >= bindings.size() || bindings[slot].version == 0) return nullptr;
+		return &bindings[slot];
+	}
+
+protected:
+	vector<binding> bindings;
+	binding& get_or_create_binding(const size_t& slot);
+	
+	static atomic<unsigned long long int> version_counter;
+	static mutex slots_lock;
+	static unordered_map<string, size_t> slots;
+	static vector<string> slot_names;
+	
+};
+
+// pre-baked state of one program kernel specialization: the compiled kernel, the kernel spec it was
+// built for and the last user arguments that were set on it (-> only changed arguments are set again)
+class pipeline_state {
+public:
+	pipeline_state(oclraster_program& program, const oclraster_program::kernel_spec& spec);
+	~pipeline_state();
+	pipeline_state(pipeline_state& pstate) = delete;
+	pipeline_state& operator=(pipeline_state& pstate) = delete;
+	
+	// returns true if this state can be used for the given draw state (projection, depth, attribute setup and bound image types)
+	bool matches(const draw_state& state) const;
+	
+	// makes the kernel active and sets all user buffer and image arguments that changed since the last bind,
+	// argc will point to the first argument after the user arguments
+	bool bind(const draw_state& state, unsigned int& argc);
+	
+	const oclraster_program::kernel_spec& get_spec() const;
+	weak_ptr<opencl::kernel_object> get_kernel() const;
+	// null kernel object if this state doesn't use attribute setup
+	weak_ptr<opencl::kernel_object> get_attribute_setup_kernel() const;
+	
+	// creates the kernel spec for the currently bound images/framebuffer and the draw state
+	static bool create_kernel_spec(const draw_state& state,
+								   const oclraster_program& program,
+								   oclraster_program::kernel_spec& spec);
+	
+	// returns the framebuffer image for the specified image variable type (color images are consumed in order)
+	static const image* get_framebuffer_image(const framebuffer* fb,
+											  const oclraster_program::IMAGE_VAR_TYPE& type,
+											  size_t& fb_img_idx);
+
+protected:
+	oclraster_program& program;
+	const oclraster_program::kernel_spec spec;
+	weak_ptr<opencl::kernel_object> kernel;
+	weak_ptr<opencl::kernel_object> attribute_setup_kernel;
+	
+	// binding versions of the last set user arguments (buffers first, then images)
+	vector<unsigned long long int> arg_versions;
+	// buffer generations of the last set images (an image may recreate its buffer while it stays bound)
+	vector<unsigned long long int> arg_image_generations;
+	
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pipeline_statistics.hpp"
+#include "oclraster.hpp"
+#include "core/memory_tracker.hpp"
+
+pipeline_statistics::pipeline_statistics() {
+}
+
+pipeline_statistics::~pipeline_statistics() {
+	if(counter_buffer != nullptr) {
+		memory_tracker::delete_buffer(counter_buffer);
+	}
+}
+
+opencl::buffer_object* pipeline_statistics::begin_draw() {
+	// only create the counter buffer when statistics are actually used
+	if(counter_buffer == nullptr) {
+		counter_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE,
+													   opencl::BUFFER_FLAG::READ_WRITE |
+													   opencl::BUFFER_FLAG::BLOCK_ON_READ |
+													   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+													   sizeof(unsigned int) * pipeline_statistic_count);
+	}
+	
+	device_counters.fill(0u);
+	ocl->write_buffer(counter_buffer, &device_counters[0]);
+	return counter_buffer;
+}
+
+void pipeline_statistics::end_draw(const unsigned int primitive_count, const unsigned int batch_count) {
+	ocl->read_buffer(&device_counters[0], counter_buffer);
+	for(size_t i = 0; i < pipeline_statistic_count; i++) {
+		last_draw.counters[i] = device_counters[i];
+	}
+	
+	// these don't need to be counted on the device
+	last_draw[PIPELINE_STATISTIC::PRIMITIVES_IN] = primitive_count;
+	last_draw[PIPELINE_STATISTIC::BATCHES] = batch_count;
+	
+	cur_frame += last_draw;
+}
+
+void pipeline_statistics::end_frame() {
+	last_frame = cur_frame;
+	cur_frame = pipeline_counters {};
+}
+
+const pipeline_counters& pipeline_statistics::get_draw_statistics() const {
+	return last_draw;
+}
+
+const pipeline_counters& pipeline_statistics::get_frame_statistics() const {
+	return last_frame;
+}
+
+const char* pipeline_statistics::statistic_name(const PIPELINE_STATISTIC stat) {
+	switch(stat) {
+		case PIPELINE_STATISTIC::PRIMITIVES_IN: return "primitives in";
+		case PIPELINE_STATISTIC::CULLED_VERTEX_DISCARD: return "culled (vertex discard)";
+		case PIPELINE_STATISTIC::CULLED_NEAR_PLANE: return "culled (near plane)";
+		case PIPELINE_STATISTIC::CULLED_FRUSTUM: return "culled (frustum)";
+		case PIPELINE_STATISTIC::CULLED_BACKFACE: return "culled (backface)";
+		case PIPELINE_STATISTIC::CULLED_DEGENERATE: return "culled (degenerate)";
+		case PIPELINE_STATISTIC::CULLED_SCISSOR: return "culled (scissor)";
+		case PIPELINE_STATISTIC::BIN_PRIMITIVE_PAIRS: return "bin/primitive pairs";
+		case PIPELINE_STATISTIC::BATCHES: return "batches";
+		case PIPELINE_STATISTIC::EMPTY_BATCHES: return "empty batches";
+		case PIPELINE_STATISTIC::FRAGMENTS_TESTED: return "fragments tested";
+		case PIPELINE_STATISTIC::FRAGMENTS_EARLY_DEPTH_REJECTED: return "fragments early depth rejected";
+		case PIPELINE_STATISTIC::FRAGMENTS_DISCARDED: return "fragments discarded";
+		case PIPELINE_STATISTIC::FRAGMENTS_LATE_DEPTH_REJECTED: return "fragments late depth rejected";
+		case PIPELINE_STATISTIC::FRAGMENTS_WRITTEN: return "fragments written";
+		case PIPELINE_STATISTIC::__MAX_PIPELINE_STATISTIC: floor_unreachable();
+	}
+	floor_unreachable();
+}
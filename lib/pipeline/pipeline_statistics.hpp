@@ -0,0 +1,98 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_PIPELINE_STATISTICS_HPP__
+#define __OCLRASTER_PIPELINE_STATISTICS_HPP__
+
+#include "oclraster/global.hpp"
+#include "cl/opencl.hpp"
+
+// pipeline statistics counters (only gathered when built with "pipeline-statistics")
+// NOTE: the order must match the PS_* indices in oclr_global.h
+enum class PIPELINE_STATISTIC : unsigned int {
+	PRIMITIVES_IN,					//!< primitives submitted to the processing stage
+	CULLED_VERTEX_DISCARD,			//!< primitives culled because a vertex was discarded in the transform program
+	CULLED_NEAR_PLANE,				//!< primitives culled because they are completely behind the camera
+	CULLED_FRUSTUM,					//!< primitives culled by the frustum test
+	CULLED_BACKFACE,				//!< primitives culled because they are back-facing
+	CULLED_DEGENERATE,				//!< primitives culled because they are too small or numerically degenerate
+	CULLED_SCISSOR,					//!< primitives culled by the scissor test (orthographic only)
+	BIN_PRIMITIVE_PAIRS,			//!< number of primitives inserted into bin queues (summed over all bins)
+	BATCHES,						//!< number of bin batch queues (#bins * #batches)
+	EMPTY_BATCHES,					//!< bin batch queues that didn't contain any primitive
+	FRAGMENTS_TESTED,				//!< fragments that are covered by a primitive and reach the depth test
+	FRAGMENTS_EARLY_DEPTH_REJECTED,	//!< fragments rejected by the early depth test
+	FRAGMENTS_DISCARDED,			//!< fragments discarded by the rasterization program
+	FRAGMENTS_LATE_DEPTH_REJECTED,	//!< fragments rejected by the depth test after the program ran (depth-override)
+	FRAGMENTS_WRITTEN,				//!< fragments that passed all tests (> framebuffer pixels -> overdraw)
+	__MAX_PIPELINE_STATISTIC
+};
+static constexpr size_t pipeline_statistic_count { (size_t)PIPELINE_STATISTIC::__MAX_PIPELINE_STATISTIC };
+
+struct pipeline_counters {
+	array<unsigned long long int, pipeline_statistic_count> counters {};
+	
+	unsigned long long int& operator[](const PIPELINE_STATISTIC stat) {
+		return counters[(size_t)stat];
+	}
+	const unsigned long long int& operator[](const PIPELINE_STATISTIC stat) const {
+		return counters[(size_t)stat];
+	}
+	pipeline_counters& operator+=(const pipeline_counters& counters_) {
+		for(size_t i = 0; i < pipeline_statistic_count; i++) {
+			counters[i] += counters_.counters[i];
+		}
+		return *this;
+	}
+};
+
+// device-side atomic counters, similar to GL pipeline statistics queries.
+// the counters are reset before each draw call and read back after it, draw counters are then
+// accumulated into per-frame counters (which are completed on each swap).
+// NOTE: reading back the counters synchronizes the command queue after every draw call and the
+// counting itself adds atomic operations to all stages -> only enabled with OCLRASTER_PIPELINE_STATISTICS.
+class pipeline_statistics {
+public:
+	pipeline_statistics();
+	~pipeline_statistics();
+	pipeline_statistics(pipeline_statistics& stats) = delete;
+	pipeline_statistics& operator=(pipeline_statistics& stats) = delete;
+	
+	// resets the device counters and returns the buffer that must be passed to the internal kernels
+	opencl::buffer_object* begin_draw();
+	// reads back the device counters (the host-side counters are computed from the draw parameters)
+	void end_draw(const unsigned int primitive_count, const unsigned int batch_count);
+	void end_frame();
+	
+	// counters of the last draw call
+	const pipeline_counters& get_draw_statistics() const;
+	// counters of the last complete frame (summed over all draw calls)
+	const pipeline_counters& get_frame_statistics() const;
+	
+	static const char* statistic_name(const PIPELINE_STATISTIC stat);
+
+protected:
+	opencl::buffer_object* counter_buffer { nullptr };
+	array<unsigned int, pipeline_statistic_count> device_counters {};
+	pipeline_counters last_draw;
+	pipeline_counters cur_frame;
+	pipeline_counters last_frame;
+	
+};
+
+#endif
@@ -27,17 +27,18 @@ processing_stage::~processing_stage() {
 }
 
 void processing_stage::process(draw_state& state, const PRIMITIVE_TYPE type) {
+	OCLRASTER_TRACE_SCOPE("processing", "stage");
 	// -> 1D kernel, with max #work-items per work-group
 	ocl->use_kernel(string("PROCESSING.") + (state.projection == PROJECTION::PERSPECTIVE ? "PERSPECTIVE" : "ORTHOGRAPHIC"));
 	
 	unsigned int argc = 0;
 	
-	const auto index_buffer = state.user_buffers.find("index_buffer");
-	if(index_buffer == state.user_buffers.cend()) {
+	const auto index_buffer = state.bindings.get_binding(index_buffer_slot);
+	if(index_buffer == nullptr || index_buffer->buffer == nullptr) {
 		log_error("index buffer not bound!");
 		return;
 	}
-	ocl->set_kernel_argument(argc++, &index_buffer->second);
+	ocl->set_kernel_argument(argc++, index_buffer->buffer);
 	
 	// internal buffer / kernel parameters
 	ocl->set_kernel_argument(argc++, state.transformed_vertices_buffer);
@@ -49,6 +50,9 @@ void processing_stage::process(draw_state& state, const PRIMITIVE_TYPE type) {
 	ocl->set_kernel_argument(argc++, state.instance_primitive_count);
 	ocl->set_kernel_argument(argc++, state.instance_index_count);
 	ocl->set_kernel_argument(argc++, state.scissor_rectangle_abs);
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	ocl->set_kernel_argument(argc++, state.pipeline_stats_buffer);
+#endif
 	ocl->set_kernel_range(ocl->compute_kernel_ranges(state.primitive_count));
 	ocl->run_kernel();
 }
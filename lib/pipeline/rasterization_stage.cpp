@@ -21,28 +21,42 @@
 #include "oclraster.hpp"
 
 rasterization_stage::rasterization_stage() : stage_base() {
-	bin_distribution_counter = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-												  opencl::BUFFER_FLAG::BLOCK_ON_READ |
-												  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-												  sizeof(unsigned int));
+	bin_distribution_counter = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE,
+															 opencl::BUFFER_FLAG::READ_WRITE |
+															 opencl::BUFFER_FLAG::BLOCK_ON_READ |
+															 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+															 sizeof(unsigned int));
 }
 
 rasterization_stage::~rasterization_stage() {
 	if(bin_distribution_counter != nullptr) {
-		ocl->delete_buffer(bin_distribution_counter);
+		memory_tracker::delete_buffer(bin_distribution_counter);
 	}
 }
 
 void rasterization_stage::rasterize(draw_state& state,
 									const PRIMITIVE_TYPE type,
 									const opencl_base::buffer_object* queue_buffer) {
+	OCLRASTER_TRACE_SCOPE("rasterization", "stage");
 	////
 	// render / rasterization
-	oclraster_program::kernel_spec spec;
-	if(!create_kernel_spec(state, *state.rasterize_prog, spec)) {
+	pipeline_state* pstate = state.rasterize_prog->get_pipeline_state(state);
+	if(pstate == nullptr) return;
+	
+	const auto index_buffer = state.bindings.get_binding(index_buffer_slot);
+	if(index_buffer == nullptr || index_buffer->buffer == nullptr) {
+		log_error("index buffer not bound!");
 		return;
 	}
-	ocl->use_kernel(state.rasterize_prog->get_kernel(spec));
+	
+	// attribute setup (plane equations of all output variables, once per primitive)
+	opencl::buffer_object* attribute_plane_buffer = nullptr;
+	if(pstate->get_spec().attribute_setup) {
+		attribute_plane_buffer = setup_attributes(state, type, *pstate, index_buffer->buffer);
+		if(attribute_plane_buffer == nullptr) return;
+	}
+	
+	ocl->use_kernel(pstate->get_kernel());
 	
 	// determine per-bin work-group size and how many iterations/splits are necessary per bin
 	const size_t bin_size = state.bin_size.x * state.bin_size.y;
@@ -58,17 +72,18 @@ void rasterization_stage::rasterize(draw_state& state,
 	
 	//
 	unsigned int argc = 0;
-	if(!bind_user_buffers(state, *state.rasterize_prog, argc)) return;
-	
-	const auto index_buffer = state.user_buffers.find("index_buffer");
-	if(index_buffer == state.user_buffers.cend()) {
-		log_error("index buffer not bound!");
+	if(!pstate->bind(state, argc)) {
+		if(attribute_plane_buffer != nullptr) memory_tracker::delete_buffer(attribute_plane_buffer);
 		return;
 	}
-	ocl->set_kernel_argument(argc++, &index_buffer->second);
+	
+	ocl->set_kernel_argument(argc++, index_buffer->buffer);
 	
 	ocl->set_kernel_argument(argc++, bin_distribution_counter);
 	ocl->set_kernel_argument(argc++, state.transformed_buffer);
+	if(attribute_plane_buffer != nullptr) {
+		ocl->set_kernel_argument(argc++, attribute_plane_buffer);
+	}
 	ocl->set_kernel_argument(argc++, queue_buffer);
 	ocl->set_kernel_argument(argc++, state.bin_count);
 	ocl->set_kernel_argument(argc++, (unsigned int)(state.bin_count.x * state.bin_count.y));
@@ -80,6 +95,13 @@ void rasterization_stage::rasterize(draw_state& state,
 	ocl->set_kernel_argument(argc++, state.instance_index_count);
 	ocl->set_kernel_argument(argc++, state.framebuffer_size);
 	ocl->set_kernel_argument(argc++, state.scissor_rectangle_abs);
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	ocl->set_kernel_argument(argc++, state.pipeline_stats_buffer);
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+	ocl->set_kernel_argument(argc++, state.bin_heatmap_buffer);
+	ocl->set_kernel_argument(argc++, state.bin_heatmap_bin_count);
+#endif
 	
 	if(ocl->get_active_device()->type >= opencl::DEVICE_TYPE::CPU0 &&
 	   ocl->get_active_device()->type <= opencl::DEVICE_TYPE::CPU255) {
@@ -93,4 +115,56 @@ void rasterization_stage::rasterize(draw_state& state,
 		ocl->set_kernel_range({ unit_count * local_size, local_size });
 	}
 	ocl->run_kernel();
+	
+	// attribute planes are only needed for this draw call
+	if(attribute_plane_buffer != nullptr) {
+		memory_tracker::delete_buffer(attribute_plane_buffer);
+	}
+}
+
+opencl::buffer_object* rasterization_stage::setup_attributes(draw_state& state,
+															 const PRIMITIVE_TYPE type,
+															 const pipeline_state& pstate,
+															 const opencl_base::buffer_object* index_buffer) {
+	OCLRASTER_TRACE_SCOPE("attribute_setup", "stage");
+	const auto setup_kernel = pstate.get_attribute_setup_kernel();
+	if(setup_kernel.use_count() == 0) {
+		log_error("no attribute setup kernel!");
+		return nullptr;
+	}
+	
+	// dx, dy and offset of all output variables (floats) for all primitives
+	const size_t plane_stride = state.rasterize_prog->get_attribute_plane_stride();
+	opencl::buffer_object* attribute_plane_buffer = memory_tracker::create_buffer(MEMORY_TAG::PIPELINE_TRANSIENT,
+																				  opencl::BUFFER_FLAG::READ_WRITE,
+																				  sizeof(float) * plane_stride * std::max(state.primitive_count, 1u));
+	
+	ocl->use_kernel(setup_kernel);
+	unsigned int argc = 0;
+	
+	// transform program outputs (same order as in the rasterization kernel)
+	const auto& structs = state.rasterize_prog->get_structs();
+	const auto& struct_slots = state.rasterize_prog->get_binding_layout().struct_slots;
+	for(size_t i = 0, struct_count = structs.size(); i < struct_count; i++) {
+		if(structs[i]->type != oclraster_program::STRUCT_TYPE::OUTPUT) continue;
+		const auto binding = state.bindings.get_binding(struct_slots[i]);
+		if(binding == nullptr || binding->buffer == nullptr) {
+			log_error("buffer \"%s\" not bound!", binding_table::get_slot_name(struct_slots[i]));
+			memory_tracker::delete_buffer(attribute_plane_buffer);
+			return nullptr;
+		}
+		ocl->set_kernel_argument(argc++, binding->buffer);
+	}
+	
+	ocl->set_kernel_argument(argc++, index_buffer);
+	ocl->set_kernel_argument(argc++, state.transformed_buffer);
+	ocl->set_kernel_argument(argc++, state.primitive_bounds_buffer);
+	ocl->set_kernel_argument(argc++, attribute_plane_buffer);
+	ocl->set_kernel_argument(argc++, (underlying_type<PRIMITIVE_TYPE>::type)type);
+	ocl->set_kernel_argument(argc++, state.primitive_count);
+	ocl->set_kernel_argument(argc++, state.instance_primitive_count);
+	ocl->set_kernel_argument(argc++, state.instance_index_count);
+	ocl->set_kernel_range(ocl->compute_kernel_ranges(state.primitive_count));
+	ocl->run_kernel();
+	return attribute_plane_buffer;
 }
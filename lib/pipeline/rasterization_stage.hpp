@@ -24,6 +24,7 @@
 
 enum class PRIMITIVE_TYPE : unsigned int;
 struct draw_state;
+class pipeline_state;
 class rasterization_stage : public stage_base {
 public:
 	rasterization_stage();
@@ -35,6 +36,13 @@ public:
 
 protected:
 	opencl::buffer_object* bin_distribution_counter = nullptr;
+	
+	// runs the attribute setup kernel of the pipeline state and returns the attribute plane buffer
+	// (must be deleted after the rasterization kernel has been enqueued), nullptr on failure
+	opencl::buffer_object* setup_attributes(draw_state& state,
+											const PRIMITIVE_TYPE type,
+											const pipeline_state& pstate,
+											const opencl_base::buffer_object* index_buffer);
 
 };
 
@@ -20,123 +20,8 @@
 #include "pipeline.hpp"
 #include "oclraster.hpp"
 
-stage_base::stage_base() {
+stage_base::stage_base() : index_buffer_slot(binding_table::get_slot("index_buffer")) {
 }
 
 stage_base::~stage_base() {
 }
-
-bool stage_base::bind_user_buffers(const draw_state& state, const oclraster_program& program, unsigned int& argc) {
-	// set user buffers
-	const auto find_and_bind_buffer = [&](const string& name) -> bool {
-		const auto buffer = state.user_buffers.find(name);
-		// TODO: only check this in debug mode?
-		if(buffer == state.user_buffers.cend()) {
-			log_error("buffer \"%s\" not bound!", name);
-			return false;
-		}
-		ocl->set_kernel_argument(argc++, &buffer->second);
-		return true;
-	};
-	
-	for(const auto& user_struct : program.get_structs()) {
-		if(user_struct->type != oclraster_program::STRUCT_TYPE::BUFFERS) {
-			if(!find_and_bind_buffer(user_struct->object_name)) return false;
-		}
-		else {
-			for(size_t i = 0, buffer_entries = user_struct->variables.size(); i < buffer_entries; i++) {
-				if(!find_and_bind_buffer(user_struct->variables[i])) return false;
-			}
-		}
-	}
-	
-	// TODO: merge this with create_kernel_spec ...?
-	const framebuffer* fb = state.active_framebuffer;
-	const auto images = program.get_images();
-	for(size_t i = 0, fb_img_idx = 0, img_count = images.image_names.size(); i < img_count; i++) {
-		if(images.is_framebuffer[i]) {
-			// framebuffer
-			if(fb == nullptr) {
-				log_error("no framebuffer is currently bound!");
-				return false;
-			}
-			const image* img = nullptr;
-			switch(images.image_types[i]) {
-				case oclraster_program::IMAGE_VAR_TYPE::DEPTH_IMAGE:
-					img = fb->get_depth_buffer();
-					break;
-				case oclraster_program::IMAGE_VAR_TYPE::STENCIL_IMAGE:
-					img = fb->get_stencil_buffer();
-					break;
-				default:
-					img = fb->get_image(fb_img_idx);
-					fb_img_idx++;
-					break;
-			}
-			if(img == nullptr) {
-				log_error("framebuffer image \"%s\" not bound!", images.image_names[i]);
-				return false;
-			}
-			ocl->set_kernel_argument(argc++, img->get_buffer());
-		}
-		else {
-			// image
-			const auto& img_name = images.image_names[i];
-			const auto img = state.user_images.find(img_name);
-			// TODO: only check this in debug mode?
-			if(img == state.user_images.cend()) {
-				log_error("image \"%s\" not bound!", img_name);
-				return false;
-			}
-			ocl->set_kernel_argument(argc++, img->second.get_buffer());
-		}
-	}
-	
-	return true;
-}
-
-bool stage_base::create_kernel_spec(const draw_state& state, const oclraster_program& program,
-									oclraster_program::kernel_spec& spec) {
-	const auto images = program.get_images();
-	const framebuffer* fb = state.active_framebuffer;
-	for(size_t i = 0, fb_img_idx = 0, img_count = images.image_names.size(); i < img_count; i++) {
-		if(images.is_framebuffer[i]) {
-			// framebuffer
-			if(fb == nullptr) {
-				log_error("no framebuffer is currently bound!");
-				return false;
-			}
-			const image* img = nullptr;
-			switch(images.image_types[i]) {
-				case oclraster_program::IMAGE_VAR_TYPE::DEPTH_IMAGE:
-					img = fb->get_depth_buffer();
-					break;
-				case oclraster_program::IMAGE_VAR_TYPE::STENCIL_IMAGE:
-					img = fb->get_stencil_buffer();
-					break;
-				default:
-					img = fb->get_image(fb_img_idx);
-					fb_img_idx++;
-					break;
-			}
-			if(img == nullptr) {
-				log_error("framebuffer image \"%s\" not bound!", images.image_names[i]);
-				return false;
-			}
-			spec.image_spec.emplace_back(img->get_image_type());
-		}
-		else {
-			// image
-			const auto& img_name = images.image_names[i];
-			const auto img = state.user_images.find(img_name);
-			if(img == state.user_images.cend()) {
-				log_error("image \"%s\" not bound!", img_name);
-				return false;
-			}
-			spec.image_spec.emplace_back(img->second.get_image_type());
-		}
-	}
-	spec.projection = state.projection;
-	spec.depth = state.depth;
-	return true;
-}
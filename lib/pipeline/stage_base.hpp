@@ -21,6 +21,7 @@
 
 #include "cl/opencl.hpp"
 #include "program/oclraster_program.hpp"
+#include "pipeline/pipeline_state.hpp"
 
 struct draw_state;
 class stage_base {
@@ -29,13 +30,8 @@ public:
 	virtual ~stage_base();
 	
 protected:
-	bool bind_user_buffers(const draw_state& state,
-						   const oclraster_program& prog,
-						   unsigned int& argc);
-	
-	bool create_kernel_spec(const draw_state& state,
-							const oclraster_program& program,
-							oclraster_program::kernel_spec& spec);
+	// binding slot of the index buffer (resolved once)
+	const size_t index_buffer_slot;
 	
 };
 
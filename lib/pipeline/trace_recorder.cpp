@@ -0,0 +1,203 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "trace_recorder.hpp"
+#include "oclraster.hpp"
+#include <fstream>
+
+atomic<bool> trace_recorder::enabled { false };
+atomic<unsigned long long int> trace_recorder::frame { 0 };
+mutex trace_recorder::events_lock;
+vector<trace_recorder::event> trace_recorder::events;
+size_t trace_recorder::capacity { 65536 };
+size_t trace_recorder::events_pos { 0 };
+size_t trace_recorder::events_count { 0 };
+unsigned long long int trace_recorder::time_base { 0 };
+
+void trace_recorder::set_enabled(const bool state) {
+	lock_guard<mutex> lock(events_lock);
+	if(state && time_base == 0) {
+		time_base = SDL_GetPerformanceCounter();
+	}
+	if(state && events.empty()) {
+		events.resize(capacity);
+	}
+	enabled = state;
+}
+
+void trace_recorder::set_capacity(const size_t capacity_) {
+	lock_guard<mutex> lock(events_lock);
+	capacity = std::max(capacity_, size_t(1));
+	events.clear();
+	if(enabled) {
+		events.resize(capacity);
+	}
+	events_pos = 0;
+	events_count = 0;
+}
+
+size_t trace_recorder::get_capacity() {
+	lock_guard<mutex> lock(events_lock);
+	return capacity;
+}
+
+void trace_recorder::next_frame() {
+	if(!enabled) return;
+	instant("frame", "frame", ull2string(frame));
+	frame++;
+}
+
+unsigned long long int trace_recorder::get_frame() {
+	return frame;
+}
+
+void trace_recorder::record(const char* name, const char* category, const TRACK track,
+							const unsigned long long int start, const unsigned long long int end,
+							const string detail) {
+	if(!enabled) return;
+	lock_guard<mutex> lock(events_lock);
+	if(events.empty()) return;
+	event& evt = events[events_pos];
+	evt.name = name;
+	evt.category = category;
+	evt.detail = detail;
+	evt.track = track;
+	evt.start = start;
+	evt.end = end;
+	evt.frame = frame;
+	evt.instant = false;
+	events_pos = (events_pos + 1) % events.size();
+	events_count = std::min(events_count + 1, events.size());
+}
+
+void trace_recorder::instant(const char* name, const char* category, const string detail) {
+	if(!enabled) return;
+	const unsigned long long int now = SDL_GetPerformanceCounter();
+	lock_guard<mutex> lock(events_lock);
+	if(events.empty()) return;
+	event& evt = events[events_pos];
+	evt.name = name;
+	evt.category = category;
+	evt.detail = detail;
+	evt.track = TRACK::HOST;
+	evt.start = now;
+	evt.end = now;
+	evt.frame = frame;
+	evt.instant = true;
+	events_pos = (events_pos + 1) % events.size();
+	events_count = std::min(events_count + 1, events.size());
+}
+
+string trace_recorder::escape_json(const string& str) {
+	string ret = "";
+	ret.reserve(str.size());
+	for(const auto& ch : str) {
+		switch(ch) {
+			case '\"': ret += "\\\""; break;
+			case '\\': ret += "\\\\"; break;
+			case '\n': ret += "\\n"; break;
+			case '\t': ret += "\\t"; break;
+			case '\r': ret += "\\r"; break;
+			default:
+				if((unsigned char)ch < 0x20) {
+					// other control characters
+					static const char hex_digits[] { "0123456789abcdef" };
+					ret += "\\u00";
+					ret += hex_digits[((unsigned char)ch >> 4u) & 0xF];
+					ret += hex_digits[(unsigned char)ch & 0xF];
+				}
+				else ret += ch;
+				break;
+		}
+	}
+	return ret;
+}
+
+bool trace_recorder::dump(const string& filename,
+						  const unsigned long long int first_frame,
+						  const unsigned long long int last_frame) {
+	// copy the requested events, so that recording isn't blocked while writing the file
+	vector<event> dump_events;
+	unsigned long long int base = 0;
+	{
+		lock_guard<mutex> lock(events_lock);
+		dump_events.reserve(events_count);
+		const size_t first_idx = (events.empty() ? 0 : (events_pos + events.size() - events_count) % events.size());
+		for(size_t i = 0; i < events_count; i++) {
+			const event& evt = events[(first_idx + i) % events.size()];
+			if(evt.frame < first_frame || evt.frame > last_frame) continue;
+			dump_events.emplace_back(evt);
+		}
+		base = time_base;
+	}
+	
+	ofstream file(filename, ios::out | ios::trunc);
+	if(!file.is_open()) {
+		log_error("failed to open trace file \"%s\"!", filename);
+		return false;
+	}
+	
+	// timestamps and durations are in microseconds
+	const double counter_to_us = 1000000.0 / double(SDL_GetPerformanceFrequency());
+	const auto timestamp = [&counter_to_us, &base](const unsigned long long int& counter) {
+		return (counter < base ? 0.0 : double(counter - base) * counter_to_us);
+	};
+	
+	file.precision(3);
+	file << fixed;
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"oclraster\"}},\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (unsigned int)TRACK::HOST << ",\"args\":{\"name\":\"host\"}},\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (unsigned int)TRACK::DEVICE << ",\"args\":{\"name\":\"device\"}}";
+	for(const auto& evt : dump_events) {
+		file << ",\n{\"name\":\"" << evt.name << "\",\"cat\":\"" << evt.category << "\"";
+		if(evt.instant) {
+			file << ",\"ph\":\"i\",\"s\":\"t\"";
+		}
+		else {
+			file << ",\"ph\":\"X\",\"dur\":" << (double(evt.end - evt.start) * counter_to_us);
+		}
+		file << ",\"ts\":" << timestamp(evt.start);
+		file << ",\"pid\":1,\"tid\":" << (unsigned int)evt.track;
+		file << ",\"args\":{\"frame\":" << evt.frame;
+		if(!evt.detail.empty()) {
+			file << ",\"detail\":\"" << escape_json(evt.detail) << "\"";
+		}
+		file << "}}";
+	}
+	file << "\n]}\n";
+	file.close();
+	
+	log_debug("dumped %u trace events to \"%s\"", dump_events.size(), filename);
+	return true;
+}
+
+//// scope
+trace_recorder::scope::scope(const char* name_, const char* category_, const string detail_) :
+name(name_), category(category_), active(trace_recorder::is_enabled()) {
+	if(active) {
+		detail = detail_;
+		start = SDL_GetPerformanceCounter();
+	}
+}
+
+trace_recorder::scope::~scope() {
+	if(active) {
+		trace_recorder::record(name, category, TRACK::HOST, start, SDL_GetPerformanceCounter(), detail);
+	}
+}
@@ -0,0 +1,113 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_TRACE_RECORDER_HPP__
+#define __OCLRASTER_TRACE_RECORDER_HPP__
+
+#include "oclraster/global.hpp"
+
+// records host api calls and device stage timings into a ring buffer, which can be dumped as a
+// chrome trace json file (load it in chrome://tracing or ui.perfetto.dev) for a range of frames.
+// recording is disabled by default and can be toggled at runtime, disabled hooks only cost a flag check.
+// NOTE: device timings are only available when built with OCLRASTER_PROFILING (the opencl wrapper
+// doesn't expose kernel events, so these are the synchronized stage timings of the pipeline_profiler).
+class trace_recorder {
+public:
+	enum class TRACK : unsigned int {
+		HOST,
+		DEVICE,
+		__MAX_TRACK
+	};
+	
+	struct event {
+		const char* name { "" }; // must be a string literal
+		const char* category { "" }; // must be a string literal
+		string detail { "" }; // optional, stored in the event "args"
+		TRACK track { TRACK::HOST };
+		unsigned long long int start { 0 }; // performance counter
+		unsigned long long int end { 0 }; // == start for instant events
+		unsigned long long int frame { 0 };
+		bool instant { false };
+	};
+	
+	static void set_enabled(const bool state);
+	static bool is_enabled() {
+		return enabled;
+	}
+	
+	// max number of stored events (older events are overwritten), this also clears all recorded events
+	// (the event storage is only allocated once recording is enabled)
+	static void set_capacity(const size_t capacity);
+	static size_t get_capacity();
+	
+	// called by the pipeline on each swap
+	static void next_frame();
+	static unsigned long long int get_frame();
+	
+	static void record(const char* name, const char* category, const TRACK track,
+					   const unsigned long long int start, const unsigned long long int end,
+					   const string detail = "");
+	static void instant(const char* name, const char* category, const string detail = "");
+	
+	// dumps all recorded events of the frames [first_frame, last_frame] as chrome trace json
+	// (use ~0ull as last_frame to dump everything up to the current frame)
+	static bool dump(const string& filename,
+					 const unsigned long long int first_frame = 0,
+					 const unsigned long long int last_frame = ~0ull);
+	
+	// escapes a string for use inside a json string literal
+	static string escape_json(const string& str);
+	
+	// records a host event for the lifetime of this object (if recording is enabled at construction)
+	class scope {
+	public:
+		scope(const char* name, const char* category, const string detail = "");
+		~scope();
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
+	
+	protected:
+		const char* name;
+		const char* category;
+		string detail;
+		unsigned long long int start { 0 };
+		const bool active;
+	};
+
+protected:
+	static atomic<bool> enabled;
+	static atomic<unsigned long long int> frame;
+	static mutex events_lock;
+	static vector<event> events;
+	static size_t capacity;
+	static size_t events_pos;
+	static size_t events_count;
+	static unsigned long long int time_base;
+	
+};
+
+#define OCLRASTER_TRACE_CONCAT_(a, b) a##b
+#define OCLRASTER_TRACE_CONCAT(a, b) OCLRASTER_TRACE_CONCAT_(a, b)
+#define OCLRASTER_TRACE_SCOPE(name, category, ...) \
+	trace_recorder::scope OCLRASTER_TRACE_CONCAT(trace_scope_, __LINE__)(name, category, ##__VA_ARGS__)
+// note: the detail argument is only evaluated if recording is enabled
+#define OCLRASTER_TRACE_INSTANT(name, category, ...) do { \
+	if(trace_recorder::is_enabled()) trace_recorder::instant(name, category, ##__VA_ARGS__); \
+} while(false)
+	
+#endif
@@ -27,17 +27,14 @@ transform_stage::~transform_stage() {
 }
 
 void transform_stage::transform(draw_state& state) {
+	OCLRASTER_TRACE_SCOPE("transform", "stage");
 	//
-	oclraster_program::kernel_spec spec;
-	if(!create_kernel_spec(state, *state.transform_prog, spec)) {
-		return;
-	}
+	pipeline_state* pstate = state.transform_prog->get_pipeline_state(state);
+	if(pstate == nullptr) return;
 	
 	// -> 1D kernel, with max #work-items per work-group
-	ocl->use_kernel(state.transform_prog->get_kernel(spec));
-	
 	unsigned int argc = 0;
-	if(!bind_user_buffers(state, *state.transform_prog, argc)) return;
+	if(!pstate->bind(state, argc)) return;
 	
 	// internal buffer / kernel parameters
 	ocl->set_kernel_argument(argc++, state.transformed_vertices_buffer);
@@ -56,21 +53,10 @@ void transform_stage::transform(draw_state& state) {
 		
 		//
 		unsigned int buffer_num = 0;
-		const auto find_and_dump_buffer = [&](const string& name) -> void {
-			const auto buffer = state.user_buffers.find(name);
-			ocl->dump_buffer((opencl::buffer_object*)&buffer->second, floor::data_path("dump/tuser_"+uint2string(buffer_num)+".hex"));
+		for(const auto& slot : state.transform_prog->get_binding_layout().buffer_slots) {
+			const auto binding = state.bindings.get_binding(slot);
+			ocl->dump_buffer((opencl::buffer_object*)binding->buffer, floor::data_path("dump/tuser_"+uint2string(buffer_num)+".hex"));
 			buffer_num++;
-		};
-		
-		for(const auto& user_struct : state.transform_prog->get_structs()) {
-			if(user_struct->type != oclraster_program::STRUCT_TYPE::BUFFERS) {
-				find_and_dump_buffer(user_struct->object_name);
-			}
-			else {
-				for(size_t i = 0, buffer_entries = user_struct->variables.size(); i < buffer_entries; i++) {
-					find_and_dump_buffer(user_struct->variables[i]);
-				}
-			}
 		}
 	}
 #endif
@@ -18,21 +18,26 @@
 
 #include "oclraster_program.hpp"
 #include "oclraster.hpp"
-#include <regex>
+#include "pipeline/pipeline.hpp"
+#include "pipeline/pipeline_state.hpp"
+#include "program/struct_layout.hpp"
 
 #include "tccpp/libtcc.h"
 extern "C" {
 #include "tccpp/tcc.h"
 }
 
-oclraster_program::oclraster_program(const string& code floor_unused,
+oclraster_program::oclraster_program(const string& code,
 									 const string entry_function_,
 									 const string build_options_,
 									 const kernel_spec default_spec_ floor_unused) :
-entry_function(entry_function_), build_options(build_options_), kernel_function_name("oclraster_program") {
+source_code(code), entry_function(entry_function_), build_options(build_options_), kernel_function_name("oclraster_program") {
 }
 
 oclraster_program::~oclraster_program() {
+	for(auto& pstate : pipeline_states) {
+		delete pstate;
+	}
 	for(auto& spec : compiled_kernels) {
 		delete spec;
 	}
@@ -43,23 +48,135 @@ oclraster_program::~oclraster_program() {
 		for(const auto& kernel : kernels) {
 			ocl->delete_kernel(kernel.second);
 		}
+		for(const auto& kernel : attribute_setup_kernels) {
+			ocl->delete_kernel(kernel.second);
+		}
+	}
+}
+
+// helper functions for the program parser (no regex, everything is a simple forward scan)
+static inline bool is_identifier_char(const char& ch) {
+	return ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_');
+}
+
+static inline bool is_whitespace_char(const char& ch) {
+	return (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f');
+}
+
+// removes comments, condenses all whitespace to a single space and removes any whitespace around ';'
+static string condense_struct_code(const string& code) {
+	string ret;
+	ret.reserve(code.size());
+	bool pending_space = false;
+	for(size_t i = 0, len = code.size(); i < len; i++) {
+		const char& ch = code[i];
+		if(ch == '/' && i + 1 < len && code[i + 1] == '/') {
+			// single-line comment
+			i = code.find('\n', i);
+			if(i == string::npos) break;
+			pending_space = true;
+			continue;
+		}
+		if(ch == '/' && i + 1 < len && code[i + 1] == '*') {
+			// multi-line comment
+			i = code.find("*/", i + 2);
+			if(i == string::npos) break;
+			i++;
+			pending_space = true;
+			continue;
+		}
+		if(is_whitespace_char(ch)) {
+			pending_space = true;
+			continue;
+		}
+		if(ch == ';') {
+			ret += ';';
+			pending_space = false;
+			continue;
+		}
+		if(pending_space && !ret.empty() && ret.back() != ';') ret += ' ';
+		pending_space = false;
+		ret += ch;
+	}
+	return ret;
+}
+
+static string strip_whitespace(const string& str) {
+	string ret;
+	ret.reserve(str.size());
+	for(const auto& ch : str) {
+		if(!is_whitespace_char(ch)) ret += ch;
 	}
+	return ret;
+}
+
+// skips whitespace, string/char literals and comments, returns the position of the next identifier
+// (or string::npos if there is none), "end_pos" is set to the position after the identifier
+static size_t find_next_identifier(const string& code, size_t pos, size_t& end_pos) {
+	for(const size_t len = code.size(); pos < len; pos++) {
+		const char& ch = code[pos];
+		if(ch == '"' || ch == '\'') {
+			// skip literal
+			for(pos++; pos < len && code[pos] != ch; pos++) {
+				if(code[pos] == '\\') pos++;
+			}
+			continue;
+		}
+		if(ch == '/' && pos + 1 < len && code[pos + 1] == '/') {
+			pos = code.find('\n', pos);
+			if(pos == string::npos) return string::npos;
+			continue;
+		}
+		if(ch == '/' && pos + 1 < len && code[pos + 1] == '*') {
+			pos = code.find("*/", pos + 2);
+			if(pos == string::npos) return string::npos;
+			pos++;
+			continue;
+		}
+		if(is_identifier_char(ch)) {
+			end_pos = pos + 1;
+			while(end_pos < len && is_identifier_char(code[end_pos])) end_pos++;
+			// numbers are no identifiers
+			if(ch >= '0' && ch <= '9') {
+				pos = end_pos - 1;
+				continue;
+			}
+			return pos;
+		}
+	}
+	return string::npos;
+}
+
+// checks if the identifier at [pos, end_pos) is followed by "()" (ignoring whitespace),
+// returns the position after the closing ')' or string::npos if this isn't the case
+static size_t match_empty_call(const string& code, size_t end_pos) {
+	const size_t len = code.size();
+	while(end_pos < len && is_whitespace_char(code[end_pos])) end_pos++;
+	if(end_pos >= len || code[end_pos] != '(') return string::npos;
+	end_pos++;
+	while(end_pos < len && is_whitespace_char(code[end_pos])) end_pos++;
+	if(end_pos >= len || code[end_pos] != ')') return string::npos;
+	return end_pos + 1;
 }
 
 void oclraster_program::process_program(const string& raw_code, const kernel_spec default_spec) {
 	// preprocess
+	const auto timer_start = SDL_GetPerformanceCounter();
 	const string code = preprocess_code(raw_code);
+	const auto timer_preprocessed = SDL_GetPerformanceCounter();
+	const auto timer_diff_ms = [](const unsigned long long int& start, const unsigned long long int& end) {
+		return (double(end - start) * 1000.0) / double(SDL_GetPerformanceFrequency());
+	};
+	timings.preprocess = timer_diff_ms(timer_start, timer_preprocessed);
 	
 	// parse
-	static const array<const pair<const char*, const STRUCT_TYPE>, 6> oclraster_struct_types {
-		{
-			{ u8"oclraster_in", STRUCT_TYPE::INPUT },
-			{ u8"oclraster_out", STRUCT_TYPE::OUTPUT },
-			{ u8"oclraster_uniforms", STRUCT_TYPE::UNIFORMS },
-			{ u8"oclraster_buffers", STRUCT_TYPE::BUFFERS },
-			{ u8"oclraster_images", STRUCT_TYPE::IMAGES },
-			{ u8"oclraster_framebuffer", STRUCT_TYPE::FRAMEBUFFER }
-		}
+	static const unordered_map<string, const STRUCT_TYPE> oclraster_struct_types {
+		{ u8"oclraster_in", STRUCT_TYPE::INPUT },
+		{ u8"oclraster_out", STRUCT_TYPE::OUTPUT },
+		{ u8"oclraster_uniforms", STRUCT_TYPE::UNIFORMS },
+		{ u8"oclraster_buffers", STRUCT_TYPE::BUFFERS },
+		{ u8"oclraster_images", STRUCT_TYPE::IMAGES },
+		{ u8"oclraster_framebuffer", STRUCT_TYPE::FRAMEBUFFER }
 	};
 	static const set<const string> specifiers {
 		"read_only", "write_only", "read_write"
@@ -79,132 +196,170 @@ void oclraster_program::process_program(const string& raw_code, const kernel_spe
 	// 		float2 tex_coord;
 	// } inputs;
 	//
-	vector<size2> image_struct_positions;
+	struct image_struct_decl {
+		size2 code_range;
+		vector<string> variable_names;
+		vector<string> variable_types;
+		vector<string> variable_specifiers;
+		bool is_framebuffer;
+	};
+	vector<image_struct_decl> image_structs;
+	vector<size2> entry_function_positions;
 	try {
-		// parse and extract
-		for(const auto& type : oclraster_struct_types) {
-			size_t struct_pos = 0;
-			while((struct_pos = code.find(type.first, struct_pos)) != string::npos) {
-				// find first ' ' space char and open '{' bracket and extract the structs name
-				const size_t space_pos = code.find_first_of(" {", struct_pos);
-				const size_t open_bracket_pos = code.find("{", struct_pos);
-				if(space_pos == string::npos || code[space_pos] == '{') throw floor_exception("no struct name");
-				if(open_bracket_pos == string::npos) throw floor_exception("no struct open bracket");
-				const string struct_name = core::trim(code.substr(space_pos+1, open_bracket_pos-space_pos-1));
-				//log_msg("struct type: \"%s\"", type.first);
-				//log_msg("struct name: \"%s\"", struct_name);
-				
-				// open/close bracket match
-				size_t bracket_pos = open_bracket_pos;
-				size_t open_bracket_count = 1;
-				while(open_bracket_count > 0) {
-					bracket_pos = code.find_first_of("{}", bracket_pos + 1);
-					if(bracket_pos == string::npos) throw floor_exception("struct open/close bracket mismatch");
-					code[bracket_pos] == '{' ? open_bracket_count++ : open_bracket_count--;
-				}
-				const size_t close_bracket_pos = bracket_pos;
-				
-				//
-				const size_t end_semicolon_pos = code.find(";", close_bracket_pos+1);
-				if(end_semicolon_pos == string::npos) {
-					throw floor_exception("end-semicolon missing from struct \""+struct_name+"\"!");
+		// parse and extract (single pass over the code)
+		size_t ident_pos = 0, ident_end_pos = 0;
+		while((ident_pos = find_next_identifier(code, ident_pos, ident_end_pos)) != string::npos) {
+			const size_t ident_len = ident_end_pos - ident_pos;
+			
+			// entry function
+			if(ident_len == entry_function.size() &&
+			   code.compare(ident_pos, ident_len, entry_function) == 0) {
+				const size_t call_end_pos = match_empty_call(code, ident_end_pos);
+				if(call_end_pos != string::npos) {
+					entry_function_positions.emplace_back(ident_pos, call_end_pos);
+					ident_pos = call_end_pos;
+					continue;
 				}
-				const string object_name = core::trim(code.substr(close_bracket_pos+1,
-																  end_semicolon_pos-close_bracket_pos-1));
-				//log_msg("object name: \"%s\"", object_name);
-				
-				//
-				string struct_interior = code.substr(open_bracket_pos+1, close_bracket_pos-open_bracket_pos-1);
-				//log_msg("struct interior:\n\t%s\n", struct_interior);
-				
-				// strip unnecessary whitespace and comments, and condense
-				static const regex rx_space("\\s+", regex::optimize);
-				static const regex rx_semicolon_space("[ ]*;[ ]*", regex::optimize);
-				static const regex rx_newline("\n|\r", regex::optimize);
-				static const regex rx_comments_sl("//(.*)", regex::optimize);
-				static const regex rx_comments_ml("/\\*(.*)\\*/", regex::optimize);
-
-				struct_interior = regex_replace(struct_interior, rx_comments_sl, "");
-				struct_interior = regex_replace(struct_interior, rx_newline, "");
-				struct_interior = regex_replace(struct_interior, rx_comments_ml, "");
-				struct_interior = regex_replace(struct_interior, rx_space, " ");
-				struct_interior = regex_replace(struct_interior, rx_semicolon_space, ";");
-				struct_interior = core::trim(struct_interior);
-				//log_msg("post-regex interior: >%s<", struct_interior);
+			}
+			
+			// oclraster struct
+			const auto struct_type = (ident_len > 9 && code.compare(ident_pos, 10, "oclraster_") == 0 ?
+									  oclraster_struct_types.find(code.substr(ident_pos, ident_len)) :
+									  oclraster_struct_types.cend());
+			if(struct_type == oclraster_struct_types.cend()) {
+				ident_pos = ident_end_pos;
+				continue;
+			}
+			const size_t struct_pos = ident_pos;
+			
+			// find the open '{' bracket and extract the structs name
+			const size_t open_bracket_pos = code.find('{', ident_end_pos);
+			if(open_bracket_pos == string::npos) throw floor_exception("no struct open bracket");
+			const string struct_name = core::trim(code.substr(ident_end_pos, open_bracket_pos - ident_end_pos));
+			if(struct_name.empty() && !is_whitespace_char(code[ident_end_pos])) throw floor_exception("no struct name");
+			//log_msg("struct type: \"%s\"", struct_type->first);
+			//log_msg("struct name: \"%s\"", struct_name);
+			
+			// open/close bracket match
+			size_t bracket_pos = open_bracket_pos;
+			size_t open_bracket_count = 1;
+			while(open_bracket_count > 0) {
+				bracket_pos = code.find_first_of("{}", bracket_pos + 1);
+				if(bracket_pos == string::npos) throw floor_exception("struct open/close bracket mismatch");
+				code[bracket_pos] == '{' ? open_bracket_count++ : open_bracket_count--;
+			}
+			const size_t close_bracket_pos = bracket_pos;
+			
+			//
+			const size_t end_semicolon_pos = code.find(';', close_bracket_pos+1);
+			if(end_semicolon_pos == string::npos) {
+				throw floor_exception("end-semicolon missing from struct \""+struct_name+"\"!");
+			}
+			const string object_name = core::trim(code.substr(close_bracket_pos+1,
+															  end_semicolon_pos-close_bracket_pos-1));
+			//log_msg("object name: \"%s\"", object_name);
+			
+			// strip unnecessary whitespace and comments, and condense
+			const string struct_interior = core::trim(condense_struct_code(code.substr(open_bracket_pos+1,
+																						close_bracket_pos-open_bracket_pos-1)));
+			//log_msg("condensed interior: >%s<", struct_interior);
+			
+			// extract all member variables
+			vector<string> variable_names, variable_types, variable_specifiers;
+			size_t semicolon_pos = 0, last_semicolon_pos = 0;
+			while((semicolon_pos = struct_interior.find(';', last_semicolon_pos)) != string::npos) {
+				const string var_decl = struct_interior.substr(last_semicolon_pos,
+															   semicolon_pos-last_semicolon_pos);
+				//log_msg("decl: >%s<", var_decl);
 				
-				// extract all member variables
-				vector<string> variable_names, variable_types, variable_specifiers;
-				size_t semicolon_pos = 0, last_semicolon_pos = 0;
-				while((semicolon_pos = struct_interior.find(";", last_semicolon_pos)) != string::npos) {
-					const string var_decl = struct_interior.substr(last_semicolon_pos,
-																   semicolon_pos-last_semicolon_pos);
-					//log_msg("decl: >%s<", var_decl);
-					
-					const size_t name_start_pos = var_decl.rfind(" ");
-					if(name_start_pos == string::npos) {
-						throw floor_exception("invalid variable declaration: \""+var_decl+"\"");
-					}
-					const string var_name = var_decl.substr(name_start_pos+1, var_decl.length()-name_start_pos-1);
-					//log_msg("name: >%s<", var_name);
-					variable_names.emplace_back(var_name);
-					
-					// check if type has an additional specifier (for images: read_only, write_only, read_write)
-					const size_t type_start_pos = var_decl.find(" ");
-					const string start_token = var_decl.substr(0, type_start_pos);
-					if(specifiers.find(start_token) != specifiers.end()) {
-						const string var_type = regex_replace(var_decl.substr(type_start_pos+1, name_start_pos-type_start_pos-1),
-															  rx_space, ""); // need to strip any whitespace
-						//log_msg("type (s): >%s<", var_type);
-						variable_types.emplace_back(var_type);
-						
-						const string var_spec = var_decl.substr(0, type_start_pos);
-						//log_msg("spec: >%s<", var_spec);
-						variable_specifiers.emplace_back(var_spec);
-					}
-					else {
-						const string var_type = core::trim(var_decl.substr(0, name_start_pos));
-						//log_msg("type: >%s<", var_type);
-						variable_types.emplace_back(var_type);
-						variable_specifiers.emplace_back("");
-					}
-					
-					// continue
-					last_semicolon_pos = semicolon_pos+1;
+				const size_t name_start_pos = var_decl.rfind(' ');
+				if(name_start_pos == string::npos) {
+					throw floor_exception("invalid variable declaration: \""+var_decl+"\"");
 				}
+				const string var_name = var_decl.substr(name_start_pos+1, var_decl.length()-name_start_pos-1);
+				//log_msg("name: >%s<", var_name);
+				variable_names.emplace_back(var_name);
 				
-				// create info struct
-				if(type.second != STRUCT_TYPE::IMAGES &&
-				   type.second != STRUCT_TYPE::FRAMEBUFFER) {
-					const bool empty = (variable_names.size() == 0); // can't use variable_names when moving
-					structs.push_back(new oclraster_struct_info {
-						type.second,
-						size2(struct_pos, end_semicolon_pos+1),
-						struct_name,
-						object_name,
-						std::move(variable_names),
-						std::move(variable_types),
-						std::move(variable_specifiers),
-						empty,
-						{}
-					});
+				// check if type has an additional specifier (for images: read_only, write_only, read_write)
+				const size_t type_start_pos = var_decl.find(' ');
+				const string start_token = var_decl.substr(0, type_start_pos);
+				if(specifiers.find(start_token) != specifiers.end()) {
+					// need to strip any whitespace
+					const string var_type = strip_whitespace(var_decl.substr(type_start_pos+1, name_start_pos-type_start_pos-1));
+					//log_msg("type (s): >%s<", var_type);
+					variable_types.emplace_back(var_type);
+					variable_specifiers.emplace_back(start_token);
 				}
 				else {
-					image_struct_positions.emplace_back(size2 { struct_pos, end_semicolon_pos+1 });
-					process_image_struct(variable_names, variable_types, variable_specifiers,
-										 (type.second == STRUCT_TYPE::FRAMEBUFFER));
+					const string var_type = core::trim(var_decl.substr(0, name_start_pos));
+					//log_msg("type: >%s<", var_type);
+					variable_types.emplace_back(var_type);
+					variable_specifiers.emplace_back("");
 				}
 				
 				// continue
-				struct_pos++;
+				last_semicolon_pos = semicolon_pos+1;
+			}
+			
+			// create info struct
+			if(struct_type->second != STRUCT_TYPE::IMAGES &&
+			   struct_type->second != STRUCT_TYPE::FRAMEBUFFER) {
+				const bool empty = (variable_names.size() == 0); // can't use variable_names when moving
+				structs.push_back(new oclraster_struct_info {
+					struct_type->second,
+					size2(struct_pos, end_semicolon_pos+1),
+					struct_name,
+					object_name,
+					std::move(variable_names),
+					std::move(variable_types),
+					std::move(variable_specifiers),
+					empty,
+					{}
+				});
 			}
+			else {
+				image_structs.emplace_back(image_struct_decl {
+					size2 { struct_pos, end_semicolon_pos+1 },
+					std::move(variable_names),
+					std::move(variable_types),
+					std::move(variable_specifiers),
+					(struct_type->second == STRUCT_TYPE::FRAMEBUFFER)
+				});
+			}
+			
+			// continue after the struct
+			ident_pos = end_semicolon_pos+1;
+		}
+		if(entry_function_positions.empty()) {
+			throw floor_exception("entry function \""+entry_function+"\" not found!");
+		}
+		
+		// process image structs (all image structs first, then all framebuffer structs)
+		stable_partition(image_structs.begin(), image_structs.end(),
+						 [](const image_struct_decl& decl) { return !decl.is_framebuffer; });
+		for(const auto& img_struct : image_structs) {
+			process_image_struct(img_struct.variable_names, img_struct.variable_types,
+								 img_struct.variable_specifiers, img_struct.is_framebuffer);
 		}
 		
+		timings.parse = timer_diff_ms(timer_preprocessed, SDL_GetPerformanceCounter());
+		
 		// process found structs
+		// -> compute the device specific layouts on the host if possible, any remaining structs are
+		// handled by a single combined probe kernel
+		vector<oclraster_struct_info*> probe_structs;
 		for(auto& oclr_struct : structs) {
 			if(oclr_struct->empty) continue;
 			if(oclr_struct->type == STRUCT_TYPE::BUFFERS) continue;
-			generate_struct_info_cl_program(*oclr_struct);
+			if(!compute_struct_info(*oclr_struct)) {
+				probe_structs.emplace_back(oclr_struct);
+			}
 		}
+		if(!probe_structs.empty()) {
+			generate_struct_info_cl_program(probe_structs);
+		}
+		const auto timer_struct_layout = SDL_GetPerformanceCounter();
+		timings.struct_layout = timer_diff_ms(timer_preprocessed, timer_struct_layout) - timings.parse;
 		
 		// order
 		sort(structs.begin(), structs.end(),
@@ -228,58 +383,43 @@ void oclraster_program::process_program(const string& raw_code, const kernel_spe
 		}
 		framebuffer_code += "} oclraster_framebuffer;\n";
 		
-		// recreate structs (in reverse, so that the offsets stay valid)
-		processed_code = code;
-		const size_t struct_count = structs.size() + image_struct_positions.size();
-		for(size_t i = 0, cur_struct = structs.size(), cur_image = image_struct_positions.size();
-			i < struct_count; i++) {
-			// figure out which struct comes next (normal struct or image struct)
-			size_t image_code_pos = 0, struct_code_pos = 0;
-			if(cur_image > 0) image_code_pos = image_struct_positions[cur_image-1].x;
-			if(cur_struct > 0) struct_code_pos = structs[cur_struct-1]->code_pos.x;
-			
-			// image
-			if(image_code_pos > struct_code_pos) {
-				cur_image--;
-				processed_code.erase(image_struct_positions[cur_image].x,
-									 image_struct_positions[cur_image].y - image_struct_positions[cur_image].x);
-				
-				// insert framebuffer struct code at the last image or framebuffer struct position
-				if(has_framebuffer && cur_image == (image_struct_positions.size()-1)) {
-					processed_code.insert(image_struct_positions[cur_image].x, framebuffer_code);
+		// recreate structs: all code modifications are collected first and then applied in a single forward pass
+		struct code_edit {
+			size2 code_range;
+			string replacement;
+		};
+		vector<code_edit> edits;
+		for(const auto& oclr_struct : structs) {
+			string struct_code = "";
+			if(!oclr_struct->empty && oclr_struct->type != STRUCT_TYPE::BUFFERS) {
+				switch(oclr_struct->type) {
+					case STRUCT_TYPE::INPUT:
+						struct_code += "oclraster_in";
+						break;
+					case STRUCT_TYPE::OUTPUT:
+						struct_code += "oclraster_out";
+						break;
+					case STRUCT_TYPE::UNIFORMS:
+						struct_code += "oclraster_uniforms";
+						break;
+					case STRUCT_TYPE::BUFFERS:
+					case STRUCT_TYPE::IMAGES:
+					case STRUCT_TYPE::FRAMEBUFFER: floor_unreachable();
 				}
-			}
-			// struct
-			else {
-				cur_struct--;
-				const oclraster_struct_info& oclr_struct = *structs[cur_struct];
-				processed_code.erase(oclr_struct.code_pos.x,
-									 oclr_struct.code_pos.y - oclr_struct.code_pos.x);
-				
-				if(!oclr_struct.empty && oclr_struct.type != STRUCT_TYPE::BUFFERS) {
-					string struct_code = "";
-					switch(oclr_struct.type) {
-						case STRUCT_TYPE::INPUT:
-							struct_code += "oclraster_in";
-							break;
-						case STRUCT_TYPE::OUTPUT:
-							struct_code += "oclraster_out";
-							break;
-						case STRUCT_TYPE::UNIFORMS:
-							struct_code += "oclraster_uniforms";
-							break;
-						case STRUCT_TYPE::BUFFERS:
-						case STRUCT_TYPE::IMAGES:
-						case STRUCT_TYPE::FRAMEBUFFER: floor_unreachable();
-					}
-					struct_code += " {\n";
-					for(size_t var_index = 0; var_index < oclr_struct.variables.size(); var_index++) {
-						struct_code += oclr_struct.variable_types[var_index] + " " + oclr_struct.variables[var_index] + ";\n";
-					}
-					struct_code += "} " + oclr_struct.name + ";\n";
-					processed_code.insert(oclr_struct.code_pos.x, struct_code);
+				struct_code += " {\n";
+				for(size_t var_index = 0; var_index < oclr_struct->variables.size(); var_index++) {
+					struct_code += oclr_struct->variable_types[var_index] + " " + oclr_struct->variables[var_index] + ";\n";
 				}
+				struct_code += "} " + oclr_struct->name + ";\n";
 			}
+			edits.emplace_back(code_edit { oclr_struct->code_pos, struct_code });
+		}
+		for(size_t i = 0, count = image_structs.size(); i < count; i++) {
+			// insert framebuffer struct code at the last image or framebuffer struct position
+			edits.emplace_back(code_edit {
+				image_structs[i].code_range,
+				(has_framebuffer && i == count - 1 ? framebuffer_code : "")
+			});
 		}
 		
 		// remove empty structs
@@ -291,16 +431,29 @@ void oclraster_program::process_program(const string& raw_code, const kernel_spe
 			else iter++;
 		}
 		
-		// build entry function parameter string
-		const string entry_function_params = create_entry_function_parameters();
+		// resolve binding slots of all user buffers and images
+		create_binding_layout();
 		
-		// check if entry function exists, and if so, replace it with a modified function name
-		const regex rx_entry_function("("+entry_function+")\\s*\\(\\s*\\)", regex::optimize);
-		if(!regex_search(code, rx_entry_function)) {
-			throw floor_exception("entry function \""+entry_function+"\" not found!");
+		// build entry function parameter string and replace the entry function with a modified function name
+		const string entry_function_code = ("OCLRASTER_FUNC oclraster_user_"+entry_function+
+											"("+create_entry_function_parameters()+")");
+		for(const auto& entry_pos : entry_function_positions) {
+			edits.emplace_back(code_edit { entry_pos, entry_function_code });
+		}
+		
+		// apply all edits
+		sort(edits.begin(), edits.end(), [](const code_edit& edit_0, const code_edit& edit_1) -> bool {
+			return edit_0.code_range.x < edit_1.code_range.x;
+		});
+		processed_code = "";
+		processed_code.reserve(code.size() + 1024);
+		size_t code_pos = 0;
+		for(const auto& edit : edits) {
+			processed_code.append(code, code_pos, edit.code_range.x - code_pos);
+			processed_code += edit.replacement;
+			code_pos = edit.code_range.y;
 		}
-		processed_code = regex_replace(processed_code, rx_entry_function,
-									   "OCLRASTER_FUNC oclraster_user_"+entry_function+"("+entry_function_params+")");
+		processed_code.append(code, code_pos, string::npos);
 		
 		// create default/first/hinted image spec, do the final processing and compile
 		kernel_spec spec { default_spec };
@@ -318,7 +471,10 @@ void oclraster_program::process_program(const string& raw_code, const kernel_spe
 			spec.image_spec.clear();
 		}
 		// else: no images in kernel/program -> just one kernel / "empty image spec"
+		const auto timer_build = SDL_GetPerformanceCounter();
+		timings.code_generation = timer_diff_ms(timer_struct_layout, timer_build);
 		build_kernel(spec);
+		timings.build = timer_diff_ms(timer_build, SDL_GetPerformanceCounter());
 	}
 	catch(floor_exception& ex) {
 		invalidate(ex.what());
@@ -327,6 +483,7 @@ void oclraster_program::process_program(const string& raw_code, const kernel_spe
 }
 
 weak_ptr<opencl::kernel_object> oclraster_program::build_kernel(const kernel_spec& spec) {
+	OCLRASTER_TRACE_SCOPE("build_kernel", "program", kernel_function_name + "." + entry_function);
 	kernel_spec* new_spec = new kernel_spec(spec);
 	compiled_kernels.emplace_back(new_spec);
 	
@@ -382,6 +539,10 @@ weak_ptr<opencl::kernel_object> oclraster_program::build_kernel(const kernel_spe
 	}
 	depth_spec_str += (spec.depth.depth_override ? ".depth_override" : "");
 	
+	// attribute setup (only if this program actually has an attribute setup kernel)
+	const bool attribute_setup = (spec.attribute_setup && has_attribute_setup());
+	const string attribute_setup_options = (attribute_setup ? " -DOCLRASTER_ATTRIBUTE_SETUP" : "");
+	
 	// finally: call the specialized processing function of inheriting classes/programs
 	// note: this should inject the user code into their respective code templates
 	const string program_code { specialized_processing(processed_code, *new_spec) };
@@ -396,15 +557,22 @@ weak_ptr<opencl::kernel_object> oclraster_program::build_kernel(const kernel_spe
 	stringstream id_stream;
 	id_stream << dec << this_thread::get_id();
 	const string identifier = ("USER_PROGRAM."+kernel_function_name+"."+entry_function+"."+
-							   proj_spec_str+depth_spec_str+img_spec_str+"."+
+							   proj_spec_str+depth_spec_str+img_spec_str+
+							   (attribute_setup ? ".attribute_setup" : "")+"."+
 							   ull2string(SDL_GetPerformanceCounter())+"."+id_stream.str());
-	weak_ptr<opencl::kernel_object> kernel = ocl->add_kernel_src(identifier, program_code, kernel_function_name,
-																 " -DBIN_SIZE="+uint2string(OCLRASTER_BIN_SIZE)+
-																 " -DBATCH_SIZE="+uint2string(OCLRASTER_BATCH_SIZE)+
-																 " -DOCLRASTER_PROJECTION_"+(spec.projection == PROJECTION::PERSPECTIVE ? "PERSPECTIVE" : "ORTHOGRAPHIC")+
-																 image_defines+
-																 framebuffer_options+
-																 " "+build_options);
+	const string kernel_options = (" -DBIN_SIZE="+uint2string(OCLRASTER_BIN_SIZE)+
+								   " -DBATCH_SIZE="+uint2string(OCLRASTER_BATCH_SIZE)+
+								   " -DOCLRASTER_PROJECTION_"+(spec.projection == PROJECTION::PERSPECTIVE ? "PERSPECTIVE" : "ORTHOGRAPHIC")+
+								   image_defines+
+								   framebuffer_options+
+								   attribute_setup_options+
+								   " "+build_options);
+	weak_ptr<opencl::kernel_object> kernel = ocl->add_kernel_src(identifier, program_code, kernel_function_name, kernel_options);
+	if(attribute_setup) {
+		// the attribute setup kernel is part of the same program code
+		attribute_setup_kernels.emplace(new_spec, ocl->add_kernel_src(identifier+".SETUP", program_code,
+																	  "oclraster_attribute_setup", kernel_options));
+	}
 	//log_msg("%s:\n%s\n", identifier, program_code);
 #if defined(OCLRASTER_DEBUG)
 	if(kernel.use_count() == 0) {
@@ -423,6 +591,13 @@ string oclraster_program::create_entry_function_parameters() const {
 			const string qualifier = get_qualifier_for_struct_type(structs[i]->type);
 			if(qualifier != "") entry_function_params += qualifier + " ";
 			entry_function_params += structs[i]->name + "* " + structs[i]->object_name + ", ";
+			if(structs[i]->type == STRUCT_TYPE::OUTPUT && has_output_derivatives()) {
+				// screen-space derivatives of all output variables (same struct type)
+				for(const auto& suffix : { "_ddx", "_ddy" }) {
+					if(qualifier != "") entry_function_params += qualifier + " ";
+					entry_function_params += structs[i]->name + "* " + structs[i]->object_name + suffix + ", ";
+				}
+			}
 		}
 		else {
 			for(size_t j = 0, buffer_entries = structs[i]->variables.size(); j < buffer_entries; j++) {
@@ -441,6 +616,10 @@ string oclraster_program::create_entry_function_parameters() const {
 	return entry_function_params;
 }
 
+bool oclraster_program::has_output_derivatives() const {
+	return false;
+}
+
 string oclraster_program::create_user_kernel_parameters(const kernel_spec& spec,
 														vector<string>& image_decls,
 														const bool const_output) const {
@@ -588,6 +767,10 @@ void oclraster_program::process_image_struct(const vector<string>& variable_name
 			else if(data_type == "FLOAT_16") img_data_type = IMAGE_TYPE::FLOAT_16;
 			else if(data_type == "FLOAT_32") img_data_type = IMAGE_TYPE::FLOAT_32;
 			else if(data_type == "FLOAT_64") img_data_type = IMAGE_TYPE::FLOAT_64;
+			else if(data_type == "BC1") img_data_type = IMAGE_TYPE::BC1;
+			else if(data_type == "BC3") img_data_type = IMAGE_TYPE::BC3;
+			else if(data_type == "BC4") img_data_type = IMAGE_TYPE::BC4;
+			else if(data_type == "BC5") img_data_type = IMAGE_TYPE::BC5;
 			else throw floor_exception("invalid image hint declaration (invalid data type): \""+hint+"\"");
 			
 			if(channel_type == "R") img_channel_type = IMAGE_CHANNEL::R;
@@ -608,6 +791,12 @@ void oclraster_program::process_image_struct(const vector<string>& variable_name
 			else image_hints.emplace_back(); // will default to UINT_8/RGBA later on
 		}
 		
+		// block compressed images can only be read (and never be framebuffer images)
+		if(has_hint && image_hints.back().is_compressed() &&
+		   (is_framebuffer || var_spec != "read_only")) {
+			throw floor_exception("block compressed images must be read_only non-framebuffer images (not " + image_hints.back().to_string() + ")!");
+		}
+		
 		// check hints of framebuffer image types
 		if(has_hint) {
 			if(image_var_type == IMAGE_VAR_TYPE::DEPTH_IMAGE) {
@@ -663,31 +852,51 @@ void oclraster_program::process_image_struct(const vector<string>& variable_name
 	images.is_framebuffer.insert(images.is_framebuffer.end(), variable_names.size(), is_framebuffer);
 }
 
-void oclraster_program::generate_struct_info_cl_program(oclraster_struct_info& struct_info) {
-	// TODO: combine this for all program structs, so it has to be run only once
-	// TODO: also: no need to use atomics (use if global_id == 0 instead) + use __builtin_offsetof?
+bool oclraster_program::compute_struct_info(oclraster_struct_info& struct_info) {
+	unordered_map<opencl::device_object*, const oclraster_struct_info::device_struct_info> dev_infos;
+	for(const auto& device : ocl->get_devices()) {
+		struct_layout::layout dev_layout;
+		if(!struct_layout::compute(device, struct_info.variable_types, struct_info.variables, dev_layout)) {
+			return false;
+		}
+		dev_infos.emplace(device, oclraster_struct_info::device_struct_info {
+			dev_layout.struct_size, std::move(dev_layout.sizes), std::move(dev_layout.offsets)
+		});
+	}
+	struct_info.device_infos.swap(dev_infos);
+	return true;
+}
+
+void oclraster_program::generate_struct_info_cl_program(const vector<oclraster_struct_info*>& probe_structs) {
 	static const string kernel_header = "#include \"oclr_global.h\"\n#include \"oclr_matrix.h\"\n";
-	static const string kernel_start = "kernel void struct_info(global int* info_buffer) {\nint index = 0;\n";
+	static const string kernel_start = "kernel void struct_info(global int* info_buffer) {\nif(get_global_id(0) != 0) return;\n";
 	static const string kernel_end = "}";
 	
+	// all structs are probed at once:
+	// info_buffer layout: for each struct: struct size, then (member size, member offset) for each member
 	string kernel_code = kernel_header;
-	
-	// struct decl
-	kernel_code += "oclraster_struct {\n";
-	for(size_t i = 0; i < struct_info.variables.size(); i++) {
-		kernel_code += struct_info.variable_types[i] + " " + struct_info.variables[i] + ";\n";
+	size_t info_buffer_size = 0;
+	for(const auto& struct_info : probe_structs) {
+		kernel_code += "oclraster_struct {\n";
+		for(size_t i = 0; i < struct_info->variables.size(); i++) {
+			kernel_code += struct_info->variable_types[i] + " " + struct_info->variables[i] + ";\n";
+		}
+		kernel_code += "} " + struct_info->name + ";\n";
+		info_buffer_size += 1 + struct_info->variables.size() * 2;
 	}
-	kernel_code += "} " + struct_info.name + ";\n";
 	
 	// actual kernel
 	kernel_code += kernel_start;
-	kernel_code += "atomic_xchg(&info_buffer[index++], (int)sizeof("+struct_info.name+"));\n";
-	for(const auto& var : struct_info.variables) {
-		// standard c ftw
-		kernel_code += "atomic_xchg(&info_buffer[index++], (int)((size_t)sizeof(("+struct_info.name+"*)0)->"+var+"));\n"; // size
-		kernel_code += "atomic_xchg(&info_buffer[index++], (int)((size_t)&((("+struct_info.name+"*)0)->"+var+")));\n"; // offset
+	size_t index = 0;
+	for(const auto& struct_info : probe_structs) {
+		kernel_code += "info_buffer["+size_t2string(index++)+"] = (int)sizeof("+struct_info->name+");\n";
+		for(const auto& var : struct_info->variables) {
+			// standard c ftw
+			kernel_code += "info_buffer["+size_t2string(index++)+"] = (int)((size_t)sizeof((("+struct_info->name+"*)0)->"+var+"));\n"; // size
+			kernel_code += "info_buffer["+size_t2string(index++)+"] = (int)((size_t)&((("+struct_info->name+"*)0)->"+var+"));\n"; // offset
+		}
 	}
-	kernel_code += "}"; // eol
+	kernel_code += kernel_end;
 	
 	//log_debug("generated kernel file:\n%s\n", kernel_code);
 	
@@ -702,8 +911,7 @@ void oclraster_program::generate_struct_info_cl_program(oclraster_struct_info& s
 		return;
 	}
 	
-	const size_t info_buffer_size = 1 + struct_info.variables.size() * 2;
-	int* info_buffer_results = new int[info_buffer_size];
+	vector<int> info_buffer_results(info_buffer_size, 0);
 	
 	ocl->lock();
 	auto active_device = ocl->get_active_device();
@@ -713,38 +921,40 @@ void oclraster_program::generate_struct_info_cl_program(oclraster_struct_info& s
 		ocl->set_active_device(devices[dev_num]->type);
 		//log_msg("DEVICE: %s", devices[dev_num]->name);
 		
-		// read/write is necessary, because of atomic_xchg
-		opencl::buffer_object* info_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
-																opencl::BUFFER_FLAG::BLOCK_ON_READ,
-																info_buffer_size * sizeof(int));
+		opencl::buffer_object* info_buffer = memory_tracker::create_buffer(MEMORY_TAG::PROGRAM,
+																		   opencl::BUFFER_FLAG::READ_WRITE |
+																		   opencl::BUFFER_FLAG::BLOCK_ON_READ,
+																		   info_buffer_size * sizeof(int));
 		
 		ocl->use_kernel(unique_identifier);
 		ocl->set_kernel_argument(0, info_buffer);
 		ocl->set_kernel_range({1, 1});
 		ocl->run_kernel();
 		
-		ocl->read_buffer(info_buffer_results, info_buffer);
+		ocl->read_buffer(&info_buffer_results[0], info_buffer);
 		
-		oclraster_struct_info::device_struct_info dev_info;
-		dev_info.struct_size = info_buffer_results[0];
-		//log_msg("struct \"%s\" size: %d", struct_info.name, dev_info.struct_size);
-		dev_info.sizes.resize(struct_info.variables.size());
-		dev_info.offsets.resize(struct_info.variables.size());
-		for(size_t i = 0; i < struct_info.variables.size(); i++) {
-			dev_info.sizes[i] = info_buffer_results[(i*2) + 1];
-			dev_info.offsets[i] = info_buffer_results[(i*2) + 2];
-			//log_msg("\tmember \"%s\": size: %d, offset: %d",
-			//		 struct_info.variables[i], dev_info.sizes[i], dev_info.offsets[i]);
-		}
-		struct_info.device_infos.emplace(devices[dev_num], dev_info);
+		size_t result_index = 0;
+		for(auto& struct_info : probe_structs) {
+			oclraster_struct_info::device_struct_info dev_info;
+			dev_info.struct_size = info_buffer_results[result_index++];
+			//log_msg("struct \"%s\" size: %d", struct_info->name, dev_info.struct_size);
+			dev_info.sizes.resize(struct_info->variables.size());
+			dev_info.offsets.resize(struct_info->variables.size());
+			for(size_t i = 0; i < struct_info->variables.size(); i++) {
+				dev_info.sizes[i] = info_buffer_results[result_index++];
+				dev_info.offsets[i] = info_buffer_results[result_index++];
+				//log_msg("\tmember \"%s\": size: %d, offset: %d",
+				//		 struct_info->variables[i], dev_info.sizes[i], dev_info.offsets[i]);
+			}
+			struct_info->device_infos.emplace(devices[dev_num], dev_info);
+		}
 		
-		ocl->delete_buffer(info_buffer);
+		memory_tracker::delete_buffer(info_buffer);
 	}
 	ocl->set_active_device(active_device->type);
 	ocl->unlock();
 	
 	// cleanup
-	delete [] info_buffer_results;
 	kernel_ptr = nullptr;
 	ocl->delete_kernel(kernel_obj);
 }
@@ -759,14 +969,58 @@ void oclraster_program::invalidate(const string error_info) {
 			   error_info != "" ? ": " + error_info + "!" : "");
 }
 
+void oclraster_program::create_binding_layout() {
+	bindings.buffer_slots.clear();
+	bindings.image_slots.clear();
+	bindings.struct_slots.clear();
+	for(const auto& user_struct : structs) {
+		if(user_struct->type != STRUCT_TYPE::BUFFERS) {
+			const size_t slot = binding_table::get_slot(user_struct->object_name);
+			bindings.buffer_slots.emplace_back(slot);
+			bindings.struct_slots.emplace_back(slot);
+		}
+		else {
+			for(const auto& var_name : user_struct->variables) {
+				bindings.buffer_slots.emplace_back(binding_table::get_slot(var_name));
+			}
+			bindings.struct_slots.emplace_back(binding_table::invalid_slot);
+		}
+	}
+	for(size_t i = 0, img_count = images.image_names.size(); i < img_count; i++) {
+		bindings.image_slots.emplace_back(images.is_framebuffer[i] ?
+										  binding_table::invalid_slot :
+										  binding_table::get_slot(images.image_names[i]));
+	}
+}
+
+const oclraster_program::binding_layout& oclraster_program::get_binding_layout() const {
+	return bindings;
+}
+
 const vector<oclraster_program::oclraster_struct_info*>& oclraster_program::get_structs() const {
 	return structs;
 }
 
+const oclraster_program::processing_timings& oclraster_program::get_processing_timings() const {
+	return timings;
+}
+
 const oclraster_program::oclraster_image_info& oclraster_program::get_images() const {
 	return images;
 }
 
+const string& oclraster_program::get_source_code() const {
+	return source_code;
+}
+
+const string& oclraster_program::get_entry_function() const {
+	return entry_function;
+}
+
+const string& oclraster_program::get_build_options() const {
+	return build_options;
+}
+
 weak_ptr<opencl::kernel_object> oclraster_program::get_kernel(const kernel_spec spec) {
 	//
 	if(kernels.empty() || compiled_kernels.empty()) {
@@ -788,6 +1042,41 @@ weak_ptr<opencl::kernel_object> oclraster_program::get_kernel(const kernel_spec
 	return build_kernel(spec);
 }
 
+bool oclraster_program::has_attribute_setup() const {
+	return false;
+}
+
+weak_ptr<opencl::kernel_object> oclraster_program::get_attribute_setup_kernel(const kernel_spec& spec) const {
+	for(const auto& kernel : attribute_setup_kernels) {
+		if(*kernel.first != spec) continue;
+		return kernel.second;
+	}
+	return opencl::null_kernel_object;
+}
+
+pipeline_state* oclraster_program::get_pipeline_state(const draw_state& state) {
+	// fast path: same state as the last draw call
+	if(last_pipeline_state != nullptr && last_pipeline_state->matches(state)) {
+		return last_pipeline_state;
+	}
+	for(const auto& pstate : pipeline_states) {
+		if(pstate != last_pipeline_state && pstate->matches(state)) {
+			last_pipeline_state = pstate;
+			return pstate;
+		}
+	}
+	
+	// no state for this configuration yet -> create a new one (this will compile the kernel if necessary)
+	kernel_spec spec;
+	if(!pipeline_state::create_kernel_spec(state, *this, spec)) {
+		return nullptr;
+	}
+	pipeline_state* pstate = new pipeline_state(*this, spec);
+	pipeline_states.emplace_back(pstate);
+	last_pipeline_state = pstate;
+	return pstate;
+}
+
 string oclraster_program::preprocess_code(const string& raw_code) {
 	// init
 	string ret_code = "";
@@ -24,6 +24,9 @@
 #include "pipeline/image.hpp"
 #include "pipeline/image_types.hpp"
 
+class pipeline_state;
+struct draw_state;
+
 // TODO: this should be in a different header
 enum class PROJECTION : unsigned int {
 	PERSPECTIVE,
@@ -75,10 +78,12 @@ public:
 		vector<image_type> image_spec;
 		PROJECTION projection;
 		depth_state depth;
+		bool attribute_setup; // only used if the program has an attribute setup kernel
 		
 		kernel_spec(const kernel_spec& spec) :
-		image_spec(spec.image_spec), projection(spec.projection), depth(spec.depth) {}
-		kernel_spec(kernel_spec&& spec) noexcept : image_spec(), projection(spec.projection), depth(spec.depth) {
+		image_spec(spec.image_spec), projection(spec.projection), depth(spec.depth), attribute_setup(spec.attribute_setup) {}
+		kernel_spec(kernel_spec&& spec) noexcept :
+		image_spec(), projection(spec.projection), depth(spec.depth), attribute_setup(spec.attribute_setup) {
 			this->image_spec.swap(spec.image_spec);
 		}
 		kernel_spec(const vector<image_type> image_spec_ = vector<image_type> {},
@@ -86,14 +91,17 @@ public:
 					const DEPTH_FUNCTION depth_func_ = DEPTH_FUNCTION::LESS,
 					const string custom_depth_func_ = "",
 					const bool depth_test_ = true,
-					const bool depth_override_ = false) :
+					const bool depth_override_ = false,
+					const bool attribute_setup_ = false) :
 		image_spec(image_spec_), projection(projection_),
 		depth(depth_func_, depth_func_ == DEPTH_FUNCTION::CUSTOM ? custom_depth_func_ : "",
-			  depth_test_, depth_override_) {}
+			  depth_test_, depth_override_),
+		attribute_setup(attribute_setup_) {}
 		
 		bool operator==(const kernel_spec& spec) const {
 			if(spec.projection != projection) return false;
 			if(spec.depth != depth) return false;
+			if(spec.attribute_setup != attribute_setup) return false;
 			if(spec.image_spec.size() != spec.image_spec.size()) return false;
 			for(size_t i = 0, spec_size = image_spec.size(); i < spec_size; i++) {
 				if(image_spec[i] != spec.image_spec[i]) return false;
@@ -162,10 +170,47 @@ public:
 	};
 	const oclraster_image_info& get_images() const;
 	
+	// binding table slots of all user buffers (in kernel argument order) and images
+	// (binding_table::invalid_slot for framebuffer images), resolved once on program creation.
+	// struct_slots contains the slot of each struct in get_structs() (invalid_slot for BUFFERS structs)
+	struct binding_layout {
+		vector<size_t> buffer_slots;
+		vector<size_t> image_slots;
+		vector<size_t> struct_slots;
+	};
+	const binding_layout& get_binding_layout() const;
+	
+	// time spent in each step of the program creation (in ms)
+	struct processing_timings {
+		double preprocess { 0.0 };
+		double parse { 0.0 };
+		double struct_layout { 0.0 };
+		double code_generation { 0.0 };
+		double build { 0.0 }; // default kernel only
+	};
+	const processing_timings& get_processing_timings() const;
+	
+	// the unprocessed user program code and the options it was created with
+	const string& get_source_code() const;
+	const string& get_entry_function() const;
+	const string& get_build_options() const;
+	
 	bool is_valid() const;
 	weak_ptr<opencl::kernel_object> get_kernel(const kernel_spec spec = kernel_spec {});
+	
+	// if true, this program has a separate attribute setup kernel that is run once per primitive
+	// (-> see pipeline::set_attribute_setup)
+	virtual bool has_attribute_setup() const;
+	// returns the attribute setup kernel for a spec that was compiled with attribute_setup == true
+	// (null kernel object if there is none)
+	weak_ptr<opencl::kernel_object> get_attribute_setup_kernel(const kernel_spec& spec) const;
+	
+	// returns the pipeline state (kernel + argument state) matching the draw state,
+	// creating and compiling a new one if necessary
+	pipeline_state* get_pipeline_state(const draw_state& state);
 
 protected:
+	const string source_code;
 	string entry_function = "main";
 	string build_options = "";
 	string kernel_function_name;
@@ -174,9 +219,17 @@ protected:
 	string processed_code = ""; // created once on program creation (pre-specialized processing)
 	vector<kernel_spec*> compiled_kernels;
 	unordered_map<kernel_spec*, weak_ptr<opencl::kernel_object>> kernels;
+	unordered_map<kernel_spec*, weak_ptr<opencl::kernel_object>> attribute_setup_kernels;
 	weak_ptr<opencl::kernel_object> build_kernel(const kernel_spec& spec);
 	
 	//
+	binding_layout bindings;
+	vector<pipeline_state*> pipeline_states;
+	pipeline_state* last_pipeline_state { nullptr };
+	void create_binding_layout();
+	
+	//
+	processing_timings timings;
 	void process_program(const string& code, const kernel_spec default_spec);
 	void process_image_struct(const vector<string>& variable_names,
 							  const vector<string>& variable_types,
@@ -190,6 +243,8 @@ protected:
 										  const kernel_spec& spec) = 0;
 	virtual string get_fixed_entry_function_parameters() const = 0;
 	virtual string get_qualifier_for_struct_type(const STRUCT_TYPE& type) const = 0;
+	// if true, "<object>_ddx" and "<object>_ddy" parameters are added after each output struct parameter
+	virtual bool has_output_derivatives() const;
 	virtual string create_depth_test_function(const kernel_spec& spec) const;
 	
 	atomic<bool> valid { false };
@@ -198,7 +253,8 @@ protected:
 	//
 	vector<oclraster_struct_info*> structs;
 	oclraster_image_info images;
-	void generate_struct_info_cl_program(oclraster_struct_info& struct_info);
+	bool compute_struct_info(oclraster_struct_info& struct_info);
+	void generate_struct_info_cl_program(const vector<oclraster_struct_info*>& probe_structs);
 	
 	//
 	virtual string preprocess_code(const string& raw_code);
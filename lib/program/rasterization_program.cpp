@@ -28,16 +28,23 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 	#include "oclr_image.h"
 	#include "oclr_primitive_assembly.h"
 
-	typedef struct __attribute__((packed, aligned(4))) {
-		// VV0: 0 - 2
-		// VV1: 3 - 5
-		// VV2: 6 - 8
-		// depth: 9
-		float data[10];
-	} transformed_data;
-
 	// shortcut for the opengl folks
 	#define discard() { return false; }
+	
+	// screen-space derivatives of interpolated output variables, e.g. dfdx(output_attributes, tex_coord)
+	#define dfdx(object, member) (object##_ddx->member)
+	#define dfdy(object, member) (object##_ddy->member)
+	
+	// difference between the (normalized) barycentric coordinates at a neighboring fragment and the current fragment
+	// -> since interpolation is linear, interpolating with this results in the derivative of an interpolated value
+	OCLRASTER_FUNC float4 compute_barycentric_derivative(const float3 VV0, const float3 VV1, const float3 VV2,
+														 const float2 coord, const float4 barycentric) {
+		float3 neighbor = (float3)(mad(coord.x, VV0.x, mad(coord.y, VV0.y, VV0.z)),
+								   mad(coord.x, VV1.x, mad(coord.y, VV1.y, VV1.z)),
+								   mad(coord.x, VV2.x, mad(coord.y, VV2.y, VV2.z)));
+		neighbor /= neighbor.x + neighbor.y + neighbor.z;
+		return (float4)(neighbor - barycentric.xyz, 0.0f);
+	}
 	//###OCLRASTER_DEPTH_TEST_FUNCTION###
 	//###OCLRASTER_USER_CODE###
 	
@@ -48,6 +55,9 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 										
 										global unsigned int* bin_distribution_counter,
 										global const transformed_data* transformed_buffer,
+#if defined(OCLRASTER_ATTRIBUTE_SETUP)
+										global const float* attribute_planes,
+#endif
 										global const uchar* bin_queues,
 										
 										const uint2 bin_count,
@@ -61,7 +71,15 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 										const unsigned int instance_index_count,
 										
 										const uint2 framebuffer_size,
-										const uint4 scissor_rectangle) {
+										const uint4 scissor_rectangle
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+										, global unsigned int* pipeline_stats
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+										, global unsigned int* bin_heatmap
+										, const uint2 heatmap_bin_count
+#endif
+										) {
 		const unsigned int local_id = get_local_id(0);
 		const unsigned int local_size = get_local_size(0);
 		
@@ -138,6 +156,21 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 			const size_t global_queue_offset = (bin_idx * batch_count) * BATCH_SIZE;
 #endif
 			
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+			// per work-item fragment statistics of this bin (-> only one atomic add per counter and bin)
+			unsigned int fragment_stats[PS_FRAGMENT_STATISTIC_COUNT] = { 0u, 0u, 0u, 0u, 0u };
+#define fragment_stat_inc(stat) fragment_stats[stat - PS_FRAGMENTS_TESTED]++
+#else
+#define fragment_stat_inc(stat)
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+			// per work-item fragment metrics of this bin (flushed once per bin, like the statistics)
+			unsigned int heatmap_fragments[2] = { 0u, 0u };
+#define heatmap_fragment_inc(metric) heatmap_fragments[metric - BH_FRAGMENTS_TESTED]++
+#else
+#define heatmap_fragment_inc(metric)
+#endif
+			
 			//
 			const uint2 bin_location = (uint2)(bin_idx % bin_count.x, bin_idx / bin_count.x) + bin_offset;
 			for(unsigned int i = 0; i < intra_bin_groups; i++) {
@@ -187,21 +220,14 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 						
 						//
 						{
-							const float3 VV0 = (float3)(transformed_buffer[primitive_id].data[0],
-														transformed_buffer[primitive_id].data[1],
-														transformed_buffer[primitive_id].data[2]);
-							const float3 VV1 = (float3)(transformed_buffer[primitive_id].data[3],
-														transformed_buffer[primitive_id].data[4],
-														transformed_buffer[primitive_id].data[5]);
-							const float3 VV2 = (float3)(transformed_buffer[primitive_id].data[6],
-														transformed_buffer[primitive_id].data[7],
-														transformed_buffer[primitive_id].data[8]);
+							// -> VV0, VV1, VV2, primitive_depth and setup_coord (edge function coordinate of this fragment)
+							LOAD_TRANSFORMED_DATA(&transformed_buffer[primitive_id]);
 							
 							//
-							float4 barycentric = (float4)(mad(fragment_coord.x, VV0.x, mad(fragment_coord.y, VV0.y, VV0.z)),
-														  mad(fragment_coord.x, VV1.x, mad(fragment_coord.y, VV1.y, VV1.z)),
-														  mad(fragment_coord.x, VV2.x, mad(fragment_coord.y, VV2.y, VV2.z)),
-														  transformed_buffer[primitive_id].data[9]); // .w = computed depth
+							float4 barycentric = (float4)(mad(setup_coord.x, VV0.x, mad(setup_coord.y, VV0.y, VV0.z)),
+														  mad(setup_coord.x, VV1.x, mad(setup_coord.y, VV1.y, VV1.z)),
+														  mad(setup_coord.x, VV2.x, mad(setup_coord.y, VV2.y, VV2.z)),
+														  primitive_depth); // .w = computed depth
 							
 #if defined(OCLRASTER_PROJECTION_PERSPECTIVE)
 							if(barycentric.x >= 0.0f || barycentric.y >= 0.0f || barycentric.z >= 0.0f) continue;
@@ -232,15 +258,21 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 #endif
 							
 							// simplified:
-							barycentric /= barycentric.x + barycentric.y + barycentric.z;
+							const float barycentric_sum = barycentric.x + barycentric.y + barycentric.z;
+							barycentric /= barycentric_sum;
 							
 							// ignore fragments with negative depth
 							if(barycentric.w < 0.0f) continue;
+							fragment_stat_inc(PS_FRAGMENTS_TESTED);
+							heatmap_fragment_inc(BH_FRAGMENTS_TESTED);
 							
 #if !defined(OCLRASTER_NO_DEPTH) && !defined(OCLRASTER_NO_DEPTH_TEST)
 #if !defined(OCLRASTER_DEPTH_OVERRIDE)
 							// early depth test
-							if(!depth_test(barycentric.w, *fragment_depth)) continue;
+							if(!depth_test(barycentric.w, *fragment_depth)) {
+								fragment_stat_inc(PS_FRAGMENTS_EARLY_DEPTH_REJECTED);
+								continue;
+							}
 #else
 							// need to save the old depth value if the user overwrites the framebuffer depth
 							const float prev_depth = *fragment_depth;
@@ -249,6 +281,7 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 							
 							// note: if a fragment is discarded, this will "continue"
 							// -> depth is not updated and fragment counter is not increased
+							heatmap_fragment_inc(BH_FRAGMENTS_SHADED);
 							//###OCLRASTER_USER_MAIN_CALL###
 							
 #if !defined(OCLRASTER_NO_DEPTH) && !defined(OCLRASTER_NO_DEPTH_TEST)
@@ -259,11 +292,13 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 							// depth test when "depth-override" is active, i.e. the depth is written by the user program
 							if(!depth_test(*fragment_depth, prev_depth)) {
 								*fragment_depth = prev_depth; // restore previous depth value
+								fragment_stat_inc(PS_FRAGMENTS_LATE_DEPTH_REJECTED);
 								continue;
 							}
 #endif
 #endif
 							
+							fragment_stat_inc(PS_FRAGMENTS_WRITTEN);
 							fragments_passed += 1.0f;
 						}
 					}
@@ -274,8 +309,50 @@ static constexpr char template_rasterization_program[] { u8R"OCLRASTER_RAWSTR(
 					}
 				}
 			}
+			
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+			for(unsigned int stat_idx = 0; stat_idx < PS_FRAGMENT_STATISTIC_COUNT; stat_idx++) {
+				if(fragment_stats[stat_idx] > 0u) {
+					pipeline_stat_add(PS_FRAGMENTS_TESTED + stat_idx, fragment_stats[stat_idx]);
+				}
+			}
+#endif
+#if defined(OCLRASTER_BIN_HEATMAP)
+			bin_heatmap_add(bin_location, BH_FRAGMENTS_TESTED, heatmap_fragments[0]);
+			bin_heatmap_add(bin_location, BH_FRAGMENTS_SHADED, heatmap_fragments[1]);
+#endif
 		}
 	}
+	
+	// attribute plane equations (only used with "attribute setup", see pipeline::set_attribute_setup):
+	// computes the screen-space plane equation (dx, dy, offset) of each output variable once per visible primitive,
+	// the rasterizer then evaluates these per fragment instead of fetching the indices and vertex outputs
+	// -> value = (setup_coord.x * dx + setup_coord.y * dy + offset) / (barycentric.x + barycentric.y + barycentric.z)
+#if defined(OCLRASTER_ATTRIBUTE_SETUP)
+	kernel void oclraster_attribute_setup(//###OCLRASTER_SETUP_USER_STRUCTS###
+										  global const unsigned int* index_buffer,
+										  global const transformed_data* transformed_buffer,
+										  global const float4* primitive_bounds_buffer,
+										  global float* attribute_planes,
+										  const unsigned int primitive_type,
+										  const unsigned int primitive_count,
+										  const unsigned int instance_primitive_count,
+										  const unsigned int instance_index_count) {
+		const unsigned int primitive_id = get_global_id(0);
+		if(primitive_id >= primitive_count) return;
+		
+		// culled primitive (-> will never be rasterized)
+		if(primitive_bounds_buffer[primitive_id].x == INFINITY) return;
+		
+		const unsigned int instance_id = primitive_id / instance_primitive_count;
+		const unsigned int instance_index_offset = instance_id * instance_index_count;
+		MAKE_PRIMITIVE_INDICES(indices);
+		
+		const float2 fragment_coord = (float2)(0.0f, 0.0f); // not needed here
+		LOAD_TRANSFORMED_DATA(&transformed_buffer[primitive_id]);
+		//###OCLRASTER_ATTRIBUTE_SETUP###
+	}
+#endif
 )OCLRASTER_RAWSTR"};
 #endif
 
@@ -312,6 +389,17 @@ string rasterization_program::specialized_processing(const string& code,
 	string main_call_parameters = "";
 	size_t cur_user_buffer = 0;
 	bool has_output_structs = false;
+	// only compute derivatives when they are actually used (otherwise the interpolated values are passed as derivatives)
+	const bool uses_derivatives = (code.find("dfdx(") != string::npos || code.find("dfdy(") != string::npos ||
+								   code.find("_ddx") != string::npos || code.find("_ddy") != string::npos);
+	
+	// with attribute setup, output variables are evaluated from their plane equations (dx, dy, offset),
+	// which are computed once per primitive by the attribute setup kernel
+	const bool attribute_setup = (spec.attribute_setup && has_attribute_setup());
+	const string attribute_plane_stride_str = uint2string(get_attribute_plane_stride()) + "u";
+	string setup_parameters = "";
+	string setup_code = "";
+	unsigned int attribute_plane_offset = 0;
 	for(const auto& oclr_struct : structs) {
 		const string cur_user_buffer_str = size_t2string(cur_user_buffer);
 		switch(oclr_struct->type) {
@@ -322,15 +410,68 @@ string rasterization_program::specialized_processing(const string& code,
 				has_output_structs = true;
 				const string interp_var_name = "interpolated_user_buffer_element_" + cur_user_buffer_str;
 				buffer_handling_code += oclr_struct->name + " " + interp_var_name +";\n";
-				for(const auto& var : oclr_struct->variables) {
-					buffer_handling_code += interp_var_name + "." + var + " = interpolate(";
+				if(uses_derivatives) {
+					buffer_handling_code += oclr_struct->name + " " + interp_var_name + "_ddx;\n";
+					buffer_handling_code += oclr_struct->name + " " + interp_var_name + "_ddy;\n";
+				}
+				if(attribute_setup) {
+					setup_parameters += "global const " + oclr_struct->name + "* user_buffer_" + cur_user_buffer_str + ",\n";
+				}
+				for(size_t var_idx = 0, var_count = oclr_struct->variables.size(); var_idx < var_count; var_idx++) {
+					const string& var = oclr_struct->variables[var_idx];
+					string vertex_values = "";
 					for(size_t i = 0; i < 3; i++) {
-						buffer_handling_code += "user_buffer_" + cur_user_buffer_str + "[indices[" + size_t2string(i) + "]]." + var;
-						if(i < 2) buffer_handling_code += ", ";
+						vertex_values += "user_buffer_" + cur_user_buffer_str + "[indices[" + size_t2string(i) + "]]." + var + ", ";
+					}
+					if(!attribute_setup) {
+						buffer_handling_code += interp_var_name + "." + var + " = interpolate(" + vertex_values + "barycentric);\n";
+						if(uses_derivatives) {
+							buffer_handling_code += interp_var_name + "_ddx." + var + " = interpolate(" + vertex_values + "barycentric_ddx);\n";
+							buffer_handling_code += interp_var_name + "_ddy." + var + " = interpolate(" + vertex_values + "barycentric_ddy);\n";
+						}
+						continue;
+					}
+					
+					// plane equation (dx, dy and offset are stored consecutively)
+					const string& var_type = oclr_struct->variable_types[var_idx];
+					const unsigned int component_count = attribute_component_count(var_type);
+					string plane[3];
+					for(unsigned int i = 0; i < 3; i++) {
+						const string offset_str = uint2string(attribute_plane_offset + i * component_count);
+						plane[i] = (component_count == 1 ?
+									"attribute_plane[" + offset_str + "]" :
+									"vload" + uint2string(component_count) + "(0, attribute_plane + " + offset_str + ")");
+						
+						const string component = string(1, "xyz"[i]);
+						string plane_value = "";
+						for(size_t j = 0; j < 3; j++) {
+							plane_value += ((j > 0 ? " + " : "") + string("user_buffer_") + cur_user_buffer_str +
+											"[indices[" + size_t2string(j) + "]]." + var + " * VV" + size_t2string(j) + "." + component);
+						}
+						setup_code += (component_count == 1 ?
+									   plane[i] + " = " + plane_value + ";\n" :
+									   "vstore" + uint2string(component_count) + "(" + plane_value + ", 0, attribute_plane + " + offset_str + ");\n");
+					}
+					attribute_plane_offset += 3 * component_count;
+					
+					buffer_handling_code += (interp_var_name + "." + var + " = (setup_coord.x * " + plane[0] +
+											 " + setup_coord.y * " + plane[1] + " + " + plane[2] + ") * barycentric_rcp;\n");
+					if(uses_derivatives) {
+						buffer_handling_code += (interp_var_name + "_ddx." + var + " = ((setup_coord.x + 1.0f) * " + plane[0] +
+												 " + setup_coord.y * " + plane[1] + " + " + plane[2] + ") * barycentric_rcp_ddx - " +
+												 interp_var_name + "." + var + ";\n");
+						buffer_handling_code += (interp_var_name + "_ddy." + var + " = (setup_coord.x * " + plane[0] +
+												 " + (setup_coord.y + 1.0f) * " + plane[1] + " + " + plane[2] + ") * barycentric_rcp_ddy - " +
+												 interp_var_name + "." + var + ";\n");
 					}
-					buffer_handling_code += ", barycentric);\n";
 				}
 				main_call_parameters += "&" + interp_var_name + ", ";
+				if(uses_derivatives) {
+					main_call_parameters += "&" + interp_var_name + "_ddx, &" + interp_var_name + "_ddy, ";
+				}
+				else {
+					main_call_parameters += "&" + interp_var_name + ", &" + interp_var_name + ", ";
+				}
 			}
 			break;
 			case oclraster_program::STRUCT_TYPE::UNIFORMS:
@@ -354,10 +495,31 @@ string rasterization_program::specialized_processing(const string& code,
 		}
 		cur_user_buffer++;
 	}
-	if(has_output_structs) {
+	if(has_output_structs && attribute_setup) {
+		// no index or transform output reads here, only the plane equations of this primitive
+		if(uses_derivatives) {
+			buffer_handling_code = ("const float barycentric_rcp_ddx = 1.0f / (barycentric_sum + VV0.x + VV1.x + VV2.x);\n"
+									"const float barycentric_rcp_ddy = 1.0f / (barycentric_sum + VV0.y + VV1.y + VV2.y);\n" +
+									buffer_handling_code);
+		}
+		buffer_handling_code = ("global const float* attribute_plane = &attribute_planes[primitive_id * " + attribute_plane_stride_str + "];\n"
+								"const float barycentric_rcp = 1.0f / barycentric_sum;\n" +
+								buffer_handling_code);
+		
+		core::find_and_replace(program_code, "//###OCLRASTER_SETUP_USER_STRUCTS###", setup_parameters);
+		core::find_and_replace(program_code, "//###OCLRASTER_ATTRIBUTE_SETUP###",
+							   "global float* attribute_plane = &attribute_planes[primitive_id * " + attribute_plane_stride_str + "];\n" +
+							   setup_code);
+	}
+	else if(has_output_structs) {
 		// reading indices is only necessary when transform stage output variables must be interpolated
 		buffer_handling_code = ("const unsigned int instance_index_offset = instance_id * instance_index_count;\nMAKE_PRIMITIVE_INDICES(indices);\n" +
 								buffer_handling_code);
+		if(uses_derivatives) {
+			buffer_handling_code = ("const float4 barycentric_ddx = compute_barycentric_derivative(VV0, VV1, VV2, setup_coord + (float2)(1.0f, 0.0f), barycentric);\n"
+									"const float4 barycentric_ddy = compute_barycentric_derivative(VV0, VV1, VV2, setup_coord + (float2)(0.0f, 1.0f), barycentric);\n" +
+									buffer_handling_code);
+		}
 	}
 	for(size_t i = 0, img_count = image_decls.size(); i < img_count; i++) {
 		// framebuffer is passed in separately
@@ -365,7 +527,10 @@ string rasterization_program::specialized_processing(const string& code,
 		main_call_parameters += images.image_names[i] + ", ";
 	}
 	main_call_parameters += "&framebuffer, fragment_coord, barycentric.w, barycentric.xyz, primitive_id, instance_id"; // the same for all rasterization programs
-	const string main_call = "if(!oclraster_user_"+entry_function+"("+main_call_parameters+")) continue;";
+	const string main_call = ("if(!oclraster_user_"+entry_function+"("+main_call_parameters+")) {\n"
+							  "fragment_stat_inc(PS_FRAGMENTS_DISCARDED);\n"
+							  "continue;\n"
+							  "}");
 	core::find_and_replace(program_code, "//###OCLRASTER_USER_MAIN_CALL###",
 						   buffer_handling_code+main_call);
 	
@@ -469,6 +634,31 @@ string rasterization_program::get_fixed_entry_function_parameters() const {
 	return "oclraster_framebuffer* framebuffer, const float2 fragment_coord, const float fragment_depth, const float3 barycentric, const unsigned int primitive_index, const unsigned int instance_index";
 }
 
+bool rasterization_program::has_output_derivatives() const {
+	return true;
+}
+
+bool rasterization_program::has_attribute_setup() const {
+	return (get_attribute_plane_stride() > 0);
+}
+
+unsigned int rasterization_program::attribute_component_count(const string& var_type) {
+	// output variables are always float, float2, float3 or float4
+	const char last_char = (var_type.empty() ? '\0' : var_type.back());
+	return (last_char >= '2' && last_char <= '4' ? (unsigned int)(last_char - '0') : 1u);
+}
+
+unsigned int rasterization_program::get_attribute_plane_stride() const {
+	unsigned int stride = 0;
+	for(const auto& oclr_struct : structs) {
+		if(oclr_struct->type != STRUCT_TYPE::OUTPUT) continue;
+		for(const auto& var_type : oclr_struct->variable_types) {
+			stride += 3 * attribute_component_count(var_type);
+		}
+	}
+	return stride;
+}
+
 string rasterization_program::get_qualifier_for_struct_type(const STRUCT_TYPE& type) const {
 	switch(type) {
 		case STRUCT_TYPE::INPUT:
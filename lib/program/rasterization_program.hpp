@@ -30,12 +30,18 @@ public:
 	virtual ~rasterization_program();
 	rasterization_program(rasterization_program& prog) = delete;
 	rasterization_program& operator=(rasterization_program& prog) = delete;
+	
+	virtual bool has_attribute_setup() const;
+	// number of floats per primitive in the attribute plane buffer (dx, dy and offset of each output variable)
+	unsigned int get_attribute_plane_stride() const;
 
 protected:
 	virtual string specialized_processing(const string& code,
 										  const kernel_spec& spec);
 	virtual string get_fixed_entry_function_parameters() const;
 	virtual string get_qualifier_for_struct_type(const STRUCT_TYPE& type) const;
+	virtual bool has_output_derivatives() const;
+	static unsigned int attribute_component_count(const string& var_type);
 
 };
 
@@ -0,0 +1,244 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "struct_layout.hpp"
+#include "oclraster.hpp"
+#include "core/memory_tracker.hpp"
+
+unordered_map<const opencl::device_object*, struct_layout::device_layout_info> struct_layout::device_infos;
+once_flag struct_layout::init_flag;
+
+// members of the test structs that are used to validate the host layout computation
+// (mixes types with explicit alignment attributes, 3-component vectors and differently sized scalars)
+static const vector<string> validation_members {
+	"char", "mat4", "oclr_half3", "float3", "uchar", "ulong2", "short", "float16", "int3", "mat2", "oclr_half"
+};
+
+const vector<string>& struct_layout::get_known_types() {
+	static const vector<string> known_types = [] {
+		vector<string> types;
+		static const array<const char*, 10> scalar_types {
+			{ "char", "uchar", "short", "ushort", "int", "uint", "long", "ulong", "float", "double" }
+		};
+		static const array<const char*, 5> vector_widths {{ "2", "3", "4", "8", "16" }};
+		for(const auto& scalar_type : scalar_types) {
+			types.emplace_back(scalar_type);
+			for(const auto& width : vector_widths) {
+				types.emplace_back(string(scalar_type) + width);
+			}
+		}
+		types.insert(types.end(), {
+			"size_t", "ptrdiff_t", "intptr_t", "uintptr_t",
+			"oclr_half", "oclr_half2", "oclr_half3", "oclr_half4",
+			"mat2", "mat3", "mat4"
+		});
+		return types;
+	}();
+	return known_types;
+}
+
+string struct_layout::normalize_type(const string& type) {
+	// split into tokens, drop qualifiers and convert "unsigned <type>" to "u<type>"
+	vector<string> tokens;
+	size_t pos = 0;
+	while((pos = type.find_first_not_of(" \t\n\r", pos)) != string::npos) {
+		const size_t end_pos = type.find_first_of(" \t\n\r", pos);
+		tokens.emplace_back(type.substr(pos, end_pos == string::npos ? string::npos : end_pos - pos));
+		pos = end_pos;
+	}
+	
+	string ret = "";
+	bool is_unsigned = false, is_signed = false;
+	for(const auto& token : tokens) {
+		if(token == "const" || token == "volatile") continue;
+		if(token == "unsigned") {
+			is_unsigned = true;
+			continue;
+		}
+		if(token == "signed") {
+			is_signed = true;
+			continue;
+		}
+		if(!ret.empty()) ret += " ";
+		ret += (is_unsigned ? "u" : "") + token;
+		is_unsigned = false;
+		is_signed = false;
+	}
+	// lone "unsigned"/"signed" -> int
+	if(is_unsigned) ret += (ret.empty() ? "uint" : " uint");
+	else if(is_signed) ret += (ret.empty() ? "int" : " int");
+	return ret;
+}
+
+void struct_layout::init() {
+	call_once(init_flag, &struct_layout::probe_devices);
+}
+
+void struct_layout::probe_devices() {
+	const auto& types = get_known_types();
+	const auto is_double_type = [](const string& type) { return (type.compare(0, 6, "double") == 0); };
+	
+	// create the probe kernel: sizes and alignments of all known types + member offsets of the test structs
+	string kernel_code = "#include \"oclr_global.h\"\n#include \"oclr_matrix.h\"\n";
+	for(size_t i = 0, type_count = types.size(); i < type_count; i++) {
+		if(is_double_type(types[i])) kernel_code += "#if defined(FLOOR_DOUBLE_SUPPORT)\n";
+		kernel_code += "typedef struct { char c; " + types[i] + " t; } oclr_align_" + size_t2string(i) + ";\n";
+		if(is_double_type(types[i])) kernel_code += "#endif\n";
+	}
+	static const array<pair<const char*, const char*>, 2> test_structs {{
+		{ "oclraster_struct {\n", "oclr_layout_test_packed" },
+		{ "typedef struct {\n", "oclr_layout_test_unpacked" },
+	}};
+	for(const auto& test_struct : test_structs) {
+		kernel_code += test_struct.first;
+		for(size_t i = 0; i < validation_members.size(); i++) {
+			kernel_code += validation_members[i] + " m" + size_t2string(i) + ";\n";
+		}
+		kernel_code += "} " + string(test_struct.second) + ";\n";
+	}
+	
+	kernel_code += "kernel void struct_layout_info(global int* info) {\n";
+	kernel_code += "if(get_global_id(0) != 0) return;\n";
+	for(size_t i = 0, type_count = types.size(); i < type_count; i++) {
+		const string size_idx = size_t2string(i * 2), align_idx = size_t2string(i * 2 + 1);
+		if(is_double_type(types[i])) kernel_code += "#if defined(FLOOR_DOUBLE_SUPPORT)\n";
+		kernel_code += "info[" + size_idx + "] = (int)sizeof(" + types[i] + ");\n";
+		kernel_code += "info[" + align_idx + "] = (int)((size_t)&(((oclr_align_" + size_t2string(i) + "*)0)->t));\n";
+		if(is_double_type(types[i])) {
+			kernel_code += "#else\ninfo[" + size_idx + "] = 0;\ninfo[" + align_idx + "] = 0;\n#endif\n";
+		}
+	}
+	size_t info_idx = types.size() * 2;
+	for(const auto& test_struct : test_structs) {
+		const string name = test_struct.second;
+		kernel_code += "info[" + size_t2string(info_idx++) + "] = (int)sizeof(" + name + ");\n";
+		for(size_t i = 0; i < validation_members.size(); i++) {
+			kernel_code += "info[" + size_t2string(info_idx++) + "] = (int)((size_t)&(((" + name + "*)0)->m" + size_t2string(i) + "));\n";
+		}
+	}
+	kernel_code += "}\n";
+	const size_t info_size = info_idx;
+	
+	//
+	weak_ptr<opencl::kernel_object> kernel_obj = ocl->add_kernel_src("STRUCT_LAYOUT_INFO", kernel_code, "struct_layout_info");
+	auto kernel_ptr = kernel_obj.lock();
+	if(kernel_ptr == nullptr) {
+		log_error("failed to create STRUCT_LAYOUT_INFO kernel - falling back to per-program struct probing!");
+		return;
+	}
+	
+	vector<int> info(info_size, 0);
+	ocl->lock();
+	auto active_device = ocl->get_active_device();
+	const auto& devices = ocl->get_devices();
+	for(const auto& device : devices) {
+		ocl->set_active_device(device->type);
+		opencl::buffer_object* info_buffer = memory_tracker::create_buffer(MEMORY_TAG::PROGRAM,
+																		   opencl::BUFFER_FLAG::READ_WRITE |
+																		   opencl::BUFFER_FLAG::BLOCK_ON_READ,
+																		   info_size * sizeof(int));
+		ocl->use_kernel("STRUCT_LAYOUT_INFO");
+		ocl->set_kernel_argument(0, info_buffer);
+		ocl->set_kernel_range({1, 1});
+		ocl->run_kernel();
+		ocl->read_buffer(&info[0], info_buffer);
+		memory_tracker::delete_buffer(info_buffer);
+		
+		// store type info (size 0 -> type is not supported on this device)
+		device_layout_info& dev_info = device_infos[device];
+		for(size_t i = 0, type_count = types.size(); i < type_count; i++) {
+			if(info[i * 2] <= 0) continue;
+			dev_info.types.emplace(types[i], type_info { (size_t)info[i * 2], (size_t)info[i * 2 + 1] });
+		}
+		
+		// validate the host computation against the device test struct layouts
+		dev_info.valid = true;
+		info_idx = types.size() * 2;
+		for(const auto& test_struct : test_structs) {
+			const bool packed = (test_struct.second == test_structs[0].second);
+			layout host_layout;
+			if(!compute(dev_info, validation_members, host_layout, packed, packed ? OCLRASTER_STRUCT_ALIGNMENT : 1)) {
+				dev_info.valid = false;
+				break;
+			}
+			bool match = (host_layout.struct_size == (size_t)info[info_idx++]);
+			for(size_t i = 0; i < validation_members.size(); i++) {
+				if(host_layout.offsets[i] != (size_t)info[info_idx++]) match = false;
+			}
+			if(!match) {
+				dev_info.valid = false;
+				break;
+			}
+		}
+		if(!dev_info.valid) {
+			log_debug("host struct layout validation failed on device \"%s\" - falling back to struct probing",
+					  device->name);
+		}
+	}
+	ocl->set_active_device(active_device->type);
+	ocl->unlock();
+	
+	kernel_ptr = nullptr;
+	ocl->delete_kernel(kernel_obj);
+}
+
+bool struct_layout::compute(const opencl::device_object* device,
+							const vector<string>& member_types,
+							const vector<string>& member_names,
+							layout& ret,
+							const bool packed,
+							const size_t struct_alignment) {
+	init();
+	
+	// array members are not handled on the host
+	for(const auto& name : member_names) {
+		if(name.find('[') != string::npos) return false;
+	}
+	
+	const auto dev_info = device_infos.find(device);
+	if(dev_info == device_infos.cend() || !dev_info->second.valid) return false;
+	return compute(dev_info->second, member_types, ret, packed, struct_alignment);
+}
+
+bool struct_layout::compute(const device_layout_info& info,
+							const vector<string>& member_types,
+							layout& ret,
+							const bool packed,
+							const size_t struct_alignment) {
+	const auto align_up = [](const size_t& value, const size_t& alignment) {
+		return ((value + alignment - 1) / alignment) * alignment;
+	};
+	
+	ret.sizes.clear();
+	ret.offsets.clear();
+	size_t offset = 0, max_alignment = 1;
+	for(const auto& member_type : member_types) {
+		const auto type = info.types.find(normalize_type(member_type));
+		if(type == info.types.cend()) return false;
+		
+		// packed: no padding between members, regardless of the member type alignment
+		const size_t member_alignment = (packed ? 1 : type->second.alignment);
+		offset = align_up(offset, member_alignment);
+		ret.sizes.emplace_back(type->second.size);
+		ret.offsets.emplace_back(offset);
+		offset += type->second.size;
+		max_alignment = std::max(max_alignment, member_alignment);
+	}
+	ret.struct_size = align_up(offset, std::max(max_alignment, struct_alignment));
+	return true;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_STRUCT_LAYOUT_HPP__
+#define __OCLRASTER_STRUCT_LAYOUT_HPP__
+
+#include "oclraster/global.hpp"
+#include "cl/opencl.hpp"
+
+// host-side OpenCL C struct layout computation (sizes, alignments and member offsets).
+// the size and alignment of every known OpenCL C type is queried once per device with a single
+// probe kernel, which also validates the layout rules against a set of test structs.
+// struct layouts of oclraster programs can then be computed on the host, without compiling
+// and running a probe kernel for each struct.
+class struct_layout {
+public:
+	struct type_info {
+		size_t size;
+		size_t alignment;
+	};
+	struct layout {
+		size_t struct_size;
+		vector<size_t> sizes;
+		vector<size_t> offsets;
+	};
+	
+	// computes the layout of a struct with the specified member types for the given device
+	// (defaults to the layout of an oclraster_struct: packed and aligned to OCLRASTER_STRUCT_ALIGNMENT).
+	// returns false if this is not possible on the host (unknown member type, array member or
+	// the device failed validation), in which case a probe kernel must be used instead.
+	static bool compute(const opencl::device_object* device,
+						const vector<string>& member_types,
+						const vector<string>& member_names,
+						layout& ret,
+						const bool packed = true,
+						const size_t struct_alignment = OCLRASTER_STRUCT_ALIGNMENT);
+	
+	// returns the canonical OpenCL C type name (e.g. "unsigned int" -> "uint", "const float4" -> "float4")
+	static string normalize_type(const string& type);
+	
+	// runs the per-device type/validation probe (automatically called on first use)
+	static void init();
+
+protected:
+	struct device_layout_info {
+		bool valid { false };
+		unordered_map<string, type_info> types;
+	};
+	static unordered_map<const opencl::device_object*, device_layout_info> device_infos;
+	static once_flag init_flag;
+	
+	static const vector<string>& get_known_types();
+	static bool compute(const device_layout_info& info,
+						const vector<string>& member_types,
+						layout& ret,
+						const bool packed,
+						const size_t struct_alignment);
+	static void probe_devices();
+	
+};
+
+#endif
@@ -29,6 +29,15 @@ for arg in "$@"; do
 		"cl-profiling")
 			BUILD_ARGS=${BUILD_ARGS}" --cl-profiling"
 			;;
+		"pipeline-statistics")
+			BUILD_ARGS=${BUILD_ARGS}" --pipeline-statistics"
+			;;
+		"bin-heatmap")
+			BUILD_ARGS=${BUILD_ARGS}" --bin-heatmap"
+			;;
+		"half-primitive-setup")
+			BUILD_ARGS=${BUILD_ARGS}" --half-primitive-setup"
+			;;
 		"gldrawpixels")
 			BUILD_ARGS=${BUILD_ARGS}" --gldrawpixels"
 			;;
@@ -84,6 +84,15 @@ solution "oclraster"
 		if(_ARGS[argc] == "--cl-profiling") then
 			defines { "OCLRASTER_PROFILING=1" }
 		end
+		if(_ARGS[argc] == "--pipeline-statistics") then
+			defines { "OCLRASTER_PIPELINE_STATISTICS=1" }
+		end
+		if(_ARGS[argc] == "--bin-heatmap") then
+			defines { "OCLRASTER_BIN_HEATMAP=1" }
+		end
+		if(_ARGS[argc] == "--half-primitive-setup") then
+			defines { "OCLRASTER_HALF_PRIMITIVE_SETUP=1" }
+		end
 		if(_ARGS[argc] == "--gldrawpixels") then
 			defines { "OCLRASTER_USE_DRAW_PIXELS=1" }
 		end
@@ -367,6 +376,156 @@ project "oclr_volume"
 			buildoptions { "-gdwarf-2" }
 		end
 
+project "oclr_program_bench"
+	targetname "oclr_program_bench"
+	kind "ConsoleApp"
+	language "C++"
+	files { "samples/oclr_program_bench/src/**.hpp", "samples/oclr_program_bench/src/**.cpp" }
+	basedir "samples/oclr_program_bench"
+	targetdir "bin"
+
+	includedirs { "/usr/include/oclraster",
+				  "/usr/local/include/oclraster",
+				  "samples/oclr_program_bench/src/" }
+
+	configuration "Release"
+		links { "oclraster" }
+		targetname "oclr_program_bench"
+		defines { "NDEBUG" }
+		flags { "Optimize" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-O3 -ffast-math" }
+		end
+		
+	configuration "Debug"
+		links { "oclrasterd" }
+		targetname "oclr_program_benchd"
+		defines { "DEBUG", "OCLRASTER_DEBUG" }
+		flags { "Symbols" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-gdwarf-2" }
+		end
+
+project "oclr_bench"
+	targetname "oclr_bench"
+	kind "ConsoleApp"
+	language "C++"
+	files { "samples/oclr_bench/src/**.hpp", "samples/oclr_bench/src/**.cpp" }
+	basedir "samples/oclr_bench"
+	targetdir "bin"
+
+	includedirs { "/usr/include/oclraster",
+				  "/usr/local/include/oclraster",
+				  "samples/oclr_bench/src/" }
+
+	configuration "Release"
+		links { "oclraster" }
+		targetname "oclr_bench"
+		defines { "NDEBUG" }
+		flags { "Optimize" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-O3 -ffast-math" }
+		end
+		
+	configuration "Debug"
+		links { "oclrasterd" }
+		targetname "oclr_benchd"
+		defines { "DEBUG", "OCLRASTER_DEBUG" }
+		flags { "Symbols" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-gdwarf-2" }
+		end
+
+project "oclr_stage_bench"
+	targetname "oclr_stage_bench"
+	kind "ConsoleApp"
+	language "C++"
+	files { "samples/oclr_stage_bench/src/**.hpp", "samples/oclr_stage_bench/src/**.cpp" }
+	basedir "samples/oclr_stage_bench"
+	targetdir "bin"
+
+	includedirs { "/usr/include/oclraster",
+				  "/usr/local/include/oclraster",
+				  "samples/oclr_stage_bench/src/" }
+
+	configuration "Release"
+		links { "oclraster" }
+		targetname "oclr_stage_bench"
+		defines { "NDEBUG" }
+		flags { "Optimize" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-O3 -ffast-math" }
+		end
+		
+	configuration "Debug"
+		links { "oclrasterd" }
+		targetname "oclr_stage_benchd"
+		defines { "DEBUG", "OCLRASTER_DEBUG" }
+		flags { "Symbols" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-gdwarf-2" }
+		end
+
+project "oclr_replay"
+	targetname "oclr_replay"
+	kind "ConsoleApp"
+	language "C++"
+	files { "samples/oclr_replay/src/**.hpp", "samples/oclr_replay/src/**.cpp" }
+	basedir "samples/oclr_replay"
+	targetdir "bin"
+
+	includedirs { "/usr/include/oclraster",
+				  "/usr/local/include/oclraster",
+				  "samples/oclr_replay/src/" }
+
+	configuration "Release"
+		links { "oclraster" }
+		targetname "oclr_replay"
+		defines { "NDEBUG" }
+		flags { "Optimize" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-O3 -ffast-math" }
+		end
+		
+	configuration "Debug"
+		links { "oclrasterd" }
+		targetname "oclr_replayd"
+		defines { "DEBUG", "OCLRASTER_DEBUG" }
+		flags { "Symbols" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-gdwarf-2" }
+		end
+
+project "oclr_image_bench"
+	targetname "oclr_image_bench"
+	kind "ConsoleApp"
+	language "C++"
+	files { "samples/oclr_image_bench/src/**.hpp", "samples/oclr_image_bench/src/**.cpp" }
+	basedir "samples/oclr_image_bench"
+	targetdir "bin"
+
+	includedirs { "/usr/include/oclraster",
+				  "/usr/local/include/oclraster",
+				  "samples/oclr_image_bench/src/" }
+
+	configuration "Release"
+		links { "oclraster" }
+		targetname "oclr_image_bench"
+		defines { "NDEBUG" }
+		flags { "Optimize" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-O3 -ffast-math" }
+		end
+		
+	configuration "Debug"
+		links { "oclrasterd" }
+		targetname "oclr_image_benchd"
+		defines { "DEBUG", "OCLRASTER_DEBUG" }
+		flags { "Symbols" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-gdwarf-2" }
+		end
+
 -- oclraster_support lib and samples
 project "liboclraster_support"
 	-- project settings
@@ -0,0 +1,575 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "oclr_bench.hpp"
+#include <fstream>
+
+// renders a fixed set of scenes offscreen (no swap/display) for a fixed number of frames, moving the
+// camera along a fixed path, and writes frame time percentiles and per-stage times to a json file.
+// usage: oclr_bench [frames] [output file] [gpu|cpu]
+// NOTE: per-stage times are only available if oclraster was built with "cl-profiling"
+static pipeline* p { nullptr };
+static camera* cam { nullptr };
+static const uint2 render_size { 1280, 720 };
+static constexpr size_t warmup_frames { 8 };
+#if defined(OCLRASTER_PROFILING)
+static constexpr bool has_stage_times { true };
+#else
+static constexpr bool has_stage_times { false };
+#endif
+
+//
+static bool load_program(const string& filename,
+						 unique_ptr<transform_program>& tp,
+						 unique_ptr<rasterization_program>& rp) {
+	string code;
+	if(!file_io::file_to_string(floor::kernel_path("user/"+filename), code)) {
+		log_error("couldn't open program: %s", filename);
+		return false;
+	}
+	tp.reset(new transform_program(code, "transform_main"));
+	rp.reset(new rasterization_program(code, "rasterize_main"));
+	return (tp->is_valid() && rp->is_valid());
+}
+
+static bool load_program(const string& tp_filename, const string& rp_filename,
+						 unique_ptr<transform_program>& tp,
+						 unique_ptr<rasterization_program>& rp) {
+	string tp_code, rp_code;
+	if(!file_io::file_to_string(floor::kernel_path("user/"+tp_filename), tp_code)) {
+		log_error("couldn't open program: %s", tp_filename);
+		return false;
+	}
+	if(!file_io::file_to_string(floor::kernel_path("user/"+rp_filename), rp_code)) {
+		log_error("couldn't open program: %s", rp_filename);
+		return false;
+	}
+	tp.reset(new transform_program(tp_code, "transform_main"));
+	rp.reset(new rasterization_program(rp_code, "rasterize_main"));
+	return (tp->is_valid() && rp->is_valid());
+}
+
+template <typename T> static opencl::buffer_object* create_uniforms_buffer(const T& data) {
+	return ocl->create_buffer(opencl::BUFFER_FLAG::READ |
+							  opencl::BUFFER_FLAG::INITIAL_COPY |
+							  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+							  sizeof(T), (void*)&data);
+}
+
+// fixed camera path: one full orbit around the origin over all measured frames, looking at the origin
+static void set_camera_on_path(const size_t frame, const size_t frame_count,
+							   const float distance, const float height) {
+	const float angle = (float(frame) / float(std::max(frame_count, size_t(1)))) * 2.0f * PI;
+	const float3 position { sinf(angle) * distance, height, cosf(angle) * distance };
+	cam->set_position(position);
+	cam->set_rotation(-atan2f(height, distance) * (180.0f / PI),
+					  atan2f(-position.x, -position.z) * (180.0f / PI),
+					  0.0f);
+	p->set_camera(cam);
+}
+
+static void draw_model(const a2m& model) {
+	p->bind_buffer("input_attributes", model.get_vertex_buffer());
+	for(unsigned int i = 0, count = model.get_object_count(); i < count; i++) {
+		p->bind_buffer("index_buffer", model.get_index_buffer(i));
+		p->draw(PRIMITIVE_TYPE::TRIANGLE, model.get_vertex_count(), { 0, model.get_index_count(i) });
+	}
+}
+
+// full-screen quad in orthographic screen space (drawn as a 4 vertex triangle strip)
+struct screen_quad {
+	oclraster_struct vertex_attribute {
+		float4 vertex;
+		float2 tex_coord;
+	};
+	opencl::buffer_object* attributes { nullptr };
+	opencl::buffer_object* indices { nullptr };
+	
+	screen_quad(const uint2& size) {
+		const array<vertex_attribute, 4> quad_attributes {{
+			{ float4 { 0.0f, (float)size.y, 0.0f, 1.0f }, float2 { 0.0f, 1.0f } },
+			{ float4 { 0.0f, 0.0f, 0.0f, 1.0f }, float2 { 0.0f, 0.0f } },
+			{ float4 { (float)size.x, (float)size.y, 0.0f, 1.0f }, float2 { 1.0f, 1.0f } },
+			{ float4 { (float)size.x, 0.0f, 0.0f, 1.0f }, float2 { 1.0f, 0.0f } },
+		}};
+		const array<unsigned int, 4> quad_indices {{ 0, 1, 2, 3 }};
+		attributes = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
+										opencl::BUFFER_FLAG::INITIAL_COPY |
+										opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+										sizeof(vertex_attribute) * quad_attributes.size(),
+										(void*)&quad_attributes[0]);
+		indices = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
+									 opencl::BUFFER_FLAG::INITIAL_COPY |
+									 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+									 sizeof(unsigned int) * quad_indices.size(),
+									 (void*)&quad_indices[0]);
+	}
+	~screen_quad() {
+		ocl->delete_buffer(attributes);
+		ocl->delete_buffer(indices);
+	}
+	
+	void draw(const unsigned int instance_count = 1) const {
+		p->bind_buffer("input_attributes", *attributes);
+		p->bind_buffer("index_buffer", *indices);
+		p->draw_instanced(PRIMITIVE_TYPE::TRIANGLE_STRIP, 4, { 0, 2 }, instance_count);
+	}
+};
+
+// uniforms of bench.cl
+oclraster_struct bench_tp_uniforms {
+	matrix4f modelview;
+	float4 grid; // .x = instances per row, .y = instance spacing
+};
+
+//////////////////////////////////////////////////////////////////
+// triangle-rate: the largest model, simple shading
+// (also run with the authored triangle/vertex order to measure the effect of the mesh optimization,
+// and with cluster culling or automatic lod selection)
+enum class TRIANGLE_RATE_MODE : unsigned int {
+	OPTIMIZED,
+	UNOPTIMIZED,
+	CLUSTERS,
+	LOD,
+};
+class triangle_rate_scene : public bench_scene {
+public:
+	triangle_rate_scene(const TRIANGLE_RATE_MODE mode_ = TRIANGLE_RATE_MODE::OPTIMIZED) :
+	bench_scene(mode_ == TRIANGLE_RATE_MODE::OPTIMIZED ? "triangle_rate" :
+				(mode_ == TRIANGLE_RATE_MODE::UNOPTIMIZED ? "triangle_rate_unoptimized" :
+				 (mode_ == TRIANGLE_RATE_MODE::CLUSTERS ? "triangle_rate_clusters" : "triangle_rate_lod"))),
+	mode(mode_) {}
+	virtual ~triangle_rate_scene() {
+		if(model != nullptr) delete model;
+		if(tp_uniforms_buffer != nullptr) ocl->delete_buffer(tp_uniforms_buffer);
+	}
+	
+	virtual bool init() override {
+		if(!load_program("bench.cl", tp, rp)) return false;
+		model = new a2m(floor::data_path("tux.a2m"), mode != TRIANGLE_RATE_MODE::UNOPTIMIZED);
+		tp_uniforms_buffer = create_uniforms_buffer(bench_tp_uniforms { matrix4f(), float4(1.0f, 0.0f, 0.0f, 0.0f) });
+		return true;
+	}
+	
+	virtual void render(framebuffer& fb, const size_t frame, const size_t frame_count) override {
+		p->bind_framebuffer(&fb);
+		set_camera_on_path(frame, frame_count, 3.0f, 1.0f);
+		p->bind_program(*tp);
+		p->bind_program(*rp);
+		p->bind_buffer("tp_uniforms", *tp_uniforms_buffer);
+		if(mode == TRIANGLE_RATE_MODE::CLUSTERS) {
+			// the modelview matrix is the identity -> object space == world space
+			p->bind_buffer("input_attributes", model->get_vertex_buffer());
+			for(unsigned int i = 0, count = model->get_object_count(); i < count; i++) {
+				p->bind_buffer("index_buffer", model->get_index_buffer(i));
+				p->draw_clusters(model->get_vertex_count(), model->get_clusters(i));
+			}
+		}
+		else if(mode == TRIANGLE_RATE_MODE::LOD) {
+			p->bind_buffer("input_attributes", model->get_vertex_buffer());
+			for(unsigned int i = 0, count = model->get_object_count(); i < count; i++) {
+				const unsigned int lod = model->select_lod(i, p->get_camera_setup());
+				p->bind_buffer("index_buffer", model->get_lod_index_buffer(i, lod));
+				p->draw(PRIMITIVE_TYPE::TRIANGLE, model->get_vertex_count(), { 0, model->get_lod_index_count(i, lod) });
+			}
+		}
+		else draw_model(*model);
+	}
+
+protected:
+	const TRIANGLE_RATE_MODE mode;
+	unique_ptr<transform_program> tp;
+	unique_ptr<rasterization_program> rp;
+	a2m* model { nullptr };
+	opencl::buffer_object* tp_uniforms_buffer { nullptr };
+	
+};
+
+//////////////////////////////////////////////////////////////////
+// fill-rate: overlapping full-screen quads, blended in the rasterization program
+class fill_rate_scene : public bench_scene {
+public:
+	fill_rate_scene() : bench_scene("fill_rate") {}
+	virtual ~fill_rate_scene() {
+		if(quad != nullptr) delete quad;
+	}
+	
+	virtual bool init() override {
+		if(!load_program("bench_fill.cl", tp, rp)) return false;
+		quad = new screen_quad(render_size);
+		return true;
+	}
+	
+	virtual void render(framebuffer& fb, const size_t frame floor_unused, const size_t frame_count floor_unused) override {
+		p->bind_framebuffer(&fb);
+		p->start_orthographic_rendering();
+		const DEPTH_FUNCTION prev_depth_func = p->get_depth_function();
+		p->set_depth_function(DEPTH_FUNCTION::ALWAYS);
+		p->bind_program(*tp);
+		p->bind_program(*rp);
+		quad->draw(layer_count);
+		p->set_depth_function(prev_depth_func);
+		p->stop_orthographic_rendering();
+	}
+
+protected:
+	static constexpr unsigned int layer_count { 16 };
+	unique_ptr<transform_program> tp;
+	unique_ptr<rasterization_program> rp;
+	screen_quad* quad { nullptr };
+	
+};
+
+//////////////////////////////////////////////////////////////////
+// heavy texturing: parallax mapping (4 textures) on a model that covers most of the screen
+class texturing_scene : public bench_scene {
+public:
+	texturing_scene() : bench_scene("texturing") {}
+	virtual ~texturing_scene() {
+		if(model != nullptr) delete model;
+		if(fp_noise != nullptr) delete fp_noise;
+		if(tp_uniforms_buffer != nullptr) ocl->delete_buffer(tp_uniforms_buffer);
+		if(rp_uniforms_buffer != nullptr) ocl->delete_buffer(rp_uniforms_buffer);
+	}
+	
+	virtual bool init() override {
+		if(!load_program("simple_parallax_vs.cl", "simple_parallax_fs.cl", tp, rp)) return false;
+		model = new a2m(floor::data_path("monkey_uv.a2m"), true);
+		
+		static const array<string, 3> texture_names {{ "rockwall_512", "rockwall_normal_512", "rockwall_height_512" }};
+		for(size_t i = 0; i < textures.size(); i++) {
+			textures[i] = make_shared<image>(image::from_file(floor::data_path(texture_names[i]+".png"),
+															  image::BACKING::BUFFER, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA));
+		}
+		
+		// deterministic noise (lcg), so that all runs use the same data
+		vector<float> fp_noise_data(512 * 512);
+		unsigned int seed = 1;
+		for(auto& val : fp_noise_data) {
+			seed = seed * 1664525u + 1013904223u;
+			val = float(seed >> 8) / float(1u << 24);
+		}
+		fp_noise = new image(512, 512, image::BACKING::BUFFER, IMAGE_TYPE::FLOAT_32, IMAGE_CHANNEL::R, &fp_noise_data[0]);
+		
+		tp_uniforms_buffer = create_uniforms_buffer(tp_uniforms { matrix4f(), matrix4f() });
+		rp_uniforms_buffer = create_uniforms_buffer(rasterize_uniforms);
+		return true;
+	}
+	
+	virtual void render(framebuffer& fb, const size_t frame, const size_t frame_count) override {
+		p->bind_framebuffer(&fb);
+		set_camera_on_path(frame, frame_count, 1.6f, 0.2f);
+		rasterize_uniforms.camera_position.vector3<float>::set(cam->get_position());
+		ocl->write_buffer(rp_uniforms_buffer, &rasterize_uniforms);
+		
+		p->bind_program(*tp);
+		p->bind_program(*rp);
+		p->bind_buffer("tp_uniforms", *tp_uniforms_buffer);
+		p->bind_buffer("rp_uniforms", *rp_uniforms_buffer);
+		p->bind_image("diffuse_texture", *textures[0]);
+		p->bind_image("normal_texture", *textures[1]);
+		p->bind_image("height_texture", *textures[2]);
+		p->bind_image("fp_noise", *fp_noise);
+		draw_model(*model);
+	}
+
+protected:
+	unique_ptr<transform_program> tp;
+	unique_ptr<rasterization_program> rp;
+	a2m* model { nullptr };
+	array<shared_ptr<image>, 3> textures;
+	image* fp_noise { nullptr };
+	
+	oclraster_struct tp_uniforms {
+		matrix4f modelview;
+		matrix4f rotation_matrix;
+	};
+	oclraster_struct rp_uniforms {
+		float4 camera_position;
+		float4 light_position; // .w = light radius ^ 2
+		float4 light_color;
+	} rasterize_uniforms {
+		float4(0.0f, 0.0f, 0.0f, 1.0f),
+		float4(0.0f, 4.0f, 4.0f, 32.0f * 32.0f),
+		float4(1.0f, 1.0f, 1.0f, 1.0f)
+	};
+	opencl::buffer_object* tp_uniforms_buffer { nullptr };
+	opencl::buffer_object* rp_uniforms_buffer { nullptr };
+	
+};
+
+//////////////////////////////////////////////////////////////////
+// instancing: a grid of model instances drawn with a single instanced draw call
+class instancing_scene : public bench_scene {
+public:
+	instancing_scene() : bench_scene("instancing") {}
+	virtual ~instancing_scene() {
+		if(model != nullptr) delete model;
+		if(tp_uniforms_buffer != nullptr) ocl->delete_buffer(tp_uniforms_buffer);
+	}
+	
+	virtual bool init() override {
+		if(!load_program("bench.cl", tp, rp)) return false;
+		model = new a2m(floor::data_path("monkey_uv.a2m"), true);
+		tp_uniforms_buffer = create_uniforms_buffer(bench_tp_uniforms {
+			matrix4f(), float4((float)instances_per_row, 2.5f, 0.0f, 0.0f)
+		});
+		return true;
+	}
+	
+	virtual void render(framebuffer& fb, const size_t frame, const size_t frame_count) override {
+		p->bind_framebuffer(&fb);
+		set_camera_on_path(frame, frame_count, 14.0f, 6.0f);
+		p->bind_program(*tp);
+		p->bind_program(*rp);
+		p->bind_buffer("tp_uniforms", *tp_uniforms_buffer);
+		p->bind_buffer("input_attributes", model->get_vertex_buffer());
+		p->bind_buffer("index_buffer", model->get_index_buffer(0));
+		p->draw_instanced(PRIMITIVE_TYPE::TRIANGLE, model->get_vertex_count(), { 0, model->get_index_count(0) },
+						  instances_per_row * instances_per_row);
+	}
+
+protected:
+	static constexpr unsigned int instances_per_row { 8 };
+	unique_ptr<transform_program> tp;
+	unique_ptr<rasterization_program> rp;
+	a2m* model { nullptr };
+	opencl::buffer_object* tp_uniforms_buffer { nullptr };
+	
+};
+
+//////////////////////////////////////////////////////////////////
+// rtt: renders a textured model into a 512*512 framebuffer, which is then displayed full-screen
+class rtt_scene : public bench_scene {
+public:
+	rtt_scene() : bench_scene("rtt") {}
+	virtual ~rtt_scene() {
+		if(model != nullptr) delete model;
+		if(quad != nullptr) delete quad;
+		if(tp_uniforms_buffer != nullptr) ocl->delete_buffer(tp_uniforms_buffer);
+		if(rtt_fb != nullptr) framebuffer::destroy_images(*rtt_fb);
+	}
+	
+	virtual bool init() override {
+		if(!load_program("diffuse_texturing_vs.cl", "diffuse_texturing_fs.cl", rtt_tp, rtt_rp)) return false;
+		if(!load_program("rtt_display_vs.cl", "rtt_display_fs.cl", display_tp, display_rp)) return false;
+		model = new a2m(floor::data_path("monkey_uv.a2m"), true);
+		texture = make_shared<image>(image::from_file(floor::data_path("planks_512.png"),
+													  image::BACKING::BUFFER, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA));
+		texture->generate_mipmaps(); // trilinear filtering in diffuse_texturing_fs
+		quad = new screen_quad(render_size);
+		
+		oclraster_struct tp_uniforms {
+			matrix4f rotation;
+			matrix4f modelview;
+		};
+		tp_uniforms_buffer = create_uniforms_buffer(tp_uniforms { matrix4f(), matrix4f() });
+		
+		rtt_fb.reset(new framebuffer(framebuffer::create_with_images(512, 512,
+																	 {{ IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA }},
+																	 { IMAGE_TYPE::FLOAT_32, IMAGE_CHANNEL::R })));
+		rtt_fb->set_clear_color_int(ulong4 { 0, 76, 180, 255 });
+		return true;
+	}
+	
+	virtual void render(framebuffer& fb, const size_t frame, const size_t frame_count) override {
+		// draw the model into the rtt framebuffer
+		rtt_fb->clear();
+		p->bind_framebuffer(rtt_fb.get());
+		set_camera_on_path(frame, frame_count, 3.0f, 0.5f);
+		p->bind_program(*rtt_tp);
+		p->bind_program(*rtt_rp);
+		p->bind_buffer("tp_uniforms", *tp_uniforms_buffer);
+		p->bind_image("diffuse_texture", *texture);
+		draw_model(*model);
+		
+		// display it
+		p->bind_framebuffer(&fb);
+		p->start_orthographic_rendering();
+		p->bind_program(*display_tp);
+		p->bind_program(*display_rp);
+		p->bind_image("texture", *rtt_fb->get_image(0));
+		quad->draw();
+		p->stop_orthographic_rendering();
+	}
+
+protected:
+	unique_ptr<transform_program> rtt_tp, display_tp;
+	unique_ptr<rasterization_program> rtt_rp, display_rp;
+	a2m* model { nullptr };
+	shared_ptr<image> texture;
+	screen_quad* quad { nullptr };
+	opencl::buffer_object* tp_uniforms_buffer { nullptr };
+	unique_ptr<framebuffer> rtt_fb;
+	
+};
+
+//////////////////////////////////////////////////////////////////
+// results
+struct scene_result {
+	string name;
+	vector<double> frame_times;
+	array<vector<double>, pipeline_stage_count> stage_times;
+};
+
+// nearest-rank percentile (same as the pipeline profiler p99)
+static double percentile(const vector<double>& sorted, const size_t pct) {
+	if(sorted.empty()) return 0.0;
+	return sorted[std::min((sorted.size() * pct) / 100, sorted.size() - 1)];
+}
+
+static void write_timings(ofstream& file, const vector<double>& times) {
+	vector<double> sorted(times);
+	sort(sorted.begin(), sorted.end());
+	double sum = 0.0;
+	for(const auto& val : sorted) sum += val;
+	file << "{ \"min\": " << (sorted.empty() ? 0.0 : sorted.front());
+	file << ", \"avg\": " << (sorted.empty() ? 0.0 : sum / double(sorted.size()));
+	file << ", \"p50\": " << percentile(sorted, 50);
+	file << ", \"p90\": " << percentile(sorted, 90);
+	file << ", \"p95\": " << percentile(sorted, 95);
+	file << ", \"p99\": " << percentile(sorted, 99);
+	file << ", \"max\": " << (sorted.empty() ? 0.0 : sorted.back());
+	file << " }";
+}
+
+static bool write_results(const string& filename, const vector<scene_result>& results,
+						  const size_t frame_count) {
+	ofstream file(filename, ios::out | ios::trunc);
+	if(!file.is_open()) {
+		log_error("couldn't open output file: %s", filename);
+		return false;
+	}
+	file.setf(ios::fixed);
+	file.precision(4);
+	
+	file << "{\n";
+	file << "\t\"version\": 1,\n";
+	file << "\t\"device\": \"" << trace_recorder::escape_json(ocl->get_active_device()->name) << "\",\n";
+	file << "\t\"resolution\": [" << render_size.x << ", " << render_size.y << "],\n";
+	file << "\t\"frames\": " << frame_count << ",\n";
+	file << "\t\"warmup_frames\": " << warmup_frames << ",\n";
+	file << "\t\"stage_times\": " << (has_stage_times ? "true" : "false") << ",\n";
+	file << "\t\"scenes\": [\n";
+	for(size_t i = 0; i < results.size(); i++) {
+		const auto& result = results[i];
+		file << "\t\t{\n";
+		file << "\t\t\t\"name\": \"" << result.name << "\",\n";
+		file << "\t\t\t\"frame_ms\": ";
+		write_timings(file, result.frame_times);
+		if(has_stage_times) {
+			file << ",\n\t\t\t\"stages_ms\": {\n";
+			for(size_t stage = 0; stage < pipeline_stage_count; stage++) {
+				file << "\t\t\t\t\"" << pipeline_profiler::stage_name((PIPELINE_STAGE)stage) << "\": ";
+				write_timings(file, result.stage_times[stage]);
+				file << (stage + 1 < pipeline_stage_count ? ",\n" : "\n");
+			}
+			file << "\t\t\t}";
+		}
+		file << "\n\t\t}" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "\t]\n";
+	file << "}\n";
+	file.close();
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	// initialize oclraster
+	oclraster::init(argv[0], (const char*)"../data/");
+	floor::set_caption(APPLICATION_NAME);
+	floor::acquire_context();
+	
+	const size_t frame_count = (argc > 1 ? std::max(string2size_t(argv[1]), size_t(1)) : 200);
+	const string output_filename = (argc > 2 ? argv[2] : "oclr_bench.json");
+	const bool use_cpu = (argc > 3 && string(argv[3]) == "cpu");
+	ocl->set_active_device(use_cpu ? opencl_base::DEVICE_TYPE::FASTEST_CPU : opencl_base::DEVICE_TYPE::FASTEST_GPU);
+	
+	cam = new camera();
+	p = new pipeline();
+	oclraster::set_active_pipeline(p);
+	
+	// everything is rendered into this framebuffer, nothing is ever displayed
+	framebuffer fb = framebuffer::create_with_images(render_size.x, render_size.y,
+													 {{ IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA }},
+													 { IMAGE_TYPE::FLOAT_32, IMAGE_CHANNEL::R });
+	
+	vector<unique_ptr<bench_scene>> scenes;
+	scenes.emplace_back(new triangle_rate_scene());
+	scenes.emplace_back(new triangle_rate_scene(TRIANGLE_RATE_MODE::UNOPTIMIZED));
+	scenes.emplace_back(new triangle_rate_scene(TRIANGLE_RATE_MODE::CLUSTERS));
+	scenes.emplace_back(new triangle_rate_scene(TRIANGLE_RATE_MODE::LOD));
+	scenes.emplace_back(new fill_rate_scene());
+	scenes.emplace_back(new texturing_scene());
+	scenes.emplace_back(new instancing_scene());
+	scenes.emplace_back(new rtt_scene());
+	
+	vector<scene_result> results;
+	for(auto& scene : scenes) {
+		if(!scene->init()) {
+			log_error("failed to initialize scene \"%s\" - skipping it", scene->name);
+			continue;
+		}
+		
+		// warmup (kernel specialization builds, first-use allocations), then start a new profiler frame
+		for(size_t i = 0; i < warmup_frames; i++) {
+			fb.clear();
+			scene->render(fb, i, frame_count);
+		}
+		ocl->finish();
+		p->get_profiler().end_frame();
+		
+		scene_result result { scene->name, {}, {} };
+		for(size_t frame = 0; frame < frame_count; frame++) {
+			const unsigned long long int frame_start = SDL_GetPerformanceCounter();
+			fb.clear();
+			scene->render(fb, frame, frame_count);
+			ocl->finish();
+			const unsigned long long int frame_end = SDL_GetPerformanceCounter();
+			result.frame_times.emplace_back((double(frame_end - frame_start) * 1000.0) /
+											double(SDL_GetPerformanceFrequency()));
+			
+			// there is no swap -> end the profiler frame manually
+			p->get_profiler().end_frame();
+			const frame_stats stats = p->get_frame_stats();
+			for(size_t stage = 0; stage < pipeline_stage_count; stage++) {
+				result.stage_times[stage].emplace_back(stats.stages[stage].last);
+			}
+		}
+		
+		vector<double> sorted(result.frame_times);
+		sort(sorted.begin(), sorted.end());
+		log_msg("%s: p50 %fms, p99 %fms", result.name, percentile(sorted, 50), percentile(sorted, 99));
+		results.emplace_back(result);
+		
+		// free the scene resources before the next scene
+		scene = nullptr;
+	}
+	if(write_results(output_filename, results, frame_count)) {
+		log_msg("wrote benchmark results to %s", output_filename);
+	}
+	
+	// cleanup
+	framebuffer::destroy_images(fb);
+	scenes.clear();
+	delete cam;
+	delete p;
+	floor::release_context();
+	oclraster::destroy();
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_SAMPLE_BENCH_HPP__
+#define __OCLRASTER_SAMPLE_BENCH_HPP__
+
+#include <oclraster/oclraster.hpp>
+#include <oclraster/pipeline/pipeline.hpp>
+#include <oclraster/pipeline/image.hpp>
+#include <oclraster/pipeline/framebuffer.hpp>
+#include <oclraster/core/a2m.hpp>
+#include <oclraster/core/camera.hpp>
+#include <oclraster/program/oclraster_program.hpp>
+#include <oclraster/program/transform_program.hpp>
+#include <oclraster/program/rasterization_program.hpp>
+
+#define APPLICATION_NAME "oclraster benchmark"
+
+// a fixed benchmark scene: all resources are loaded in init(), render() draws one frame into the
+// specified framebuffer (frame is in [0, frame_count) and determines the camera position on the path)
+class bench_scene {
+public:
+	bench_scene(const string& name_) : name(name_) {}
+	virtual ~bench_scene() {}
+	
+	virtual bool init() = 0;
+	virtual void render(framebuffer& fb, const size_t frame, const size_t frame_count) = 0;
+	
+	const string name;
+	
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "oclr_image_bench.hpp"
+#include <random>
+
+// measures the software sampling throughput of buffer based images with the different image layouts
+// (linear vs. tiled), for nearest and linear filtering with rotated and minified texture coordinates
+// usage: oclr_image_bench [iterations] [image size] [gpu|cpu]
+static const uint2 output_size { 1024, 1024 };
+
+static constexpr char sample_program[] { u8R"OCLRASTER_RAWSTR(
+	#include "oclr_global.h"
+	#include "oclr_image.h"
+	
+	// one sample per work-item: the output is mapped onto the (rotated and scaled) image
+	kernel void sample_image(global const uchar4* img,
+							 global float4* output,
+							 const uint2 output_size,
+							 const float2 rotation, // (cos, sin)
+							 const float scale,
+							 const uint linear_filter) {
+		const uint2 coord = (uint2)(get_global_id(0), get_global_id(1));
+		if(coord.x >= output_size.x || coord.y >= output_size.y) return;
+		
+		const float2 centered = (convert_float2(coord) + 0.5f) / convert_float2(output_size) - 0.5f;
+		const float2 tex_coord = (float2)(dot(centered, (float2)(rotation.x, -rotation.y)),
+										  dot(centered, rotation.yx)) * scale + 0.5f;
+		const oclr_sampler_t sampler = (CLK_NORMALIZED_COORDS_TRUE | CLK_ADDRESS_REPEAT |
+										(linear_filter != 0u ? CLK_FILTER_LINEAR : CLK_FILTER_NEAREST));
+		output[coord.y * output_size.x + coord.x] = image_read_sw(img, sampler, tex_coord);
+	}
+)OCLRASTER_RAWSTR"};
+
+struct scenario {
+	string name;
+	float angle; // in degrees
+	float scale; // > 1: minification
+	bool linear_filter;
+};
+
+static const vector<scenario> scenarios {
+	{ "nearest", 0.0f, 1.0f, false },
+	{ "nearest_rotated_45", 45.0f, 1.0f, false },
+	{ "nearest_rotated_90", 90.0f, 1.0f, false },
+	{ "linear", 0.0f, 1.0f, true },
+	{ "linear_rotated_45", 45.0f, 1.0f, true },
+	{ "linear_rotated_90", 90.0f, 1.0f, true },
+	{ "linear_minified_4x", 0.0f, 4.0f, true },
+	{ "linear_minified_4x_rotated_90", 90.0f, 4.0f, true },
+};
+
+static const vector<pair<image::LAYOUT, const char*>> layouts {
+	{ image::LAYOUT::LINEAR, "linear" },
+	{ image::LAYOUT::TILED_4X4, "tiled 4x4" },
+	{ image::LAYOUT::TILED_8X8, "tiled 8x8" },
+};
+
+int main(int argc, char* argv[]) {
+	// initialize oclraster
+	oclraster::init(argv[0], (const char*)"../data/");
+	floor::set_caption(APPLICATION_NAME);
+	floor::acquire_context();
+	
+	const size_t iterations = (argc > 1 ? std::max(string2size_t(argv[1]), size_t(1)) : 20);
+	const unsigned int image_size = (argc > 2 ? std::max((unsigned int)string2size_t(argv[2]), 1u) : 2048);
+	const bool use_cpu = (argc > 3 && string(argv[3]) == "cpu");
+	ocl->set_active_device(use_cpu ? opencl_base::DEVICE_TYPE::FASTEST_CPU : opencl_base::DEVICE_TYPE::FASTEST_GPU);
+	
+	weak_ptr<opencl::kernel_object> kernel = ocl->add_kernel_src("IMAGE_BENCH", sample_program, "sample_image",
+																 " -DOCLRASTER_IMAGE_UCHAR4");
+	if(kernel.use_count() == 0) {
+		log_error("failed to build the sampling kernel!");
+		floor::release_context();
+		oclraster::destroy();
+		return -1;
+	}
+	
+	// random texel data (-> no compression or caching effects from uniform areas)
+	mt19937 rng(1337);
+	uniform_int_distribution<unsigned int> dist_texel(0u, 0xFFFFFFFFu);
+	vector<unsigned int> pixels(size_t(image_size) * size_t(image_size));
+	for(auto& pixel : pixels) pixel = dist_texel(rng);
+	unique_ptr<image> img(new image(image_size, image_size, image::BACKING::BUFFER, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA, &pixels[0]));
+	
+	opencl::buffer_object* output_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
+															  sizeof(float4) * output_size.x * output_size.y);
+	
+	log_msg("image benchmark: %ux%u RGBA8 image, %ux%u samples, %u iterations",
+			image_size, image_size, output_size.x, output_size.y, iterations);
+	for(const auto& layout : layouts) {
+		if(!img->modify_layout(layout.first)) continue;
+		log_msg("%s layout:", layout.second);
+		
+		for(const auto& sc : scenarios) {
+			const float angle = DEG2RAD(sc.angle);
+			ocl->use_kernel(kernel);
+			ocl->set_kernel_argument(0, img->get_buffer());
+			ocl->set_kernel_argument(1, output_buffer);
+			ocl->set_kernel_argument(2, output_size);
+			ocl->set_kernel_argument(3, float2 { cosf(angle), sinf(angle) });
+			ocl->set_kernel_argument(4, sc.scale);
+			ocl->set_kernel_argument(5, sc.linear_filter ? 1u : 0u);
+			ocl->set_kernel_range(ocl->compute_kernel_ranges(output_size.x, output_size.y));
+			
+			// first iteration is a warmup
+			double min_time = numeric_limits<double>::max(), avg_time = 0.0;
+			for(size_t i = 0; i <= iterations; i++) {
+				ocl->finish();
+				const unsigned long long int start = SDL_GetPerformanceCounter();
+				ocl->run_kernel();
+				ocl->finish();
+				const unsigned long long int end = SDL_GetPerformanceCounter();
+				if(i == 0) continue;
+				
+				const double time = (double(end - start) * 1000.0) / double(SDL_GetPerformanceFrequency());
+				min_time = std::min(min_time, time);
+				avg_time += time;
+			}
+			avg_time /= double(iterations);
+			log_msg("\t%s: %fms (min %fms), %f Msamples/s",
+					sc.name, avg_time, min_time, double(output_size.x * output_size.y) / (avg_time * 1000.0));
+		}
+	}
+	
+	// cleanup
+	ocl->delete_buffer(output_buffer);
+	img.reset();
+	floor::release_context();
+	oclraster::destroy();
+	return 0;
+}
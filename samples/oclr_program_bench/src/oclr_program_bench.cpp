@@ -0,0 +1,133 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "oclr_program_bench.hpp"
+#include <dirent.h>
+
+// measures the program creation time (preprocessing, parsing, struct layout computation,
+// code generation and default kernel compilation) of all user programs in data/kernels/user/
+// usage: oclr_program_bench [iterations]
+struct bench_result {
+	string name;
+	vector<oclraster_program::processing_timings> timings;
+};
+
+static vector<string> get_user_programs() {
+	vector<string> ret;
+	const string user_path = floor::kernel_path("user/");
+	DIR* dir = opendir(user_path.c_str());
+	if(dir == nullptr) {
+		log_error("couldn't open user program directory: %s", user_path);
+		return ret;
+	}
+	while(const dirent* entry = readdir(dir)) {
+		const string name = entry->d_name;
+		if(name.size() > 3 && name.compare(name.size() - 3, 3, ".cl") == 0) {
+			ret.emplace_back(name);
+		}
+	}
+	closedir(dir);
+	sort(ret.begin(), ret.end());
+	return ret;
+}
+
+static void print_result(const bench_result& result) {
+	// min and avg over all iterations
+	oclraster_program::processing_timings min_timings {
+		numeric_limits<double>::max(), numeric_limits<double>::max(), numeric_limits<double>::max(),
+		numeric_limits<double>::max(), numeric_limits<double>::max()
+	}, avg_timings;
+	for(const auto& timings : result.timings) {
+		min_timings.preprocess = std::min(min_timings.preprocess, timings.preprocess);
+		min_timings.parse = std::min(min_timings.parse, timings.parse);
+		min_timings.struct_layout = std::min(min_timings.struct_layout, timings.struct_layout);
+		min_timings.code_generation = std::min(min_timings.code_generation, timings.code_generation);
+		min_timings.build = std::min(min_timings.build, timings.build);
+		avg_timings.preprocess += timings.preprocess;
+		avg_timings.parse += timings.parse;
+		avg_timings.struct_layout += timings.struct_layout;
+		avg_timings.code_generation += timings.code_generation;
+		avg_timings.build += timings.build;
+	}
+	const double count = double(result.timings.size());
+	log_msg("%s: preprocess %fms (min %fms), parse %fms (min %fms), struct layout %fms (min %fms), codegen %fms (min %fms), build %fms (min %fms)",
+			result.name,
+			avg_timings.preprocess / count, min_timings.preprocess,
+			avg_timings.parse / count, min_timings.parse,
+			avg_timings.struct_layout / count, min_timings.struct_layout,
+			avg_timings.code_generation / count, min_timings.code_generation,
+			avg_timings.build / count, min_timings.build);
+}
+
+int main(int argc, char* argv[]) {
+	// initialize oclraster
+	oclraster::init(argv[0], (const char*)"../data/");
+	floor::set_caption(APPLICATION_NAME);
+	floor::acquire_context();
+	
+	const size_t iterations = (argc > 1 ? std::max(string2size_t(argv[1]), size_t(1)) : 10);
+	
+	// first program creation includes the one-time struct layout probe -> do it once before measuring
+	struct_layout::init();
+	
+	vector<bench_result> results;
+	for(const auto& filename : get_user_programs()) {
+		string code;
+		if(!file_io::file_to_string(floor::kernel_path("user/"+filename), code)) {
+			log_error("couldn't open program: %s", filename);
+			continue;
+		}
+		
+		// a file can contain a transform program, a rasterization program or both
+		const bool has_transform = (code.find("transform_main") != string::npos);
+		const bool has_rasterization = (code.find("rasterize_main") != string::npos);
+		bench_result tp_result { filename + " (transform)", {} };
+		bench_result rp_result { filename + " (rasterization)", {} };
+		for(size_t i = 0; i < iterations; i++) {
+			if(has_transform) {
+				transform_program* prog = new transform_program(code, "transform_main");
+				if(prog->is_valid()) tp_result.timings.emplace_back(prog->get_processing_timings());
+				delete prog;
+			}
+			if(has_rasterization) {
+				rasterization_program* prog = new rasterization_program(code, "rasterize_main");
+				if(prog->is_valid()) rp_result.timings.emplace_back(prog->get_processing_timings());
+				delete prog;
+			}
+		}
+		if(!tp_result.timings.empty()) results.emplace_back(tp_result);
+		if(!rp_result.timings.empty()) results.emplace_back(rp_result);
+	}
+	
+	//
+	log_msg("program processing benchmark (%u iterations):", iterations);
+	double total_processing = 0.0, total_build = 0.0;
+	for(const auto& result : results) {
+		print_result(result);
+		for(const auto& timings : result.timings) {
+			total_processing += timings.preprocess + timings.parse + timings.struct_layout + timings.code_generation;
+			total_build += timings.build;
+		}
+	}
+	log_msg("total: processing %fms, build %fms (per iteration: %fms, %fms)",
+			total_processing, total_build,
+			total_processing / double(iterations), total_build / double(iterations));
+	
+	oclraster::destroy();
+	return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "oclr_replay.hpp"
+
+// replays a frame capture (see frame_capture) headlessly into offscreen framebuffers
+// usage: oclr_replay [capture file] [iterations] [gpu|cpu]
+
+// all device resources of a capture
+struct replay_resources {
+	vector<unique_ptr<oclraster_program>> programs;
+	vector<opencl::buffer_object*> buffers;
+	vector<unique_ptr<image>> images;
+	vector<framebuffer> framebuffers;
+};
+
+static bool create_resources(const frame_capture::capture& cap, replay_resources& res) {
+	for(const auto& prog : cap.programs) {
+		if(prog.transform) {
+			res.programs.emplace_back(new transform_program(prog.source, prog.entry_function, prog.build_options));
+		}
+		else {
+			res.programs.emplace_back(new rasterization_program(prog.source, prog.entry_function, prog.build_options));
+		}
+		if(!res.programs.back()->is_valid()) {
+			log_error("failed to create program #%u!", res.programs.size() - 1);
+			return false;
+		}
+	}
+	
+	for(const auto& data : cap.buffers) {
+		res.buffers.emplace_back(data.empty() ? nullptr :
+								 ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
+													opencl::BUFFER_FLAG::INITIAL_COPY |
+													opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+													data.size(), (void*)&data[0]));
+	}
+	
+	for(const auto& data : cap.images) {
+		res.images.emplace_back(new image(data.size.x, data.size.y, data.backing, data.data_type, data.channel_order,
+										  data.pixels.empty() ? nullptr : &data.pixels[0]));
+		if(data.mipmapped) res.images.back()->generate_mipmaps();
+	}
+	
+	// the default framebuffer is replayed into an offscreen framebuffer of the same size and format
+	res.framebuffers.reserve(cap.framebuffers.size());
+	for(const auto& data : cap.framebuffers) {
+		res.framebuffers.emplace_back(data.size.x, data.size.y);
+		framebuffer& fb = res.framebuffers.back();
+		for(size_t i = 0, image_count = data.image_types.size(); i < image_count; i++) {
+			if(data.image_types[i].first == IMAGE_TYPE::NONE) continue;
+			fb.attach(i, *new image(data.size.x, data.size.y, image::BACKING::BUFFER,
+									data.image_types[i].first, data.image_types[i].second));
+		}
+		if(data.depth_type.first != IMAGE_TYPE::NONE) {
+			fb.attach_depth_buffer(*new image(data.size.x, data.size.y, image::BACKING::BUFFER,
+											  data.depth_type.first, data.depth_type.second));
+		}
+		if(data.stencil_type.first != IMAGE_TYPE::NONE) {
+			fb.attach_stencil_buffer(*new image(data.size.x, data.size.y, image::BACKING::BUFFER,
+												data.stencil_type.first, data.stencil_type.second));
+		}
+	}
+	return true;
+}
+
+static void destroy_resources(replay_resources& res) {
+	for(auto& buffer : res.buffers) {
+		if(buffer != nullptr) ocl->delete_buffer(buffer);
+	}
+	for(auto& fb : res.framebuffers) {
+		framebuffer::destroy_images(fb);
+	}
+	res.buffers.clear();
+	res.images.clear();
+	res.framebuffers.clear();
+	res.programs.clear();
+}
+
+static void replay(pipeline* p, const frame_capture::capture& cap, replay_resources& res) {
+	draw_state& state = p->_get_draw_state();
+	for(const auto& cmd : cap.commands) {
+		framebuffer& fb = res.framebuffers[cmd.framebuffer_id];
+		switch(cmd.type) {
+			case frame_capture::COMMAND_TYPE::CLEAR:
+				fb.set_clear_color_int(cmd.clear_color_int);
+				fb.set_clear_color_float(cmd.clear_color_float);
+				fb.set_clear_depth(cmd.clear_depth_value);
+				fb.set_clear_stencil(cmd.clear_stencil_value);
+				fb.clear(cmd.clear_indices, cmd.clear_depth, cmd.clear_stencil);
+				break;
+			case frame_capture::COMMAND_TYPE::DRAW: {
+				p->bind_framebuffer(&fb);
+				
+				// restore the complete draw state of the captured draw call
+				state.projection = cmd.projection;
+				state.backface_culling = cmd.backface_culling;
+				p->set_depth_state(cmd.depth);
+				p->set_scissor_test(cmd.scissor_test);
+				p->set_attribute_setup(cmd.attribute_setup);
+				p->set_scissor_rectangle(cmd.scissor_rectangle.x, cmd.scissor_rectangle.y,
+										 cmd.scissor_rectangle.z, cmd.scissor_rectangle.w);
+				p->get_camera_setup() = cmd.cam_setup;
+				p->update_camera_buffer();
+				
+				p->bind_program(*(transform_program*)res.programs[cmd.transform_program].get());
+				p->bind_program(*(rasterization_program*)res.programs[cmd.rasterization_program].get());
+				for(const auto& binding : cmd.bindings) {
+					switch(binding.type) {
+						case frame_capture::RESOURCE_TYPE::BUFFER:
+							if(res.buffers[binding.index] == nullptr) continue;
+							p->bind_buffer(binding.name, *res.buffers[binding.index]);
+							break;
+						case frame_capture::RESOURCE_TYPE::IMAGE:
+							p->bind_image(binding.name, *res.images[binding.index]);
+							break;
+						case frame_capture::RESOURCE_TYPE::FRAMEBUFFER_IMAGE: {
+							const image* fb_img = res.framebuffers[binding.index].get_image(binding.fb_image_index);
+							if(fb_img == nullptr) continue;
+							p->bind_image(binding.name, *fb_img);
+						}
+						break;
+					}
+				}
+				
+				p->draw_instanced(cmd.primitive_type, cmd.vertex_count, cmd.element_range, cmd.instance_count);
+			}
+			break;
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	// initialize oclraster
+	oclraster::init(argv[0], (const char*)"../data/");
+	floor::set_caption(APPLICATION_NAME);
+	floor::acquire_context();
+	
+	const string capture_filename = (argc > 1 ? argv[1] : "oclr_simple.oclrcap");
+	const size_t iterations = (argc > 2 ? std::max(string2size_t(argv[2]), size_t(1)) : 1);
+	const bool use_cpu = (argc > 3 && string(argv[3]) == "cpu");
+	ocl->set_active_device(use_cpu ? opencl_base::DEVICE_TYPE::FASTEST_CPU : opencl_base::DEVICE_TYPE::FASTEST_GPU);
+	
+	frame_capture::capture cap;
+	if(!frame_capture::load(capture_filename, cap)) {
+		floor::release_context();
+		oclraster::destroy();
+		return -1;
+	}
+	size_t draw_count = 0;
+	for(const auto& cmd : cap.commands) {
+		if(cmd.type == frame_capture::COMMAND_TYPE::DRAW) draw_count++;
+	}
+	log_msg("replaying \"%s\": %u commands (%u draw calls), %u programs, %u buffers, %u images, %u framebuffers",
+			capture_filename, cap.commands.size(), draw_count, cap.programs.size(),
+			cap.buffers.size(), cap.images.size(), cap.framebuffers.size());
+	
+	pipeline* p = new pipeline();
+	oclraster::set_active_pipeline(p);
+	
+	replay_resources res;
+	if(!create_resources(cap, res)) {
+		destroy_resources(res);
+		delete p;
+		floor::release_context();
+		oclraster::destroy();
+		return -1;
+	}
+	
+	// first replay is a warmup (kernel specialization builds)
+	double min_time = numeric_limits<double>::max(), max_time = 0.0, avg_time = 0.0;
+	for(size_t i = 0; i <= iterations; i++) {
+		ocl->finish();
+		const unsigned long long int start = SDL_GetPerformanceCounter();
+		replay(p, cap, res);
+		ocl->finish();
+		const unsigned long long int end = SDL_GetPerformanceCounter();
+		if(i == 0) continue;
+		
+		const double time = (double(end - start) * 1000.0) / double(SDL_GetPerformanceFrequency());
+		min_time = std::min(min_time, time);
+		max_time = std::max(max_time, time);
+		avg_time += time;
+	}
+	log_msg("%u iterations: avg %fms, min %fms, max %fms",
+			iterations, avg_time / double(iterations), min_time, max_time);
+	
+	// cleanup
+	p->bind_framebuffer(nullptr);
+	destroy_resources(res);
+	delete p;
+	floor::release_context();
+	oclraster::destroy();
+	return 0;
+}
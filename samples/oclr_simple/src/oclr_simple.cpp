@@ -74,7 +74,7 @@ int main(int argc floor_unused, char* argv[]) {
 	oclraster::set_active_pipeline(p);
 	
 	// load the model (blender monkey with uv coordinates)
-	a2m* model = new a2m(floor::data_path("monkey_uv.a2m"));
+	a2m* model = new a2m(floor::data_path("monkey_uv.a2m"), true);
 	//a2m* model = new a2m(floor::data_path("blend_test.a2m"));
 	//model->flip_faces();
 	
@@ -153,10 +153,17 @@ int main(int argc floor_unused, char* argv[]) {
 	
 	static constexpr auto image_backing = image::BACKING::BUFFER; // or image::BACKING::IMAGE
 	array<array<shared_ptr<image>, textures_per_material>, material_count> materials;
+	// decode all textures in parallel
+	vector<image_loader::request> texture_requests;
+	for(const auto& texture_name : texture_names) {
+		texture_requests.emplace_back(image_loader::request {
+			floor::data_path(texture_name+".png"), image_backing, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA
+		});
+	}
+	vector<image> textures = image_loader::load_batch(texture_requests);
 	for(size_t i = 0; i < material_count; i++) {
 		for(size_t j = 0; j < textures_per_material; j++) {
-			materials[i][j] = make_shared<image>(image::from_file(floor::data_path(texture_names[(i * textures_per_material) + j]+".png"),
-																  image_backing, IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA));
+			materials[i][j] = make_shared<image>(move(textures[(i * textures_per_material) + j]));
 		}
 	}
 	
@@ -382,6 +389,25 @@ bool key_handler(EVENT_TYPE type, shared_ptr<event_object> obj) {
 			case SDLK_f:
 				p->_set_fxaa_state(p->_get_fxaa_state() ^ true);
 				break;
+			case SDLK_F12:
+				// capture the next frame (replay it with oclr_replay)
+				frame_capture::request("oclr_simple.oclrcap");
+				break;
+			case SDLK_h: {
+				// cycle the bin heatmap overlay: off -> primitives -> fragments tested -> fragments shaded -> off
+				bin_heatmap& heatmap = p->get_bin_heatmap();
+				if(!heatmap.get_overlay_state()) {
+					heatmap.set_overlay(true, (BIN_HEATMAP_METRIC)0);
+				}
+				else if((size_t)heatmap.get_overlay_metric() + 1 < bin_heatmap_metric_count) {
+					heatmap.set_overlay(true, (BIN_HEATMAP_METRIC)((size_t)heatmap.get_overlay_metric() + 1));
+				}
+				else heatmap.set_overlay(false);
+			}
+			break;
+			case SDLK_F11:
+				p->get_bin_heatmap().export_image("oclr_simple_heatmap.bmp", p->get_bin_heatmap().get_overlay_metric());
+				break;
 			case SDLK_1:
 				selected_material = 0;
 				break;
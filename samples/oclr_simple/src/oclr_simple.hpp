@@ -23,6 +23,8 @@
 #include <oclraster/pipeline/pipeline.hpp>
 #include <oclraster/pipeline/transform_stage.hpp>
 #include <oclraster/pipeline/image.hpp>
+#include <oclraster/pipeline/image_loader.hpp>
+#include <oclraster/pipeline/frame_capture.hpp>
 #include <oclraster/core/a2m.hpp>
 #include <oclraster/core/camera.hpp>
 #include <oclraster/program/oclraster_program.hpp>
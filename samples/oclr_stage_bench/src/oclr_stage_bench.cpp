@@ -0,0 +1,291 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "oclr_stage_bench.hpp"
+#include <random>
+
+// drives the processing, binning and rasterization stage directly with synthetic, already transformed
+// (orthographic screen space) triangles, so that each stage can be measured in isolation and without
+// any user transform program cost. the rasterization program is a minimal constant color program.
+// usage: oclr_stage_bench [iterations] [uniform|full_screen|clustered <count> <size> <coverage>]
+static const uint2 render_size { 1280, 720 };
+
+enum class DISTRIBUTION : unsigned int {
+	UNIFORM, // triangles uniformly distributed over the covered area
+	FULL_SCREEN, // pairs of triangles that cover the complete framebuffer
+	CLUSTERED, // triangles concentrated in a few discs inside the covered area
+};
+
+struct scenario {
+	string name;
+	DISTRIBUTION distribution;
+	unsigned int count; // triangle count (if 0: derived from overlap)
+	float size; // triangle leg length in pixels (ignored for FULL_SCREEN)
+	float coverage; // fraction of the framebuffer (centered) the triangles are placed in
+	float overlap; // wanted average depth complexity inside the covered area (only used if count is 0)
+	unsigned int cluster_count; // CLUSTERED only
+	float cluster_radius; // CLUSTERED only, in pixels
+};
+
+static const vector<scenario> default_scenarios {
+	{ "uniform_tiny", DISTRIBUTION::UNIFORM, 100000, 2.0f, 1.0f, 0.0f, 0, 0.0f },
+	{ "uniform_small", DISTRIBUTION::UNIFORM, 0, 8.0f, 1.0f, 4.0f, 0, 0.0f },
+	{ "uniform_medium_partial", DISTRIBUTION::UNIFORM, 0, 64.0f, 0.25f, 4.0f, 0, 0.0f },
+	{ "full_screen", DISTRIBUTION::FULL_SCREEN, 32, 0.0f, 1.0f, 0.0f, 0, 0.0f },
+	{ "clustered", DISTRIBUTION::CLUSTERED, 100000, 4.0f, 1.0f, 0.0f, 8, 48.0f },
+	{ "clustered_single_bin", DISTRIBUTION::CLUSTERED, 50000, 2.0f, 1.0f, 0.0f, 1, (float)OCLRASTER_BIN_SIZE * 0.5f },
+};
+
+struct stage_timings {
+	vector<double> processing, binning, rasterization;
+};
+
+// generates the transformed vertices (3 per triangle) for the given scenario
+static vector<float4> generate_triangles(const scenario& sc, mt19937& rng) {
+	const float2 fb_size { (float)render_size.x, (float)render_size.y };
+	vector<float4> vertices;
+	
+	if(sc.distribution == DISTRIBUTION::FULL_SCREEN) {
+		for(unsigned int i = 0; i < sc.count; i++) {
+			if(i % 2 == 0) {
+				vertices.emplace_back(0.0f, 0.0f, 1.0f, 1.0f);
+				vertices.emplace_back(fb_size.x, 0.0f, 1.0f, 1.0f);
+				vertices.emplace_back(0.0f, fb_size.y, 1.0f, 1.0f);
+			}
+			else {
+				vertices.emplace_back(fb_size.x, 0.0f, 1.0f, 1.0f);
+				vertices.emplace_back(fb_size.x, fb_size.y, 1.0f, 1.0f);
+				vertices.emplace_back(0.0f, fb_size.y, 1.0f, 1.0f);
+			}
+		}
+		return vertices;
+	}
+	
+	// covered area: centered rectangle with the framebuffer aspect ratio
+	const float2 area_size = fb_size * sqrtf(core::clamp(sc.coverage, 0.0f, 1.0f));
+	const float2 area_offset = (fb_size - area_size) * 0.5f;
+	const float triangle_area = sc.size * sc.size * 0.5f;
+	const unsigned int count = (sc.count != 0 ? sc.count :
+								(unsigned int)((sc.overlap * area_size.x * area_size.y) / triangle_area));
+	
+	uniform_real_distribution<float> dist_x(area_offset.x, area_offset.x + area_size.x);
+	uniform_real_distribution<float> dist_y(area_offset.y, area_offset.y + area_size.y);
+	uniform_real_distribution<float> dist_angle(0.0f, 2.0f * PI);
+	uniform_real_distribution<float> dist_unit(0.0f, 1.0f);
+	
+	vector<float2> cluster_centers;
+	if(sc.distribution == DISTRIBUTION::CLUSTERED) {
+		for(unsigned int i = 0; i < std::max(sc.cluster_count, 1u); i++) {
+			cluster_centers.emplace_back(dist_x(rng), dist_y(rng));
+		}
+	}
+	
+	vertices.reserve(count * 3);
+	for(unsigned int i = 0; i < count; i++) {
+		float2 center;
+		if(sc.distribution == DISTRIBUTION::CLUSTERED) {
+			// uniform inside the cluster disc
+			const float2& cluster_center = cluster_centers[i % cluster_centers.size()];
+			const float radius = sc.cluster_radius * sqrtf(dist_unit(rng));
+			const float angle = dist_angle(rng);
+			center = cluster_center + float2(cosf(angle), sinf(angle)) * radius;
+		}
+		else {
+			center = float2(dist_x(rng), dist_y(rng));
+		}
+		
+		// right-angled triangle with randomly rotated legs of length "size"
+		const float angle = dist_angle(rng);
+		const float2 leg_x = float2(cosf(angle), sinf(angle)) * sc.size;
+		const float2 leg_y = float2(-leg_x.y, leg_x.x);
+		const float2 v0 = center - (leg_x + leg_y) * (1.0f / 3.0f);
+		const float2 v1 = v0 + leg_x;
+		const float2 v2 = v0 + leg_y;
+		vertices.emplace_back(v0.x, v0.y, 1.0f, 1.0f);
+		vertices.emplace_back(v1.x, v1.y, 1.0f, 1.0f);
+		vertices.emplace_back(v2.x, v2.y, 1.0f, 1.0f);
+	}
+	return vertices;
+}
+
+static double time_ms(const unsigned long long int& start, const unsigned long long int& end) {
+	return (double(end - start) * 1000.0) / double(SDL_GetPerformanceFrequency());
+}
+
+static void print_timing(const char* stage, const vector<double>& timings) {
+	if(timings.empty()) return;
+	double min_time = numeric_limits<double>::max(), avg_time = 0.0;
+	for(const auto& timing : timings) {
+		min_time = std::min(min_time, timing);
+		avg_time += timing;
+	}
+	log_msg("\t%s: %fms (min %fms)", stage, avg_time / double(timings.size()), min_time);
+}
+
+int main(int argc, char* argv[]) {
+	// initialize oclraster
+	oclraster::init(argv[0], (const char*)"../data/");
+	floor::set_caption(APPLICATION_NAME);
+	floor::acquire_context();
+	
+	const size_t iterations = (argc > 1 ? std::max(string2size_t(argv[1]), size_t(1)) : 20);
+	
+	// custom scenario from the command line or the default set
+	vector<scenario> scenarios;
+	if(argc > 5) {
+		const string dist_name = argv[2];
+		scenario sc { "custom_" + dist_name, DISTRIBUTION::UNIFORM,
+			(unsigned int)string2size_t(argv[3]), string2float(argv[4]), string2float(argv[5]),
+			0.0f, 8, 48.0f };
+		if(dist_name == "full_screen") sc.distribution = DISTRIBUTION::FULL_SCREEN;
+		else if(dist_name == "clustered") sc.distribution = DISTRIBUTION::CLUSTERED;
+		else if(dist_name != "uniform") {
+			log_error("unknown distribution: %s", dist_name);
+			return -1;
+		}
+		scenarios.emplace_back(sc);
+	}
+	else scenarios = default_scenarios;
+	
+	// setup: offscreen framebuffer, orthographic projection, no depth test, minimal rasterization program
+	pipeline* p = new pipeline();
+	oclraster::set_active_pipeline(p);
+	framebuffer fb = framebuffer::create_with_images(render_size.x, render_size.y,
+													 {{ IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA }},
+													 { IMAGE_TYPE::FLOAT_32, IMAGE_CHANNEL::R });
+	p->bind_framebuffer(&fb);
+	p->start_orthographic_rendering();
+	p->set_depth_test(false);
+	
+	string rp_code;
+	if(!file_io::file_to_string(floor::kernel_path("user/stage_bench_fs.cl"), rp_code)) {
+		log_error("couldn't open rasterization program!");
+		return -1;
+	}
+	rasterization_program* rp = new rasterization_program(rp_code, "rasterize_main");
+	p->bind_program(*rp);
+	
+	processing_stage processing;
+	binning_stage binning;
+	rasterization_stage rasterization;
+	draw_state& state = p->_get_draw_state();
+	
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	// the stage kernels always expect a statistics buffer in this configuration
+	const vector<unsigned int> zero_stats(pipeline_statistic_count, 0);
+	opencl::buffer_object* stats_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
+															 opencl::BUFFER_FLAG::INITIAL_COPY,
+															 sizeof(unsigned int) * pipeline_statistic_count,
+															 (void*)&zero_stats[0]);
+	state.pipeline_stats_buffer = stats_buffer;
+#endif
+	
+	log_msg("stage benchmark: %ux%u, bin size %u, batch size %u, %u iterations",
+			render_size.x, render_size.y, OCLRASTER_BIN_SIZE, OCLRASTER_BATCH_PRIMITIVE_COUNT, iterations);
+	mt19937 rng(1337);
+	for(const auto& sc : scenarios) {
+		const vector<float4> vertices = generate_triangles(sc, rng);
+		const unsigned int vertex_count = (unsigned int)vertices.size();
+		const unsigned int primitive_count = vertex_count / 3;
+		if(primitive_count == 0) {
+			log_error("%s: no triangles - skipping", sc.name);
+			continue;
+		}
+		vector<unsigned int> indices(vertex_count);
+		for(unsigned int i = 0; i < vertex_count; i++) indices[i] = i;
+		
+		opencl::buffer_object* index_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
+																 opencl::BUFFER_FLAG::INITIAL_COPY |
+																 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+																 sizeof(unsigned int) * indices.size(),
+																 (void*)&indices[0]);
+		p->bind_buffer("index_buffer", *index_buffer);
+		if(!p->_prepare_draw(PRIMITIVE_TYPE::TRIANGLE, vertex_count, { 0, primitive_count }, 1)) {
+			ocl->delete_buffer(index_buffer);
+			continue;
+		}
+		
+		// same buffer sizes/padding as pipeline::draw_instanced
+		const unsigned int pc_mod_batch_size = (primitive_count % OCLRASTER_BATCH_PRIMITIVE_COUNT);
+		const unsigned int primitive_padding = (pc_mod_batch_size == 0 ? 0 : OCLRASTER_BATCH_PRIMITIVE_COUNT - pc_mod_batch_size);
+		state.transformed_vertices_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE |
+															   opencl::BUFFER_FLAG::INITIAL_COPY,
+															   sizeof(float4) * vertices.size(),
+															   (void*)&vertices[0]);
+		state.transformed_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
+													  state.transformed_primitive_size() * (primitive_count + primitive_padding));
+		state.primitive_bounds_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ_WRITE,
+														   sizeof(float) * 4 * (primitive_count + primitive_padding));
+		
+		// first iteration is a warmup (rasterization kernel specialization build)
+		stage_timings timings;
+		for(size_t i = 0; i <= iterations; i++) {
+			fb.clear();
+			ocl->finish();
+			
+			const unsigned long long int processing_start = SDL_GetPerformanceCounter();
+			processing.process(state, PRIMITIVE_TYPE::TRIANGLE);
+			ocl->finish();
+			const unsigned long long int binning_start = SDL_GetPerformanceCounter();
+			const auto queue_buffer = binning.bin(state);
+			ocl->finish();
+			const unsigned long long int rasterization_start = SDL_GetPerformanceCounter();
+			rasterization.rasterize(state, PRIMITIVE_TYPE::TRIANGLE, queue_buffer);
+			ocl->finish();
+			const unsigned long long int rasterization_end = SDL_GetPerformanceCounter();
+			
+			if(i == 0) continue;
+			timings.processing.emplace_back(time_ms(processing_start, binning_start));
+			timings.binning.emplace_back(time_ms(binning_start, rasterization_start));
+			timings.rasterization.emplace_back(time_ms(rasterization_start, rasterization_end));
+		}
+		
+		// estimated average depth complexity of the covered area
+		const float triangle_area = (sc.distribution == DISTRIBUTION::FULL_SCREEN ?
+									 float(render_size.x * render_size.y) * 0.5f : sc.size * sc.size * 0.5f);
+		const float covered_area = float(render_size.x * render_size.y) *
+								   (sc.distribution == DISTRIBUTION::FULL_SCREEN ? 1.0f : core::clamp(sc.coverage, 0.0f, 1.0f));
+		log_msg("%s: %u triangles, ~%f overlap, %u bins, %u batches",
+				sc.name, primitive_count, (float(primitive_count) * triangle_area) / covered_area,
+				state.bin_count.x * state.bin_count.y, state.batch_count);
+		print_timing("processing", timings.processing);
+		print_timing("binning", timings.binning);
+		print_timing("rasterization", timings.rasterization);
+		
+		ocl->delete_buffer(state.transformed_vertices_buffer);
+		ocl->delete_buffer(state.transformed_buffer);
+		ocl->delete_buffer(state.primitive_bounds_buffer);
+		ocl->delete_buffer(index_buffer);
+		state.transformed_vertices_buffer = nullptr;
+		state.transformed_buffer = nullptr;
+		state.primitive_bounds_buffer = nullptr;
+	}
+	
+	// cleanup
+#if defined(OCLRASTER_PIPELINE_STATISTICS)
+	state.pipeline_stats_buffer = nullptr;
+	ocl->delete_buffer(stats_buffer);
+#endif
+	p->bind_framebuffer(nullptr);
+	framebuffer::destroy_images(fb);
+	delete rp;
+	delete p;
+	floor::release_context();
+	oclraster::destroy();
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ *  Flexible OpenCL Rasterizer (oclraster)
+ *  Copyright (C) 2012 - 2013 Florian Ziesche
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OCLRASTER_SAMPLE_STAGE_BENCH_HPP__
+#define __OCLRASTER_SAMPLE_STAGE_BENCH_HPP__
+
+#include <oclraster/oclraster.hpp>
+#include <oclraster/pipeline/pipeline.hpp>
+#include <oclraster/pipeline/processing_stage.hpp>
+#include <oclraster/pipeline/binning_stage.hpp>
+#include <oclraster/pipeline/rasterization_stage.hpp>
+#include <oclraster/pipeline/framebuffer.hpp>
+#include <oclraster/program/rasterization_program.hpp>
+
+#define APPLICATION_NAME "oclraster stage benchmark"
+
+#endif
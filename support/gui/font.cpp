@@ -134,26 +134,30 @@ fm(fm_), filenames(filenames_)
 		{ 1.0f, 1.0f, 0.0f, 1.0f },
 		{ 1.0f, 0.0f, 0.0f, 1.0f }
 	};
-	glyph_vbo = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-								   opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-								   opencl::BUFFER_FLAG::INITIAL_COPY,
-								   4 * sizeof(float4), &glyph_quad[0]);
-	
-	text_ubo = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-								  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-								  font_max_ubo_size);
-	
-	tp_uniforms = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-									 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-									 sizeof(font_tp_uniforms));
+	glyph_vbo = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+											  opencl::BUFFER_FLAG::READ |
+											  opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+											  opencl::BUFFER_FLAG::INITIAL_COPY,
+											  4 * sizeof(float4), &glyph_quad[0]);
+	
+	text_ubo = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+											 opencl::BUFFER_FLAG::READ |
+											 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+											 font_max_ubo_size);
+	
+	tp_uniforms = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+												opencl::BUFFER_FLAG::READ |
+												opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+												sizeof(font_tp_uniforms));
 	
 	// only temporary
 	array<unsigned int, 4> indices {{ 0, 1, 2, 3 }};
-	_tmp_indices = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-									  opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-									  opencl::BUFFER_FLAG::INITIAL_COPY,
-									  sizeof(unsigned int) * 4,
-									  &indices[0]);
+	_tmp_indices = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+												 opencl::BUFFER_FLAG::READ |
+												 opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+												 opencl::BUFFER_FLAG::INITIAL_COPY,
+												 sizeof(unsigned int) * 4,
+												 &indices[0]);
 }
 
 font::~font() {
@@ -168,9 +172,9 @@ font::~font() {
 		}
 	}
 	
-	if(glyph_vbo != nullptr) ocl->delete_buffer(glyph_vbo);
-	if(text_ubo != nullptr) ocl->delete_buffer(text_ubo);
-	if(tp_uniforms != nullptr) ocl->delete_buffer(tp_uniforms);
+	if(glyph_vbo != nullptr) memory_tracker::delete_buffer(glyph_vbo);
+	if(text_ubo != nullptr) memory_tracker::delete_buffer(text_ubo);
+	if(tp_uniforms != nullptr) memory_tracker::delete_buffer(tp_uniforms);
 	if(tex_array != nullptr) delete tex_array;
 }
 
@@ -326,9 +330,10 @@ font::text_cache font::cache_text(const string& text, opencl::buffer_object* exi
 	//
 	opencl::buffer_object* ubo = existing_ubo;
 	if(ubo == nullptr) {
-		ubo = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-								 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-								 font_max_ubo_size);
+		ubo = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+											opencl::BUFFER_FLAG::READ |
+											opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+											font_max_ubo_size);
 	}
 	
 	// update ubo with text data
@@ -346,7 +351,7 @@ font::text_cache font::cache_text(const string& text, opencl::buffer_object* exi
 
 void font::destroy_text_cache(text_cache& cached_text) {
 	if(cached_text.first.first != nullptr) {
-		ocl->delete_buffer(cached_text.first.first);
+		memory_tracker::delete_buffer(cached_text.first.first);
 		cached_text.first.first = nullptr;
 	}
 }
@@ -71,15 +71,17 @@ window_handler_fnctr(this, &gui::window_handler) {
 									EVENT_TYPE::MOUSE_WHEEL_DOWN);
 	
 	array<unsigned int, 4> indices {{ 0, 1, 2, 3 }};
-	fullscreen_indices = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-											opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-											opencl::BUFFER_FLAG::INITIAL_COPY,
-											sizeof(unsigned int) * indices.size(),
-											&indices[0]);
-	
-	fullscreen_vertices = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-											 opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-											 sizeof(float4) * 4);
+	fullscreen_indices = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+													   opencl::BUFFER_FLAG::READ |
+													   opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+													   opencl::BUFFER_FLAG::INITIAL_COPY,
+													   sizeof(unsigned int) * indices.size(),
+													   &indices[0]);
+	
+	fullscreen_vertices = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+														opencl::BUFFER_FLAG::READ |
+														opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+														sizeof(float4) * 4);
 	
 	recreate_buffers(size2(floor::get_width(), floor::get_height()));
 	
@@ -119,10 +121,10 @@ gui::~gui() {
 	delete fm;
 	
 	if(fullscreen_vertices != nullptr) {
-		ocl->delete_buffer(fullscreen_vertices);
+		memory_tracker::delete_buffer(fullscreen_vertices);
 	}
 	if(fullscreen_indices != nullptr) {
-		ocl->delete_buffer(fullscreen_indices);
+		memory_tracker::delete_buffer(fullscreen_indices);
 	}
 
 	log_debug("gui object deleted");
@@ -419,6 +421,7 @@ void gui::recreate_buffers(const size2 size) {
 	main_fbo = framebuffer::create_with_images((unsigned int)size.x, (unsigned int)size.y,
 											   { { IMAGE_TYPE::UINT_8, IMAGE_CHANNEL::RGBA } },
 											   { IMAGE_TYPE::FLOAT_32, IMAGE_CHANNEL::R });
+	main_fbo.set_memory_tag(MEMORY_TAG::GUI);
 	
 	// resize/recreate surfaces
 	for(const auto& surface : cb_surfaces) {
@@ -24,21 +24,23 @@
 
 gui_surface::gui_surface(const float2& buffer_size_, const float2& offset_, const SURFACE_FLAGS flags_) :
 flags(flags_), buffer_size(buffer_size_), buffer(0, 0), offset(offset_) {
-	vbo_rectangle = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-									   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-									   sizeof(float4) * 4);
+	vbo_rectangle = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+												  opencl::BUFFER_FLAG::READ |
+												  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+												  sizeof(float4) * 4);
 	const array<unsigned int, 4> indices {{ 0, 1, 2, 3 }};
-	rectangle_indices = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-										   opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-										   opencl::BUFFER_FLAG::INITIAL_COPY,
-										   sizeof(unsigned int) * 4, &indices[0]);
+	rectangle_indices = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+													  opencl::BUFFER_FLAG::READ |
+													  opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+													  opencl::BUFFER_FLAG::INITIAL_COPY,
+													  sizeof(unsigned int) * 4, &indices[0]);
 	resize(buffer_size);
 }
 
 gui_surface::~gui_surface() {
 	delete_buffer();
-	if(vbo_rectangle != nullptr) ocl->delete_buffer(vbo_rectangle);
-	if(rectangle_indices != nullptr) ocl->delete_buffer(rectangle_indices);
+	if(vbo_rectangle != nullptr) memory_tracker::delete_buffer(vbo_rectangle);
+	if(rectangle_indices != nullptr) memory_tracker::delete_buffer(rectangle_indices);
 }
 
 void gui_surface::delete_buffer() {
@@ -66,6 +68,7 @@ void gui_surface::resize(const float2& buffer_size_) {
 												 has_depth ? IMAGE_TYPE::FLOAT_32 : IMAGE_TYPE::NONE,
 												 has_depth ? IMAGE_CHANNEL::R : IMAGE_CHANNEL::NONE
 											 });
+	buffer.set_memory_tag(MEMORY_TAG::GUI);
 	
 	// set blit vbo rectangle data
 	set_offset(offset);
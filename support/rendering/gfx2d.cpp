@@ -30,29 +30,31 @@ void gfx2d::init(pipeline* p_) {
 	oclr_pipeline = p_;
 	
 	//
-	primitives_buffer = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-										   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-										   sizeof(float) * primitive_buffer_size);
+	primitives_buffer = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+													  opencl::BUFFER_FLAG::READ |
+													  opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+													  sizeof(float) * primitive_buffer_size);
 	
 	// indices are constant for all primitive types
 	unsigned int* indices = new unsigned int[primitive_buffer_size];
 	for(unsigned int i = 0; i < primitive_buffer_size; i++) {
 		indices[i] = i;
 	}
-	primitives_indices = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-											opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-											opencl::BUFFER_FLAG::INITIAL_COPY,
-											sizeof(unsigned int) * primitive_buffer_size,
-											indices);
+	primitives_indices = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+													   opencl::BUFFER_FLAG::READ |
+													   opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+													   opencl::BUFFER_FLAG::INITIAL_COPY,
+													   sizeof(unsigned int) * primitive_buffer_size,
+													   indices);
 	delete [] indices;
 }
 
 void gfx2d::destroy() {
 	if(primitives_buffer != nullptr) {
-		ocl->delete_buffer(primitives_buffer);
+		memory_tracker::delete_buffer(primitives_buffer);
 	}
 	if(primitives_indices != nullptr) {
-		ocl->delete_buffer(primitives_indices);
+		memory_tracker::delete_buffer(primitives_indices);
 	}
 }
 
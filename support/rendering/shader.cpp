@@ -106,14 +106,16 @@ void shader_helper::init(pipeline* p_) {
 	
 	// create a large enough uniform buffer
 	matrix4f tp_mvm; // identity matrix for now
-	primitives_tp_uniforms = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-												opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
-												opencl::BUFFER_FLAG::INITIAL_COPY,
-												sizeof(float) * primitives_tp_uniform_buffer_size,
-												&tp_mvm);
-	primitives_rp_uniforms = ocl->create_buffer(opencl::BUFFER_FLAG::READ |
-												opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
-												sizeof(float) * primitives_rp_uniform_buffer_size);
+	primitives_tp_uniforms = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+														   opencl::BUFFER_FLAG::READ |
+														   opencl::BUFFER_FLAG::BLOCK_ON_WRITE |
+														   opencl::BUFFER_FLAG::INITIAL_COPY,
+														   sizeof(float) * primitives_tp_uniform_buffer_size,
+														   &tp_mvm);
+	primitives_rp_uniforms = memory_tracker::create_buffer(MEMORY_TAG::GUI,
+														   opencl::BUFFER_FLAG::READ |
+														   opencl::BUFFER_FLAG::BLOCK_ON_WRITE,
+														   sizeof(float) * primitives_rp_uniform_buffer_size);
 	
 	//
 	floor::get_event()->add_internal_event_handler(evt_handler, EVENT_TYPE::KERNEL_RELOAD);
@@ -124,10 +126,10 @@ void shader_helper::destroy() {
 	floor::get_event()->remove_event_handler(evt_handler);
 	
 	if(primitives_tp_uniforms != nullptr) {
-		ocl->delete_buffer(primitives_tp_uniforms);
+		memory_tracker::delete_buffer(primitives_tp_uniforms);
 	}
 	if(primitives_rp_uniforms != nullptr) {
-		ocl->delete_buffer(primitives_rp_uniforms);
+		memory_tracker::delete_buffer(primitives_rp_uniforms);
 	}
 }
 